@@ -0,0 +1,128 @@
+#include "benchmark/benchmark.h"
+
+#include "data/formats/geoJson.h"
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "log.h"
+#include "tile/tileTask.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+using namespace Tangram;
+
+// Number of features in the generated FeatureCollection
+const int num_features = 20000;
+
+using ParseFn = std::shared_ptr<TileData> (*)(const TileTask&, int32_t);
+
+// Writes a FeatureCollection of polygons and lines with a few properties each
+static std::string generateCollection() {
+    std::string json = R"({"type":"FeatureCollection","features":[)";
+
+    for (int i = 0; i < num_features; i++) {
+        if (i > 0) { json += ","; }
+        double x = -0.5 + (i % 100) * 0.01;
+        double y = -0.5 + (i / 100 % 100) * 0.01;
+
+        json += R"({"type":"Feature","properties":{"kind":"building","id":)" + std::to_string(i) +
+            R"(,"height":12.5,"name":"feature )" + std::to_string(i) + R"("},"geometry":)";
+
+        if (i % 2 == 0) {
+            json += R"({"type":"Polygon","coordinates":[[)";
+            for (int j = 0; j < 16; j++) {
+                if (j > 0) { json += ","; }
+                double angle = j * 2.0 * M_PI / 16;
+                json += "[" + std::to_string(x + 0.004 * std::cos(angle)) + "," +
+                    std::to_string(y + 0.004 * std::sin(angle)) + "]";
+            }
+            json += "]]}}";
+        } else {
+            json += R"({"type":"LineString","coordinates":[)";
+            for (int j = 0; j < 8; j++) {
+                if (j > 0) { json += ","; }
+                json += "[" + std::to_string(x + 0.001 * j) + "," + std::to_string(y) + "]";
+            }
+            json += "]}}";
+        }
+    }
+    json += "]}";
+    return json;
+}
+
+struct GeoJsonParseFixture : public benchmark::Fixture {
+    std::shared_ptr<TileSource> source;
+    std::shared_ptr<TileTask> task;
+    size_t bytes = 0;
+
+    void SetUp(const ::benchmark::State& state) override {
+        if (task) { return; }
+
+        source = std::make_shared<TileSource>("test", nullptr);
+        source->setFormat(TileSource::Format::GeoJson);
+
+        std::string json = generateCollection();
+        bytes = json.size();
+
+        task = source->createTask(TileID(0, 0, 0));
+        static_cast<BinaryTileTask&>(*task).rawTileData = TileBuffer::copy(json.data(), json.size());
+    }
+
+    void parse(benchmark::State& _st, ParseFn _parse) {
+        while (_st.KeepRunning()) {
+            auto tileData = _parse(*task, 0);
+            if (!tileData || tileData->layers.empty()) {
+                LOGE("Invalid tile");
+                exit(-1);
+            }
+            benchmark::DoNotOptimize(tileData);
+        }
+        _st.SetBytesProcessed(_st.iterations() * bytes);
+    }
+
+    // Returns the peak resident set size in kB of a child process
+    // that parses the tile once, or only exits when _parse is null
+    long peakRss(ParseFn _parse) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            if (_parse) {
+                auto tileData = _parse(*task, 0);
+                benchmark::DoNotOptimize(tileData);
+            }
+            _exit(0);
+        }
+        int status = 0;
+        struct rusage usage;
+        if (pid < 0 || wait4(pid, &status, 0, &usage) != pid) {
+            LOGE("Cannot measure peak RSS");
+            exit(-1);
+        }
+        return usage.ru_maxrss;
+    }
+
+    // Labels the benchmark with the peak RSS of a parse over that of a child which does nothing
+    void labelPeakRss(benchmark::State& _st, ParseFn _parse) {
+        long peak = peakRss(_parse) - peakRss(nullptr);
+        _st.SetLabel("peak RSS +" + std::to_string(peak) + " kB");
+    }
+};
+
+// Parse with the streaming reader, features go directly to the TileData
+BENCHMARK_DEFINE_F(GeoJsonParseFixture, GeoJsonParseStream)(benchmark::State& st) {
+    labelPeakRss(st, &GeoJson::parseTile);
+    parse(st, &GeoJson::parseTile);
+}
+BENCHMARK_REGISTER_F(GeoJsonParseFixture, GeoJsonParseStream);
+
+// Parse into a JSON document before reading the features
+BENCHMARK_DEFINE_F(GeoJsonParseFixture, GeoJsonParseDocument)(benchmark::State& st) {
+    labelPeakRss(st, &GeoJson::parseTileDocument);
+    parse(st, &GeoJson::parseTileDocument);
+}
+BENCHMARK_REGISTER_F(GeoJsonParseFixture, GeoJsonParseDocument);
+
+BENCHMARK_MAIN();
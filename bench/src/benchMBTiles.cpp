@@ -0,0 +1,161 @@
+#include "benchmark/benchmark.h"
+
+#include "data/mbtilesDataSource.h"
+#include "data/tileArchive.h"
+#include "data/tileArchiveDataSource.h"
+#include "data/tileSource.h"
+#include "log.h"
+#include "mockPlatform.h"
+#include "tile/tileTask.h"
+
+#include <SQLiteCpp/Database.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+
+using namespace Tangram;
+
+const char tile_file[] = "res/tile.mvt";
+const char mbtiles_file[] = "bench_z14.mbtiles";
+const char archive_file[] = "bench_z14.tilearchive";
+
+// Tiles covering a 2304x1536 pixel viewport at z14
+const int viewX = 8185, viewY = 5447;
+const int viewWidth = 9, viewHeight = 6;
+
+struct Counter {
+    std::atomic<int> pending{0};
+    std::condition_variable done;
+    std::mutex mutex;
+
+    void decrement() {
+        if (--pending == 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_one();
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]{ return pending == 0; });
+    }
+};
+
+static void createMBTiles() {
+    auto rawTileData = MockPlatform::getBytesFromFile(tile_file);
+    if (rawTileData.empty()) {
+        LOGE("Invalid tile file '%s'", tile_file);
+        exit(-1);
+    }
+
+    std::remove(mbtiles_file);
+
+    SQLite::Database db(mbtiles_file, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+    db.exec("CREATE TABLE metadata (name TEXT, value TEXT);"
+            "CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB);"
+            "CREATE UNIQUE INDEX tile_index ON tiles (zoom_level, tile_column, tile_row);"
+            "INSERT INTO metadata (name, value) VALUES ('compression', 'identity');");
+
+    db.exec("BEGIN;");
+    SQLite::Statement stmt(db, "INSERT INTO tiles (zoom_level, tile_column, tile_row, tile_data) VALUES (?, ?, ?, ?);");
+    for (int x = viewX; x < viewX + viewWidth; x++) {
+        for (int y = viewY; y < viewY + viewHeight; y++) {
+            stmt.bind(1, 14);
+            stmt.bind(2, x);
+            stmt.bind(3, (1 << 14) - 1 - y);
+            // Distinct contents for each tile, so that they are not deduplicated
+            auto tileData = rawTileData;
+            tileData.push_back(char(x));
+            tileData.push_back(char(y));
+            stmt.bind(4, tileData.data(), tileData.size());
+            stmt.exec();
+            stmt.reset();
+        }
+    }
+    db.exec("COMMIT;");
+}
+
+class ViewportFixture : public benchmark::Fixture {
+public:
+    std::shared_ptr<MockPlatform> platform;
+    std::shared_ptr<TileSource> source;
+    std::unique_ptr<TileSource::DataSource> dataSource;
+
+    Counter counter;
+
+    void SetUp(const ::benchmark::State& state) override {
+        createMBTiles();
+
+        platform = std::make_shared<MockPlatform>();
+        source = std::make_shared<TileSource>("bench", nullptr);
+    }
+
+    void TearDown(const ::benchmark::State& state) override {
+        dataSource.reset();
+        std::remove(mbtiles_file);
+        std::remove(archive_file);
+    }
+
+    __attribute__ ((noinline)) void run() {
+        counter.pending = viewWidth * viewHeight;
+
+        TileTaskCb cb{[this](std::shared_ptr<TileTask> _task) {
+            if (!_task->hasData()) {
+                LOGE("Missing tile %s", _task->tileId().toString().c_str());
+                exit(-1);
+            }
+            counter.decrement();
+        }};
+
+        for (int x = viewX; x < viewX + viewWidth; x++) {
+            for (int y = viewY; y < viewY + viewHeight; y++) {
+                dataSource->loadTileData(source->createTask(TileID(x, y, 14)), cb);
+            }
+        }
+        counter.wait();
+    }
+};
+
+class MBTilesFixture : public ViewportFixture {
+public:
+    void SetUp(const ::benchmark::State& state) override {
+        ViewportFixture::SetUp(state);
+
+        dataSource = std::make_unique<MBTilesDataSource>(platform, "bench", mbtiles_file, "",
+                                                         false, false, state.range(0));
+    }
+};
+
+// The same tiles, converted from the MBTiles file
+class TileArchiveFixture : public ViewportFixture {
+public:
+    void SetUp(const ::benchmark::State& state) override {
+        ViewportFixture::SetUp(state);
+
+        if (!TileArchive::fromMBTiles(mbtiles_file, archive_file)) {
+            LOGE("Cannot convert '%s'", mbtiles_file);
+            exit(-1);
+        }
+        dataSource = std::make_unique<TileArchiveDataSource>(platform, archive_file);
+    }
+};
+
+BENCHMARK_DEFINE_F(MBTilesFixture, MBTilesViewportBench)(benchmark::State& st) {
+    while (st.KeepRunning()) {
+        run();
+    }
+    st.SetItemsProcessed(st.iterations() * viewWidth * viewHeight);
+}
+BENCHMARK_REGISTER_F(MBTilesFixture, MBTilesViewportBench)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+BENCHMARK_DEFINE_F(TileArchiveFixture, TileArchiveViewportBench)(benchmark::State& st) {
+    while (st.KeepRunning()) {
+        run();
+    }
+    st.SetItemsProcessed(st.iterations() * viewWidth * viewHeight);
+}
+BENCHMARK_REGISTER_F(TileArchiveFixture, TileArchiveViewportBench)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,98 @@
+#include "benchmark/benchmark.h"
+
+#include "data/formats/mvt.h"
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "log.h"
+#include "mockPlatform.h"
+#include "tile/tileTask.h"
+
+#include <dirent.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Tangram;
+
+const char tile_file[] = "res/tile.mvt";
+
+// Directory of .mvt files to decode in addition to the test tile
+const char tile_corpus_env[] = "TANGRAM_BENCH_TILES";
+
+struct MvtDecodeFixture : public benchmark::Fixture {
+    std::shared_ptr<TileSource> source;
+    std::vector<std::shared_ptr<TileTask>> tasks;
+    size_t bytes = 0;
+
+    void addTile(const std::string& _path) {
+        auto task = source->createTask(TileID(0, 0, 0));
+        auto rawTileData = MockPlatform::getBytesFromFile(_path.c_str());
+        if (rawTileData.empty()) {
+            LOGE("Invalid tile file '%s'", _path.c_str());
+            exit(-1);
+        }
+        bytes += rawTileData.size();
+        static_cast<BinaryTileTask&>(*task).rawTileData = TileBuffer::adopt(std::move(rawTileData));
+        tasks.push_back(task);
+    }
+
+    void SetUp(const ::benchmark::State& state) override {
+        if (!tasks.empty()) { return; }
+
+        source = std::make_shared<TileSource>("test", nullptr);
+        source->setFormat(TileSource::Format::Mvt);
+
+        addTile(tile_file);
+
+        const char* corpus = std::getenv(tile_corpus_env);
+        if (!corpus) { return; }
+
+        DIR* dir = opendir(corpus);
+        if (!dir) {
+            LOGE("Cannot open tile corpus '%s'", corpus);
+            exit(-1);
+        }
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".mvt") == 0) {
+                addTile(std::string(corpus) + "/" + name);
+            }
+        }
+        closedir(dir);
+    }
+};
+
+// Parse layers and properties, geometry stays encoded
+BENCHMARK_DEFINE_F(MvtDecodeFixture, MvtParseLayers)(benchmark::State& st) {
+    while (st.KeepRunning()) {
+        for (auto& task : tasks) {
+            auto tileData = Mvt::parseTile(*task, 0);
+            benchmark::DoNotOptimize(tileData);
+        }
+    }
+    st.SetBytesProcessed(st.iterations() * bytes);
+}
+BENCHMARK_REGISTER_F(MvtDecodeFixture, MvtParseLayers);
+
+// Parse and decode the geometry of all features
+BENCHMARK_DEFINE_F(MvtDecodeFixture, MvtDecodeGeometry)(benchmark::State& st) {
+    while (st.KeepRunning()) {
+        for (auto& task : tasks) {
+            auto tileData = Mvt::parseTile(*task, 0);
+            if (!tileData) {
+                LOGE("Invalid tile");
+                exit(-1);
+            }
+            for (auto& layer : tileData->layers) {
+                for (auto& feature : layer.features) {
+                    tileData->decodeGeometry(feature);
+                }
+            }
+            benchmark::DoNotOptimize(tileData);
+        }
+    }
+    st.SetBytesProcessed(st.iterations() * bytes);
+}
+BENCHMARK_REGISTER_F(MvtDecodeFixture, MvtDecodeGeometry);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+#include "benchmark/benchmark.h"
+
+#include "data/tileSource.h"
+#include "mockPlatform.h"
+#include "tile/tile.h"
+#include "tile/tileManager.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+#include "view/view.h"
+
+#include <cmath>
+#include <memory>
+
+using namespace Tangram;
+
+const int numViews = 256;
+
+// Builds tiles right away, without geometry
+struct BenchTaskQueue : TileTaskQueue {
+    void enqueue(std::shared_ptr<TileTask> task) override {
+        task->setTile(std::make_unique<Tile>(task->tileId(), task->source()->id(),
+                                             task->source()->generation()));
+    }
+};
+
+struct BenchTileSource : TileSource {
+    BenchTileSource(const std::string& _name) : TileSource(_name, nullptr) {
+        m_generateGeometry = true;
+    }
+
+    void loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override {
+        _task->startedLoading();
+        _cb.func(std::move(_task));
+    }
+
+    void cancelLoadingTile(TileTask& _task) override {}
+
+    std::shared_ptr<TileData> parse(const TileTask& _task) const override { return nullptr; }
+
+    void clearData() override {}
+
+    std::shared_ptr<TileTask> createTask(TileID _tileId, int _subTask) override {
+        return std::make_shared<TileTask>(_tileId, shared_from_this(), _subTask);
+    }
+};
+
+class TileManagerFixture : public benchmark::Fixture {
+public:
+    BenchTaskQueue queue;
+    std::unique_ptr<TileManager> tileManager;
+    std::vector<View> views;
+
+    void SetUp(const ::benchmark::State& state) override {
+        tileManager = std::make_unique<TileManager>(std::make_shared<MockPlatform>(), queue);
+
+        std::vector<std::shared_ptr<TileSource>> sources;
+        for (int i = 0; i < state.range(0); i++) {
+            sources.push_back(std::make_shared<BenchTileSource>("source" + std::to_string(i)));
+        }
+        tileManager->setTileSources(sources);
+
+        // Pitched view panning and zooming around a city
+        auto center = MapProjection::lngLatToProjectedMeters({13.4, 52.5});
+        for (int i = 0; i < numViews; i++) {
+            float t = float(i) / numViews;
+            View view(1920, 1080);
+            view.setPosition(center.x + 20000 * std::sin(t * 6.28f), center.y + 10000 * t);
+            view.setZoom(13.f + 3.f * std::sin(t * 3.14f));
+            view.setPitch(0.8f);
+            view.update();
+            views.push_back(view);
+        }
+    }
+
+    void TearDown(const ::benchmark::State& state) override {
+        tileManager.reset();
+        views.clear();
+    }
+};
+
+BENCHMARK_DEFINE_F(TileManagerFixture, UpdateTileSetsBench)(benchmark::State& st) {
+    size_t i = 0;
+    while (st.KeepRunning()) {
+        tileManager->updateTileSets(views[i++ % numViews]);
+    }
+}
+BENCHMARK_REGISTER_F(TileManagerFixture, UpdateTileSetsBench)->Arg(1)->Arg(5);
+
+BENCHMARK_MAIN();
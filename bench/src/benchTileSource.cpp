@@ -26,7 +26,7 @@ struct TileSourceFixture : public benchmark::Fixture {
 
         auto rawTileData = MockPlatform::getBytesFromFile(tile_file);
         auto& t = dynamic_cast<BinaryTileTask&>(*tileTask);
-        t.rawTileData = std::make_shared<std::vector<char>>(rawTileData);
+        t.rawTileData = TileBuffer::adopt(std::move(rawTileData));
     }
     void TearDown(const ::benchmark::State& state) override {
     }
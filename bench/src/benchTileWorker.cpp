@@ -0,0 +1,116 @@
+#include "benchmark/benchmark.h"
+
+#include "data/tileSource.h"
+#include "mockPlatform.h"
+#include "scene/scene.h"
+#include "tile/tileBuilder.h"
+#include "tile/tileTask.h"
+#include "tile/tileWorker.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+
+using namespace Tangram;
+
+const int numTasks = 2048;
+
+struct Counter {
+    std::atomic<int> pending{0};
+    std::condition_variable done;
+    std::mutex mutex;
+
+    void decrement() {
+        if (--pending == 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_one();
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]{ return pending == 0; });
+    }
+};
+
+// Counts processed tasks, TileSource and TileBuilder are not used.
+struct BenchTask : public TileTask {
+    BenchTask(TileID& _tileId, std::shared_ptr<TileSource> _source, Counter& _counter)
+        : TileTask(_tileId, _source, -1), counter(_counter) {}
+
+    void parse() override {
+        m_parsed = true;
+    }
+
+    void process(TileBuilder& _tileBuilder) override {
+        counter.decrement();
+    }
+
+    Counter& counter;
+};
+
+class TileWorkerFixture : public benchmark::Fixture {
+public:
+    std::shared_ptr<MockPlatform> platform;
+    std::shared_ptr<TileSource> source;
+    std::unique_ptr<TileWorker> worker;
+    std::vector<std::shared_ptr<TileTask>> tasks;
+
+    Counter counter;
+
+    void SetUp(const ::benchmark::State& state) override {
+        platform = std::make_shared<MockPlatform>();
+        source = std::make_shared<TileSource>("bench", nullptr);
+
+        auto scene = std::make_shared<Scene>();
+        worker = std::make_unique<TileWorker>(platform, state.range(0), 1);
+        worker->setScene(scene);
+    }
+
+    void TearDown(const ::benchmark::State& state) override {
+        worker->stop();
+        worker.reset();
+        tasks.clear();
+    }
+
+    void createTasks() {
+        tasks.clear();
+        for (int i = 0; i < numTasks; i++) {
+            TileID id(i % 1024, i / 1024, 10);
+            tasks.push_back(std::make_shared<BenchTask>(id, source, counter));
+        }
+    }
+
+    __attribute__ ((noinline)) void run(std::mt19937& rng) {
+        counter.pending = numTasks;
+
+        for (auto& task : tasks) {
+            task->setPriority(rng() % 10000);
+            worker->enqueue(task);
+        }
+
+        // Reprioritize queued tasks like TileManager does on every frame
+        for (size_t i = 0; i < tasks.size(); i += 2) {
+            tasks[i]->setPriority(rng() % 10000);
+        }
+
+        counter.wait();
+    }
+};
+
+BENCHMARK_DEFINE_F(TileWorkerFixture, TileWorkerBench)(benchmark::State& st) {
+    std::mt19937 rng(0);
+
+    while (st.KeepRunning()) {
+        st.PauseTiming();
+        createTasks();
+        st.ResumeTiming();
+
+        run(rng);
+    }
+    st.SetItemsProcessed(st.iterations() * numTasks);
+}
+BENCHMARK_REGISTER_F(TileWorkerFixture, TileWorkerBench)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,138 @@
+#include "benchmark/benchmark.h"
+
+#include "data/formats/topoJson.h"
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "log.h"
+#include "tile/tileTask.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Tangram;
+
+// Number of districts along each side of the generated region
+const int grid_size = 64;
+// Districts along each side of a state
+const int state_size = 8;
+// Points of each border arc
+const int arc_points = 32;
+// Quantized size of a district
+const int cell_size = 1000;
+
+// Writes a quantized topology of administrative boundaries: a grid of
+// district polygons that share their borders, and the borders between
+// states as lines that reuse the arcs of the districts
+static std::string generateTopology() {
+    int n = grid_size;
+
+    // Arcs from column c to c + 1 along row r, then from row r to r + 1 along column c
+    auto horizontal = [&](int r, int c) { return r * n + c; };
+    auto vertical = [&](int r, int c) { return (n + 1) * n + r * (n + 1) + c; };
+
+    std::string json = R"({"type":"Topology","transform":{"scale":[)" +
+        std::to_string(20.0 / (n * cell_size)) + "," + std::to_string(20.0 / (n * cell_size)) +
+        R"(],"translate":[-10,-10]},"arcs":[)";
+
+    // Borders wiggle perpendicular to their direction, ends stay on the grid
+    auto writeArc = [&](int x, int y, int dx, int dy, int seed) {
+        json += "[";
+        int px = x, py = y;
+        for (int i = 0; i < arc_points; i++) {
+            int t = i * cell_size / (arc_points - 1);
+            int offset = (i == 0 || i == arc_points - 1) ? 0 : (seed * 31 + i * 7919) % 41 - 20;
+            int qx = x + dx * t + dy * offset;
+            int qy = y + dy * t + dx * offset;
+            if (i > 0) { json += ","; }
+            json += "[" + std::to_string(qx - px) + "," + std::to_string(qy - py) + "]";
+            px = qx;
+            py = qy;
+        }
+        json += "]";
+    };
+
+    bool first = true;
+    for (int r = 0; r <= n; r++) {
+        for (int c = 0; c < n; c++) {
+            if (!first) { json += ","; }
+            first = false;
+            writeArc(c * cell_size, r * cell_size, 1, 0, horizontal(r, c));
+        }
+    }
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c <= n; c++) {
+            json += ",";
+            writeArc(c * cell_size, r * cell_size, 0, 1, vertical(r, c));
+        }
+    }
+
+    json += R"(],"objects":{"districts":{"type":"GeometryCollection","geometries":[)";
+
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) {
+            if (r > 0 || c > 0) { json += ","; }
+            int state = (r / state_size) * (n / state_size) + c / state_size;
+            json += R"({"type":"Polygon","properties":{"kind":"district","state":)" + std::to_string(state) +
+                R"(,"name":"district )" + std::to_string(r * n + c) + R"("},"arcs":[[)" +
+                std::to_string(horizontal(r, c)) + "," +
+                std::to_string(vertical(r, c + 1)) + "," +
+                std::to_string(~horizontal(r + 1, c)) + "," +
+                std::to_string(~vertical(r, c)) + "]]}";
+        }
+    }
+
+    json += R"(]},"borders":{"type":"GeometryCollection","geometries":[)";
+
+    first = true;
+    for (int i = state_size; i < n; i += state_size) {
+        std::string row, column;
+        for (int j = 0; j < n; j++) {
+            if (j > 0) { row += ","; column += ","; }
+            row += std::to_string(horizontal(i, j));
+            column += std::to_string(vertical(j, i));
+        }
+        if (!first) { json += ","; }
+        first = false;
+        json += R"({"type":"LineString","properties":{"kind":"state"},"arcs":[)" + row + "]},";
+        json += R"({"type":"LineString","properties":{"kind":"state"},"arcs":[)" + column + "]}";
+    }
+
+    json += "]}}}";
+    return json;
+}
+
+struct TopoJsonParseFixture : public benchmark::Fixture {
+    std::shared_ptr<TileSource> source;
+    std::shared_ptr<TileTask> task;
+    size_t bytes = 0;
+
+    void SetUp(const ::benchmark::State& state) override {
+        if (task) { return; }
+
+        source = std::make_shared<TileSource>("test", nullptr);
+        source->setFormat(TileSource::Format::TopoJson);
+
+        std::string json = generateTopology();
+        bytes = json.size();
+
+        task = source->createTask(TileID(0, 0, 0));
+        static_cast<BinaryTileTask&>(*task).rawTileData = TileBuffer::copy(json.data(), json.size());
+    }
+};
+
+// Parse the districts and state borders of the generated topology
+BENCHMARK_DEFINE_F(TopoJsonParseFixture, TopoJsonParseBoundaries)(benchmark::State& st) {
+    while (st.KeepRunning()) {
+        auto tileData = TopoJson::parseTile(*task, 0);
+        if (!tileData || tileData->layers.size() != 2) {
+            LOGE("Invalid tile");
+            exit(-1);
+        }
+        benchmark::DoNotOptimize(tileData);
+    }
+    st.SetBytesProcessed(st.iterations() * bytes);
+}
+BENCHMARK_REGISTER_F(TopoJsonParseFixture, TopoJsonParseBoundaries);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "tile/tileID.h"
+#include "util/types.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Tangram {
+
+class Platform;
+class TileSource;
+struct OfflineDownloadState;
+
+/* Area and zoom range of tiles to store for offline use */
+struct OfflineRegion {
+
+    // Outline of the region, in longitude and latitude
+    std::vector<LngLat> polygon;
+
+    int32_t minZoom = 0;
+    int32_t maxZoom = 0;
+
+    OfflineRegion(std::vector<LngLat> _polygon, int32_t _minZoom, int32_t _maxZoom)
+        : polygon(std::move(_polygon)), minZoom(_minZoom), maxZoom(_maxZoom) {}
+
+    static OfflineRegion fromBounds(LngLat _southWest, LngLat _northEast,
+                                    int32_t _minZoom, int32_t _maxZoom);
+
+    /* IDs of the tiles intersecting the region, by increasing zoom */
+    std::vector<TileID> tileIDs() const;
+};
+
+/* Loads all tiles of an OfflineRegion through the DataSource chain of a TileSource
+ *
+ * Tiles are requested with a bounded number of concurrent requests from a
+ * background thread. No GL context is needed, so that regions can be packaged
+ * headless, e.g. in a build job.
+ *
+ * With an MBTiles DataSource in cache mode at the head of the chain (see
+ * createSource()) the downloaded tiles are stored in the MBTiles file. Tiles
+ * found in the file are not downloaded again, so that starting a canceled or
+ * interrupted download for the same file resumes it.
+ */
+class OfflineDownload {
+
+public:
+
+    struct Progress {
+        // Tiles of the region
+        size_t total = 0;
+        // Tiles loaded, from the store or downloaded
+        size_t completed = 0;
+        // Tiles which could not be loaded
+        size_t failed = 0;
+
+        bool done = false;
+        bool canceled = false;
+    };
+
+    using ProgressCallback = std::function<void(const Progress&)>;
+
+    /* @_maxRequests: maximum number of tiles requested at once */
+    OfflineDownload(std::shared_ptr<TileSource> _source, OfflineRegion _region,
+                    size_t _maxRequests = 8);
+
+    /* Cancels a running download */
+    ~OfflineDownload();
+
+    /* Request the tiles of the region. @_callback is called from the
+     * download thread whenever tiles were loaded. */
+    void start(ProgressCallback _callback = nullptr);
+
+    /* Stop requesting tiles and cancel the running requests */
+    void cancel();
+
+    /* Wait until all tiles were loaded or the download was canceled.
+     * Returns true when all tiles were loaded. */
+    bool wait();
+
+    Progress progress() const;
+
+    /* TileSource that stores the tiles from @_urlTemplate in the MBTiles file
+     * at @_mbtilesPath. Stored tiles are committed to the file at the latest
+     * when the TileSource is destroyed. Returns nullptr when MBTiles support
+     * is disabled. */
+    static std::shared_ptr<TileSource> createSource(std::shared_ptr<Platform> _platform,
+                                                    const std::string& _name,
+                                                    const std::string& _urlTemplate,
+                                                    const std::string& _mbtilesPath,
+                                                    std::vector<std::string> _subdomains = {},
+                                                    bool _isTms = false);
+
+private:
+
+    void run(ProgressCallback _callback);
+
+    std::shared_ptr<TileSource> m_source;
+    std::vector<TileID> m_tiles;
+    size_t m_maxRequests;
+
+    // Shared with the callbacks of running requests
+    std::shared_ptr<OfflineDownloadState> m_state;
+
+    std::thread m_thread;
+};
+
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "data/propertyKey.h"
+
+#include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -7,10 +11,17 @@ namespace Tangram {
 
 class Value;
 struct PropertyItem;
+using PropertyValues = std::deque<Value>;
 
 // Helper to cleanup double string values from trailing 0s
 std::string doubleToString(double _doubleValue);
 
+/* Feature properties, sorted by PropertyKey
+ *
+ * The values are shared with copies of the Properties and, for features of
+ * tile data, with the other features of their Layer. Setting a value copies
+ * shared values first.
+ */
 struct Properties {
     using Item = PropertyItem;
 
@@ -19,17 +30,18 @@ struct Properties {
 
     Properties(const Properties& _other) = default;
     Properties(Properties&& _other) = default;
-    Properties(std::vector<Item>&& _items);
     Properties& operator=(const Properties& _other) = default;
     Properties& operator=(Properties&& _other);
 
     const Value& get(const std::string& key) const;
+    const Value& get(PropertyKey key) const;
 
     void sort();
 
     void clear();
 
     bool contains(const std::string& key) const;
+    bool contains(PropertyKey key) const;
 
     bool getNumber(const std::string& key, double& value) const;
 
@@ -50,26 +62,18 @@ struct Properties {
     void set(std::string key, std::string value);
     void set(std::string key, double value);
 
-    void setSorted(std::vector<Item>&& _items);
-
-    // template <typename... Args> void set(std::string key, Args&&... args) {
-    //     props.emplace_back(std::move(key), Value{std::forward<Args>(args)...});
-    //     sort();
-    // }
+    /* Set the items, sorted by key, which refer to values in @_values */
+    void setSorted(std::vector<Item>&& _items, std::shared_ptr<PropertyValues> _values);
 
     const std::vector<Item>& items() const { return props; }
 
     int32_t sourceId;
 
-    static bool keyComparator(const std::string& a, const std::string& b) {
-        if (a.size() == b.size()) {
-            return a < b;
-        } else {
-            return a.size() < b.size();
-        }
-    }
 private:
+    void set(PropertyKey key, Value value);
+
     std::vector<Item> props;
+    std::shared_ptr<PropertyValues> values;
 };
 
 }
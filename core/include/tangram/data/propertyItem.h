@@ -1,19 +1,26 @@
 #pragma once
 
+#include "data/propertyKey.h"
 #include "util/variant.h"
 
+#include <deque>
+
 namespace Tangram {
 
+/* Values of feature properties, shared by the Properties that refer to them.
+ * References to the values stay valid when values are added. */
+using PropertyValues = std::deque<Value>;
+
 struct PropertyItem {
-    PropertyItem(std::string _key, Value _value) :
-        key(std::move(_key)), value(std::move(_value)) {}
+    PropertyItem(PropertyKey _key, const Value* _value) :
+        key(_key), value(_value) {}
+
+    PropertyKey key;
+    // Points into the PropertyValues of the Properties
+    const Value* value;
 
-    std::string key;
-    Value value;
     bool operator<(const PropertyItem& _rhs) const {
-        return key.size() == _rhs.key.size()
-            ? key < _rhs.key
-            : key.size() < _rhs.key.size();
+        return key < _rhs.key;
     }
 };
 
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Tangram {
+
+/* Interned name of a feature property
+ *
+ * Names are added to a table that is shared by all scenes and threads, so that
+ * properties can be compared and looked up by a small integer id. Keys are
+ * found without locking, the table grows with the names that are added.
+ */
+class PropertyKey {
+
+public:
+
+    PropertyKey() {}
+
+    /* Key of @_name, added to the table when it is new */
+    static PropertyKey intern(const std::string& _name);
+
+    /* Key of @_name, invalid when no property of that name was interned */
+    static PropertyKey find(const std::string& _name);
+
+    const std::string& name() const;
+
+    /* Number of interned names */
+    static uint32_t count();
+
+    uint32_t id() const { return m_id; }
+
+    bool isValid() const { return m_id != 0; }
+
+    bool operator==(const PropertyKey& _rhs) const { return m_id == _rhs.m_id; }
+    bool operator!=(const PropertyKey& _rhs) const { return m_id != _rhs.m_id; }
+    bool operator<(const PropertyKey& _rhs) const { return m_id < _rhs.m_id; }
+
+private:
+
+    explicit PropertyKey(uint32_t _id) : m_id(_id) {}
+
+    uint32_t m_id = 0;
+};
+
+}
@@ -2,6 +2,7 @@
 
 #include "tile/tileTask.h"
 
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -15,6 +16,7 @@ struct Raster;
 class Tile;
 class TileManager;
 struct RawCache;
+struct SharedTileData;
 class Texture;
 
 class TileSource : public std::enable_shared_from_this<TileSource> {
@@ -62,12 +64,33 @@ public:
 
         virtual void clear() { if (next) next->clear(); }
 
+        /* Identifies the data of this and the next DataSources, e.g. by file
+         * and modification time, or by URL for network sources. Empty when the
+         * data may change between sessions without notice. */
+        virtual std::string dataVersion() const { return ""; }
+
+        /* Time after which data of the same version may have changed, e.g. for
+         * network sources which cannot check whether their data changed. Zero
+         * when data of the same version does not change. */
+        virtual std::chrono::seconds maxAge() const {
+            return next ? next->maxAge() : std::chrono::seconds(0);
+        }
+
         void setNext(std::unique_ptr<DataSource> _next) {
             next = std::move(_next);
             next->level = level + 1;
         }
         std::unique_ptr<DataSource> next;
         int level = 0;
+
+    protected:
+        /* @_version followed by the version of the next DataSources, which may
+         * provide tiles missing in this one. Empty when any of them is unversioned. */
+        std::string chainVersion(const std::string& _version) const;
+
+        /* Path, size and modification time of the file at @_path, empty for
+         * assets and missing files */
+        static std::string fileVersion(const std::string& _path);
     };
 
     enum class Format {
@@ -105,6 +128,20 @@ public:
     /* Parse a <TileTask> with data into a <TileData>, returning an empty TileData on failure */
     virtual std::shared_ptr<TileData> parse(const TileTask& _task) const;
 
+    /* Parse a <TileTask> or share the <TileData> that is still in use by another task
+     * for the same source tile. Overzoomed tiles at different styling zooms map onto
+     * one source tile and are parsed only once. */
+    std::shared_ptr<TileData> parseTileData(const TileTask& _task);
+
+    struct ParseStats {
+        // Number of parsed tiles
+        uint64_t parsed = 0;
+        // Number of tasks that shared the TileData of another task
+        uint64_t shared = 0;
+    };
+
+    ParseStats parseStats() const;
+
     /* Clears all data associated with this TileSource */
     virtual void clearData();
 
@@ -137,9 +174,29 @@ public:
     bool generateGeometry() const { return m_generateGeometry; }
     void generateGeometry(bool generateGeometry) { m_generateGeometry = generateGeometry; }
 
+    /* Collections of the tile data that are used by Scene layers. Parsers can
+     * skip other collections. Empty when all collections are used. */
+    const std::vector<std::string>& collections() const { return m_collections; }
+    void addCollections(const std::vector<std::string>& _collections);
+
+    /* Share parsed TileData between tasks for the same source tile (default: true) */
+    bool shareTileData() const;
+    void shareTileData(bool _share);
+
     /* Avoid RTTI by adding a boolean check on the data source object */
     virtual bool isRaster() const { return false; }
 
+    /* Whether tiles are loaded from DataSources rather than created from client data */
+    bool hasDataSource() const { return bool(m_sources); }
+
+    /* Version of the data of the DataSources (see DataSource::dataVersion) */
+    std::string dataVersion() const { return m_sources ? m_sources->dataVersion() : ""; }
+
+    /* Maximum age of data of the same version (see DataSource::maxAge) */
+    std::chrono::seconds dataMaxAge() const {
+        return m_sources ? m_sources->maxAge() : std::chrono::seconds(0);
+    }
+
     void setFormat(Format format) { m_format = format; }
 
 protected:
@@ -150,6 +207,9 @@ protected:
     // Is set true for any source assigned in a Scene Layer and when the layer is not disabled
     bool m_generateGeometry = false;
 
+    // Sorted names of the collections used by Scene layers
+    std::vector<std::string> m_collections;
+
     // Name used to identify this source in the style sheet
     std::string m_name;
 
@@ -168,6 +228,9 @@ protected:
     std::vector<std::shared_ptr<TileSource>> m_rasterSources;
 
     std::unique_ptr<DataSource> m_sources;
+
+    // TileData in use by tasks and tiles, by source tile
+    std::unique_ptr<SharedTileData> m_sharedTileData;
 };
 
 }
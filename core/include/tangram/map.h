@@ -112,6 +112,18 @@ struct EdgePadding {
         : left(left), top(top), right(right), bottom(bottom) {}
 };
 
+struct TileCacheStats {
+    // Cached tiles that were shown again, or not found when needed
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // Tiles dropped to stay within the cache size
+    uint64_t evictions = 0;
+    // Number of cached tiles and their memory usage in bytes
+    size_t entries = 0;
+    size_t usage = 0;
+    size_t maxUsage = 0;
+};
+
 struct CameraUpdate {
     enum Flags {
         SET_LNGLAT =      1 << 0,
@@ -392,6 +404,33 @@ public:
     // Set the radius in logical pixels to use when picking features on the map (default is 0.5).
     void setPickRadius(float _radius);
 
+    // Set how tiles are prefetched during camera animations and flings: Tiles of the view predicted
+    // _lookahead seconds ahead are loaded with lower priority than visible tiles. At most _maxTiles
+    // prefetched tiles are loading and at most _maxBytes of prefetched tiles wait in the tile cache
+    // to become visible. A _lookahead of 0 disables prefetching (default is 0.5s, 16 tiles, 8MB).
+    void setTilePrefetch(float _lookahead, uint32_t _maxTiles, size_t _maxBytes);
+
+    // Set how much work is spent per frame on newly loaded tiles: Ready tiles are completed for at
+    // most _completeTime milliseconds and at most _uploadBytes of their meshes are uploaded to the
+    // GPU, closest to the view center first. Remaining tiles are deferred to the next frames while
+    // their proxy tiles stay visible. A value of 0 disables the limit (default is 4ms, 4MB).
+    void setTileFrameBudget(float _completeTime, size_t _uploadBytes);
+
+    // Set the number of threads that decode tile data before the tiles are built on the two build
+    // threads. With 0 the tile data is decoded on the build threads (default is 2).
+    void setTileParseWorkers(uint32_t _count);
+
+    // Set a directory to store built tile geometry, so that tiles of the same scene and data are
+    // restored instead of loaded and built again, also after a restart. The directory must exist.
+    // Only tiles of MBTiles and tile archive files are cached. Labels are built again from the tile
+    // data. The least recently used tiles are removed when the files exceed _maxSize bytes (default
+    // 128MB). An empty _path disables the cache (disabled by default).
+    void setTileGeometryCache(const std::string& _path, size_t _maxSize = 128*1024*1024);
+
+    // Get the hit, miss and eviction counts and the memory usage of the cache for tiles that left
+    // the view
+    TileCacheStats getTileCacheStats();
+
     // Create a query to select a feature marked as 'interactive'. The query runs on the next frame.
     // Calls _onFeaturePickCallback once the query has completed, and returns the FeaturePickResult
     // with its associated properties or null if no feature was found.
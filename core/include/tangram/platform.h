@@ -2,6 +2,7 @@
 
 #include "util/url.h"
 
+#include <chrono>
 #include <functional>
 #include <string>
 #include <vector>
@@ -21,11 +22,22 @@ using UrlRequestHandle = uint64_t;
 struct UrlResponse {
     std::vector<char> content;
     const char* error = nullptr;
+    // HTTP status code of the response, 0 when unknown or when no response was received.
+    int httpStatus = 0;
+    // Whether the request failed because it took too long.
+    bool timedOut = false;
+    // Time when the transfer started, after the request waited for the platform to start it.
+    // Default-constructed when the platform does not report it.
+    std::chrono::steady_clock::time_point transferStart;
 };
 
 // Function type for receiving data from a URL request.
 using UrlCallback = std::function<void(UrlResponse&&)>;
 
+// Priority of a URL request, requests with lower values are started first.
+// It may be called again while the request waits to be started.
+using UrlRequestPriority = std::function<double()>;
+
 using FontSourceLoader = std::function<std::vector<char>()>;
 
 struct FontSourceHandle {
@@ -76,6 +88,12 @@ public:
     // thread than the original call to startUrlRequest.
     virtual UrlRequestHandle startUrlRequest(Url _url, UrlCallback _callback) = 0;
 
+    // Start a URL request like startUrlRequest. Platforms that queue requests
+    // can start them in the order of _priority. By default the priority is
+    // ignored.
+    virtual UrlRequestHandle startUrlRequestWithPriority(Url _url, UrlCallback _callback,
+                                                         UrlRequestPriority _priority);
+
     // Stop retrieving data from a URL that was previously requested. When a
     // request is canceled its callback will still be run, but the response
     // will have an error string and the data may not be complete.
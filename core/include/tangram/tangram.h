@@ -10,6 +10,7 @@
 #define TANGRAM_VERSION_PATCH 1
 
 #include "data/clientGeoJsonSource.h"
+#include "data/offlineRegion.h"
 #include "data/properties.h"
 #include "data/propertyItem.h"
 #include "data/tileSource.h"
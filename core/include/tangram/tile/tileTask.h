@@ -2,6 +2,7 @@
 
 #include "tile/tileID.h"
 #include "platform.h" // UrlRequestHandle
+#include "util/tileBuffer.h"
 
 #include <atomic>
 #include <functional>
@@ -14,6 +15,7 @@ class TileManager;
 class TileBuilder;
 class TileSource;
 class Tile;
+class TileTaskHeap;
 class MapProjection;
 struct TileData;
 
@@ -22,7 +24,7 @@ class TileTask {
 
 public:
 
-    TileTask(TileID& _tileId, std::shared_ptr<TileSource> _source, int _subTask);
+    TileTask(const TileID& _tileId, std::shared_ptr<TileSource> _source, int _subTask);
 
     // No copies
     TileTask(const TileTask& _other) = delete;
@@ -49,7 +51,7 @@ public:
 
     TileID tileId() const { return m_tileId; }
 
-    void cancel() { m_canceled = true; }
+    void cancel();
     bool isCanceled() const { return m_canceled; }
 
     double getPriority() const {
@@ -57,16 +59,40 @@ public:
     }
 
     void setPriority(double _priority) {
-        m_priority.store(_priority);
+        float priority = _priority;
+        if (m_priority.exchange(priority) != priority) {
+            updateQueuePosition();
+        }
     }
 
-    void setProxyState(bool isProxy) { m_proxyState = isProxy; }
+    void setProxyState(bool isProxy) {
+        if (m_proxyState.exchange(isProxy) != isProxy) {
+            updateQueuePosition();
+        }
+    }
     bool isProxy() const { return m_proxyState; }
 
+    // Prefetch tasks load tiles of a predicted view. They are processed
+    // after all other tasks.
+    void setPrefetch(bool _prefetch) {
+        if (m_prefetch.exchange(_prefetch) != _prefetch) {
+            updateQueuePosition();
+        }
+    }
+    bool isPrefetch() const { return m_prefetch; }
+
     auto& subTasks() { return m_subTasks; }
     int subTaskId() const { return m_subTaskId; }
     bool isSubTask() const { return m_subTaskId >= 0; }
 
+    // running on parse worker thread: decode raw data into TileData
+    virtual void parse();
+    bool isParsed() const { return m_parsed; }
+
+    // Time in microseconds spent in parse()
+    uint64_t parseTime() const { return m_parseTime; }
+    void setParseTime(uint64_t _parseTime) { m_parseTime = _parseTime; }
+
     // running on worker thread
     virtual void process(TileBuilder& _tileBuilder);
 
@@ -87,8 +113,21 @@ public:
 
     void startedLoading() { m_needsLoading = false; }
 
+    /* Restore the tile from the GeometryCache instead of loading and parsing
+     * its data. Set by TileManager before loading. */
+    void setCachedGeometry() {
+        m_cachedGeometry = true;
+        m_parsed = true;
+    }
+    bool hasCachedGeometry() const { return m_cachedGeometry; }
+
 protected:
 
+    friend class TileTaskHeap;
+
+    // Restore order of the worker queue holding this task
+    void updateQueuePosition();
+
     const TileID m_tileId;
 
     const int m_subTaskId;
@@ -102,6 +141,14 @@ protected:
     const int64_t m_sourceId;
     const int64_t m_sourceGeneration;
 
+    // Parsed tile data, passed from parse to build stage
+    std::shared_ptr<TileData> m_tileData;
+    bool m_parsed = false;
+    uint64_t m_parseTime = 0;
+
+    // Tile meshes are restored from the GeometryCache
+    bool m_cachedGeometry = false;
+
     // Tile result, set when tile was  sucessfully created
     std::unique_ptr<Tile> m_tile;
 
@@ -111,6 +158,12 @@ protected:
 
     std::atomic<float> m_priority;
     std::atomic<bool> m_proxyState;
+    std::atomic<bool> m_prefetch;
+
+    // Queue holding this task while it waits for a TileWorker and the
+    // task's position in that queue. Both are managed by TileTaskHeap.
+    std::atomic<TileTaskHeap*> m_heap;
+    size_t m_heapIndex = 0;
 };
 
 class BinaryTileTask : public TileTask {
@@ -119,10 +172,10 @@ public:
         : TileTask(_tileId, _source, _subTask) {}
 
     virtual bool hasData() const override {
-        return rawTileData && !rawTileData->empty();
+        return m_cachedGeometry || (rawTileData && !rawTileData->empty());
     }
     // Raw tile data that will be processed by TileSource.
-    std::shared_ptr<std::vector<char>> rawTileData;
+    std::shared_ptr<TileBuffer> rawTileData;
 
     bool dataFromCache = false;
     bool urlRequestStarted = false;
@@ -130,6 +183,26 @@ public:
     UrlRequestHandle urlRequestHandle = 0;
 };
 
+/* Rebuilds the meshes of some styles of an existing Tile from its TileData,
+ * e.g. after a Scene update changed only these styles. The meshes of all
+ * other styles are taken over from the existing Tile on completion.
+ */
+class RestyleTileTask : public TileTask {
+public:
+    RestyleTileTask(std::shared_ptr<Tile> _tile, std::shared_ptr<TileSource> _source,
+                    std::shared_ptr<const std::vector<bool>> _styles);
+
+    virtual void process(TileBuilder& _tileBuilder) override;
+
+    virtual void complete() override;
+
+protected:
+    std::shared_ptr<Tile> m_baseTile;
+
+    // Styles to rebuild, indexed by Style ID
+    std::shared_ptr<const std::vector<bool>> m_styles;
+};
+
 struct TileTaskQueue {
     virtual void enqueue(std::shared_ptr<TileTask> task) = 0;
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+/* Ref-counted bytes of a raw tile
+ *
+ * Owned buffers use blocks from a pool of power-of-two size classes, which
+ * are returned to the pool when the buffer is released. Buffers can also take
+ * over a vector, or refer to memory that is owned by another object, e.g. a
+ * memory-mapped file, without copying.
+ */
+class TileBuffer {
+
+public:
+
+    /* Owned buffer of @_size bytes */
+    static std::shared_ptr<TileBuffer> create(size_t _size = 0);
+
+    /* Owned buffer with a copy of @_size bytes at @_data */
+    static std::shared_ptr<TileBuffer> copy(const char* _data, size_t _size);
+
+    /* Buffer with the contents of @_data */
+    static std::shared_ptr<TileBuffer> adopt(std::vector<char>&& _data);
+
+    /* Buffer referring to @_size bytes at @_data, which stay valid as long
+     * as @_owner is alive */
+    static std::shared_ptr<TileBuffer> view(const char* _data, size_t _size,
+                                            std::shared_ptr<const void> _owner);
+
+    TileBuffer(const TileBuffer&) = delete;
+    TileBuffer& operator=(const TileBuffer&) = delete;
+
+    ~TileBuffer();
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /* Writable bytes of owned buffers, nullptr for views and adopted vectors */
+    char* mutableData() { return m_block; }
+
+    size_t capacity() const { return m_capacity; }
+
+    /* Make room for @_capacity bytes in an owned buffer, keeping its contents */
+    void reserve(size_t _capacity);
+
+    /* Resize an owned buffer, keeping its contents */
+    void resize(size_t _size);
+
+    struct PoolStats {
+        // Blocks taken from the pool or newly allocated
+        uint64_t reused = 0;
+        uint64_t allocated = 0;
+        // Bytes of the blocks waiting in the pool
+        size_t pooledBytes = 0;
+    };
+
+    static PoolStats poolStats();
+
+private:
+
+    TileBuffer() {}
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+
+    // Pooled block of owned buffers
+    char* m_block = nullptr;
+    size_t m_capacity = 0;
+
+    std::vector<char> m_vector;
+    std::shared_ptr<const void> m_owner;
+};
+
+}
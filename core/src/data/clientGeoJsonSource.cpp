@@ -281,41 +281,48 @@ struct add_geometry {
         return { pt.x / extent, 1. - pt.y / extent };
     }
 
+    // Add the points of a line or ring, skipping repeated points
+    template <typename Points>
+    void addRing(const Points& points) {
+        Point last;
+        bool first = true;
+        for (const auto& p : points) {
+            auto tp = transformPoint(p);
+            if (!first && tp == last) { continue; }
+            arena.addPoint(tp);
+            last = tp;
+            first = false;
+        }
+        arena.endRing();
+    }
+
     Feature& feature;
+    GeometryArena& arena;
 
     bool operator()(const geometry::point<int16_t>& p) {
         feature.geometryType = GeometryType::points;
-        feature.points.push_back(transformPoint(p));
+        arena.addPoint(transformPoint(p));
+        arena.endRing();
         return true;
     }
     bool operator()(const geometry::line_string<int16_t>& geom) {
         feature.geometryType = GeometryType::lines;
-        feature.lines.emplace_back();
-        Line& line = feature.lines.back();
-        for (const auto& p : geom) {
-            auto tp = transformPoint(p);
-            if (line.size() > 0 && tp == line.back()) { continue; }
-            line.push_back(tp);
-        }
+        addRing(geom);
         return true;
     }
     bool operator()(const geometry::polygon<int16_t>& geom) {
         feature.geometryType = GeometryType::polygons;
-        feature.polygons.emplace_back();
         for (const auto& ring : geom) {
-            feature.polygons.back().emplace_back();
-            Line& line = feature.polygons.back().back();
-            for (const auto& p : ring) {
-                auto tp = transformPoint(p);
-                if (line.size() > 0 && tp == line.back()) { continue; }
-                line.push_back(tp);
-            }
+            addRing(ring);
         }
+        arena.endPart();
         return true;
     }
 
     bool operator()(const geometry::multi_point<int16_t>& geom) {
-        for (auto& g : geom) { (*this)(g); }
+        feature.geometryType = GeometryType::points;
+        for (auto& g : geom) { arena.addPoint(transformPoint(g)); }
+        arena.endRing();
         return true;
     }
 
@@ -351,7 +358,8 @@ std::shared_ptr<TileData> ClientGeoJsonSource::parse(const TileTask& _task) cons
     for (auto& it : tile.features) {
         Feature feature(m_id);
 
-        if (geometry::geometry<int16_t>::visit(it.geometry, add_geometry{ feature })) {
+        if (geometry::geometry<int16_t>::visit(it.geometry, add_geometry{ feature, data->geometry })) {
+            feature.geometry = data->geometry.endFeature();
             feature.props = m_store->properties[it.id.get<uint64_t>()];
             layer.features.emplace_back(std::move(feature));
         }
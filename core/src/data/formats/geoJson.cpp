@@ -7,9 +7,284 @@
 #include "util/mapProjection.h"
 
 #include "glm/glm.hpp"
+#include "rapidjson/encodedstream.h"
+#include "rapidjson/error/en.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
 
 namespace Tangram {
 
+namespace {
+
+/* Reads the features of a GeoJSON tile from the events of a rapidjson::Reader.
+ *
+ * Only the feature that is being read is kept apart from the TileData: its
+ * points go to the GeometryArena, its properties to the values of its layer.
+ * The members of GeoJSON objects may come in any order, so coordinates are
+ * read by their nesting depth before the geometry type is known. */
+class GeoJsonReader : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, GeoJsonReader> {
+
+public:
+
+    GeoJsonReader(TileData& _tileData, int32_t _sourceId, const TileID& _tileId)
+        : m_tileData(_tileData), m_arena(_tileData.geometry), m_sourceId(_sourceId) {
+
+        BoundingBox tileBounds(MapProjection::tileBounds(_tileId));
+        m_tileOrigin = tileBounds.min;
+        m_tileInverseScale = 1.0 / tileBounds.width();
+    }
+
+    bool StartObject() {
+        Scope parent = m_scopes.empty() ? Scope::none : m_scopes.back();
+
+        if (parent == Scope::none) {
+            m_scopes.push_back(Scope::root);
+        } else if (parent == Scope::root) {
+            // Members of the root object may be named layers
+            m_scopes.push_back(Scope::collection);
+            m_collections.emplace_back(m_key);
+        } else if (parent == Scope::features) {
+            m_scopes.push_back(Scope::feature);
+            m_feature = Feature(m_sourceId);
+            m_geometryType = GeometryType::unknown;
+        } else if (parent == Scope::feature && m_key == "properties") {
+            m_scopes.push_back(Scope::properties);
+        } else if (parent == Scope::feature && m_key == "geometry") {
+            m_scopes.push_back(Scope::geometry);
+        } else {
+            m_scopes.push_back(Scope::skip);
+        }
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        Scope scope = m_scopes.back();
+        m_scopes.pop_back();
+
+        if (scope == Scope::feature) {
+            endFeature();
+        } else if (scope == Scope::root) {
+            endRoot();
+        }
+        return true;
+    }
+
+    bool StartArray() {
+        Scope parent = m_scopes.empty() ? Scope::none : m_scopes.back();
+
+        if ((parent == Scope::root || parent == Scope::collection) && m_key == "features") {
+            if (parent == Scope::root) {
+                m_collections.emplace_back("");
+                m_collections.back().isRoot = true;
+            }
+            m_collection = &m_collections.back();
+            m_collection->layer.values = std::make_shared<PropertyValues>();
+            m_scopes.push_back(Scope::features);
+        } else if (parent == Scope::geometry && m_key == "coordinates") {
+            m_scopes.push_back(Scope::coordinates);
+            m_depth = 1;
+            m_positionDepth = 0;
+            m_numComponents = 0;
+        } else if (parent == Scope::coordinates) {
+            m_scopes.push_back(Scope::coordinates);
+            m_depth++;
+        } else {
+            m_scopes.push_back(Scope::skip);
+        }
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        Scope scope = m_scopes.back();
+        m_scopes.pop_back();
+
+        if (scope == Scope::features) {
+            m_collection->hasFeatures = true;
+            m_collection = nullptr;
+        } else if (scope == Scope::coordinates) {
+            if (m_depth == m_positionDepth) {
+                if (m_numComponents >= 2) {
+                    m_arena.addPoint(project(m_position[0], m_position[1]));
+                }
+                m_numComponents = 0;
+            } else if (m_depth + 1 == m_positionDepth) {
+                // End of a line or ring
+                m_arena.endRing();
+            } else if (m_depth + 2 == m_positionDepth) {
+                // End of a polygon
+                m_arena.endPart();
+            }
+            m_depth--;
+        }
+        return true;
+    }
+
+    bool Key(const char* _str, rapidjson::SizeType _length, bool) {
+        m_key.assign(_str, _length);
+        return true;
+    }
+
+    bool String(const char* _str, rapidjson::SizeType _length, bool) {
+        Scope parent = m_scopes.empty() ? Scope::none : m_scopes.back();
+
+        if (parent == Scope::properties) {
+            addProperty(std::string(_str, _length));
+        } else if (m_key == "type") {
+            if (parent == Scope::geometry) {
+                m_geometryType = geometryType(_str, _length);
+            } else if (parent == Scope::collection) {
+                m_collections.back().isCollection = isFeatureCollection(_str, _length);
+            } else if (parent == Scope::root) {
+                m_rootIsCollection = isFeatureCollection(_str, _length);
+            }
+        }
+        return true;
+    }
+
+    bool Bool(bool _value) { return Double(_value); }
+    bool Int(int _value) { return Double(_value); }
+    bool Uint(unsigned _value) { return Double(_value); }
+    bool Int64(int64_t _value) { return Double(_value); }
+    bool Uint64(uint64_t _value) { return Double(_value); }
+
+    bool Double(double _value) {
+        Scope parent = m_scopes.empty() ? Scope::none : m_scopes.back();
+
+        if (parent == Scope::coordinates) {
+            if (m_positionDepth == 0) { m_positionDepth = m_depth; }
+            if (m_depth == m_positionDepth && m_numComponents < 2) {
+                m_position[m_numComponents] = _value;
+            }
+            m_numComponents++;
+        } else if (parent == Scope::properties) {
+            addProperty(_value);
+        }
+        return true;
+    }
+
+private:
+
+    enum class Scope : uint8_t {
+        none,
+        root,
+        collection,
+        features,
+        feature,
+        properties,
+        geometry,
+        coordinates,
+        skip,
+    };
+
+    struct Collection {
+        Collection(const std::string& _name) : layer(_name) {}
+        Layer layer;
+        bool isRoot = false;
+        bool isCollection = false;
+        bool hasFeatures = false;
+    };
+
+    static bool isFeatureCollection(const char* _str, size_t _length) {
+        return _length == 17 && std::strncmp(_str, "FeatureCollection", _length) == 0;
+    }
+
+    static GeometryType geometryType(const char* _str, size_t _length) {
+        std::string type(_str, _length);
+        if (type == "Point" || type == "MultiPoint") { return GeometryType::points; }
+        if (type == "LineString" || type == "MultiLineString") { return GeometryType::lines; }
+        if (type == "Polygon" || type == "MultiPolygon") { return GeometryType::polygons; }
+        return GeometryType::unknown;
+    }
+
+    Point project(double _longitude, double _latitude) const {
+        ProjectedMeters meters = MapProjection::lngLatToProjectedMeters(LngLat(_longitude, _latitude));
+        return Point {
+            (meters.x - m_tileOrigin.x) * m_tileInverseScale,
+            (meters.y - m_tileOrigin.y) * m_tileInverseScale,
+        };
+    }
+
+    template<typename T>
+    void addProperty(T&& _value) {
+        if (!m_collection) { return; }
+        auto& values = *m_collection->layer.values;
+        values.push_back(std::forward<T>(_value));
+        m_properties.emplace_back(PropertyKey::intern(m_key), &values.back());
+    }
+
+    void endFeature() {
+        // Ends the ring of Point and MultiPoint geometries
+        m_arena.endRing();
+        FeatureGeometry geometry = m_arena.endFeature();
+
+        if (!m_collection) {
+            m_properties.clear();
+            return;
+        }
+
+        // Features of unknown geometry type keep no geometry, as in parseTileDocument
+        if (m_geometryType != GeometryType::unknown) {
+            m_feature.geometryType = m_geometryType;
+            m_feature.geometry = geometry;
+            if (m_geometryType != GeometryType::polygons) {
+                // Nesting of lines is read like that of polygons
+                m_feature.geometry.parts = nullptr;
+                m_feature.geometry.partCount = 0;
+            }
+        }
+
+        std::sort(m_properties.begin(), m_properties.end());
+        m_feature.props.setSorted(std::move(m_properties), m_collection->layer.values);
+        m_properties.clear();
+
+        m_collection->layer.features.push_back(std::move(m_feature));
+    }
+
+    void endRoot() {
+        for (auto& collection : m_collections) {
+            bool isCollection = collection.isRoot ? m_rootIsCollection : collection.isCollection;
+            if (!isCollection || !collection.hasFeatures) { continue; }
+            // A root FeatureCollection is the only layer, otherwise each
+            // FeatureCollection member of the root is a layer
+            if (collection.isRoot == m_rootIsCollection) {
+                m_tileData.layers.push_back(std::move(collection.layer));
+            }
+        }
+        m_collections.clear();
+    }
+
+    TileData& m_tileData;
+    GeometryArena& m_arena;
+    int32_t m_sourceId;
+
+    glm::dvec2 m_tileOrigin;
+    double m_tileInverseScale;
+
+    std::vector<Scope> m_scopes;
+    std::string m_key;
+
+    // Layers being read, std::deque keeps references when adding layers
+    std::deque<Collection> m_collections;
+    Collection* m_collection = nullptr;
+    bool m_rootIsCollection = false;
+
+    Feature m_feature;
+    GeometryType m_geometryType = GeometryType::unknown;
+    std::vector<Properties::Item> m_properties;
+
+    // Nesting depth in the coordinates array and the depth of its positions
+    int m_depth = 0;
+    int m_positionDepth = 0;
+    double m_position[2];
+    int m_numComponents = 0;
+};
+
+}
+
 bool GeoJson::isFeatureCollection(const JsonValue& _in) {
 
     // A FeatureCollection must have a "type" of "FeatureCollection"
@@ -35,23 +310,21 @@ Point GeoJson::getPoint(const JsonValue& _in, const Transform& _proj) {
     return _proj(LngLat(_in[0].GetDouble(), _in[1].GetDouble()));
 }
 
-Line GeoJson::getLine(const JsonValue& _in, const Transform& _proj) {
+void GeoJson::getLine(const JsonValue& _in, const Transform& _proj, GeometryArena& _arena) {
 
-    Line line;
     for (auto itr = _in.Begin(); itr != _in.End(); ++itr) {
-        line.push_back(getPoint(*itr, _proj));
+        _arena.addPoint(getPoint(*itr, _proj));
     }
-    return line;
+    _arena.endRing();
 
 }
 
-Polygon GeoJson::getPolygon(const JsonValue& _in, const Transform& _proj) {
+void GeoJson::getPolygon(const JsonValue& _in, const Transform& _proj, GeometryArena& _arena) {
 
-    Polygon polygon;
     for (auto itr = _in.Begin(); itr != _in.End(); ++itr) {
-        polygon.push_back(getLine(*itr, _proj));
+        getLine(*itr, _proj, _arena);
     }
-    return polygon;
+    _arena.endPart();
 
 }
 
@@ -60,29 +333,35 @@ Properties GeoJson::getProperties(const JsonValue& _in, int32_t _sourceId) {
     std::vector<PropertyItem> items;
     items.reserve(_in.MemberCount());
 
+    auto values = std::make_shared<PropertyValues>();
+
     for (auto it = _in.MemberBegin(); it != _in.MemberEnd(); ++it) {
 
         const auto& name = it->name.GetString();
         const auto& value = it->value;
         if (value.IsNumber()) {
-            items.emplace_back(name, value.GetDouble());
+            values->push_back(value.GetDouble());
         } else if (it->value.IsString()) {
-            items.emplace_back(name, value.GetString());
+            values->push_back(std::string(value.GetString()));
         } else if (it->value.IsBool()) {
-            items.emplace_back(name, double(value.GetBool()));
+            values->push_back(double(value.GetBool()));
+        } else {
+            continue;
         }
+        items.emplace_back(PropertyKey::intern(name), &values->back());
     }
 
     Properties properties;
     properties.sourceId = _sourceId;
-    properties.setSorted(std::move(items));
+    properties.setSorted(std::move(items), std::move(values));
     properties.sort();
 
     return properties;
 
 }
 
-Feature GeoJson::getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId) {
+Feature GeoJson::getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId,
+                            GeometryArena& _arena) {
 
     Feature feature;
 
@@ -100,46 +379,51 @@ Feature GeoJson::getFeature(const JsonValue& _in, const Transform& _proj, int32_
     if (geometryType.compare("Point") == 0) {
 
         feature.geometryType = GeometryType::points;
-        feature.points.push_back(getPoint(coords, _proj));
+        _arena.addPoint(getPoint(coords, _proj));
+        _arena.endRing();
 
     } else if (geometryType.compare("MultiPoint") == 0) {
 
         feature.geometryType = GeometryType::points;
         for (auto pointCoords = coords.Begin(); pointCoords != coords.End(); ++pointCoords) {
-            feature.points.push_back(getPoint(*pointCoords, _proj));
+            _arena.addPoint(getPoint(*pointCoords, _proj));
         }
+        _arena.endRing();
 
     } else if (geometryType.compare("LineString") == 0) {
 
         feature.geometryType = GeometryType::lines;
-        feature.lines.push_back(getLine(coords, _proj));
+        getLine(coords, _proj, _arena);
 
     } else if (geometryType.compare("MultiLineString") == 0) {
 
         feature.geometryType = GeometryType::lines;
         for (auto lineCoords = coords.Begin(); lineCoords != coords.End(); ++lineCoords) {
-            feature.lines.push_back(getLine(*lineCoords, _proj));
+            getLine(*lineCoords, _proj, _arena);
         }
 
     } else if (geometryType.compare("Polygon") == 0) {
 
         feature.geometryType = GeometryType::polygons;
-        feature.polygons.push_back(getPolygon(coords, _proj));
+        getPolygon(coords, _proj, _arena);
 
     } else if (geometryType.compare("MultiPolygon") == 0) {
 
         feature.geometryType = GeometryType::polygons;
         for (auto polyCoords = coords.Begin(); polyCoords != coords.End(); ++polyCoords) {
-            feature.polygons.push_back(getPolygon(*polyCoords, _proj));
+            getPolygon(*polyCoords, _proj, _arena);
         }
 
     }
 
+    feature.geometry = _arena.endFeature();
+
     return feature;
 
 }
 
-Layer GeoJson::getLayer(const JsonValue& _in, const Transform& _proj, int32_t _sourceId) {
+Layer GeoJson::getLayer(const JsonValue& _in, const Transform& _proj, int32_t _sourceId,
+                        GeometryArena& _arena) {
 
     Layer layer("");
 
@@ -151,14 +435,14 @@ Layer GeoJson::getLayer(const JsonValue& _in, const Transform& _proj, int32_t _s
     }
 
     for (auto featureIt = features->value.Begin(); featureIt != features->value.End(); ++featureIt) {
-        layer.features.push_back(getFeature(*featureIt, _proj, _sourceId));
+        layer.features.push_back(getFeature(*featureIt, _proj, _sourceId, _arena));
     }
 
     return layer;
 
 }
 
-std::shared_ptr<TileData> GeoJson::parseTile(const TileTask& _task, int32_t _sourceId) {
+std::shared_ptr<TileData> GeoJson::parseTileDocument(const TileTask& _task, int32_t _sourceId) {
 
     auto& task = static_cast<const BinaryTileTask&>(_task);
 
@@ -188,11 +472,12 @@ std::shared_ptr<TileData> GeoJson::parseTile(const TileTask& _task, int32_t _sou
 
     // Transform JSON data into TileData using GeoJson functions
     if (GeoJson::isFeatureCollection(document)) {
-        tileData->layers.push_back(GeoJson::getLayer(document, projFn, _sourceId));
+        tileData->layers.push_back(GeoJson::getLayer(document, projFn, _sourceId, tileData->geometry));
     } else {
         for (auto layer = document.MemberBegin(); layer != document.MemberEnd(); ++layer) {
             if (GeoJson::isFeatureCollection(layer->value)) {
-                tileData->layers.push_back(GeoJson::getLayer(layer->value, projFn, _sourceId));
+                tileData->layers.push_back(GeoJson::getLayer(layer->value, projFn, _sourceId,
+                                                             tileData->geometry));
                 tileData->layers.back().name = layer->name.GetString();
             }
         }
@@ -205,4 +490,28 @@ std::shared_ptr<TileData> GeoJson::parseTile(const TileTask& _task, int32_t _sou
 
 }
 
+std::shared_ptr<TileData> GeoJson::parseTile(const TileTask& _task, int32_t _sourceId) {
+
+    auto& task = static_cast<const BinaryTileTask&>(_task);
+
+    auto tileData = std::make_shared<TileData>();
+
+    GeoJsonReader handler(*tileData, _sourceId, task.tileId());
+
+    rapidjson::MemoryStream mstream(task.rawTileData->data(), task.rawTileData->size());
+    rapidjson::EncodedInputStream<rapidjson::UTF8<char>, rapidjson::MemoryStream> istream(mstream);
+
+    rapidjson::Reader reader;
+    auto result = reader.Parse(istream, handler);
+
+    if (result.IsError()) {
+        LOGE("Json parsing failed on tile [%s]: %s (%zu)", task.tileId().toString().c_str(),
+             rapidjson::GetParseError_En(result.Code()), result.Offset());
+        return std::make_shared<TileData>();
+    }
+
+    return tileData;
+
+}
+
 }
@@ -18,18 +18,27 @@ bool isFeatureCollection(const JsonValue& _in);
 
 Point getPoint(const JsonValue& _in, const Transform& _proj);
 
-Line getLine(const JsonValue& _in, const Transform& _proj);
+/* Add the line @_in to @_arena */
+void getLine(const JsonValue& _in, const Transform& _proj, GeometryArena& _arena);
 
-Polygon getPolygon(const JsonValue& _in, const Transform& _proj);
+/* Add the rings of polygon @_in to @_arena */
+void getPolygon(const JsonValue& _in, const Transform& _proj, GeometryArena& _arena);
 
 Properties getProperties(const JsonValue& _in, int32_t _sourceId);
 
-Feature getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId);
+Feature getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId,
+                   GeometryArena& _arena);
 
-Layer getLayer(const JsonValue& _in, const Transform& _proj, int32_t _sourceId);
+Layer getLayer(const JsonValue& _in, const Transform& _proj, int32_t _sourceId,
+               GeometryArena& _arena);
 
+/* Parse the tile with a streaming reader that adds each feature to the TileData
+ * as soon as it is read, without building a JSON document */
 std::shared_ptr<TileData> parseTile(const TileTask& _task, int32_t _sourceId);
 
+/* Parse the tile into a JSON document and then read the features from it */
+std::shared_ptr<TileData> parseTileDocument(const TileTask& _task, int32_t _sourceId);
+
 } // namespace GeoJson
 
 } // namespace Tangram
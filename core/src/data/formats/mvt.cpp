@@ -7,7 +7,9 @@
 #include "util/geom.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
+#include <stdexcept>
 
 #define LAYER 3
 
@@ -24,53 +26,107 @@
 
 namespace Tangram {
 
-Mvt::Geometry Mvt::getGeometry(ParserContext& _ctx, protobuf::message _geomIn) {
+void Mvt::decodeVarints(const char* _data, const char* _end, std::vector<uint32_t>& _values) {
 
-    Geometry geometry;
+    auto data = reinterpret_cast<const uint8_t*>(_data);
+    auto end = reinterpret_cast<const uint8_t*>(_end);
+
+    _values.clear();
+    _values.reserve(end - data);
+
+    while (data < end) {
+        // Most geometry integers are small deltas: decode eight single byte
+        // varints at once when no byte of the next word has a continuation bit.
+        if (end - data >= 8) {
+            uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            if ((word & 0x8080808080808080ull) == 0) {
+                for (int i = 0; i < 8; i++) { _values.push_back(data[i]); }
+                data += 8;
+                continue;
+            }
+        }
+
+        uint32_t value = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+            if (data >= end) {
+                throw std::runtime_error("unterminated varint, unexpected end of buffer");
+            }
+            if (shift > 28) {
+                throw std::runtime_error("unterminated varint (too long)");
+            }
+            byte = *data++;
+            value |= uint32_t(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+
+        _values.push_back(value);
+    }
+}
+
+void Mvt::getGeometry(ParserContext& _ctx, protobuf::message _geomIn) {
+
+    Geometry& geometry = _ctx.geometry;
+    geometry.positions.clear();
+    geometry.sizes.clear();
+
+    decodeVarints(_geomIn.getData(), _geomIn.getEnd(), geometry.values);
+
+    const uint32_t* value = geometry.values.data();
+    const uint32_t* end = value + geometry.values.size();
+
+    auto& positions = geometry.positions;
 
     GeomCmd cmd = GeomCmd::moveTo;
     uint32_t cmdRepeat = 0;
 
-    double invTileExtent = (1.0/(_ctx.tileExtent-1.0));
-
     int64_t x = 0;
     int64_t y = 0;
 
     size_t numCoordinates = 0;
 
-    while(_geomIn.getData() < _geomIn.getEnd()) {
+    // Sum up the zigzag encoded deltas to integer positions
+    while (value < end) {
 
-        if(cmdRepeat == 0) { // get new command, length and parameters..
-            uint32_t cmdData = static_cast<uint32_t>(_geomIn.varint());
+        if (cmdRepeat == 0) { // get new command, length and parameters..
+            uint32_t cmdData = *value++;
             cmd = static_cast<GeomCmd>(cmdData & 0x7); //first 3 bits of the cmdData
             cmdRepeat = cmdData >> 3; //last 5 bits
         }
 
-        if(cmd == GeomCmd::moveTo || cmd == GeomCmd::lineTo) { // get parameters/points
+        if (cmd == GeomCmd::moveTo || cmd == GeomCmd::lineTo) { // get parameters/points
+            if (end - value < 2) {
+                throw std::runtime_error("missing geometry parameters");
+            }
             // if cmd is move then move to a new line/set of points and save this line
-            if(cmd == GeomCmd::moveTo) {
-                if (geometry.coordinates.size() > 0) {
+            if (cmd == GeomCmd::moveTo) {
+                if (positions.size() > 0) {
                     geometry.sizes.push_back(numCoordinates);
                 }
                 numCoordinates = 0;
             }
 
-            x += _geomIn.svarint();
-            y += _geomIn.svarint();
+            x += (value[0] >> 1) ^ -int64_t(value[0] & 1);
+            y += (value[1] >> 1) ^ -int64_t(value[1] & 1);
+            value += 2;
 
-            // bring the points in 0 to 1 space
-            Point p;
-            p.x = invTileExtent * (double)x;
-            p.y = invTileExtent * (double)(_ctx.tileExtent - y);
-
-            if (numCoordinates == 0 || geometry.coordinates.back() != p) {
-                geometry.coordinates.push_back(p);
+            // Skip repeated points
+            size_t n = positions.size();
+            if (numCoordinates == 0 || positions[n - 2] != x || positions[n - 1] != y) {
+                positions.push_back(int32_t(x));
+                positions.push_back(int32_t(y));
                 numCoordinates++;
             }
-        } else if(cmd == GeomCmd::closePath) {
+        } else if (cmd == GeomCmd::closePath) {
             // end of a polygon, push first point in this line as last and push line to poly
-            geometry.coordinates.push_back(geometry.coordinates[geometry.coordinates.size() - numCoordinates]);
-            geometry.sizes.push_back(numCoordinates + 1);
+            if (numCoordinates > 0) {
+                size_t first = positions.size() - 2 * numCoordinates;
+                positions.push_back(positions[first]);
+                positions.push_back(positions[first + 1]);
+                geometry.sizes.push_back(numCoordinates + 1);
+            }
             numCoordinates = 0;
         }
 
@@ -82,7 +138,91 @@ Mvt::Geometry Mvt::getGeometry(ParserContext& _ctx, protobuf::message _geomIn) {
         geometry.sizes.push_back(numCoordinates);
     }
 
-    return geometry;
+    // bring the points in 0 to 1 space
+    double invTileExtent = (1.0/(_ctx.tileExtent-1.0));
+    double tileExtent = _ctx.tileExtent;
+
+    size_t numPoints = positions.size() / 2;
+    geometry.coordinates.resize(numPoints);
+
+    const int32_t* position = positions.data();
+    Point* coordinate = geometry.coordinates.data();
+    for (size_t i = 0; i < numPoints; i++) {
+        coordinate[i].x = invTileExtent * position[2 * i];
+        coordinate[i].y = invTileExtent * (tileExtent - position[2 * i + 1]);
+    }
+}
+
+// Winding of the first ring of @_geometry with a nonzero area, 0 when there is none
+static int firstRingWinding(const Mvt::Geometry& _geometry) {
+    const Point* pos = _geometry.coordinates.data();
+    for (int length : _geometry.sizes) {
+        const Point* end = pos + length;
+        float area = signedArea(pos, end);
+        if (area != 0) { return area > 0 ? 1 : -1; }
+        pos = end;
+    }
+    return 0;
+}
+
+void Mvt::setGeometry(ParserContext& _ctx, Feature& _feature) {
+
+    GeometryArena& arena = *_ctx.geometryArena;
+
+    switch(_feature.geometryType) {
+        case GeometryType::points:
+            arena.addPoints(_ctx.geometry.coordinates.data(), _ctx.geometry.coordinates.size());
+            arena.endRing();
+            break;
+
+        case GeometryType::lines:
+        {
+            const Point* pos = _ctx.geometry.coordinates.data();
+            for (int length : _ctx.geometry.sizes) {
+                arena.addPoints(pos, length);
+                arena.endRing();
+                pos += length;
+            }
+            break;
+        }
+        case GeometryType::polygons:
+        {
+            const Point* pos = _ctx.geometry.coordinates.data();
+            for (int length : _ctx.geometry.sizes) {
+                if (length == 0) { continue; }
+                const Point* end = pos + length;
+                float area = signedArea(pos, end);
+                if (area == 0) {
+                    pos = end;
+                    continue;
+                }
+                int winding = area > 0 ? 1 : -1;
+                // Determine exterior winding from first polygon.
+                if (_ctx.winding == 0) {
+                    _ctx.winding = winding;
+                }
+                if (winding == _ctx.winding) {
+                    // This is an exterior polygon.
+                    arena.endPart();
+                }
+                if (_ctx.winding > 0) {
+                    arena.addPoints(pos, length);
+                } else {
+                    for (auto it = end; it != pos; --it) { arena.addPoint(*(it - 1)); }
+                }
+                arena.endRing();
+                pos = end;
+            }
+            arena.endPart();
+            break;
+        }
+        case GeometryType::unknown:
+            break;
+        default:
+            break;
+    }
+
+    _feature.geometry = arena.endFeature();
 }
 
 Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
@@ -92,6 +232,8 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
     _ctx.featureTags.clear();
     _ctx.featureTags.assign(_ctx.keys.size(), -1);
 
+    protobuf::message geometryMsg;
+    bool hasGeometry = false;
 
     while(_featureIn.next()) {
         switch(_featureIn.tag) {
@@ -118,7 +260,7 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
 
                     auto valueKey = tagsMsg.varint();
 
-                    if( _ctx.values.size() <= valueKey ) {
+                    if( _ctx.values->size() <= valueKey ) {
                         LOGE("accessing out of bound values");
                         return feature;
                     }
@@ -132,7 +274,12 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
                 break;
             // Actual geometry data
             case FEATURE_GEOM:
-                _ctx.geometry = getGeometry(_ctx, _featureIn.getMessage());
+                if (_ctx.lazyGeometry) {
+                    geometryMsg = _featureIn.getMessage();
+                    hasGeometry = true;
+                } else {
+                    getGeometry(_ctx, _featureIn.getMessage());
+                }
                 break;
 
             default:
@@ -147,69 +294,28 @@ Feature Mvt::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
     for (int tagKey : _ctx.orderedKeys) {
         int tagValue = _ctx.featureTags[tagKey];
         if (tagValue >= 0) {
-            properties.emplace_back(_ctx.keys[tagKey], _ctx.values[tagValue]);
+            properties.emplace_back(_ctx.keys[tagKey], &(*_ctx.values)[tagValue]);
         }
     }
-    feature.props.setSorted(std::move(properties));
-
-    switch(feature.geometryType) {
-        case GeometryType::points:
-            feature.points.insert(feature.points.begin(),
-                                  _ctx.geometry.coordinates.begin(),
-                                  _ctx.geometry.coordinates.end());
-            break;
-
-        case GeometryType::lines:
-        {
-            auto pos = _ctx.geometry.coordinates.begin();
-            for (int length : _ctx.geometry.sizes) {
-                if (length == 0) { continue; }
-                Line line;
-                line.reserve(length);
-                line.insert(line.begin(), pos, pos + length);
-                pos += length;
-                feature.lines.emplace_back(std::move(line));
+    feature.props.setSorted(std::move(properties), _ctx.values);
+
+    if (hasGeometry) {
+        // The exterior winding of the layer is set by its first polygon in
+        // file order, not by the first one that happens to be decoded
+        if (_ctx.winding == 0 && feature.geometryType == GeometryType::polygons) {
+            try {
+                getGeometry(_ctx, geometryMsg);
+                _ctx.winding = firstRingWinding(_ctx.geometry);
+            } catch(const std::exception&) {
+                // Logged when the feature is decoded
             }
-            break;
         }
-        case GeometryType::polygons:
-        {
-            auto pos = _ctx.geometry.coordinates.begin();
-            auto rpos = _ctx.geometry.coordinates.rend();
-            for (int length : _ctx.geometry.sizes) {
-                if (length == 0) { continue; }
-                float area = signedArea(pos, pos + length);
-                if (area == 0) {
-                    pos += length;
-                    rpos -= length;
-                    continue;
-                }
-                int winding = area > 0 ? 1 : -1;
-                // Determine exterior winding from first polygon.
-                if (_ctx.winding == 0) {
-                    _ctx.winding = winding;
-                }
-                Line line;
-                line.reserve(length);
-                if (_ctx.winding > 0) {
-                    line.insert(line.end(), pos, pos + length);
-                } else {
-                    line.insert(line.end(), rpos - length, rpos);
-                }
-                pos += length;
-                rpos -= length;
-                if (winding == _ctx.winding || feature.polygons.empty()) {
-                    // This is an exterior polygon.
-                    feature.polygons.emplace_back();
-                }
-                feature.polygons.back().push_back(std::move(line));
-            }
-            break;
-        }
-        case GeometryType::unknown:
-            break;
-        default:
-            break;
+        feature.encodedGeometry = _ctx.lazyGeometry->add(geometryMsg, _ctx.tileExtent, _ctx.winding);
+        return feature;
+    }
+
+    if (feature.encodedGeometry == 0) {
+        setGeometry(_ctx, feature);
     }
 
     return feature;
@@ -220,8 +326,9 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
     Layer layer("");
 
     _ctx.keys.clear();
-    _ctx.values.clear();
+    _ctx.values = std::make_shared<PropertyValues>();
     _ctx.featureMsgs.clear();
+    _ctx.winding = 0;
 
     bool lastWasFeature = false;
     size_t numFeatures = 0;
@@ -245,7 +352,7 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
                 continue;
             }
             case LAYER_KEY: {
-                _ctx.keys.push_back(_layerIn.string());
+                _ctx.keys.push_back(PropertyKey::intern(_layerIn.string()));
                 break;
             }
             case LAYER_VALUE: {
@@ -254,28 +361,28 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
                 while (valueItr.next()) {
                     switch (valueItr.tag) {
                         case 1: // string value
-                            _ctx.values.push_back(valueItr.string());
+                            _ctx.values->push_back(valueItr.string());
                             break;
                         case 2: // float value
-                            _ctx.values.push_back(valueItr.float32());
+                            _ctx.values->push_back(valueItr.float32());
                             break;
                         case 3: // double value
-                            _ctx.values.push_back(valueItr.float64());
+                            _ctx.values->push_back(valueItr.float64());
                             break;
                         case 4: // int value
-                            _ctx.values.push_back(valueItr.int64());
+                            _ctx.values->push_back(valueItr.int64());
                             break;
                         case 5: // uint value
-                            _ctx.values.push_back(valueItr.varint());
+                            _ctx.values->push_back(valueItr.varint());
                             break;
                         case 6: // sint value
-                            _ctx.values.push_back(valueItr.int64());
+                            _ctx.values->push_back(valueItr.int64());
                             break;
                         case 7: // bool value
-                            _ctx.values.push_back(valueItr.boolean());
+                            _ctx.values->push_back(valueItr.boolean());
                             break;
                         default:
-                            _ctx.values.push_back(none_type{});
+                            _ctx.values->push_back(none_type{});
                             valueItr.skip();
                             break;
                     }
@@ -295,6 +402,8 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
 
     if (_ctx.featureMsgs.empty()) { return layer; }
 
+    layer.values = _ctx.values;
+
     //// Assign ordering to keys for faster sorting
     _ctx.orderedKeys.clear();
     _ctx.orderedKeys.reserve(_ctx.keys.size());
@@ -305,7 +414,7 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
     // sort by Property key ordering
     std::sort(_ctx.orderedKeys.begin(), _ctx.orderedKeys.end(),
               [&](int a, int b) {
-                  return Properties::keyComparator(_ctx.keys[a], _ctx.keys[b]);
+                  return _ctx.keys[a] < _ctx.keys[b];
               });
 
     layer.features.reserve(numFeatures);
@@ -321,7 +430,47 @@ Layer Mvt::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
     return layer;
 }
 
-std::shared_ptr<TileData> Mvt::parseTile(const TileTask& _task, int32_t _sourceId) {
+uint32_t Mvt::LazyGeometry::add(protobuf::message _geometry, int _tileExtent, int _winding) {
+    m_entries.emplace_back(_geometry, _tileExtent, _winding);
+    return m_entries.size();
+}
+
+void Mvt::LazyGeometry::decode(Feature& _feature) {
+    auto& entry = m_entries[_feature.encodedGeometry - 1];
+    if (entry.decoded.load(std::memory_order_acquire)) { return; }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (entry.decoded.load(std::memory_order_relaxed)) { return; }
+
+    m_ctx.tileExtent = entry.tileExtent;
+    m_ctx.winding = entry.winding;
+    try {
+        getGeometry(m_ctx, entry.geometry);
+    } catch(const std::exception& e) {
+        LOGE("Cannot decode feature geometry: %s", e.what());
+        return;
+    }
+    setGeometry(m_ctx, _feature);
+    entry.decoded.store(true, std::memory_order_release);
+}
+
+// Whether the layer message @_layerIn is named in @_layers
+static bool containsLayer(protobuf::message _layerIn, const std::vector<std::string>& _layers) {
+    std::string name;
+
+    while(_layerIn.next()) {
+        if(_layerIn.tag == LAYER_NAME) {
+            name = _layerIn.string();
+            break;
+        }
+        _layerIn.skip();
+    }
+    // Unnamed layers match all collections
+    return name.empty() || std::find(_layers.begin(), _layers.end(), name) != _layers.end();
+}
+
+std::shared_ptr<TileData> Mvt::parseTile(const TileTask& _task, int32_t _sourceId,
+                                         const std::vector<std::string>& _layers) {
 
     auto tileData = std::make_shared<TileData>();
 
@@ -329,11 +478,20 @@ std::shared_ptr<TileData> Mvt::parseTile(const TileTask& _task, int32_t _sourceI
 
     protobuf::message item(task.rawTileData->data(), task.rawTileData->size());
     ParserContext ctx(_sourceId);
+    ctx.geometryArena = &tileData->geometry;
+
+    // Geometry is decoded for the features that are styled
+    auto lazyGeometry = std::make_unique<LazyGeometry>(task.rawTileData, tileData->geometry);
+    ctx.lazyGeometry = lazyGeometry.get();
+    tileData->geometryDecoder = std::move(lazyGeometry);
 
     try {
         while(item.next()) {
             if(item.tag == LAYER) {
-                tileData->layers.push_back(getLayer(ctx, item.getMessage()));
+                auto layerMsg = item.getMessage();
+                if (!_layers.empty() && !containsLayer(layerMsg, _layers)) { continue; }
+
+                tileData->layers.push_back(getLayer(ctx, layerMsg));
             } else {
                 item.skip();
             }
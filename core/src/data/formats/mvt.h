@@ -2,9 +2,13 @@
 
 #include "data/tileData.h"
 #include "pbf/pbf.hpp"
+#include "util/tileBuffer.h"
 #include "util/variant.h"
 
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -16,7 +20,13 @@ class MapProjection;
 
 namespace Mvt {
 
+    class LazyGeometry;
+
     struct Geometry {
+        // Integers of the packed geometry message
+        std::vector<uint32_t> values;
+        // Positions of the points in tile extent units, x and y interleaved
+        std::vector<int32_t> positions;
         std::vector<Point> coordinates;
         std::vector<int> sizes;
     };
@@ -25,9 +35,11 @@ namespace Mvt {
         ParserContext(int32_t _sourceId) : sourceId(_sourceId){}
 
         int32_t sourceId;
-        std::vector<std::string> keys;
-        std::vector<Value> values;
+        std::vector<PropertyKey> keys;
+        // Values of the current layer, shared by its features
+        std::shared_ptr<PropertyValues> values;
         std::vector<protobuf::message> featureMsgs;
+        // Geometry of the current feature, reused for all features
         Geometry geometry;
         // Map Key ID -> Tag values
         std::vector<int> featureTags;
@@ -36,6 +48,12 @@ namespace Mvt {
 
         int tileExtent = 0;
         int winding = 0;
+
+        // Keeps the geometry of features encoded when set
+        LazyGeometry* lazyGeometry = nullptr;
+
+        // Stores the decoded geometry
+        GeometryArena* geometryArena = nullptr;
     };
 
     enum GeomCmd {
@@ -44,13 +62,61 @@ namespace Mvt {
         closePath = 7
     };
 
-    Geometry getGeometry(ParserContext& _ctx, protobuf::message _geomIn);
+    /* Geometry messages of the features in a tile, decoded when the features
+     * are used */
+    class LazyGeometry : public GeometryDecoder {
+    public:
+        LazyGeometry(std::shared_ptr<TileBuffer> _data, GeometryArena& _arena)
+            : m_data(std::move(_data)), m_ctx(0) {
+            m_ctx.geometryArena = &_arena;
+        }
+
+        /* Keep the @_geometry message of a feature, returns its encodedGeometry ID.
+         * @_winding is the exterior winding of the layer, 0 when unknown */
+        uint32_t add(protobuf::message _geometry, int _tileExtent, int _winding);
+
+        void decode(Feature& _feature) override;
+
+    private:
+        struct Entry {
+            Entry(protobuf::message _geometry, int _tileExtent, int _winding)
+                : geometry(_geometry), tileExtent(_tileExtent), winding(_winding) {}
+
+            protobuf::message geometry;
+            int tileExtent;
+            int winding;
+            // Set after the geometry of the feature was set, checked without the lock
+            std::atomic<bool> decoded{false};
+        };
+
+        // Owns the bytes of the geometry messages
+        std::shared_ptr<TileBuffer> m_data;
+        // Entries never move, their flags are read while other features are decoded
+        std::deque<Entry> m_entries;
+
+        // Decoded geometry
+        ParserContext m_ctx;
+        std::mutex m_mutex;
+    };
+
+    /* Decode the varints in @_data to @_end into @_values. Throws
+     * std::runtime_error on truncated or too long varints. */
+    void decodeVarints(const char* _data, const char* _end, std::vector<uint32_t>& _values);
+
+    /* Decode the geometry message @_geomIn into the geometry of @_ctx */
+    void getGeometry(ParserContext& _ctx, protobuf::message _geomIn);
+
+    /* Add the geometry decoded into @_ctx to its arena and set it on @_feature */
+    void setGeometry(ParserContext& _ctx, Feature& _feature);
 
     Feature getFeature(ParserContext& _ctx, protobuf::message _featureIn);
 
     Layer getLayer(ParserContext& _ctx, protobuf::message _layerIn);
 
-    std::shared_ptr<TileData> parseTile(const TileTask& _task, int32_t _sourceId);
+    /* Parse the layers of the tile, or only the layers named in @_layers when
+     * it is not empty */
+    std::shared_ptr<TileData> parseTile(const TileTask& _task, int32_t _sourceId,
+                                        const std::vector<std::string>& _layers = {});
 
 } // namespace Mvt
 
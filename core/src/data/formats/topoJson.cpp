@@ -16,6 +16,7 @@ TopoJson::Topology TopoJson::getTopology(const JsonDocument& _document, const Tr
 
     auto transform = _document.FindMember("transform");
     if (transform != _document.MemberEnd()) {
+        topo.quantized = true;
         auto scale = transform->value.FindMember("scale");
         if (scale != transform->value.MemberEnd() && scale->value.Size() == 2) {
             topo.scale = { scale->value[0].GetDouble(), scale->value[1].GetDouble() };
@@ -26,6 +27,8 @@ TopoJson::Topology TopoJson::getTopology(const JsonDocument& _document, const Tr
         }
     }
 
+    topo.arcs.push_back(0);
+
     // Quantized, delta-encoded 'arcs' in Json
     auto jsonArcList = _document.FindMember("arcs");
 
@@ -39,31 +42,34 @@ TopoJson::Topology TopoJson::getTopology(const JsonDocument& _document, const Tr
         return topo;
     }
 
-    topo.arcs.reserve(jsonArcs.Size());
-
-    // Decode and transform the points that make up 'arcs'
+    size_t numPoints = 0;
     for (auto jsonArcsIt = jsonArcs.Begin(); jsonArcsIt != jsonArcs.End(); ++jsonArcsIt) {
+        if (jsonArcsIt->IsArray()) { numPoints += jsonArcsIt->Size(); }
+    }
 
-        const auto& jsonArc = *jsonArcsIt;
+    topo.points.reserve(numPoints);
+    topo.arcs.reserve(jsonArcs.Size() + 1);
 
-        if (!jsonArc.IsArray()) { // According to spec, jsonArc.Size() >= 2 should also hold
-            continue;
-        }
+    // Decode and transform the points that make up 'arcs', each arc is projected
+    // once and then shared by all the features that reference it
+    for (auto jsonArcsIt = jsonArcs.Begin(); jsonArcsIt != jsonArcs.End(); ++jsonArcsIt) {
 
-        Line arc;
-        arc.reserve(jsonArc.Size());
+        const auto& jsonArc = *jsonArcsIt;
 
-        // Quantized position
-        glm::ivec2 q;
+        // According to spec, jsonArc.Size() >= 2 should also hold. Invalid arcs
+        // are kept empty so that the indices of the following arcs stay the same
+        if (jsonArc.IsArray()) {
 
-        for (auto jsonCoordsIt = jsonArc.Begin(); jsonCoordsIt != jsonArc.End(); ++jsonCoordsIt) {
+            // Quantized position
+            glm::ivec2 q;
 
-            const auto& jsonCoords = *jsonCoordsIt;
+            for (auto jsonCoordsIt = jsonArc.Begin(); jsonCoordsIt != jsonArc.End(); ++jsonCoordsIt) {
 
-            arc.push_back(getPoint(jsonCoords, topo, q));
+                topo.points.push_back(getPoint(*jsonCoordsIt, topo, q));
+            }
         }
 
-        topo.arcs.push_back(arc);
+        topo.arcs.push_back(topo.points.size());
     }
 
     return topo;
@@ -75,24 +81,42 @@ Point TopoJson::getPoint(const JsonValue& _coordinates, const Topology& _topolog
         return Point();
     }
 
-    _cursor.x += _coordinates[0].GetInt();
-    _cursor.y += _coordinates[1].GetInt();
+    const auto& x = _coordinates[0];
+    const auto& y = _coordinates[1];
+    glm::dvec2 position;
 
-    auto tmp = glm::dvec2(_cursor) * _topology.scale + _topology.translate;
-    return _topology.proj(LngLat(tmp.x, tmp.y));
+    if (_topology.quantized) {
+        if (!x.IsInt() || !y.IsInt()) {
+            return Point();
+        }
+        _cursor.x += x.GetInt();
+        _cursor.y += y.GetInt();
+        position = glm::dvec2(_cursor) * _topology.scale + _topology.translate;
+    } else {
+        if (!x.IsNumber() || !y.IsNumber()) {
+            return Point();
+        }
+        position = { x.GetDouble(), y.GetDouble() };
+    }
 
-}
+    return _topology.proj(LngLat(position.x, position.y));
 
-Line TopoJson::getLine(const JsonValue& _arcs, const Topology& _topology) {
+}
 
-    Line line;
+void TopoJson::getLine(const JsonValue& _arcs, const Topology& _topology, GeometryArena& _arena) {
 
     if (!_arcs.IsArray()) {
-        return line;
+        return;
     }
 
+    bool first = true;
+
     for (auto arcIt = _arcs.Begin(); arcIt != _arcs.End(); ++arcIt) {
 
+        if (!arcIt->IsInt()) {
+            continue;
+        }
+
         auto index = arcIt->GetInt();
         bool reverse = false;
         if (index < 0) {
@@ -100,58 +124,56 @@ Line TopoJson::getLine(const JsonValue& _arcs, const Topology& _topology) {
             index = -1 - index;
         }
 
-        if (index < 0 || (std::vector<Line>::size_type)index >= _topology.arcs.size()) {
+        if ((size_t)index >= _topology.arcCount()) {
             continue;
         }
 
-        const auto& arc = _topology.arcs[index];
+        const Point* points = _topology.points.data() + _topology.arcs[index];
+        size_t count = _topology.arcs[index + 1] - _topology.arcs[index];
 
-        auto begin = arc.begin();
-        auto end = arc.end();
-        size_t inc = 1;
-        if (reverse) {
-            begin = arc.end() - 1;
-            end = arc.begin() - 1;
-            inc = -inc;
+        if (count == 0) {
+            continue;
         }
 
         // If a line is made from multiple arcs, the first position of an arc must
         // be equal to the last position of the previous arc. So when reconstructing
         // the geometry, the first position of each arc except the first may be dropped
-        if (arcIt != _arcs.Begin()) {
-            begin = begin + inc;
+        if (!first) {
+            if (!reverse) { points++; }
+            count--;
         }
+        first = false;
 
-        for (auto pointIt = begin; pointIt != end; pointIt += inc) {
-            line.push_back(*pointIt);
+        if (reverse) {
+            _arena.addPointsReversed(points, count);
+        } else {
+            _arena.addPoints(points, count);
         }
 
     }
 
-    return line;
+    _arena.endRing();
 
 }
 
-Polygon TopoJson::getPolygon(const JsonValue& _arcSets, const Topology& _topology) {
-
-    Polygon polygon;
+void TopoJson::getPolygon(const JsonValue& _arcSets, const Topology& _topology, GeometryArena& _arena) {
 
     if (!_arcSets.IsArray()) {
-        return polygon;
+        return;
     }
 
     for (auto arcSetIt = _arcSets.Begin(); arcSetIt != _arcSets.End(); ++arcSetIt) {
 
-        auto ring = getLine(*arcSetIt, _topology);
-        polygon.push_back(ring);
+        getLine(*arcSetIt, _topology, _arena);
 
     }
 
-    return polygon;
+    _arena.endPart();
 
 }
 
-Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _source) {
+Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _source,
+                             GeometryArena& _arena) {
 
     static const JsonValue keyProperties("properties");
     static const JsonValue keyType("type");
@@ -176,7 +198,8 @@ Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topolo
         auto coordinatesIt = _geometry.FindMember(keyCoordinates);
         if (coordinatesIt != _geometry.MemberEnd()) {
             glm::ivec2 cursor;
-            feature.points.push_back(getPoint(coordinatesIt->value, _topology, cursor));
+            _arena.addPoint(getPoint(coordinatesIt->value, _topology, cursor));
+            _arena.endRing();
         }
     } else if (type == "MultiPoint") {
         feature.geometryType = GeometryType::points;
@@ -185,14 +208,15 @@ Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topolo
             auto& coordinates = coordinatesIt->value;
             for (auto point = coordinates.Begin(); point != coordinates.End(); ++point) {
                 glm::ivec2 cursor;
-                feature.points.push_back(getPoint(*point, _topology, cursor));
+                _arena.addPoint(getPoint(*point, _topology, cursor));
             }
+            _arena.endRing();
         }
     } else if (type == "LineString") {
         feature.geometryType = GeometryType::lines;
         auto arcsIt = _geometry.FindMember(keyArcs);
         if (arcsIt != _geometry.MemberEnd()) {
-            feature.lines.push_back(getLine(arcsIt->value, _topology));
+            getLine(arcsIt->value, _topology, _arena);
         }
     } else if (type == "MultiLineString") {
         feature.geometryType = GeometryType::lines;
@@ -200,14 +224,14 @@ Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topolo
         if (arcsIt != _geometry.MemberEnd() && arcsIt->value.IsArray()) {
             auto& arcs = arcsIt->value;
             for (auto arcList = arcs.Begin(); arcList != arcs.End(); ++arcList) {
-                feature.lines.push_back(getLine(*arcList, _topology));
+                getLine(*arcList, _topology, _arena);
             }
         }
     } else if (type == "Polygon") {
         feature.geometryType = GeometryType::polygons;
         auto arcsIt = _geometry.FindMember(keyArcs);
         if (arcsIt != _geometry.MemberEnd()) {
-            feature.polygons.push_back(getPolygon(arcsIt->value, _topology));
+            getPolygon(arcsIt->value, _topology, _arena);
         }
     } else if (type == "MultiPolygon") {
         feature.geometryType = GeometryType::polygons;
@@ -215,18 +239,21 @@ Feature TopoJson::getFeature(const JsonValue& _geometry, const Topology& _topolo
         if (arcsIt != _geometry.MemberEnd() && arcsIt->value.IsArray()) {
             auto& arcs = arcsIt->value;
             for (auto arcList = arcs.Begin(); arcList != arcs.End(); ++arcList) {
-                feature.polygons.push_back(getPolygon(*arcList, _topology));
+                getPolygon(*arcList, _topology, _arena);
             }
         }
     } else if (type == "GeometryCollection") {
         // Not handled
     }
 
+    feature.geometry = _arena.endFeature();
+
     return feature;
 
 }
 
-Layer TopoJson::getLayer(JsonValue::MemberIterator& _objectIt, const Topology& _topology, int32_t _source) {
+Layer TopoJson::getLayer(JsonValue::MemberIterator& _objectIt, const Topology& _topology, int32_t _source,
+                         GeometryArena& _arena) {
 
     Layer layer(_objectIt->name.GetString());
 
@@ -236,7 +263,7 @@ Layer TopoJson::getLayer(JsonValue::MemberIterator& _objectIt, const Topology& _
         auto geometries = object.FindMember("geometries");
         if (geometries != object.MemberEnd() && geometries->value.IsArray()) {
             for (auto it = geometries->value.Begin(); it != geometries->value.End(); ++it) {
-                layer.features.push_back(getFeature(*it, _topology, _source));
+                layer.features.push_back(getFeature(*it, _topology, _source, _arena));
             }
         }
     }
@@ -282,7 +309,7 @@ std::shared_ptr<TileData> TopoJson::parseTile(const TileTask& _task, int32_t _so
     if (objectsIt == document.MemberEnd()) { return tileData; }
     auto& objects = objectsIt->value;
     for (auto layer = objects.MemberBegin(); layer != objects.MemberEnd(); ++layer) {
-        tileData->layers.push_back(TopoJson::getLayer(layer, topology, _source));
+        tileData->layers.push_back(TopoJson::getLayer(layer, topology, _source, tileData->geometry));
     }
 
     // Discard JSON object and return TileData
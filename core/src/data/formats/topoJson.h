@@ -19,21 +19,32 @@ using Transform = std::function<Point(LngLat _lngLat)>;
 struct Topology {
     glm::dvec2 scale = { 1., 1. };
     glm::dvec2 translate = { 0., 0. };
-    std::vector<Line> arcs;
+    // Positions of a quantized topology are integers, delta-encoded within arcs
+    bool quantized = false;
+    // Projected points of all arcs, arc i spans points[arcs[i]] to points[arcs[i + 1]]
+    std::vector<Point> points;
+    std::vector<uint32_t> arcs;
     Transform proj;
+
+    size_t arcCount() const { return arcs.empty() ? 0 : arcs.size() - 1; }
 };
 
 Topology getTopology(const JsonDocument& _document, const Transform& _proj);
 
+/* Decode the position @_coordinates, quantized positions are added to @_cursor */
 Point getPoint(const JsonValue& _coordinates, const Topology& _topology, glm::ivec2& _cursor);
 
-Line getLine(const JsonValue& _arcs, const Topology& _topology);
+/* Add the line made of @_arcs to @_arena */
+void getLine(const JsonValue& _arcs, const Topology& _topology, GeometryArena& _arena);
 
-Polygon getPolygon(const JsonValue& _arcs, const Topology& _topology);
+/* Add the rings made of @_arcs to @_arena */
+void getPolygon(const JsonValue& _arcs, const Topology& _topology, GeometryArena& _arena);
 
-Feature getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _sourceId);
+Feature getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _sourceId,
+                   GeometryArena& _arena);
 
-Layer getLayer(JsonValue::MemberIterator& _object, const Topology& _topology, int32_t _sourceId);
+Layer getLayer(JsonValue::MemberIterator& _object, const Topology& _topology, int32_t _sourceId,
+               GeometryArena& _arena);
 
 std::shared_ptr<TileData> parseTile(const TileTask& _task, int32_t _sourceId);
 
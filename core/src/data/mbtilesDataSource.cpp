@@ -7,8 +7,22 @@
 #include "util/url.h"
 
 #include <SQLiteCpp/Database.h>
+#include <SQLiteCpp/Transaction.h>
+
+#include <algorithm>
+#include <cstring>
 #include "hash-library/md5.cpp"
 
+// Pending tiles are stored in one transaction when one of these limits is reached
+#define WRITE_BATCH_TILES 128
+#define WRITE_BATCH_BYTES (4 * 1024 * 1024)
+#define WRITE_BATCH_DELAY_MS 1000
+
+// Tiles up to this size are compared with the last stored tile of the same
+// size to find duplicates without hashing them
+#define DEDUPLICATE_MAX_SIZE 4096
+#define DEDUPLICATE_MAX_ENTRIES 256
+
 
 namespace Tangram {
 
@@ -105,31 +119,60 @@ struct MBTilesQueries {
     // REPLACE INTO statement in map table
     SQLite::Statement putMap;
 
-    // REPLACE INTO statement in images table
+    // INSERT OR IGNORE INTO statement in images table
     SQLite::Statement putImage;
 
     MBTilesQueries(SQLite::Database& _db, bool _cache)
         : getTileData(_db, "SELECT tile_data FROM tiles WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?;"),
           putMap(_db, _cache ? "REPLACE INTO map (zoom_level, tile_column, tile_row, tile_id) VALUES (?, ?, ?, ?);" : ";" ),
-          putImage(_db, _cache ? "REPLACE INTO images (tile_id, tile_data) VALUES (?, ?);" : ";") {}
+          putImage(_db, _cache ? "INSERT OR IGNORE INTO images (tile_id, tile_data) VALUES (?, ?);" : ";") {}
 
 };
 
+struct MBTilesConnection {
+    std::unique_ptr<SQLite::Database> db;
+    std::unique_ptr<MBTilesQueries> queries;
+};
+
 MBTilesDataSource::MBTilesDataSource(std::shared_ptr<Platform> _platform, std::string _name,
-                                     std::string _path, std::string _mime, bool _cache, bool _offlineFallback)
+                                     std::string _path, std::string _mime, bool _cache, bool _offlineFallback,
+                                     size_t _readers)
     : m_name(_name),
       m_path(_path),
       m_mime(_mime),
       m_cacheMode(_cache),
       m_offlineMode(_offlineFallback),
+      m_numReaders(std::max(_readers, size_t(1))),
       m_platform(_platform) {
 
-    m_worker = std::make_unique<AsyncWorker>();
-
     openMBTiles();
+
+    // Tiles of the store change in cache mode and come from the next source in offline mode
+    if (!m_cacheMode && !m_offlineMode && !m_readers.empty()) {
+        m_version = fileVersion(m_path);
+    }
+
+    // One thread per connection: Reads never wait for a free reader
+    m_readWorker = std::make_unique<AsyncWorker>(m_readers.size());
+
+    if (m_writer) {
+        m_writeThread = std::thread(&MBTilesDataSource::writeTiles, this);
+    }
 }
 
 MBTilesDataSource::~MBTilesDataSource() {
+    // Join the readers while the members they use are alive
+    m_readWorker.reset();
+
+    if (m_writeThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            m_writerRunning = false;
+        }
+        m_writeCondition.notify_one();
+        // Commits the pending tiles
+        m_writeThread.join();
+    }
 }
 
 bool MBTilesDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
@@ -143,20 +186,18 @@ bool MBTilesDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb
         return loadNextSource(_task, _cb);
     }
 
-    if (!m_db) { return false; }
+    if (m_readers.empty()) { return false; }
 
     if (_task->rawSource == this->level) {
 
-        m_worker->enqueue([this, _task, _cb](){
+        m_readWorker->enqueue([this, _task, _cb](){
             TileID tileId = _task->tileId();
 
             auto& task = static_cast<BinaryTileTask&>(*_task);
-            task.rawTileData = std::make_shared<std::vector<char>>();
-
-            getTileData(tileId, *task.rawTileData);
+            task.rawTileData = readTileData(tileId);
 
             if (task.hasData()) {
-                LOGW("loaded tile: %s, %d", tileId.toString().c_str(), task.rawTileData->size());
+                LOGD("loaded tile: %s, %d", tileId.toString().c_str(), task.rawTileData->size());
 
                 _cb.func(_task);
 
@@ -184,7 +225,7 @@ bool MBTilesDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb
 bool MBTilesDataSource::loadNextSource(std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
     if (!next) { return false; }
 
-    if (!m_db) {
+    if (m_readers.empty()) {
         return next->loadTileData(_task, _cb);
     }
 
@@ -193,15 +234,12 @@ bool MBTilesDataSource::loadNextSource(std::shared_ptr<TileTask> _task, TileTask
 
         if (_task->hasData()) {
 
-            if (m_cacheMode) {
-                m_worker->enqueue([this, _task](){
-
-                        auto& task = static_cast<BinaryTileTask&>(*_task);
+            if (m_writer) {
+                auto& task = static_cast<BinaryTileTask&>(*_task);
 
-                        LOGW("store tile: %s, %d", _task->tileId().toString().c_str(), task.hasData());
+                LOGD("store tile: %s, %d", _task->tileId().toString().c_str(), task.hasData());
 
-                        storeTileData(_task->tileId(), *task.rawTileData);
-                    });
+                storeTileData(_task->tileId(), task.rawTileData);
             }
 
             _cb.func(_task);
@@ -209,14 +247,12 @@ bool MBTilesDataSource::loadNextSource(std::shared_ptr<TileTask> _task, TileTask
         } else if (m_offlineMode) {
             LOGW("try fallback tile: %s, %d", _task->tileId().toString().c_str());
 
-            m_worker->enqueue([this, _task, _cb](){
+            m_readWorker->enqueue([this, _task, _cb](){
 
                 auto& task = static_cast<BinaryTileTask&>(*_task);
-                task.rawTileData = std::make_shared<std::vector<char>>();
-
-                getTileData(_task->tileId(), *task.rawTileData);
+                task.rawTileData = readTileData(_task->tileId());
 
-                LOGW("loaded tile: %s, %d", _task->tileId().toString().c_str(), task.rawTileData->size());
+                LOGD("loaded tile: %s, %d", _task->tileId().toString().c_str(), task.rawTileData->size());
 
                 _cb.func(_task);
 
@@ -230,16 +266,11 @@ bool MBTilesDataSource::loadNextSource(std::shared_ptr<TileTask> _task, TileTask
     return next->loadTileData(_task, cb);
 }
 
-void MBTilesDataSource::openMBTiles() {
+std::unique_ptr<MBTilesConnection> MBTilesDataSource::openConnection(int _mode) {
 
-    try {
-        auto mode = SQLite::OPEN_READONLY;
-        if (m_cacheMode) {
-            // Need to explicitly open a SQLite DB with OPEN_READWRITE
-            // and OPEN_CREATE flags to make a file and write.
-            mode = SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE;
-        }
+    auto connection = std::make_unique<MBTilesConnection>();
 
+    try {
         auto url = Url(m_path);
         auto path = url.path();
         const char* vfs = "";
@@ -247,52 +278,95 @@ void MBTilesDataSource::openMBTiles() {
             vfs = "ndk-asset";
             path.erase(path.begin()); // Remove leading '/'.
         }
-        m_db = std::make_unique<SQLite::Database>(path, mode, 0, vfs);
+        connection->db = std::make_unique<SQLite::Database>(path, _mode, 0, vfs);
         LOG("SQLite database opened: %s", path.c_str());
 
     } catch (std::exception& e) {
         LOGE("Unable to open SQLite database: %s - %s", m_path.c_str(), e.what());
-        m_db.reset();
-        return;
+        return nullptr;
     }
 
-    bool ok = testSchema(*m_db);
+    return connection;
+}
+
+void MBTilesDataSource::openMBTiles() {
+
+    // The schema is checked, and set up in cache mode, on the first connection.
+    std::unique_ptr<MBTilesConnection> connection;
+    if (m_cacheMode) {
+        // Need to explicitly open a SQLite DB with OPEN_READWRITE
+        // and OPEN_CREATE flags to make a file and write.
+        connection = openConnection(SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE);
+    } else {
+        connection = openConnection(SQLite::OPEN_READONLY);
+    }
+    if (!connection) { return; }
+
+    bool ok = testSchema(*connection->db);
     if (ok) {
         if (m_cacheMode && !m_schemaOptions.isCache) {
             // TODO better description
             LOGE("Cannot cache to 'externally created' MBTiles database");
             // Run in non-caching mode
             m_cacheMode = false;
-            return;
+            connection.reset();
         }
     } else if (m_cacheMode) {
 
         // Setup the database by running the schema.sql.
-        initSchema(*m_db, m_name, m_mime);
+        initSchema(*connection->db, m_name, m_mime);
 
-        ok = testSchema(*m_db);
+        ok = testSchema(*connection->db);
         if (!ok) {
             LOGE("Unable to initialize MBTiles schema");
-            m_db.reset();
             return;
         }
     } else {
         LOGE("Invalid MBTiles schema");
-        m_db.reset();
         return;
     }
 
     if (m_schemaOptions.compression == Compression::unsupported) {
-        m_db.reset();
         return;
     }
 
-    try {
-        m_queries = std::make_unique<MBTilesQueries>(*m_db, m_cacheMode);
-    } catch (std::exception& e) {
-        LOGE("Unable to initialize queries: %s", e.what());
-        m_db.reset();
-        return;
+    if (m_cacheMode) {
+        try {
+            // Readers are not blocked while tiles are stored. WAL mode is
+            // persistent and requires write access to the file.
+            connection->db->exec("PRAGMA journal_mode=WAL;");
+            // Sync only on WAL checkpoints
+            connection->db->exec("PRAGMA synchronous=NORMAL;");
+        } catch (std::exception& e) {
+            LOGW("Unable to enable WAL mode: %s", e.what());
+        }
+
+        try {
+            connection->queries = std::make_unique<MBTilesQueries>(*connection->db, true);
+        } catch (std::exception& e) {
+            LOGE("Unable to initialize queries: %s", e.what());
+            return;
+        }
+        m_writer = std::move(connection);
+    }
+
+    for (size_t i = 0; i < m_numReaders; i++) {
+        auto reader = connection ? std::move(connection) : openConnection(SQLite::OPEN_READONLY);
+        if (!reader) { break; }
+
+        try {
+            reader->queries = std::make_unique<MBTilesQueries>(*reader->db, false);
+        } catch (std::exception& e) {
+            LOGE("Unable to initialize queries: %s", e.what());
+            break;
+        }
+        m_freeReaders.push_back(reader.get());
+        m_readers.push_back(std::move(reader));
+    }
+
+    if (m_readers.empty()) {
+        m_writer.reset();
+        m_cacheMode = false;
     }
 }
 
@@ -422,9 +496,50 @@ void MBTilesDataSource::initSchema(SQLite::Database& db, std::string _name, std:
     }
 }
 
-bool MBTilesDataSource::getTileData(const TileID& _tileId, std::vector<char>& _data) {
+MBTilesConnection* MBTilesDataSource::acquireReader() {
+    std::unique_lock<std::mutex> lock(m_readerMutex);
+    m_readerCondition.wait(lock, [&]{ return !m_freeReaders.empty(); });
+
+    auto reader = m_freeReaders.back();
+    m_freeReaders.pop_back();
+    return reader;
+}
+
+void MBTilesDataSource::releaseReader(MBTilesConnection* _reader) {
+    {
+        std::lock_guard<std::mutex> lock(m_readerMutex);
+        m_freeReaders.push_back(_reader);
+    }
+    m_readerCondition.notify_one();
+}
+
+std::shared_ptr<TileBuffer> MBTilesDataSource::readTileData(const TileID& _tileId) {
+    if (m_writer) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        TileID key(_tileId.x, _tileId.y, _tileId.z);
+
+        auto it = m_pendingTiles.find(key);
+        if (it != m_pendingTiles.end()) { return it->second; }
+
+        it = m_committingTiles.find(key);
+        if (it != m_committingTiles.end()) { return it->second; }
+    }
 
-    auto& stmt = m_queries->getTileData;
+    auto data = TileBuffer::create();
+    getTileData(_tileId, *data);
+    return data;
+}
+
+bool MBTilesDataSource::getTileData(const TileID& _tileId, TileBuffer& _data) {
+    auto reader = acquireReader();
+    bool found = getTileData(*reader, _tileId, _data);
+    releaseReader(reader);
+    return found;
+}
+
+bool MBTilesDataSource::getTileData(MBTilesConnection& _reader, const TileID& _tileId, TileBuffer& _data) {
+
+    auto& stmt = _reader.queries->getTileData;
     try {
         // Google TMS to WMTS
         // https://github.com/mapbox/node-mbtiles/blob/
@@ -447,14 +562,15 @@ bool MBTilesDataSource::getTileData(const TileID& _tileId, std::vector<char>& _d
                 if (zlib::inflate(blob, length, _data) != 0) {
                     if (m_schemaOptions.compression == Compression::undefined) {
                         _data.resize(length);
-                        memcpy(_data.data(), blob, length);
+                        memcpy(_data.mutableData(), blob, length);
                     } else {
                         LOGW("Invalid deflate compression");
                     }
                 }
             } else {
+                // The blob is only valid until the statement is reset
                 _data.resize(length);
-                memcpy(_data.data(), blob, length);
+                memcpy(_data.mutableData(), blob, length);
             }
 
             stmt.reset();
@@ -471,46 +587,133 @@ bool MBTilesDataSource::getTileData(const TileID& _tileId, std::vector<char>& _d
     return false;
 }
 
-void MBTilesDataSource::storeTileData(const TileID& _tileId, const std::vector<char>& _data) {
+void MBTilesDataSource::storeTileData(const TileID& _tileId, std::shared_ptr<TileBuffer> _data) {
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        if (m_pendingTiles.empty()) {
+            m_pendingSince = std::chrono::steady_clock::now();
+        }
+
+        auto& pending = m_pendingTiles[TileID(_tileId.x, _tileId.y, _tileId.z)];
+        if (pending) { m_pendingBytes -= pending->size(); }
+
+        pending = std::move(_data);
+        m_pendingBytes += pending->size();
+    }
+    m_writeCondition.notify_one();
+}
+
+bool MBTilesDataSource::isBatchFull() const {
+    return m_pendingTiles.size() >= WRITE_BATCH_TILES || m_pendingBytes >= WRITE_BATCH_BYTES;
+}
+
+void MBTilesDataSource::writeTiles() {
+    std::unique_lock<std::mutex> lock(m_writeMutex);
+
+    while (true) {
+        m_writeCondition.wait(lock, [&]{ return !m_writerRunning || !m_pendingTiles.empty(); });
+
+        if (m_pendingTiles.empty()) { break; }
+
+        if (m_writerRunning) {
+            auto deadline = m_pendingSince + std::chrono::milliseconds(WRITE_BATCH_DELAY_MS);
+            m_writeCondition.wait_until(lock, deadline, [&]{ return !m_writerRunning || isBatchFull(); });
+        }
+
+        // Committing tiles stay readable until the transaction is done.
+        // Only this thread modifies them.
+        std::swap(m_pendingTiles, m_committingTiles);
+        m_pendingBytes = 0;
+
+        lock.unlock();
+        commitTiles(m_committingTiles);
+        lock.lock();
+
+        m_committingTiles.clear();
+    }
+}
+
+void MBTilesDataSource::commitTiles(const TileDataMap& _tiles) {
+    try {
+        SQLite::Transaction transaction(*m_writer->db);
+
+        for (const auto& tile : _tiles) {
+            writeTileData(tile.first, tile.second);
+        }
+
+        transaction.commit();
+
+    } catch (std::exception& e) {
+        LOGE("MBTiles SQLite transaction failed: %s", e.what());
+        // Hashed contents may not be stored
+        m_storedContent.clear();
+    }
+}
+
+void MBTilesDataSource::writeTileData(const TileID& _tileId, const std::shared_ptr<TileBuffer>& _data) {
     int z = _tileId.z;
     int y = (1 << z) - 1 - _tileId.y;
 
-    const char* data = _data.data();
-    size_t size = _data.size();
+    const char* data = _data->data();
+    size_t size = _data->size();
 
     /**
      * We create an MD5 of the raw tile data. The MD5 functions as a hash
      * between the map and images tables. With this, tiles with duplicate
      * data will join to a single entry in the images table.
      */
-    MD5 md5;
-    std::string md5id = md5(data, size);
+    std::string md5id;
+    bool stored = false;
+
+    // Identical small tiles, e.g. of water or empty areas, are common
+    if (size <= DEDUPLICATE_MAX_SIZE) {
+        auto it = m_storedContent.find(size);
+        if (it != m_storedContent.end() &&
+            std::memcmp(it->second.second->data(), data, size) == 0) {
+            md5id = it->second.first;
+            stored = true;
+        }
+    }
 
-    try {
-        auto& stmt = m_queries->putMap;
-        stmt.bind(1, z);
-        stmt.bind(2, _tileId.x);
-        stmt.bind(3, y);
-        stmt.bind(4, md5id);
-        stmt.exec();
+    if (!stored) {
+        MD5 md5;
+        md5id = md5(data, size);
 
-        stmt.reset();
+        if (size <= DEDUPLICATE_MAX_SIZE) {
+            if (m_storedContent.size() >= DEDUPLICATE_MAX_ENTRIES) { m_storedContent.clear(); }
+            m_storedContent[size] = { md5id, _data };
+        }
+    }
+
+    auto& putMap = m_writer->queries->putMap;
+    try {
+        putMap.bind(1, z);
+        putMap.bind(2, _tileId.x);
+        putMap.bind(3, y);
+        putMap.bind(4, md5id);
+        putMap.exec();
 
     } catch (std::exception& e) {
         LOGE("MBTiles SQLite put map statement failed: %s", e.what());
     }
-
     try {
-        auto& stmt = m_queries->putImage;
-        stmt.bind(1, md5id);
-        stmt.bind(2, data, size);
-        stmt.exec();
+        putMap.reset();
+    } catch(...) {}
 
-        stmt.reset();
+    if (stored) { return; }
+
+    auto& putImage = m_writer->queries->putImage;
+    try {
+        putImage.bind(1, md5id);
+        putImage.bind(2, data, size);
+        putImage.exec();
 
     } catch (std::exception& e) {
         LOGE("MBTiles SQLite put image statement failed: %s", e.what());
     }
+    try {
+        putImage.reset();
+    } catch(...) {}
 }
 
 }
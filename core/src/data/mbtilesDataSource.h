@@ -2,6 +2,14 @@
 
 #include "data/tileSource.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 namespace SQLite {
 class Database;
 }
@@ -11,14 +19,15 @@ namespace Tangram {
 
 class Platform;
 
-struct MBTilesQueries;
+struct MBTilesConnection;
 class AsyncWorker;
 
 class MBTilesDataSource : public TileSource::DataSource {
 public:
 
+    /* @_readers: number of read-only connections that load tiles in parallel */
     MBTilesDataSource(std::shared_ptr<Platform> _platform, std::string _name, std::string _path, std::string _mime,
-                      bool _cache = false, bool _offlineFallback = false);
+                      bool _cache = false, bool _offlineFallback = false, size_t _readers = 2);
 
     ~MBTilesDataSource();
 
@@ -26,11 +35,29 @@ public:
 
     void clear() override {}
 
+    std::string dataVersion() const override { return chainVersion(m_version); }
+
 private:
-    bool getTileData(const TileID& _tileId, std::vector<char>& _data);
-    void storeTileData(const TileID& _tileId, const std::vector<char>& _data);
+    using TileDataMap = std::map<TileID, std::shared_ptr<TileBuffer>>;
+
+    // Pending tile or tile data from the MBTiles store
+    std::shared_ptr<TileBuffer> readTileData(const TileID& _tileId);
+    bool getTileData(const TileID& _tileId, TileBuffer& _data);
+    bool getTileData(MBTilesConnection& _reader, const TileID& _tileId, TileBuffer& _data);
+
+    // Queue tile data to be stored by the writer thread
+    void storeTileData(const TileID& _tileId, std::shared_ptr<TileBuffer> _data);
+    bool isBatchFull() const;
+    void writeTiles();
+    void commitTiles(const TileDataMap& _tiles);
+    void writeTileData(const TileID& _tileId, const std::shared_ptr<TileBuffer>& _data);
+
     bool loadNextSource(std::shared_ptr<TileTask> _task, TileTaskCb _cb);
 
+    MBTilesConnection* acquireReader();
+    void releaseReader(MBTilesConnection* _reader);
+
+    std::unique_ptr<MBTilesConnection> openConnection(int _mode);
     void openMBTiles();
     bool testSchema(SQLite::Database& db);
     void initSchema(SQLite::Database& db, std::string _name, std::string _mimeType);
@@ -44,13 +71,41 @@ private:
     // Store tiles from next source
     bool m_cacheMode;
 
+    // File version of a read-only store, empty in cache and offline mode
+    std::string m_version;
+
     // Offline fallback: Try next source (download) first, then fall back to mbtiles
     bool m_offlineMode;
 
-    // Pointer to SQLite DB of MBTiles store
-    std::unique_ptr<SQLite::Database> m_db;
-    std::unique_ptr<MBTilesQueries> m_queries;
-    std::unique_ptr<AsyncWorker> m_worker;
+    size_t m_numReaders;
+
+    // Read-only connections to the MBTiles store, each used by one thread at a time
+    std::vector<std::unique_ptr<MBTilesConnection>> m_readers;
+    std::vector<MBTilesConnection*> m_freeReaders;
+    std::mutex m_readerMutex;
+    std::condition_variable m_readerCondition;
+
+    // Connection for storing tiles in cache mode
+    std::unique_ptr<MBTilesConnection> m_writer;
+
+    // Reset first in the destructor, its tasks use the connections and the
+    // pending tiles below
+    std::unique_ptr<AsyncWorker> m_readWorker;
+
+    // Tiles to be stored in the next transaction, and tiles of the running
+    // transaction. Both are read before the MBTiles store.
+    TileDataMap m_pendingTiles;
+    TileDataMap m_committingTiles;
+    size_t m_pendingBytes = 0;
+    std::chrono::steady_clock::time_point m_pendingSince;
+
+    bool m_writerRunning = true;
+    std::mutex m_writeMutex;
+    std::condition_variable m_writeCondition;
+    std::thread m_writeThread;
+
+    // MD5 ids and contents of recently stored small tiles by size
+    std::unordered_map<size_t, std::pair<std::string, std::shared_ptr<TileBuffer>>> m_storedContent;
 
     // Platform reference
     std::shared_ptr<Platform> m_platform;
@@ -4,81 +4,174 @@
 #include "tile/tileID.h"
 #include "log.h"
 
-#include <list>
+#include <atomic>
+#include <deque>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 
 namespace Tangram {
 
+// Number of independently locked parts of the cache
+#define NUM_SHARDS 8
+
+/* Raw tile data cache with CLOCK eviction
+ *
+ * Tiles are spread over shards by TileID. Lookups only take the read lock of
+ * their shard and mark the entry as referenced. Insertions evict entries of
+ * their shard in CLOCK order, skipping and unmarking referenced entries, so
+ * that recently used tiles survive one more round.
+ */
 struct RawCache {
 
-    // Used to ensure safe access from async loading threads
-    std::mutex m_mutex;
+    struct Entry {
+        TileID id = TileID(-1, -1, -1);
+        std::shared_ptr<TileBuffer> data;
+        std::atomic<bool> referenced{false};
+    };
+
+    struct Shard {
+        std::shared_timed_mutex mutex;
+
+        std::unordered_map<TileID, size_t> index;
+        // Entries in CLOCK order, stable in memory. Slots without data are
+        // listed in freeSlots.
+        std::deque<Entry> slots;
+        std::vector<size_t> freeSlots;
+        size_t hand = 0;
+
+        std::atomic<size_t> usage{0};
+    };
 
-    // LRU in-memory cache for raw tile data
-    using CacheEntry = std::pair<TileID, std::shared_ptr<std::vector<char>>>;
-    using CacheList = std::list<CacheEntry>;
-    using CacheMap = std::unordered_map<TileID, typename CacheList::iterator>;
+    Shard m_shards[NUM_SHARDS];
 
-    CacheMap m_cacheMap;
-    CacheList m_cacheList;
-    int m_usage = 0;
-    int m_maxUsage = 0;
+    std::atomic<size_t> m_maxUsage{0};
+
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+
+    static TileID key(const TileID& _tileId) {
+        return TileID(_tileId.x, _tileId.y, _tileId.z);
+    }
+
+    Shard& shard(const TileID& _id) {
+        return m_shards[std::hash<TileID>()(_id) % NUM_SHARDS];
+    }
+
+    size_t shardCapacity() const {
+        return m_maxUsage / NUM_SHARDS;
+    }
 
     bool get(BinaryTileTask& _task) {
 
-        if (m_maxUsage <= 0) { return false; }
+        if (m_maxUsage == 0) { return false; }
 
-        std::lock_guard<std::mutex> lock(m_mutex);
-        const auto& taskTileID = _task.tileId();
-        TileID id(taskTileID.x, taskTileID.y, taskTileID.z);
+        TileID id = key(_task.tileId());
+        auto& s = shard(id);
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(s.mutex);
 
-        auto it = m_cacheMap.find(id);
-        if (it != m_cacheMap.end()) {
-            // Move cached entry to start of list
-            m_cacheList.splice(m_cacheList.begin(), m_cacheList, it->second);
-            _task.rawTileData = m_cacheList.front().second;
+            auto it = s.index.find(id);
+            if (it != s.index.end()) {
+                auto& entry = s.slots[it->second];
+                entry.referenced.store(true, std::memory_order_relaxed);
+                _task.rawTileData = entry.data;
 
-            return true;
+                m_hits++;
+                return true;
+            }
         }
-
+        m_misses++;
         return false;
     }
-    void put(const TileID& tileID, std::shared_ptr<std::vector<char>> rawDataRef) {
 
-        if (m_maxUsage <= 0) { return; }
+    void put(const TileID& _tileId, std::shared_ptr<TileBuffer> _data) {
+
+        size_t capacity = shardCapacity();
+        if (capacity == 0 || _data->size() > capacity) { return; }
 
-        std::lock_guard<std::mutex> lock(m_mutex);
-        TileID id(tileID.x, tileID.y, tileID.z);
+        TileID id = key(_tileId);
+        auto& s = shard(id);
 
-        m_cacheList.push_front({id, rawDataRef});
-        m_cacheMap[id] = m_cacheList.begin();
+        std::unique_lock<std::shared_timed_mutex> lock(s.mutex);
 
-        m_usage += rawDataRef->size();
+        auto it = s.index.find(id);
+        if (it != s.index.end()) {
+            auto& entry = s.slots[it->second];
+            s.usage -= entry.data->size();
+            s.usage += _data->size();
+            entry.data = std::move(_data);
+            entry.referenced = true;
 
-        while (m_usage > m_maxUsage) {
-            if (m_cacheList.empty()) {
-                LOGE("Error: invalid cache state!");
-                m_usage = 0;
-                break;
+        } else {
+            size_t slot = s.slots.size();
+            if (!s.freeSlots.empty()) {
+                slot = s.freeSlots.back();
+                s.freeSlots.pop_back();
+            } else {
+                s.slots.emplace_back();
             }
+            auto& entry = s.slots[slot];
+            entry.id = id;
+            s.usage += _data->size();
+            entry.data = std::move(_data);
+            // New entries survive one round of the clock
+            entry.referenced = true;
+
+            s.index.emplace(id, slot);
+        }
+
+        evict(s, capacity);
+    }
+
+    void evict(Shard& _shard, size_t _capacity) {
+        while (_shard.usage > _capacity && !_shard.index.empty()) {
+            if (_shard.hand >= _shard.slots.size()) { _shard.hand = 0; }
 
-            // LOGE("Limit raw cache tiles:%d, %fMB ", m_cacheList.size(),
-            //        double(m_cacheUsage) / (1024*1024));
+            auto& entry = _shard.slots[_shard.hand++];
+            if (!entry.data) { continue; }
+
+            if (entry.referenced.exchange(false, std::memory_order_relaxed)) { continue; }
+
+            _shard.usage -= entry.data->size();
+            _shard.index.erase(entry.id);
+            _shard.freeSlots.push_back(_shard.hand - 1);
+            entry.data.reset();
+        }
+    }
 
-            auto& entry = m_cacheList.back();
-            m_usage -= entry.second->size();
+    void setMaxUsage(size_t _maxUsage) {
+        m_maxUsage = _maxUsage;
 
-            m_cacheMap.erase(entry.first);
-            m_cacheList.pop_back();
+        for (auto& s : m_shards) {
+            std::unique_lock<std::shared_timed_mutex> lock(s.mutex);
+            evict(s, shardCapacity());
         }
     }
 
     void clear() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_cacheMap.clear();
-        m_cacheList.clear();
-        m_usage = 0;
+        for (auto& s : m_shards) {
+            std::unique_lock<std::shared_timed_mutex> lock(s.mutex);
+            s.index.clear();
+            s.slots.clear();
+            s.freeSlots.clear();
+            s.hand = 0;
+            s.usage = 0;
+        }
+    }
+
+    MemoryCacheDataSource::Stats stats() {
+        MemoryCacheDataSource::Stats stats;
+        stats.hits = m_hits;
+        stats.misses = m_misses;
+        stats.maxUsage = m_maxUsage;
+
+        for (auto& s : m_shards) {
+            std::shared_lock<std::shared_timed_mutex> lock(s.mutex);
+            stats.usage += s.usage;
+            stats.entries += s.index.size();
+        }
+        return stats;
     }
 };
 
@@ -90,14 +183,18 @@ MemoryCacheDataSource::MemoryCacheDataSource() :
 MemoryCacheDataSource::~MemoryCacheDataSource() {}
 
 void MemoryCacheDataSource::setCacheSize(size_t _cacheSize) {
-    m_cache->m_maxUsage = _cacheSize;
+    m_cache->setMaxUsage(_cacheSize);
+}
+
+MemoryCacheDataSource::Stats MemoryCacheDataSource::stats() const {
+    return m_cache->stats();
 }
 
 bool MemoryCacheDataSource::cacheGet(BinaryTileTask& _task) {
     return m_cache->get(_task);
 }
 
-void MemoryCacheDataSource::cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef) {
+void MemoryCacheDataSource::cachePut(const TileID& _tileID, std::shared_ptr<TileBuffer> _rawDataRef) {
     m_cache->put(_tileID, _rawDataRef);
 }
 
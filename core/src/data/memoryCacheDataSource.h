@@ -14,15 +14,29 @@ public:
 
     void clear() override;
 
+    /* Holds copies of the data of the next DataSources */
+    std::string dataVersion() const override { return next ? next->dataVersion() : ""; }
+
     /* @_cacheSize: Set size of in-memory cache for tile data in bytes.
      * This cache holds unprocessed tile data for fast recreation of recently used tiles.
      */
     void setCacheSize(size_t _cacheSize);
 
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        // Bytes of cached tile data
+        size_t usage = 0;
+        size_t maxUsage = 0;
+        size_t entries = 0;
+    };
+
+    Stats stats() const;
+
 private:
     bool cacheGet(BinaryTileTask& _task);
 
-    void cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef);
+    void cachePut(const TileID& _tileID, std::shared_ptr<TileBuffer> _rawDataRef);
 
     std::unique_ptr<RawCache> m_cache;
 
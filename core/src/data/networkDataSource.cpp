@@ -3,14 +3,220 @@
 #include "log.h"
 #include "platform.h"
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+
 namespace Tangram {
 
+struct SourceRequests;
+
+/* Request for a tile URL, shared by all tasks that wait for it */
+struct TileRequest {
+    using Waiter = std::pair<std::shared_ptr<TileTask>, TileTaskCb>;
+    using Key = std::pair<const Platform*, std::string>;
+
+    Key key;
+    std::vector<Waiter> waiters;
+
+    // Source whose queue holds the request while it waits for the limiter
+    SourceRequests* queue = nullptr;
+
+    RequestLimiter::Clock::time_point start;
+    UrlRequestHandle handle = 0;
+    // Set when startUrlRequest returned the handle
+    bool started = false;
+    bool canceled = false;
+};
+
+/* Running tile requests of all NetworkDataSources by platform and URL, so
+ * that TileSources with the same URL template, overzoomed tiles and proxy
+ * tiles share one request */
+struct TileRequests {
+    std::mutex mutex;
+    std::map<TileRequest::Key, std::shared_ptr<TileRequest>> requests;
+};
+
+static TileRequests& tileRequests() {
+    // Not destroyed, requests may finish during static destruction
+    static TileRequests* instance = new TileRequests();
+    return *instance;
+}
+
+/* Requests started by a NetworkDataSource, shared with the callbacks of
+ * its running requests. Guarded by the mutex of TileRequests. */
+struct SourceRequests {
+    // Not owned, the callbacks of running requests keep SourceRequests alive
+    std::weak_ptr<Platform> platform;
+    RequestLimiter limiter;
+
+    // Requests waiting for the limiter
+    std::vector<std::shared_ptr<TileRequest>> queue;
+
+    SourceRequests(std::shared_ptr<Platform> _platform, RequestLimiter::Options _options)
+        : platform(_platform), limiter(_options) {}
+};
+
+// Most urgent priority of the tasks waiting for @_request
+static double requestPriority(const TileRequest& _request) {
+    double priority = std::numeric_limits<double>::max();
+    for (const auto& waiter : _request.waiters) {
+        priority = std::min(priority, waiter.first->getPriority());
+    }
+    return priority;
+}
+
+// Take the most urgent queued requests that the limiter allows to start.
+// Called with the mutex of TileRequests held.
+static std::vector<std::shared_ptr<TileRequest>> takeStartable(SourceRequests& _source) {
+    std::vector<std::shared_ptr<TileRequest>> startable;
+
+    while (!_source.queue.empty() && _source.limiter.canStart()) {
+        auto next = std::min_element(_source.queue.begin(), _source.queue.end(),
+                                     [](const std::shared_ptr<TileRequest>& _a,
+                                        const std::shared_ptr<TileRequest>& _b) {
+                                         return requestPriority(*_a) < requestPriority(*_b);
+                                     });
+        (*next)->queue = nullptr;
+        startable.push_back(std::move(*next));
+        _source.queue.erase(next);
+
+        _source.limiter.onStart();
+    }
+    return startable;
+}
+
+static void startRequest(std::shared_ptr<SourceRequests> _source, std::shared_ptr<TileRequest> _request) {
+
+    const auto& url = _request->key.second;
+    _request->start = RequestLimiter::Clock::now();
+
+    UrlCallback onRequestFinish = [_source, request = _request](UrlResponse&& response) {
+        auto& requests = tileRequests();
+        auto end = RequestLimiter::Clock::now();
+
+        std::vector<TileRequest::Waiter> waiters;
+        std::vector<std::shared_ptr<TileRequest>> startable;
+        {
+            std::lock_guard<std::mutex> lock(requests.mutex);
+
+            // A canceled request may have been replaced by a new one
+            auto it = requests.requests.find(request->key);
+            if (it != requests.requests.end() && it->second == request) {
+                requests.requests.erase(it);
+            }
+            std::swap(waiters, request->waiters);
+
+            // Exclude the time the request waited in the queue of the platform
+            auto start = std::max(request->start, response.transferStart);
+
+            auto& limiter = _source->limiter;
+            if (request->canceled) {
+                limiter.onCancel();
+            } else if (response.error) {
+                limiter.onFailure(start, end, RequestLimiter::isCongestion(response.httpStatus,
+                                                                           response.timedOut));
+            } else {
+                limiter.onSuccess(start, end);
+            }
+            startable = takeStartable(*_source);
+        }
+
+        for (auto& next : startable) { startRequest(_source, next); }
+
+        std::shared_ptr<TileBuffer> content;
+        if (response.error) {
+            LOGD("URL request '%s': %s", request->key.second.c_str(), response.error);
+        } else if (!response.content.empty()) {
+            content = TileBuffer::adopt(std::move(response.content));
+        }
+
+        for (auto& waiter : waiters) {
+            auto& task = waiter.first;
+
+            if (!task->source()) {
+                LOGW("URL Callback for deleted TileSource '%s'", request->key.second.c_str());
+                continue;
+            }
+            if (task->isCanceled()) { continue; }
+
+            // Without data the task is reported as failed
+            static_cast<BinaryTileTask&>(*task).rawTileData = content;
+            waiter.second.func(task);
+        }
+    };
+
+    UrlRequestPriority priority = [weakRequest = std::weak_ptr<TileRequest>(_request)]() {
+        auto request = weakRequest.lock();
+        if (!request) { return std::numeric_limits<double>::max(); }
+
+        std::lock_guard<std::mutex> lock(tileRequests().mutex);
+        return requestPriority(*request);
+    };
+
+    auto platform = _source->platform.lock();
+    if (!platform) {
+        std::lock_guard<std::mutex> lock(tileRequests().mutex);
+        tileRequests().requests.erase(_request->key);
+        _source->limiter.onCancel();
+        return;
+    }
+
+    auto handle = platform->startUrlRequestWithPriority(Url(url), onRequestFinish, priority);
+
+    bool canceled = false;
+    {
+        std::lock_guard<std::mutex> lock(tileRequests().mutex);
+        _request->handle = handle;
+        _request->started = true;
+        canceled = _request->canceled;
+
+        for (auto& waiter : _request->waiters) {
+            static_cast<BinaryTileTask&>(*waiter.first).urlRequestHandle = handle;
+        }
+    }
+    // All waiters canceled while the request was started
+    if (canceled) { platform->cancelUrlRequest(handle); }
+}
+
 NetworkDataSource::NetworkDataSource(std::shared_ptr<Platform> _platform, const std::string& _urlTemplate,
-        std::vector<std::string>&& _urlSubdomains, bool isTms) :
+        std::vector<std::string>&& _urlSubdomains, bool isTms, RequestLimiter::Options _limiterOptions) :
     m_platform(_platform),
     m_urlTemplate(_urlTemplate),
     m_urlSubdomains(std::move(_urlSubdomains)),
-    m_isTms(isTms) {}
+    m_isTms(isTms),
+    m_requests(std::make_shared<SourceRequests>(_platform, _limiterOptions)) {}
+
+constexpr std::chrono::seconds NetworkDataSource::DEFAULT_MAX_AGE;
+
+NetworkDataSource::~NetworkDataSource() {
+    std::vector<std::shared_ptr<TileRequest>> startable;
+    {
+        std::lock_guard<std::mutex> lock(tileRequests().mutex);
+
+        for (auto& request : m_requests->queue) {
+            request->queue = nullptr;
+
+            auto& waiters = request->waiters;
+            waiters.erase(std::remove_if(waiters.begin(), waiters.end(),
+                                         [](const TileRequest::Waiter& _waiter) {
+                                             return !_waiter.first->source();
+                                         }), waiters.end());
+
+            if (waiters.empty()) {
+                tileRequests().requests.erase(request->key);
+            } else {
+                // Tasks of other TileSources share the request
+                m_requests->limiter.onStart();
+                startable.push_back(request);
+            }
+        }
+        m_requests->queue.clear();
+    }
+    for (auto& request : startable) { startRequest(m_requests, request); }
+}
 
 std::string NetworkDataSource::buildUrlForTile(const TileID& tile, size_t subdomainIndex) const {
 
@@ -43,6 +249,14 @@ std::string NetworkDataSource::buildUrlForTile(const TileID& tile, size_t subdom
     return url;
 }
 
+std::string NetworkDataSource::urlForTile(const TileID& tile) const {
+    size_t subdomainIndex = 0;
+    if (!m_urlSubdomains.empty()) {
+        subdomainIndex = size_t(tile.x + tile.y) % m_urlSubdomains.size();
+    }
+    return buildUrlForTile(tile, subdomainIndex);
+}
+
 bool NetworkDataSource::loadTileData(std::shared_ptr<TileTask> task, TileTaskCb callback) {
 
     if (task->rawSource != this->level) {
@@ -50,50 +264,98 @@ bool NetworkDataSource::loadTileData(std::shared_ptr<TileTask> task, TileTaskCb
         return false;
     }
 
-    auto tileId = task->tileId();
-
-    Url url(buildUrlForTile(tileId, m_urlSubdomainIndex));
-
-    if (!m_urlSubdomains.empty()) {
-        m_urlSubdomainIndex = (m_urlSubdomainIndex + 1) % m_urlSubdomains.size();
-    }
+    auto& dlTask = static_cast<BinaryTileTask&>(*task);
+    auto key = std::make_pair(m_platform.get(), urlForTile(task->tileId()));
+    auto& requests = tileRequests();
 
-    UrlCallback onRequestFinish = [callback, task, url](UrlResponse&& response) {
+    std::shared_ptr<TileRequest> request;
+    {
+        std::lock_guard<std::mutex> lock(requests.mutex);
+        dlTask.urlRequestStarted = true;
 
-        auto source = task->source();
-        if (!source) {
-            LOGW("URL Callback for deleted TileSource '%s'", url.string().c_str());
-            return;
-        }
-        if (task->isCanceled()) {
-            return;
-        }
-        if (response.error) {
-            LOGD("URL request '%s': %s", url.string().c_str(), response.error);
-            return;
+        auto it = requests.requests.find(key);
+        if (it != requests.requests.end()) {
+            // Wait for the response of the running or queued request
+            it->second->waiters.emplace_back(task, callback);
+            return true;
         }
 
-        if (!response.content.empty()) {
-            auto& dlTask = static_cast<BinaryTileTask&>(*task);
-            dlTask.rawTileData = std::make_shared<std::vector<char>>(std::move(response.content));
+        request = std::make_shared<TileRequest>();
+        request->key = key;
+        request->waiters.emplace_back(task, callback);
+        requests.requests.emplace(key, request);
+
+        if (!m_requests->limiter.canStart()) {
+            request->queue = m_requests.get();
+            m_requests->queue.push_back(request);
+            return true;
         }
-        callback.func(task);
-    };
+        m_requests->limiter.onStart();
+    }
 
-    auto& dlTask = static_cast<BinaryTileTask&>(*task);
-    dlTask.urlRequestHandle = m_platform->startUrlRequest(url, onRequestFinish);
-    dlTask.urlRequestStarted = true;
+    startRequest(m_requests, request);
 
     return true;
 }
 
 void NetworkDataSource::cancelLoadingTile(TileTask& task) {
     auto& dlTask = static_cast<BinaryTileTask&>(task);
-    if (dlTask.urlRequestStarted) {
-        dlTask.urlRequestStarted = false;
+    if (!dlTask.urlRequestStarted) { return; }
+    dlTask.urlRequestStarted = false;
+
+    auto key = std::make_pair(m_platform.get(), urlForTile(task.tileId()));
+    auto& requests = tileRequests();
+
+    UrlRequestHandle handle = 0;
+    {
+        std::lock_guard<std::mutex> lock(requests.mutex);
+
+        auto it = requests.requests.find(key);
+        if (it == requests.requests.end()) { return; }
+
+        auto request = it->second;
+        auto& waiters = request->waiters;
 
-        m_platform->cancelUrlRequest(dlTask.urlRequestHandle);
+        waiters.erase(std::remove_if(waiters.begin(), waiters.end(),
+                                     [&](const TileRequest::Waiter& _waiter) {
+                                         return _waiter.first.get() == &task;
+                                     }), waiters.end());
+
+        // Only abort the request when no task is waiting for it anymore
+        if (!waiters.empty()) { return; }
+
+        request->canceled = true;
+        requests.requests.erase(it);
+
+        if (request->queue) {
+            auto& queue = request->queue->queue;
+            queue.erase(std::find(queue.begin(), queue.end(), request));
+            request->queue = nullptr;
+            return;
+        }
+
+        // Otherwise canceled when startUrlRequest returns
+        if (!request->started) { return; }
+        handle = request->handle;
     }
+    m_platform->cancelUrlRequest(handle);
+}
+
+std::string NetworkDataSource::dataVersion() const {
+    std::stringstream version;
+    version << m_urlTemplate;
+    for (const auto& subdomain : m_urlSubdomains) { version << ',' << subdomain; }
+    if (m_isTms) { version << ",tms"; }
+    return chainVersion(version.str());
+}
+
+NetworkDataSource::Metrics NetworkDataSource::metrics() const {
+    std::lock_guard<std::mutex> lock(tileRequests().mutex);
+
+    Metrics metrics;
+    metrics.limiter = m_requests->limiter.metrics();
+    metrics.queued = m_requests->queue.size();
+    return metrics;
 }
 
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "data/requestLimiter.h"
 #include "data/tileSource.h"
 #include "platform.h"
 
@@ -8,28 +9,63 @@
 namespace Tangram {
 
 class Platform;
+struct SourceRequests;
 
+/* Requests tiles with the URL requests of the Platform
+ *
+ * The number of concurrent requests adapts to the latency and errors of the
+ * responses (see RequestLimiter). Requests beyond the limit wait and are
+ * started by the priority of their tasks.
+ */
 class NetworkDataSource : public TileSource::DataSource {
 public:
 
+    // Default of maxAge(), platforms do not expose the caching headers of responses
+    static constexpr std::chrono::seconds DEFAULT_MAX_AGE = std::chrono::hours(24);
+
     NetworkDataSource(std::shared_ptr<Platform> _platform, const std::string& _urlTemplate,
-                      std::vector<std::string>&& _urlSubdomains, bool _isTms);
+                      std::vector<std::string>&& _urlSubdomains, bool _isTms,
+                      RequestLimiter::Options _limiterOptions = RequestLimiter::Options());
+
+    ~NetworkDataSource();
 
     bool loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override;
 
     void cancelLoadingTile(TileTask& _task) override;
 
+    /* The URL template, subdomains and TMS flag, tiles of the same URL are
+     * assumed to change only after maxAge() */
+    std::string dataVersion() const override;
+
+    std::chrono::seconds maxAge() const override { return m_maxAge; }
+    void setMaxAge(std::chrono::seconds _maxAge) { m_maxAge = _maxAge; }
+
+    struct Metrics {
+        RequestLimiter::Metrics limiter;
+        // Requests waiting for the limiter
+        size_t queued = 0;
+    };
+
+    Metrics metrics() const;
+
 private:
     // Build the URL of a tile using our URL template.
     std::string buildUrlForTile(const TileID& _tile, size_t _subdomainIndex) const;
 
+    // URL of a tile with a subdomain chosen by its coordinates, so that
+    // requests for the same tile resolve to the same URL
+    std::string urlForTile(const TileID& _tile) const;
+
     std::shared_ptr<Platform> m_platform;
 
     // URL template for requesting tiles from a network or filesystem
     std::string m_urlTemplate;
     std::vector<std::string> m_urlSubdomains;
-    size_t m_urlSubdomainIndex = 0;
     bool m_isTms = false;
+
+    std::chrono::seconds m_maxAge = DEFAULT_MAX_AGE;
+
+    std::shared_ptr<SourceRequests> m_requests;
 };
 
 }
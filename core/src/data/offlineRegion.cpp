@@ -0,0 +1,293 @@
+#include "data/offlineRegion.h"
+
+#include "data/networkDataSource.h"
+#include "data/tileSource.h"
+#include "log.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+
+#ifdef TANGRAM_MBTILES_DATASOURCE
+#include "data/mbtilesDataSource.h"
+#endif
+
+#include "glm/vec2.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+
+// Tile coordinates do not fit into TileID beyond this zoom
+#define MAX_REGION_ZOOM 24
+
+namespace Tangram {
+
+struct OfflineDownloadState {
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    OfflineDownload::Progress progress;
+
+    // Requested tiles which did not complete yet
+    std::vector<std::shared_ptr<TileTask>> requests;
+};
+
+// Even-odd rule
+static bool isInside(const std::vector<glm::dvec2>& _polygon, glm::dvec2 _point) {
+    bool inside = false;
+    for (size_t i = 0, j = _polygon.size() - 1; i < _polygon.size(); j = i++) {
+        const auto& a = _polygon[i];
+        const auto& b = _polygon[j];
+        if ((a.y > _point.y) != (b.y > _point.y) &&
+            _point.x < (b.x - a.x) * (_point.y - a.y) / (b.y - a.y) + a.x) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+// Liang-Barsky clipping of the segment from @_a to @_b. Segments that only
+// touch the border of the box do not intersect it.
+static bool intersects(glm::dvec2 _a, glm::dvec2 _b, glm::dvec2 _min, glm::dvec2 _max) {
+    double t0 = 0, t1 = 1;
+    glm::dvec2 d = _b - _a;
+
+    const double p[4] = { -d.x, d.x, -d.y, d.y };
+    const double q[4] = { _a.x - _min.x, _max.x - _a.x, _a.y - _min.y, _max.y - _a.y };
+
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0) {
+            if (q[i] <= 0) { return false; }
+            continue;
+        }
+        double t = q[i] / p[i];
+        if (p[i] < 0) {
+            t0 = std::max(t0, t);
+        } else {
+            t1 = std::min(t1, t);
+        }
+    }
+    return t0 < t1;
+}
+
+static bool intersects(const std::vector<glm::dvec2>& _polygon, glm::dvec2 _min, glm::dvec2 _max) {
+    // Tile inside of the polygon
+    if (isInside(_polygon, (_min + _max) * 0.5)) { return true; }
+
+    // Polygon inside of the tile or crossing its border
+    for (size_t i = 0, j = _polygon.size() - 1; i < _polygon.size(); j = i++) {
+        if (intersects(_polygon[j], _polygon[i], _min, _max)) { return true; }
+    }
+    return false;
+}
+
+OfflineRegion OfflineRegion::fromBounds(LngLat _southWest, LngLat _northEast,
+                                        int32_t _minZoom, int32_t _maxZoom) {
+    return OfflineRegion({
+            _southWest,
+            { _northEast.longitude, _southWest.latitude },
+            _northEast,
+            { _southWest.longitude, _northEast.latitude }
+        }, _minZoom, _maxZoom);
+}
+
+std::vector<TileID> OfflineRegion::tileIDs() const {
+    std::vector<TileID> tiles;
+    if (polygon.size() < 3) { return tiles; }
+
+    // Polygon in tile coordinates of zoom 0
+    std::vector<glm::dvec2> points;
+    glm::dvec2 min(1), max(0);
+
+    const double maxLat = MapProjection::MAX_LATITUDE_DEGREES;
+    const double size = MapProjection::EARTH_CIRCUMFERENCE_METERS;
+
+    for (const auto& lngLat : polygon) {
+        auto meters = MapProjection::lngLatToProjectedMeters({
+                lngLat.longitude, std::min(std::max(lngLat.latitude, -maxLat), maxLat) });
+
+        glm::dvec2 point(0.5 + meters.x / size, 0.5 - meters.y / size);
+        points.push_back(point);
+
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    for (int32_t z = std::max(minZoom, 0); z <= std::min(maxZoom, MAX_REGION_ZOOM); z++) {
+        int32_t maxTile = (1 << z) - 1;
+        double scale = 1 << z;
+
+        int32_t x0 = std::max(int32_t(std::floor(min.x * scale)), 0);
+        int32_t x1 = std::min(int32_t(std::floor(max.x * scale)), maxTile);
+        int32_t y0 = std::max(int32_t(std::floor(min.y * scale)), 0);
+        int32_t y1 = std::min(int32_t(std::floor(max.y * scale)), maxTile);
+
+        for (int32_t y = y0; y <= y1; y++) {
+            for (int32_t x = x0; x <= x1; x++) {
+                glm::dvec2 tileMin(x / scale, y / scale);
+                glm::dvec2 tileMax((x + 1) / scale, (y + 1) / scale);
+
+                if (intersects(points, tileMin, tileMax)) {
+                    tiles.emplace_back(x, y, z);
+                }
+            }
+        }
+    }
+    return tiles;
+}
+
+OfflineDownload::OfflineDownload(std::shared_ptr<TileSource> _source, OfflineRegion _region,
+                                 size_t _maxRequests)
+    : m_source(_source),
+      m_maxRequests(std::max(_maxRequests, size_t(1))),
+      m_state(std::make_shared<OfflineDownloadState>()) {
+
+    // Tiles beyond the maximum zoom of the source do not exist
+    _region.maxZoom = std::min(_region.maxZoom, m_source->maxZoom());
+    m_tiles = _region.tileIDs();
+
+    m_state->progress.total = m_tiles.size();
+}
+
+OfflineDownload::~OfflineDownload() {
+    cancel();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void OfflineDownload::start(ProgressCallback _callback) {
+    if (m_thread.joinable()) {
+        LOGW("Offline download for '%s' was started already", m_source->name().c_str());
+        return;
+    }
+    m_thread = std::thread(&OfflineDownload::run, this, std::move(_callback));
+}
+
+void OfflineDownload::run(ProgressCallback _callback) {
+    auto state = m_state;
+
+    TileTaskCb cb{[state](std::shared_ptr<TileTask> _task) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+
+            // Ignore canceled requests
+            auto it = std::find(state->requests.begin(), state->requests.end(), _task);
+            if (it == state->requests.end()) { return; }
+            state->requests.erase(it);
+
+            if (_task->hasData()) {
+                state->progress.completed++;
+            } else {
+                state->progress.failed++;
+            }
+        }
+        state->condition.notify_all();
+    }};
+
+    size_t next = 0;
+    size_t reported = 0;
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    auto& progress = state->progress;
+
+    while (!progress.canceled) {
+
+        while (next < m_tiles.size() && state->requests.size() < m_maxRequests) {
+            auto task = m_source->createTask(m_tiles[next++]);
+            state->requests.push_back(task);
+
+            lock.unlock();
+            m_source->loadTileData(task, cb);
+            lock.lock();
+
+            // No DataSource of the chain could load the tile
+            if (task->needsLoading()) {
+                auto it = std::find(state->requests.begin(), state->requests.end(), task);
+                if (it != state->requests.end()) {
+                    state->requests.erase(it);
+                    progress.failed++;
+                }
+            }
+            if (progress.canceled) { break; }
+        }
+
+        if (next == m_tiles.size() && state->requests.empty() && !progress.canceled) {
+            progress.done = true;
+        }
+
+        bool changed = progress.completed + progress.failed != reported;
+        reported = progress.completed + progress.failed;
+
+        if (_callback && (changed || progress.done)) {
+            Progress current = progress;
+
+            lock.unlock();
+            _callback(current);
+            lock.lock();
+        }
+
+        if (progress.done) { break; }
+
+        state->condition.wait(lock, [&]{
+            return progress.canceled || progress.completed + progress.failed != reported;
+        });
+    }
+
+    if (progress.canceled && _callback) {
+        Progress current = progress;
+        lock.unlock();
+        _callback(current);
+    }
+}
+
+void OfflineDownload::cancel() {
+    std::vector<std::shared_ptr<TileTask>> requests;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        if (m_state->progress.done || m_state->progress.canceled) { return; }
+
+        m_state->progress.canceled = true;
+        std::swap(requests, m_state->requests);
+    }
+    m_state->condition.notify_all();
+
+    for (auto& task : requests) {
+        task->cancel();
+        m_source->cancelLoadingTile(*task);
+    }
+}
+
+bool OfflineDownload::wait() {
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    auto current = progress();
+    return current.done && current.failed == 0;
+}
+
+OfflineDownload::Progress OfflineDownload::progress() const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->progress;
+}
+
+std::shared_ptr<TileSource> OfflineDownload::createSource(std::shared_ptr<Platform> _platform,
+                                                          const std::string& _name,
+                                                          const std::string& _urlTemplate,
+                                                          const std::string& _mbtilesPath,
+                                                          std::vector<std::string> _subdomains,
+                                                          bool _isTms) {
+#ifdef TANGRAM_MBTILES_DATASOURCE
+    auto rawSources = std::make_unique<MBTilesDataSource>(_platform, _name, _mbtilesPath, "", true);
+    rawSources->setNext(std::make_unique<NetworkDataSource>(_platform, _urlTemplate,
+                                                            std::move(_subdomains), _isTms));
+
+    return std::make_shared<TileSource>(_name, std::move(rawSources));
+#else
+    LOGE("MBTiles support is disabled. Cannot store offline tiles of source: %s", _name.c_str());
+    return nullptr;
+#endif
+}
+
+}
@@ -21,41 +21,47 @@ Properties::~Properties() {}
 
 Properties& Properties::operator=(Properties&& _other) {
     props = std::move(_other.props);
+    values = std::move(_other.values);
     sourceId = _other.sourceId;
     return *this;
 }
 
-void Properties::setSorted(std::vector<Item>&& _items) {
+void Properties::setSorted(std::vector<Item>&& _items, std::shared_ptr<PropertyValues> _values) {
     props = std::move(_items);
+    values = std::move(_values);
 }
 
 const Value& Properties::get(const std::string& key) const {
+    return get(PropertyKey::find(key));
+}
+
+const Value& Properties::get(PropertyKey key) const {
+    if (!key.isValid()) { return NOT_A_VALUE; }
 
-    const auto it = std::find_if(props.begin(), props.end(),
-                                 [&](const auto& item) {
-                                     return item.key == key;
-                                 });
-    if (it == props.end()) {
+    const auto it = std::lower_bound(props.begin(), props.end(), key,
+                                     [](const Item& item, PropertyKey key) {
+                                         return item.key < key;
+                                     });
+    if (it == props.end() || it->key != key) {
         return NOT_A_VALUE;
     }
 
-    // auto it = std::lower_bound(props.begin(), props.end(), key,
-    //                            [](auto& item, auto& key) {
-    //                                return keyComparator(item.key, key);
-    //                            });
-    // if (it == props.end() || it->key != key) {
-    //     return NOT_FOUND;
-    // }
-
-    return it->value;
+    return *it->value;
 }
 
-void Properties::clear() { props.clear(); }
+void Properties::clear() {
+    props.clear();
+    values.reset();
+}
 
 bool Properties::contains(const std::string& key) const {
     return !get(key).is<none_type>();
 }
 
+bool Properties::contains(PropertyKey key) const {
+    return !get(key).is<none_type>();
+}
+
 bool Properties::getNumber(const std::string& key, double& value) const {
     auto& it = get(key);
     if (it.is<double>()) {
@@ -126,30 +132,35 @@ void Properties::sort() {
 }
 
 void Properties::set(std::string key, std::string value) {
-
-    auto it = std::lower_bound(props.begin(), props.end(), key,
-                               [](auto& item, auto& key) {
-                                   return keyComparator(item.key, key);
-                               });
-
-    if (it == props.end() || it->key != key) {
-        props.emplace(it, std::move(key), std::move(value));
-    } else {
-        it->value = std::move(value);
-    }
+    set(PropertyKey::intern(key), Value(std::move(value)));
 }
 
 void Properties::set(std::string key, double value) {
+    set(PropertyKey::intern(key), Value(value));
+}
+
+void Properties::set(PropertyKey key, Value value) {
+
+    // Copy the values that are shared with other Properties
+    if (!values || values.use_count() > 1) {
+        auto ownValues = std::make_shared<PropertyValues>();
+        for (auto& item : props) {
+            ownValues->push_back(*item.value);
+            item.value = &ownValues->back();
+        }
+        values = std::move(ownValues);
+    }
 
     auto it = std::lower_bound(props.begin(), props.end(), key,
-                               [](auto& item, auto& key) {
-                                   return keyComparator(item.key, key);
+                               [](const Item& item, PropertyKey key) {
+                                   return item.key < key;
                                });
 
     if (it == props.end() || it->key != key) {
-        props.emplace(it, std::move(key), value);
+        values->push_back(std::move(value));
+        props.emplace(it, key, &values->back());
     } else {
-        it->value = value;
+        *const_cast<Value*>(it->value) = std::move(value);
     }
 }
 
@@ -159,7 +170,7 @@ std::string Properties::toJson() const {
 
     for (const auto& item : props) {
         bool last = (&item == &props.back());
-        json += "\"" + item.key + "\": \"" + asString(item.value) + (last ? "\"" : "\",");
+        json += "\"" + item.key.name() + "\": \"" + asString(*item.value) + (last ? "\"" : "\",");
     }
 
     json += " }";
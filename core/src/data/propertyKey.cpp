@@ -0,0 +1,149 @@
+#include "data/propertyKey.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Tangram {
+
+/* Open addressing hash table of the key ids by name, with at most half of
+ * its slots used. Ids and names are only added, and each is published with a
+ * release store after it was written, so that keys are found and named
+ * without a lock. Only intern() of a new name locks.
+ *
+ * The table grows by rehashing into twice the slots. Replaced slot arrays are
+ * kept, as readers may still probe them. Names are stored in blocks of
+ * doubling size which never move. */
+struct PropertyKeyTable {
+    static constexpr uint32_t INITIAL_SLOTS = 1024;
+    static constexpr uint32_t FIRST_BLOCK_SIZE = 256;
+    // Blocks for all 32 bit ids
+    static constexpr uint32_t NUM_BLOCKS = 24;
+
+    struct Slots {
+        explicit Slots(uint32_t _size) : mask(_size - 1), ids(new std::atomic<uint32_t>[_size]) {
+            for (uint32_t i = 0; i < _size; i++) { ids[i].store(0, std::memory_order_relaxed); }
+        }
+        // Number of slots - 1, the number of slots is a power of two
+        uint32_t mask;
+        // Key ids, 0 for empty slots
+        std::unique_ptr<std::atomic<uint32_t>[]> ids;
+    };
+
+    std::mutex mutex;
+    uint32_t count = 0;
+
+    std::atomic<Slots*> slots;
+    std::vector<std::unique_ptr<Slots>> allSlots;
+
+    // Names by id - 1, block k holds FIRST_BLOCK_SIZE << k names
+    std::atomic<std::string*> blocks[NUM_BLOCKS];
+
+    PropertyKeyTable() {
+        allSlots.emplace_back(new Slots(INITIAL_SLOTS));
+        slots.store(allSlots.back().get(), std::memory_order_relaxed);
+        for (auto& block : blocks) { block.store(nullptr, std::memory_order_relaxed); }
+    }
+
+    static uint32_t blockOf(uint32_t _index, uint32_t& _offset) {
+        uint32_t block = 0;
+        uint32_t size = FIRST_BLOCK_SIZE;
+        while (_index >= size) {
+            _index -= size;
+            size <<= 1;
+            block++;
+        }
+        _offset = _index;
+        return block;
+    }
+
+    const std::string& name(uint32_t _id) const {
+        uint32_t offset = 0;
+        uint32_t block = blockOf(_id - 1, offset);
+        return blocks[block].load(std::memory_order_acquire)[offset];
+    }
+
+    // Slot of @_name in @_slots, or the empty slot where it would be added
+    uint32_t findSlot(const Slots& _slots, const std::string& _name, uint32_t& _id) const {
+        uint32_t slot = std::hash<std::string>()(_name) & _slots.mask;
+        while (true) {
+            _id = _slots.ids[slot].load(std::memory_order_acquire);
+            if (_id == 0 || name(_id) == _name) { return slot; }
+            slot = (slot + 1) & _slots.mask;
+        }
+    }
+
+    // Called with the mutex held
+    void grow() {
+        auto& current = *slots.load(std::memory_order_relaxed);
+        std::unique_ptr<Slots> larger(new Slots(2 * (current.mask + 1)));
+        for (uint32_t id = 1; id <= count; id++) {
+            uint32_t existing = 0;
+            uint32_t slot = findSlot(*larger, name(id), existing);
+            larger->ids[slot].store(id, std::memory_order_relaxed);
+        }
+        slots.store(larger.get(), std::memory_order_release);
+        allSlots.push_back(std::move(larger));
+    }
+};
+
+static PropertyKeyTable& table() {
+    // Not destroyed, keys may be used during static destruction
+    static PropertyKeyTable* instance = new PropertyKeyTable();
+    return *instance;
+}
+
+PropertyKey PropertyKey::intern(const std::string& _name) {
+    auto key = find(_name);
+    if (key.isValid()) { return key; }
+
+    auto& keys = table();
+    std::lock_guard<std::mutex> lock(keys.mutex);
+
+    uint32_t id = 0;
+    keys.findSlot(*keys.slots.load(std::memory_order_relaxed), _name, id);
+    if (id != 0) { return PropertyKey(id); }
+
+    if (2 * (keys.count + 1) > keys.slots.load(std::memory_order_relaxed)->mask + 1) {
+        keys.grow();
+    }
+    auto& slots = *keys.slots.load(std::memory_order_relaxed);
+    uint32_t slot = keys.findSlot(slots, _name, id);
+
+    uint32_t offset = 0;
+    uint32_t block = PropertyKeyTable::blockOf(keys.count, offset);
+    std::string* names = keys.blocks[block].load(std::memory_order_relaxed);
+    if (!names) {
+        names = new std::string[PropertyKeyTable::FIRST_BLOCK_SIZE << block];
+        keys.blocks[block].store(names, std::memory_order_release);
+    }
+    names[offset] = _name;
+
+    id = ++keys.count;
+    slots.ids[slot].store(id, std::memory_order_release);
+    return PropertyKey(id);
+}
+
+PropertyKey PropertyKey::find(const std::string& _name) {
+    auto& keys = table();
+    uint32_t id = 0;
+    keys.findSlot(*keys.slots.load(std::memory_order_acquire), _name, id);
+    return PropertyKey(id);
+}
+
+const std::string& PropertyKey::name() const {
+    static const std::string EMPTY_STRING = "";
+    if (m_id == 0) { return EMPTY_STRING; }
+
+    return table().name(m_id);
+}
+
+uint32_t PropertyKey::count() {
+    auto& keys = table();
+    std::lock_guard<std::mutex> lock(keys.mutex);
+    return keys.count;
+}
+
+}
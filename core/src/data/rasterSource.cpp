@@ -31,7 +31,7 @@ public:
         }
     }
 
-    void process(TileBuilder& _tileBuilder) override {
+    void parse() override {
         auto source = rasterSource();
         if (!source) { return; }
 
@@ -40,6 +40,16 @@ public:
             m_texture = source->createTexture(m_tileId, *rawTileData);
         }
 
+        if (isSubTask()) {
+            m_parsed = true;
+        } else {
+            BinaryTileTask::parse();
+        }
+    }
+
+    void process(TileBuilder& _tileBuilder) override {
+        if (!m_parsed) { parse(); }
+
         // Create tile geometries
         if (!isSubTask()) {
             BinaryTileTask::process(_tileBuilder);
@@ -82,7 +92,7 @@ RasterSource::RasterSource(const std::string& _name, std::unique_ptr<DataSource>
     m_emptyTexture = std::make_shared<Texture>(m_texOptions);
 }
 
-std::shared_ptr<Texture> RasterSource::createTexture(TileID _tile, const std::vector<char>& _rawTileData) {
+std::shared_ptr<Texture> RasterSource::createTexture(TileID _tile, const TileBuffer& _rawTileData) {
     if (_rawTileData.empty()) {
         return m_emptyTexture;
     }
@@ -120,13 +130,12 @@ std::shared_ptr<TileData> RasterSource::parse(const TileTask& _task) const {
 
     Feature rasterFeature;
     rasterFeature.geometryType = GeometryType::polygons;
-    rasterFeature.polygons = { { {
-                                         {0.0f, 0.0f},
-                                         {1.0f, 0.0f},
-                                         {1.0f, 1.0f},
-                                         {0.0f, 1.0f},
-                                         {0.0f, 0.0f}
-                                 } } };
+    for (const auto& point : { Point{0.0f, 0.0f}, Point{1.0f, 0.0f}, Point{1.0f, 1.0f},
+                               Point{0.0f, 1.0f}, Point{0.0f, 0.0f} }) {
+        tileData->geometry.addPoint(point);
+    }
+    tileData->geometry.endPart();
+    rasterFeature.geometry = tileData->geometry.endFeature();
     rasterFeature.props = Properties();
 
     tileData->layers.emplace_back("");
@@ -40,7 +40,7 @@ public:
 
     virtual bool isRaster() const override { return true; }
 
-    std::shared_ptr<Texture> createTexture(TileID _tile, const std::vector<char>& _rawTileData);
+    std::shared_ptr<Texture> createTexture(TileID _tile, const TileBuffer& _rawTileData);
 
     Raster getRaster(const TileTask& _task);
 
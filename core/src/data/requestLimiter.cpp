@@ -0,0 +1,102 @@
+#include "data/requestLimiter.h"
+
+#include <algorithm>
+#include <limits>
+
+// Weight of a new sample in the moving average of the latency
+#define LATENCY_SMOOTHING 0.2
+// Number of responses before the moving average is used for the base latency
+#define LATENCY_WARMUP 5
+
+namespace Tangram {
+
+static double milliseconds(RequestLimiter::Clock::duration _duration) {
+    return std::chrono::duration<double, std::milli>(_duration).count();
+}
+
+RequestLimiter::RequestLimiter(Options _options)
+    : m_options(_options),
+      m_limit(std::min(std::max(_options.initialLimit, _options.minLimit), _options.maxLimit)),
+      m_previousMinLatency(std::numeric_limits<double>::max()),
+      m_windowMinLatency(std::numeric_limits<double>::max()) {}
+
+bool RequestLimiter::canStart() const {
+    return m_inFlight < std::max(size_t(m_limit), size_t(1));
+}
+
+void RequestLimiter::onStart() {
+    m_inFlight++;
+}
+
+void RequestLimiter::onSuccess(Clock::time_point _start, Clock::time_point _end) {
+    // Most of the limit was in use when this request was running
+    bool limited = m_inFlight * 2 >= m_limit;
+
+    if (m_inFlight > 0) { m_inFlight--; }
+    m_succeeded++;
+
+    double latency = milliseconds(_end - _start);
+    m_latency = m_succeeded == 1 ? latency :
+        m_latency + (latency - m_latency) * LATENCY_SMOOTHING;
+
+    // The base latency is the lowest moving average, so that it compares with
+    // the moving average and not with the fastest single response
+    if (m_succeeded > LATENCY_WARMUP) {
+        m_windowMinLatency = std::min(m_windowMinLatency, m_latency);
+        if (++m_windowSamples >= m_options.baseLatencyWindow) {
+            m_previousMinLatency = m_windowMinLatency;
+            m_windowMinLatency = std::numeric_limits<double>::max();
+            m_windowSamples = 0;
+        }
+    }
+    double baseLatency = std::min(m_previousMinLatency, m_windowMinLatency);
+
+    // A single slow response may just have been a dense tile
+    if (m_latency > baseLatency * m_options.latencyTolerance) {
+        decrease(_start, _end);
+        return;
+    }
+
+    if (limited) {
+        m_limit = std::min(m_limit + 1 / m_limit, m_options.maxLimit);
+    }
+}
+
+bool RequestLimiter::isCongestion(int _httpStatus, bool _timedOut) {
+    return _timedOut || _httpStatus == 429 || _httpStatus >= 500;
+}
+
+void RequestLimiter::onFailure(Clock::time_point _start, Clock::time_point _end, bool _congestion) {
+    if (m_inFlight > 0) { m_inFlight--; }
+    m_failed++;
+
+    if (_congestion) { decrease(_start, _end); }
+}
+
+void RequestLimiter::onCancel() {
+    if (m_inFlight > 0) { m_inFlight--; }
+}
+
+void RequestLimiter::decrease(Clock::time_point _start, Clock::time_point _end) {
+    // Started before the last decrease took effect
+    if (m_decreases > 0 && _start < m_lastDecrease) { return; }
+
+    m_limit = std::max(m_limit * m_options.backoff, m_options.minLimit);
+    m_lastDecrease = _end;
+    m_decreases++;
+}
+
+RequestLimiter::Metrics RequestLimiter::metrics() const {
+    Metrics metrics;
+    metrics.limit = m_limit;
+    metrics.inFlight = m_inFlight;
+    double baseLatency = std::min(m_previousMinLatency, m_windowMinLatency);
+    metrics.baseLatencyMs = baseLatency == std::numeric_limits<double>::max() ? 0 : baseLatency;
+    metrics.latencyMs = m_latency;
+    metrics.succeeded = m_succeeded;
+    metrics.failed = m_failed;
+    metrics.decreases = m_decreases;
+    return metrics;
+}
+
+}
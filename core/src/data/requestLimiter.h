@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Tangram {
+
+/* Adaptive limit of concurrent requests to a tile server
+ *
+ * Additive increase, multiplicative decrease: The limit grows by up to one
+ * request per round trip while responses arrive quickly and at least half of
+ * the limit is in use. It is reduced when a request fails because of congestion, or when
+ * the moving average of the latency exceeds a multiple of the base latency, the lowest
+ * moving average of the recent requests. Single slow responses, e.g. of dense tiles, do
+ * not reduce the limit. Latencies are measured from the start of the transfer, so that time spent
+ * waiting in the queue of the platform does not count.
+ * Only requests which started after the last reduction can reduce the limit
+ * again, so that a burst of slow responses counts once.
+ *
+ * Not thread-safe, callers synchronize access.
+ */
+class RequestLimiter {
+
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        double initialLimit = 4;
+        double minLimit = 1;
+        double maxLimit = 32;
+        // Factor applied to the limit on congestion
+        double backoff = 0.5;
+        // Average latencies beyond this multiple of the base latency signal congestion
+        double latencyTolerance = 2;
+        // Number of requests after which the base latency is measured anew
+        uint32_t baseLatencyWindow = 100;
+    };
+
+    struct Metrics {
+        double limit = 0;
+        size_t inFlight = 0;
+        double baseLatencyMs = 0;
+        // Moving average of the request latency
+        double latencyMs = 0;
+        uint64_t succeeded = 0;
+        uint64_t failed = 0;
+        uint64_t decreases = 0;
+    };
+
+    RequestLimiter() : RequestLimiter(Options()) {}
+    explicit RequestLimiter(Options _options);
+
+    /* Whether another request may start */
+    bool canStart() const;
+
+    void onStart();
+
+    /* Whether a failed request signals an overloaded server: a timeout, HTTP 429
+     * or 5xx. Other errors, e.g. 404, do not reduce the limit. */
+    static bool isCongestion(int _httpStatus, bool _timedOut);
+
+    /* Record the result of a request started at @_start. Failures reduce the
+     * limit only on @_congestion. */
+    void onSuccess(Clock::time_point _start, Clock::time_point _end);
+    void onFailure(Clock::time_point _start, Clock::time_point _end, bool _congestion);
+
+    /* Canceled requests do not affect the limit */
+    void onCancel();
+
+    Metrics metrics() const;
+
+private:
+
+    void decrease(Clock::time_point _start, Clock::time_point _end);
+
+    Options m_options;
+
+    double m_limit;
+    size_t m_inFlight = 0;
+
+    // Lowest latency of the previous and the current window
+    double m_previousMinLatency;
+    double m_windowMinLatency;
+    uint32_t m_windowSamples = 0;
+
+    double m_latency = 0;
+    Clock::time_point m_lastDecrease;
+
+    uint64_t m_succeeded = 0;
+    uint64_t m_failed = 0;
+    uint64_t m_decreases = 0;
+};
+
+}
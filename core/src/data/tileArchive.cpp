@@ -0,0 +1,312 @@
+#include "data/tileArchive.h"
+
+#include "log.h"
+#include "util/url.h"
+
+#ifdef TANGRAM_MBTILES_DATASOURCE
+#include <SQLiteCpp/Database.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define ARCHIVE_VERSION 1
+
+namespace Tangram {
+
+static const char MAGIC[4] = { 'T', 'G', 'T', 'A' };
+
+static_assert(sizeof(TileArchive::Header) == 48, "Unexpected archive header size");
+static_assert(sizeof(TileArchive::Entry) == 24, "Unexpected archive entry size");
+
+TileArchive::TileArchive(const std::string& _path) {
+
+    auto url = Url(_path);
+    if (url.scheme() == "asset") {
+        LOGE("Tile archives cannot be mapped from assets: %s", _path.c_str());
+        return;
+    }
+    auto path = url.path();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOGE("Unable to open tile archive: %s", path.c_str());
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(Header)) {
+        LOGE("Invalid tile archive: %s", path.c_str());
+        close(fd);
+        return;
+    }
+
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps the file open
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        LOGE("Unable to map tile archive: %s", path.c_str());
+        return;
+    }
+
+    auto bytes = static_cast<const char*>(data);
+    size_t size = st.st_size;
+    std::memcpy(&m_header, bytes, sizeof(Header));
+
+    bool valid = std::memcmp(m_header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+        m_header.version == ARCHIVE_VERSION &&
+        m_header.directoryOffset % alignof(Entry) == 0 &&
+        m_header.directoryOffset <= size &&
+        m_header.numEntries <= (size - m_header.directoryOffset) / sizeof(Entry);
+
+    if (!valid) {
+        LOGE("Invalid tile archive: %s", path.c_str());
+        munmap(data, size);
+        return;
+    }
+
+    // Random access, with clusters of neighboring tiles
+    madvise(data, size, MADV_RANDOM);
+
+    m_data = bytes;
+    m_size = size;
+    m_entries = reinterpret_cast<const Entry*>(bytes + m_header.directoryOffset);
+}
+
+TileArchive::~TileArchive() {
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+// Hilbert curve index of @_x, @_y in a grid of size @_n
+static uint64_t hilbertIndex(uint32_t _n, uint32_t _x, uint32_t _y) {
+    uint64_t d = 0;
+    for (uint32_t s = _n / 2; s > 0; s /= 2) {
+        uint32_t rx = (_x & s) > 0;
+        uint32_t ry = (_y & s) > 0;
+        d += uint64_t(s) * s * ((3 * rx) ^ ry);
+
+        if (ry == 0) {
+            if (rx == 1) {
+                _x = _n - 1 - _x;
+                _y = _n - 1 - _y;
+            }
+            std::swap(_x, _y);
+        }
+    }
+    return d;
+}
+
+uint64_t TileArchive::tileKey(const TileID& _tileId) {
+    // (4^z - 1) / 3 tiles in lower zooms
+    uint64_t base = ((uint64_t(1) << (2 * _tileId.z)) - 1) / 3;
+    return base + hilbertIndex(1u << _tileId.z, _tileId.x, _tileId.y);
+}
+
+bool TileArchive::getTile(const TileID& _tileId, const char*& _data, size_t& _size) const {
+    if (!m_data || _tileId.z < 0 || _tileId.z > 30) { return false; }
+
+    uint64_t key = tileKey(_tileId);
+
+    const Entry* begin = m_entries;
+    const Entry* end = m_entries + m_header.numEntries;
+
+    // Last entry starting at or before key
+    auto it = std::upper_bound(begin, end, key, [](uint64_t _key, const Entry& _entry) {
+        return _key < _entry.tileKey;
+    });
+    if (it == begin) { return false; }
+    --it;
+
+    if (key - it->tileKey >= it->runLength) { return false; }
+
+    if (it->offset > m_size || it->length > m_size - it->offset) {
+        LOGW("Invalid tile archive entry for tile %s", _tileId.toString().c_str());
+        return false;
+    }
+
+    _data = m_data + it->offset;
+    _size = it->length;
+    return true;
+}
+
+#ifdef TANGRAM_MBTILES_DATASOURCE
+
+struct ArchiveTile {
+    uint64_t tileKey;
+    int z, x, y;
+};
+
+bool TileArchive::fromMBTiles(const std::string& _mbtilesPath, const std::string& _archivePath) {
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = ARCHIVE_VERSION;
+    header.compression = Compression::unknown;
+    header.minZoom = 255;
+    header.maxZoom = 0;
+
+    std::vector<ArchiveTile> tiles;
+    std::vector<Entry> entries;
+
+    FILE* file = nullptr;
+
+    try {
+        SQLite::Database db(_mbtilesPath, SQLite::OPEN_READONLY);
+
+        SQLite::Statement compression(db, "SELECT value FROM metadata WHERE name = 'compression';");
+        if (compression.executeStep()) {
+            std::string value = compression.getColumn(0);
+            if (value == "identity") {
+                header.compression = Compression::identity;
+            } else if (value == "deflate") {
+                header.compression = Compression::deflate;
+            } else {
+                LOGE("Unsupported MBTiles tile compression: %s", value.c_str());
+                return false;
+            }
+        }
+
+        // Order tiles along the Hilbert curve of each zoom
+        SQLite::Statement ids(db, "SELECT zoom_level, tile_column, tile_row FROM tiles;");
+        while (ids.executeStep()) {
+            int z = ids.getColumn(0);
+            int x = ids.getColumn(1);
+            int y = (1 << z) - 1 - int(ids.getColumn(2));
+            if (z < 0 || z > 30 || x < 0 || x >= (1 << z) || y < 0 || y >= (1 << z)) { continue; }
+
+            tiles.push_back({ tileKey(TileID(x, y, z)), z, x, y });
+            header.minZoom = std::min(header.minZoom, uint8_t(z));
+            header.maxZoom = std::max(header.maxZoom, uint8_t(z));
+        }
+        std::sort(tiles.begin(), tiles.end(), [](const ArchiveTile& _a, const ArchiveTile& _b) {
+            return _a.tileKey < _b.tileKey;
+        });
+
+        file = std::fopen(_archivePath.c_str(), "w+b");
+        if (!file) {
+            LOGE("Unable to create tile archive: %s", _archivePath.c_str());
+            return false;
+        }
+
+        // Written again when the data is complete
+        std::fwrite(&header, sizeof(header), 1, file);
+        header.dataOffset = sizeof(header);
+
+        uint64_t offset = header.dataOffset;
+
+        // Offsets of tile contents by hash, compared on matches
+        std::unordered_multimap<size_t, Entry> contents;
+        std::vector<char> stored;
+
+        SQLite::Statement data(db, "SELECT tile_data FROM tiles WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?;");
+
+        for (const auto& tile : tiles) {
+            data.bind(1, tile.z);
+            data.bind(2, tile.x);
+            data.bind(3, (1 << tile.z) - 1 - tile.y);
+
+            if (!data.executeStep()) {
+                data.reset();
+                continue;
+            }
+            SQLite::Column column = data.getColumn(0);
+            const char* blob = static_cast<const char*>(column.getBlob());
+            uint32_t length = column.getBytes();
+
+            // Find identical contents which were written before
+            size_t hash = std::hash<std::string>()(std::string(blob, length));
+            const Entry* match = nullptr;
+
+            auto range = contents.equal_range(hash);
+            for (auto it = range.first; it != range.second && !match; ++it) {
+                if (it->second.length != length) { continue; }
+
+                stored.resize(length);
+                std::fflush(file);
+                std::fseek(file, it->second.offset, SEEK_SET);
+                bool equal = std::fread(stored.data(), 1, length, file) == length &&
+                    std::memcmp(stored.data(), blob, length) == 0;
+                std::fseek(file, 0, SEEK_END);
+
+                if (equal) { match = &it->second; }
+            }
+
+            Entry entry{ tile.tileKey, offset, length, 1 };
+            if (match) {
+                entry.offset = match->offset;
+            } else {
+                if (std::fwrite(blob, 1, length, file) != length) {
+                    throw std::runtime_error("Write failed");
+                }
+                offset += length;
+                contents.emplace(hash, entry);
+            }
+            data.reset();
+
+            // Extend the previous run for consecutive tiles with the same data
+            if (!entries.empty()) {
+                auto& last = entries.back();
+                if (last.tileKey + last.runLength == entry.tileKey &&
+                    last.offset == entry.offset && last.length == entry.length) {
+                    last.runLength++;
+                    continue;
+                }
+            }
+            entries.push_back(entry);
+        }
+
+        header.dataLength = offset - header.dataOffset;
+
+        // Align the directory for access in place
+        while (offset % alignof(Entry) != 0) {
+            std::fputc(0, file);
+            offset++;
+        }
+        header.directoryOffset = offset;
+        header.numEntries = entries.size();
+
+        if (std::fwrite(entries.data(), sizeof(Entry), entries.size(), file) != entries.size()) {
+            throw std::runtime_error("Write failed");
+        }
+        std::fseek(file, 0, SEEK_SET);
+        if (std::fwrite(&header, sizeof(header), 1, file) != 1 || std::fclose(file) != 0) {
+            file = nullptr;
+            throw std::runtime_error("Write failed");
+        }
+        file = nullptr;
+
+    } catch (std::exception& e) {
+        LOGE("Unable to convert MBTiles %s to tile archive: %s", _mbtilesPath.c_str(), e.what());
+        if (file) { std::fclose(file); }
+        std::remove(_archivePath.c_str());
+        return false;
+    }
+
+    LOG("Converted %d tiles of %s into %d archive entries", int(tiles.size()),
+        _mbtilesPath.c_str(), int(entries.size()));
+    return true;
+}
+
+#else
+
+bool TileArchive::fromMBTiles(const std::string& _mbtilesPath, const std::string& _archivePath) {
+    LOGE("MBTiles support is disabled. Cannot convert %s", _mbtilesPath.c_str());
+    return false;
+}
+
+#endif
+
+}
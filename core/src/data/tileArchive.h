@@ -0,0 +1,83 @@
+#pragma once
+
+#include "tile/tileID.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Tangram {
+
+/* Read-only single-file tile archive, memory-mapped
+ *
+ * Layout, in the style of PMTiles: a header, the tile data and a directory
+ * at the end. Tiles are addressed by a tile key that enumerates the tiles of
+ * each zoom along a Hilbert curve, so that tiles which are close on the map
+ * are close in the file. The directory holds fixed-size entries sorted by
+ * tile key and is searched in place. Each entry covers a run of consecutive
+ * tile keys with the same data, tiles with identical data share their bytes.
+ *
+ * All values are stored little-endian.
+ */
+class TileArchive {
+
+public:
+
+    enum class Compression : uint8_t {
+        // Tiles may be deflate or gzip compressed
+        unknown = 0,
+        identity = 1,
+        deflate = 2,
+    };
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t dataOffset;
+        uint64_t dataLength;
+        uint64_t directoryOffset;
+        uint64_t numEntries;
+        Compression compression;
+        uint8_t minZoom;
+        uint8_t maxZoom;
+        uint8_t reserved[5];
+    };
+
+    struct Entry {
+        uint64_t tileKey;
+        // Offset of the tile data from the start of the file
+        uint64_t offset;
+        uint32_t length;
+        // Number of consecutive tile keys with this data
+        uint32_t runLength;
+    };
+
+    explicit TileArchive(const std::string& _path);
+
+    ~TileArchive();
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    Compression compression() const { return m_header.compression; }
+
+    /* Set @_data and @_size to the bytes of the tile in the mapping.
+     * Returns false when the archive has no data for the tile. */
+    bool getTile(const TileID& _tileId, const char*& _data, size_t& _size) const;
+
+    /* Number of tiles of lower zooms plus the Hilbert index of the tile */
+    static uint64_t tileKey(const TileID& _tileId);
+
+    /* Write all tiles of the MBTiles file @_mbtilesPath to a new archive at
+     * @_archivePath. Returns false on errors and when MBTiles support is disabled. */
+    static bool fromMBTiles(const std::string& _mbtilesPath, const std::string& _archivePath);
+
+private:
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+
+    Header m_header;
+    const Entry* m_entries = nullptr;
+};
+
+}
@@ -0,0 +1,80 @@
+#include "data/tileArchiveDataSource.h"
+
+#include "data/tileArchive.h"
+#include "log.h"
+#include "platform.h"
+#include "util/asyncWorker.h"
+#include "util/zlibHelper.h"
+
+namespace Tangram {
+
+TileArchiveDataSource::TileArchiveDataSource(std::shared_ptr<Platform> _platform, const std::string& _path)
+    : m_archive(std::make_shared<TileArchive>(_path)),
+      m_worker(std::make_unique<AsyncWorker>()),
+      m_platform(_platform) {
+
+    if (m_archive->isOpen()) { m_version = fileVersion(_path); }
+}
+
+TileArchiveDataSource::~TileArchiveDataSource() {
+    // Stop reading before the DataSource is destroyed
+    m_worker.reset();
+}
+
+bool TileArchiveDataSource::loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
+
+    if (!m_archive->isOpen() || _task->rawSource != this->level) {
+        if (!next) { return false; }
+        if (_task->rawSource == this->level) { _task->rawSource = next->level; }
+
+        return next->loadTileData(_task, _cb);
+    }
+
+    m_worker->enqueue([this, _task, _cb](){
+        auto& task = static_cast<BinaryTileTask&>(*_task);
+        task.rawTileData = getTileData(_task->tileId());
+
+        if (task.rawTileData) {
+            _cb.func(_task);
+
+        } else if (next) {
+            // Don't try this source again
+            _task->rawSource = next->level;
+
+            if (!next->loadTileData(_task, _cb)) {
+                // Trigger TileManager update so that tile will be
+                // loaded next time.
+                _task->setNeedsLoading(true);
+                m_platform->requestRender();
+            }
+        } else {
+            LOGD("missing tile: %s", _task->tileId().toString().c_str());
+            _cb.func(_task);
+        }
+    });
+
+    return true;
+}
+
+std::shared_ptr<TileBuffer> TileArchiveDataSource::getTileData(const TileID& _tileId) {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    if (!m_archive->getTile(_tileId, data, size)) { return nullptr; }
+
+    auto compression = m_archive->compression();
+
+    if (compression != TileArchive::Compression::identity) {
+        auto buffer = TileBuffer::create();
+        if (zlib::inflate(data, size, *buffer) == 0) { return buffer; }
+
+        if (compression == TileArchive::Compression::deflate) {
+            LOGW("Invalid deflate compression");
+            return nullptr;
+        }
+    }
+
+    return TileBuffer::view(data, size, m_archive);
+}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "data/tileSource.h"
+
+namespace Tangram {
+
+class AsyncWorker;
+class Platform;
+class TileArchive;
+
+/* DataSource for tiles of a memory-mapped TileArchive file */
+class TileArchiveDataSource : public TileSource::DataSource {
+public:
+
+    TileArchiveDataSource(std::shared_ptr<Platform> _platform, const std::string& _path);
+
+    ~TileArchiveDataSource();
+
+    bool loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override;
+
+    void clear() override {}
+
+    std::string dataVersion() const override { return chainVersion(m_version); }
+
+private:
+
+    // Uncompressed tiles refer to the mapping, which is kept alive by the
+    // returned buffers. Returns nullptr when the archive has no data for the tile.
+    std::shared_ptr<TileBuffer> getTileData(const TileID& _tileId);
+
+    std::shared_ptr<TileArchive> m_archive;
+
+    // File version of the archive, empty when it could not be opened
+    std::string m_version;
+
+    // Reads from the mapping may block on file I/O
+    std::unique_ptr<AsyncWorker> m_worker;
+
+    std::shared_ptr<Platform> m_platform;
+};
+
+}
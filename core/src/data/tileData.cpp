@@ -0,0 +1,80 @@
+#include "data/tileData.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Size of the first block of an arena, following blocks double in size
+#define MIN_BLOCK_SIZE 1024
+#define MAX_BLOCK_SIZE 65536
+
+namespace Tangram {
+
+void GeometryArena::endRing() {
+    if (m_coordinates.size() > m_rings.back()) {
+        m_rings.push_back(m_coordinates.size());
+    }
+}
+
+void GeometryArena::endPart() {
+    endRing();
+
+    uint32_t rings = m_rings.size() - 1;
+    if (rings > m_parts.back()) {
+        m_parts.push_back(rings);
+    }
+}
+
+void GeometryArena::reset() {
+    m_coordinates.clear();
+    m_rings.assign(1, 0);
+    m_parts.assign(1, 0);
+}
+
+template<typename T>
+const T* GeometryArena::copy(const T* _data, size_t _count) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Blocks are not aligned for T");
+
+    size_t size = _count * sizeof(T);
+    size_t offset = (alignof(T) - reinterpret_cast<uintptr_t>(m_position) % alignof(T)) % alignof(T);
+
+    if (m_position == nullptr || m_position + offset + size > m_end) {
+        m_blockSize = std::min(std::max(m_blockSize * 2, size_t(MIN_BLOCK_SIZE)), size_t(MAX_BLOCK_SIZE));
+        size_t blockSize = std::max(m_blockSize, size);
+
+        m_blocks.emplace_back(new char[blockSize]);
+        m_position = m_blocks.back().get();
+        m_end = m_position + blockSize;
+        m_capacity += blockSize;
+        offset = 0;
+    }
+
+    T* result = reinterpret_cast<T*>(m_position + offset);
+    std::memcpy(result, _data, size);
+    m_position += offset + size;
+
+    return result;
+}
+
+FeatureGeometry GeometryArena::endFeature() {
+    FeatureGeometry geometry;
+
+    geometry.ringCount = m_rings.size() - 1;
+    if (geometry.ringCount > 0) {
+        // Only points of ended rings are stored
+        geometry.coordinates = copy(m_coordinates.data(), m_rings.back());
+        geometry.rings = copy(m_rings.data(), m_rings.size());
+    }
+
+    geometry.partCount = m_parts.size() - 1;
+    if (geometry.partCount > 0) {
+        geometry.parts = copy(m_parts.data(), m_parts.size());
+    }
+
+    reset();
+
+    return geometry;
+}
+
+}
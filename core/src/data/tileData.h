@@ -3,6 +3,8 @@
 #include "glm/vec2.hpp"
 #include "data/properties.h"
 
+#include <iterator>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -36,8 +38,14 @@ Data heirarchy:
 
   A <Feature> contains a <GeometryType> denoting what variety of geometry is
   contained in the feature, a <Properties> struct describing the feature, and
-  one collection each of <Point>s, <Line>s, and <Polygon>s. Only the geometry
-  collection corresponding to the feature's geometryType should contain data.
+  its geometry, which is read as <Point>s, <Line>s or <Polygon>s according to
+  the feature's geometryType. Parsers may leave the geometry encoded until
+  TileData::decodeGeometry is called for the feature.
+
+  The geometry of all features of a <TileData> is stored in its <GeometryArena>:
+  the points of all lines and rings in one buffer, with offset arrays for the
+  rings and the polygons. Features and styles read it through <LineSpan>s and
+  <PolygonSpan>s.
 
   A <Properties> contains a sorted vector of key-value pairs storing the
   properties of a <Feature>
@@ -66,17 +74,213 @@ using Line = std::vector<Point>;
 
 using Polygon = std::vector<Line>;
 
+/* Contiguous points of a line or of a polygon ring */
+class LineSpan {
+public:
+    using value_type = Point;
+    using const_iterator = const Point*;
+
+    LineSpan() {}
+    LineSpan(const Point* _begin, const Point* _end) : m_begin(_begin), m_end(_end) {}
+    LineSpan(const Line& _line) : m_begin(_line.data()), m_end(_line.data() + _line.size()) {}
+
+    const Point* begin() const { return m_begin; }
+    const Point* end() const { return m_end; }
+
+    size_t size() const { return m_end - m_begin; }
+    bool empty() const { return m_begin == m_end; }
+
+    const Point& operator[](size_t _index) const { return m_begin[_index]; }
+    const Point& front() const { return *m_begin; }
+    const Point& back() const { return *(m_end - 1); }
+
+private:
+    const Point* m_begin = nullptr;
+    const Point* m_end = nullptr;
+};
+
+/* Iterates the spans of a LineList or PolygonList */
+template<typename List>
+class SpanIterator {
+public:
+    using value_type = typename List::value_type;
+
+    SpanIterator(const List& _list, size_t _index) : m_list(_list), m_index(_index) {}
+
+    value_type operator*() const { return m_list[m_index]; }
+    SpanIterator& operator++() { m_index++; return *this; }
+
+    bool operator==(const SpanIterator& _rhs) const { return m_index == _rhs.m_index; }
+    bool operator!=(const SpanIterator& _rhs) const { return m_index != _rhs.m_index; }
+
+private:
+    List m_list;
+    size_t m_index;
+};
+
+/* Lines in one coordinate buffer, line i ranges from coordinates[offsets[i]]
+ * to coordinates[offsets[i+1]] */
+class LineList {
+public:
+    using value_type = LineSpan;
+    using const_iterator = SpanIterator<LineList>;
+
+    LineList() {}
+    LineList(const Point* _coordinates, const uint32_t* _offsets, size_t _size)
+        : m_coordinates(_coordinates), m_offsets(_offsets), m_size(_size) {}
+
+    const_iterator begin() const { return { *this, 0 }; }
+    const_iterator end() const { return { *this, m_size }; }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    LineSpan operator[](size_t _index) const {
+        return { m_coordinates + m_offsets[_index], m_coordinates + m_offsets[_index + 1] };
+    }
+    LineSpan front() const { return (*this)[0]; }
+    LineSpan back() const { return (*this)[m_size - 1]; }
+
+private:
+    const Point* m_coordinates = nullptr;
+    const uint32_t* m_offsets = nullptr;
+    size_t m_size = 0;
+};
+
+/* The rings of a polygon, the first ring is the exterior */
+using PolygonSpan = LineList;
+
+/* Polygons in one coordinate buffer, polygon i has the rings from
+ * rings[parts[i]] to rings[parts[i+1]] */
+class PolygonList {
+public:
+    using value_type = PolygonSpan;
+    using const_iterator = SpanIterator<PolygonList>;
+
+    PolygonList() {}
+    PolygonList(const Point* _coordinates, const uint32_t* _rings, const uint32_t* _parts, size_t _size)
+        : m_coordinates(_coordinates), m_rings(_rings), m_parts(_parts), m_size(_size) {}
+
+    const_iterator begin() const { return { *this, 0 }; }
+    const_iterator end() const { return { *this, m_size }; }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    PolygonSpan operator[](size_t _index) const {
+        return { m_coordinates, m_rings + m_parts[_index], m_parts[_index + 1] - m_parts[_index] };
+    }
+    PolygonSpan front() const { return (*this)[0]; }
+    PolygonSpan back() const { return (*this)[m_size - 1]; }
+
+private:
+    const Point* m_coordinates = nullptr;
+    const uint32_t* m_rings = nullptr;
+    const uint32_t* m_parts = nullptr;
+    size_t m_size = 0;
+};
+
+/* Geometry of a feature in a GeometryArena */
+struct FeatureGeometry {
+    const Point* coordinates = nullptr;
+    // Offsets of the lines or rings in coordinates, ringCount + 1 entries
+    const uint32_t* rings = nullptr;
+    // Offsets of the polygons in rings, partCount + 1 entries
+    const uint32_t* parts = nullptr;
+    uint32_t ringCount = 0;
+    uint32_t partCount = 0;
+};
+
+/* Stores the geometry of many features in a few large blocks that are released
+ * together, instead of allocating each line and ring.
+ *
+ * The geometry of a feature is added point by point: endRing() ends each line
+ * or ring, endPart() ends each polygon and endFeature() returns the geometry
+ * that was added since the last call. Stored geometry never moves, so its
+ * spans stay valid while more features are added. */
+class GeometryArena {
+public:
+    GeometryArena() { reset(); }
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    void addPoint(const Point& _point) { m_coordinates.push_back(_point); }
+
+    void addPoints(const Point* _points, size_t _count) {
+        m_coordinates.insert(m_coordinates.end(), _points, _points + _count);
+    }
+
+    void addPointsReversed(const Point* _points, size_t _count) {
+        m_coordinates.insert(m_coordinates.end(), std::reverse_iterator<const Point*>(_points + _count),
+                             std::reverse_iterator<const Point*>(_points));
+    }
+
+    /* End the current line or ring, empty ones are dropped */
+    void endRing();
+
+    /* End the current polygon with the rings since the last endPart() */
+    void endPart();
+
+    /* Copy the geometry that was added into the arena and start the next feature */
+    FeatureGeometry endFeature();
+
+    /* Bytes allocated for the stored geometry */
+    size_t capacity() const { return m_capacity; }
+
+private:
+    void reset();
+
+    template<typename T>
+    const T* copy(const T* _data, size_t _count);
+
+    std::vector<Point> m_coordinates;
+    std::vector<uint32_t> m_rings;
+    std::vector<uint32_t> m_parts;
+
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    char* m_position = nullptr;
+    char* m_end = nullptr;
+    size_t m_blockSize = 0;
+    size_t m_capacity = 0;
+};
+
 struct Feature {
     Feature() {}
     Feature(int32_t _sourceId) { props.sourceId = _sourceId; }
 
     GeometryType geometryType = GeometryType::polygons;
 
-    std::vector<Point> points;
-    std::vector<Line> lines;
-    std::vector<Polygon> polygons;
+    FeatureGeometry geometry;
 
     Properties props;
+
+    // ID of geometry that the parser left encoded, 0 when the geometry is decoded
+    uint32_t encodedGeometry = 0;
+
+    /* All points of the feature */
+    LineSpan points() const {
+        if (geometry.ringCount == 0) { return {}; }
+        return { geometry.coordinates, geometry.coordinates + geometry.rings[geometry.ringCount] };
+    }
+
+    LineList lines() const {
+        return { geometry.coordinates, geometry.rings, geometry.ringCount };
+    }
+
+    PolygonList polygons() const {
+        return { geometry.coordinates, geometry.rings, geometry.parts, geometry.partCount };
+    }
+};
+
+/* Decodes the geometry of features that a parser left encoded, so that only the
+ * features that match a filter are decoded */
+class GeometryDecoder {
+public:
+    virtual ~GeometryDecoder() {}
+
+    /* Decode the geometry of @_feature unless that was done before */
+    virtual void decode(Feature& _feature) = 0;
 };
 
 struct Layer {
@@ -87,12 +291,28 @@ struct Layer {
 
     std::vector<Feature> features;
 
+    // Property values that are shared by the features, when the parser provides them
+    std::shared_ptr<PropertyValues> values;
+
 };
 
 struct TileData {
 
     std::vector<Layer> layers;
 
+    // Geometry of the features in layers
+    GeometryArena geometry;
+
+    std::unique_ptr<GeometryDecoder> geometryDecoder;
+
+    /* Make the geometry of @_feature available. TileData may be shared by
+     * threads, the decoder synchronizes the decoding. */
+    void decodeGeometry(const Feature& _feature) const {
+        if (_feature.encodedGeometry != 0 && geometryDecoder) {
+            geometryDecoder->decode(const_cast<Feature&>(_feature));
+        }
+    }
+
 };
 
 }
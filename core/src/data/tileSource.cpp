@@ -5,22 +5,61 @@
 #include "data/formats/topoJson.h"
 #include "data/tileData.h"
 #include "platform.h"
+#include "tile/tileHash.h"
 #include "tile/tileID.h"
 #include "tile/tile.h"
 #include "tile/tileTask.h"
 #include "log.h"
 #include "util/geom.h"
+#include "util/url.h"
 
+#include <algorithm>
 #include <atomic>
 #include <functional>
+#include <sstream>
+#include <unordered_map>
+
+#include <sys/stat.h>
 
 namespace Tangram {
 
+struct SharedTileData {
+    struct Entry {
+        int64_t generation;
+        std::weak_ptr<TileData> tileData;
+    };
+
+    std::mutex mutex;
+
+    // Keyed by the source tile coordinates, i.e. TileID with s == z
+    std::unordered_map<TileID, Entry> entries;
+
+    // Number of entries after the last removal of expired entries
+    size_t purgeSize = 0;
+
+    std::atomic<bool> enabled{true};
+
+    std::atomic<uint64_t> parsed{0};
+    std::atomic<uint64_t> shared{0};
+
+    void purge() {
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.tileData.expired()) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        purgeSize = entries.size();
+    }
+};
+
 TileSource::TileSource(const std::string& _name, std::unique_ptr<DataSource> _sources,
                        ZoomOptions _zoomOptions) :
     m_name(_name),
     m_zoomOptions(_zoomOptions),
-    m_sources(std::move(_sources)) {
+    m_sources(std::move(_sources)),
+    m_sharedTileData(std::make_unique<SharedTileData>()) {
 
     static std::atomic<int32_t> s_serial;
 
@@ -31,6 +70,29 @@ TileSource::~TileSource() {
     clearData();
 }
 
+std::string TileSource::DataSource::chainVersion(const std::string& _version) const {
+    if (_version.empty() || !next) { return _version; }
+
+    auto nextVersion = next->dataVersion();
+    if (nextVersion.empty()) { return ""; }
+
+    return _version + '|' + nextVersion;
+}
+
+std::string TileSource::DataSource::fileVersion(const std::string& _path) {
+    auto url = Url(_path);
+    if (url.scheme() == "asset") { return ""; }
+
+    auto path = url.path();
+
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) { return ""; }
+
+    std::stringstream version;
+    version << path << ':' << st.st_size << ':' << st.st_mtime;
+    return version.str();
+}
+
 int32_t TileSource::zoomBiasFromTileSize(int32_t tileSize) {
     const auto BaseTileSize = 256;
 
@@ -82,6 +144,12 @@ void TileSource::clearData() {
 
     if (m_sources) { m_sources->clear(); }
 
+    {
+        std::lock_guard<std::mutex> lock(m_sharedTileData->mutex);
+        m_sharedTileData->entries.clear();
+        m_sharedTileData->purgeSize = 0;
+    }
+
     m_generation++;
 }
 
@@ -106,12 +174,85 @@ std::shared_ptr<TileData> TileSource::parse(const TileTask& _task) const {
     switch (m_format) {
     case Format::TopoJson: return TopoJson::parseTile(_task, m_id);
     case Format::GeoJson: return GeoJson::parseTile(_task, m_id);
-    case Format::Mvt: return Mvt::parseTile(_task, m_id);
+    case Format::Mvt: return Mvt::parseTile(_task, m_id, m_collections);
     }
     assert(false);
     return nullptr;
 }
 
+std::shared_ptr<TileData> TileSource::parseTileData(const TileTask& _task) {
+
+    auto& shared = *m_sharedTileData;
+
+    if (!shared.enabled) {
+        shared.parsed++;
+        return parse(_task);
+    }
+
+    const auto& tileId = _task.tileId();
+    TileID sourceTileId(tileId.x, tileId.y, tileId.z);
+    int64_t generation = _task.sourceGeneration();
+
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        auto it = shared.entries.find(sourceTileId);
+        if (it != shared.entries.end() && it->second.generation == generation) {
+            if (auto tileData = it->second.tileData.lock()) {
+                shared.shared++;
+                return tileData;
+            }
+        }
+    }
+
+    // Tasks for the same source tile that are parsed concurrently
+    // both parse it, the later one replaces the shared entry.
+    auto tileData = parse(_task);
+    shared.parsed++;
+
+    if (tileData) {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        auto& entry = shared.entries[sourceTileId];
+        if (entry.tileData.expired() || entry.generation <= generation) {
+            entry = { generation, tileData };
+        }
+        if (shared.entries.size() > 2 * shared.purgeSize + 64) {
+            shared.purge();
+        }
+    }
+
+    return tileData;
+}
+
+TileSource::ParseStats TileSource::parseStats() const {
+    ParseStats stats;
+    stats.parsed = m_sharedTileData->parsed;
+    stats.shared = m_sharedTileData->shared;
+    return stats;
+}
+
+bool TileSource::shareTileData() const {
+    return m_sharedTileData->enabled;
+}
+
+void TileSource::shareTileData(bool _share) {
+    m_sharedTileData->enabled = _share;
+
+    if (!_share) {
+        std::lock_guard<std::mutex> lock(m_sharedTileData->mutex);
+        m_sharedTileData->entries.clear();
+        m_sharedTileData->purgeSize = 0;
+    }
+}
+
+void TileSource::addCollections(const std::vector<std::string>& _collections) {
+    for (const auto& collection : _collections) {
+        auto it = std::lower_bound(m_collections.begin(), m_collections.end(), collection);
+        if (it == m_collections.end() || *it != collection) {
+            m_collections.insert(it, collection);
+        }
+    }
+}
+
 void TileSource::cancelLoadingTile(TileTask& _task) {
 
     if (m_sources) { m_sources->cancelLoadingTile(_task); }
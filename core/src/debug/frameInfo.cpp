@@ -8,6 +8,7 @@
 #include "tile/tileManager.h"
 #include "tile/tile.h"
 #include "tile/tileCache.h"
+#include "tile/tileWorker.h"
 #include "view/view.h"
 
 #include <deque>
@@ -52,7 +53,8 @@ void FrameInfo::beginFrame() {
 }
 
 
-void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManager) {
+void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManager,
+                     const TileWorker& _tileWorker) {
 
     if (getDebugFlag(DebugFlags::tangram_infos) || getDebugFlag(DebugFlags::tangram_stats)) {
         static int cpt = 0;
@@ -114,9 +116,26 @@ void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManag
                                  + std::to_string(_tileManager.getVisibleTiles().size()));
             debuginfos.push_back("selectable features:"
                                  + std::to_string(features));
-            debuginfos.push_back("tile cache size:"
-                                 + std::to_string(_tileManager.getTileCache()->getMemoryUsage() / 1024) + "kb");
+            auto cacheStats = _tileManager.getTileCache()->stats();
+            debuginfos.push_back("tile cache size:" + std::to_string(cacheStats.usage / 1024) + "kb"
+                                 + " hits:" + std::to_string(cacheStats.hits)
+                                 + " misses:" + std::to_string(cacheStats.misses)
+                                 + " evictions:" + std::to_string(cacheStats.evictions));
             debuginfos.push_back("tile size:" + std::to_string(memused / 1024) + "kb");
+
+            auto workerStats = _tileWorker.stats();
+            debuginfos.push_back("parse queue:" + std::to_string(workerStats.parseQueue)
+                                 + " avg:" + to_string_with_precision(workerStats.parseTime, 2) + "ms");
+            debuginfos.push_back("build queue:" + std::to_string(workerStats.buildQueue)
+                                 + " avg:" + to_string_with_precision(workerStats.buildTime, 2) + "ms");
+            debuginfos.push_back("canceled builds:" + std::to_string(workerStats.canceled)
+                                 + " saved:" + to_string_with_precision(workerStats.canceledTimeSaved, 1) + "ms");
+            auto& prefetch = _tileManager.prefetchStats();
+            debuginfos.push_back("prefetch:" + std::to_string(prefetch.requested)
+                                 + " canceled:" + std::to_string(prefetch.canceled)
+                                 + " hit rate:" + to_string_with_precision(prefetch.hitRate() * 100, 1) + "%");
+            debuginfos.push_back("deferred tasks:" + std::to_string(_tileManager.deferredTasks())
+                                 + " uploads:" + std::to_string(_tileManager.pendingUploads()));
             debuginfos.push_back("avg frame cpu time:" + to_string_with_precision(avgTimeCpu, 2) + "ms");
             debuginfos.push_back("avg frame render time:" + to_string_with_precision(avgTimeRender, 2) + "ms");
             debuginfos.push_back("avg frame update time:" + to_string_with_precision(avgTimeUpdate, 2) + "ms");
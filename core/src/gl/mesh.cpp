@@ -5,6 +5,7 @@
 #include "gl/glError.h"
 #include "platform.h"
 #include "log.h"
+#include "util/serialize.h"
 
 namespace Tangram {
 
@@ -211,10 +212,119 @@ bool MeshBase::draw(RenderState& rs, ShaderProgram& _shader, bool _useVao) {
     return true;
 }
 
+void MeshBase::resetVaos() {
+    if (m_rs) { m_vaos.dispose(*m_rs); }
+}
+
 size_t MeshBase::bufferSize() const {
     return m_nVertices * m_vertexLayout->getStride() + m_nIndices * sizeof(GLushort);
 }
 
+bool MeshBase::serialize(std::vector<char>& _out) const {
+
+    if (!m_isCompiled || m_isUploaded) { return false; }
+
+    size_t stride = m_vertexLayout->getStride();
+
+    write(_out, uint32_t(m_drawMode));
+    write(_out, uint32_t(m_hint));
+    write(_out, uint32_t(stride));
+    write(_out, uint64_t(m_nVertices));
+    write(_out, uint64_t(m_nIndices));
+    write(_out, uint32_t(m_vertexOffsets.size()));
+
+    for (auto& offset : m_vertexOffsets) {
+        write(_out, offset.first);
+        write(_out, offset.second);
+    }
+
+    if (m_nVertices > 0) {
+        const char* vertices = reinterpret_cast<const char*>(m_glVertexData);
+        _out.insert(_out.end(), vertices, vertices + m_nVertices * stride);
+    }
+    if (m_nIndices > 0) {
+        const char* indices = reinterpret_cast<const char*>(m_glIndexData);
+        _out.insert(_out.end(), indices, indices + m_nIndices * sizeof(GLushort));
+    }
+    return true;
+}
+
+bool MeshBase::deserialize(const char*& _data, const char* _end) {
+
+    if (m_isCompiled) { return false; }
+
+    const char* data = _data;
+
+    uint32_t drawMode, hint, stride, numOffsets;
+    uint64_t numVertices, numIndices;
+
+    if (!read(data, _end, drawMode) || !read(data, _end, hint) ||
+        !read(data, _end, stride) || !read(data, _end, numVertices) ||
+        !read(data, _end, numIndices) || !read(data, _end, numOffsets)) {
+        return false;
+    }
+
+    if (stride != uint32_t(m_vertexLayout->getStride())) {
+        LOGW("Vertex layout of serialized mesh does not match");
+        return false;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> offsets(numOffsets);
+    for (auto& offset : offsets) {
+        if (!read(data, _end, offset.first) || !read(data, _end, offset.second)) {
+            return false;
+        }
+    }
+
+    size_t vertexBytes = numVertices * stride;
+    size_t indexBytes = numIndices * sizeof(GLushort);
+
+    if (size_t(_end - data) < vertexBytes + indexBytes) { return false; }
+
+    setDrawMode(drawMode);
+    m_hint = hint;
+    m_vertexOffsets = std::move(offsets);
+    m_nVertices = numVertices;
+    m_nIndices = numIndices;
+
+    m_glVertexData = new GLbyte[vertexBytes];
+    std::memcpy(m_glVertexData, data, vertexBytes);
+    data += vertexBytes;
+
+    if (m_nIndices > 0) {
+        m_glIndexData = new GLushort[m_nIndices];
+        std::memcpy(m_glIndexData, data, indexBytes);
+        data += indexBytes;
+    }
+
+    m_isCompiled = true;
+    _data = data;
+
+    return true;
+}
+
+void MeshBase::mapSelectionColors(const SelectionColorMap& _selectionColors) {
+
+    if (!m_isCompiled || m_isUploaded) { return; }
+
+    for (const auto& attrib : m_vertexLayout->getAttribs()) {
+        if (attrib.name != "a_selection_color") { continue; }
+
+        size_t stride = m_vertexLayout->getStride();
+        GLbyte* end = m_glVertexData + m_nVertices * stride;
+
+        for (GLbyte* vertex = m_glVertexData + attrib.offset; vertex < end; vertex += stride) {
+            uint32_t color;
+            std::memcpy(&color, vertex, sizeof(color));
+            if (color == 0) { continue; }
+
+            color = _selectionColors(color);
+            std::memcpy(vertex, &color, sizeof(color));
+        }
+        break;
+    }
+}
+
 // Add indices by collecting them into batches to draw as much as
 // possible in one draw call.  The indices must be shifted by the
 // number of vertices that are present in the current batch.
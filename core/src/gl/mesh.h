@@ -73,6 +73,26 @@ public:
 
     size_t bufferSize() const;
 
+    void resetVaos();
+
+    /*
+     * Appends the compiled vertices and indices to _out; Returns false when
+     * the data was already released by upload()
+     */
+    bool serialize(std::vector<char>& _out) const;
+
+    /*
+     * Restores compiled vertices and indices written by serialize() for the
+     * current vertex layout; Advances _data past the mesh on success
+     */
+    bool deserialize(const char*& _data, const char* _end);
+
+    /*
+     * Replaces the selection colors of the compiled vertices by the colors
+     * that _selectionColors maps them to
+     */
+    void mapSelectionColors(const SelectionColorMap& _selectionColors);
+
 protected:
 
     // Used in draw for legth and offsets: sumIndices, sumVertices
@@ -151,6 +171,26 @@ public:
         return MeshBase::draw(rs, shader, useVao);
     }
 
+    void resetVaos() override {
+        MeshBase::resetVaos();
+    }
+
+    bool isUploaded() const override {
+        return m_isUploaded || !m_isCompiled || m_nVertices == 0;
+    }
+
+    size_t uploadBuffers(RenderState& rs) override {
+        if (isUploaded()) { return 0; }
+
+        size_t bytes = MeshBase::bufferSize();
+        MeshBase::upload(rs);
+        return bytes;
+    }
+
+    bool serialize(std::vector<char>& _out) const override {
+        return MeshBase::serialize(_out);
+    }
+
     void compile(const std::vector<MeshData<T>>& _meshes);
 
     void compile(const MeshData<T>& _mesh);
@@ -295,4 +335,50 @@ void Mesh<T>::updateVertices(Range _vertexRange, const T& _newVertexValue) {
     setDirty(start, end - start);
 }
 
+/*
+ * RawMesh - Mesh restored from the serialized buffers of a Mesh<T> with the
+ * same VertexLayout
+ */
+class RawMesh : public StyledMesh, protected MeshBase {
+public:
+    RawMesh(std::shared_ptr<VertexLayout> _vertexLayout)
+        : MeshBase(_vertexLayout) {}
+
+    bool deserialize(const char*& _data, const char* _end) {
+        return MeshBase::deserialize(_data, _end);
+    }
+
+    void mapSelectionColors(const SelectionColorMap& _selectionColors) {
+        MeshBase::mapSelectionColors(_selectionColors);
+    }
+
+    size_t bufferSize() const override {
+        return MeshBase::bufferSize();
+    }
+
+    bool draw(RenderState& rs, ShaderProgram& shader, bool useVao = true) override {
+        return MeshBase::draw(rs, shader, useVao);
+    }
+
+    void resetVaos() override {
+        MeshBase::resetVaos();
+    }
+
+    bool isUploaded() const override {
+        return m_isUploaded || !m_isCompiled || m_nVertices == 0;
+    }
+
+    size_t uploadBuffers(RenderState& rs) override {
+        if (isUploaded()) { return 0; }
+
+        size_t bytes = MeshBase::bufferSize();
+        MeshBase::upload(rs);
+        return bytes;
+    }
+
+    bool serialize(std::vector<char>& _out) const override {
+        return MeshBase::serialize(_out);
+    }
+};
+
 }
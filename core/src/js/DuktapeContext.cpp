@@ -191,7 +191,7 @@ int DuktapeContext::jsHasProperty(duk_context *_ctx) {
     }
 
     const char* key = duk_require_string(_ctx, 1);
-    auto result = static_cast<duk_bool_t>(context->_feature->props.contains(key));
+    auto result = static_cast<duk_bool_t>(context->_feature->props.contains(context->propertyKey(key)));
     duk_push_boolean(_ctx, result);
 
     return 1;
@@ -212,7 +212,7 @@ int DuktapeContext::jsGetProperty(duk_context *_ctx) {
     // Get the property name (second parameter)
     const char* key = duk_require_string(_ctx, 1);
 
-    auto it = context->_feature->props.get(key);
+    auto it = context->_feature->props.get(context->propertyKey(key));
     if (it.is<std::string>()) {
         duk_push_string(_ctx, it.get<std::string>().c_str());
     } else if (it.is<double>()) {
@@ -225,6 +225,16 @@ int DuktapeContext::jsGetProperty(duk_context *_ctx) {
     return 1;
 }
 
+PropertyKey DuktapeContext::propertyKey(const char* name) const {
+    auto it = _propertyKeys.find(name);
+    if (it != _propertyKeys.end()) { return it->second; }
+
+    auto key = PropertyKey::intern(name);
+    // Only valid keys are kept
+    if (key.isValid()) { _propertyKeys.emplace(name, key); }
+    return key;
+}
+
 void DuktapeContext::fatalErrorHandler(void*, const char* message) {
     LOGE("Fatal Error in DuktapeJavaScriptContext: %s", message);
     abort();
@@ -5,9 +5,11 @@
 #pragma once
 
 #include "js/JavaScriptFwd.h"
+#include "data/propertyKey.h"
 #include "duktape/duktape.h"
 
 #include <string>
+#include <unordered_map>
 
 namespace Tangram {
 
@@ -165,6 +167,9 @@ private:
 
     bool evaluateFunction(uint32_t index);
 
+    // Key of the feature property @name, resolved once for each name
+    PropertyKey propertyKey(const char* name) const;
+
     DuktapeValue getStackTopValue() {
         return DuktapeValue(_ctx, duk_normalize_index(_ctx, -1));
     }
@@ -173,6 +178,8 @@ private:
 
     const Feature* _feature = nullptr;
 
+    mutable std::unordered_map<std::string, PropertyKey> _propertyKeys;
+
     friend JavaScriptScope<DuktapeContext>;
 };
 
@@ -164,6 +164,16 @@ JSObjectRef JSCoreContext::compileFunction(const std::string& source) {
     return JSValueToObject(_context, jsFunction, nullptr);
 }
 
+PropertyKey JSCoreContext::propertyKey(const char* name) {
+    auto it = _propertyKeys.find(name);
+    if (it != _propertyKeys.end()) { return it->second; }
+
+    auto key = PropertyKey::intern(name);
+    // Only valid keys are kept
+    if (key.isValid()) { _propertyKeys.emplace(name, key); }
+    return key;
+}
+
 bool JSCoreContext::jsHasPropertyCallback(JSContextRef, JSObjectRef object, JSStringRef property) {
     auto jsCoreContext = reinterpret_cast<JSCoreContext*>(JSObjectGetPrivate(object));
     if (!jsCoreContext) {
@@ -175,7 +185,7 @@ bool JSCoreContext::jsHasPropertyCallback(JSContextRef, JSObjectRef object, JSSt
     }
     char nameBuffer[128]; // This should be enough for all the names we use - could make it dynamically-sized if needed.
     JSStringGetUTF8CString(property, nameBuffer, sizeof(nameBuffer));
-    return feature->props.contains(nameBuffer);
+    return feature->props.contains(jsCoreContext->propertyKey(nameBuffer));
 }
 
 JSValueRef JSCoreContext::jsGetPropertyCallback(JSContextRef context, JSObjectRef object, JSStringRef property, JSValueRef*) {
@@ -190,7 +200,7 @@ JSValueRef JSCoreContext::jsGetPropertyCallback(JSContextRef context, JSObjectRe
     JSValueRef jsValue = nullptr;
     char nameBuffer[128]; // This should be enough for all the names we use - could make it dynamically-sized if needed.
     JSStringGetUTF8CString(property, nameBuffer, sizeof(nameBuffer));
-    auto it = feature->props.get(nameBuffer);
+    auto it = feature->props.get(jsCoreContext->propertyKey(nameBuffer));
     if (it.is<std::string>()) {
         jsValue = jsCoreContext->_strings.get(context, it.get<std::string>());
     } else if (it.is<double>()) {
@@ -3,6 +3,7 @@
 //
 #pragma once
 #include "js/JavaScriptFwd.h"
+#include "data/propertyKey.h"
 #include <JavaScriptCore/JavaScript.h>
 #include <list>
 #include <unordered_map>
@@ -226,6 +227,9 @@ private:
 
     JSObjectRef compileFunction(const std::string& source);
 
+    // Key of the feature property @name, resolved once for each name
+    PropertyKey propertyKey(const char* name);
+
     std::vector<JSObjectRef> _functions;
 
     JSContextGroupRef _group;
@@ -235,6 +239,8 @@ private:
 
     const Feature* _feature;
 
+    std::unordered_map<std::string, PropertyKey> _propertyKeys;
+
     friend JavaScriptScope<JSCoreContext>;
 };
 
@@ -9,6 +9,7 @@
 #include "textLabels.h"
 #include "util/geom.h"
 #include "util/lineSampler.h"
+#include "util/serialize.h"
 #include "view/view.h"
 
 #include <glm/gtx/norm.hpp>
@@ -209,7 +210,7 @@ void CurvedLabel::addVerticesToMesh(ScreenTransform& _transform, const glm::vec2
 
     auto it = m_textLabels.quads.begin() + m_textRanges[m_textRangeIndex].start;
     auto end = it + m_textRanges[m_textRangeIndex].length;
-    auto& style = m_textLabels.style;
+    auto& style = m_textLabels.style();
 
     auto& meshes = style.getMeshes();
 
@@ -285,4 +286,14 @@ void CurvedLabel::addVerticesToMesh(ScreenTransform& _transform, const glm::vec2
     }
 }
 
+bool CurvedLabel::serialize(std::vector<char>& _out) const {
+    if (!TextLabel::serialize(_out)) { return false; }
+
+    write(_out, m_prio);
+    write(_out, uint32_t(m_anchorPoint));
+    write(_out, uint32_t(m_modelTransform.size()));
+    for (const auto& point : m_modelTransform) { write(_out, point); }
+    return true;
+}
+
 }
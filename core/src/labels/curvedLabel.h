@@ -55,6 +55,8 @@ public:
         return m_modelTransform[m_anchorPoint];
     }
 
+    bool serialize(std::vector<char>& _out) const override;
+
 protected:
 
     const std::vector<glm::vec2> m_modelTransform;
@@ -5,6 +5,7 @@
 #include "tile/tile.h"
 #include "util/geom.h"
 #include "util/mapProjection.h"
+#include "util/serialize.h"
 #include "view/view.h"
 
 namespace Tangram {
@@ -35,6 +36,21 @@ Label::Label(glm::vec2 _size, Type _type, Options _options)
 
 Label::~Label() {}
 
+bool Label::serialize(std::vector<char>& _out) const {
+    write(_out, m_type);
+    write(_out, m_options);
+    write(_out, m_dim - m_options.buffer);
+    return true;
+}
+
+bool Label::deserialize(const char*& _data, const char* _end, Type& _type,
+                        Options& _options, glm::vec2& _size) {
+    if (!read(_data, _end, _type) || !read(_data, _end, _options) || !read(_data, _end, _size)) {
+        return false;
+    }
+    return _options.anchors.count >= 0 && _options.anchors.count <= LabelProperty::max_anchors;
+}
+
 void Label::setRelative(Label& _relative, bool _definePriority, bool _defineCollide) {
     m_relative = &_relative;
 
@@ -15,6 +15,7 @@
 #include <string>
 #include <limits>
 #include <memory>
+#include <vector>
 
 namespace Tangram {
 
@@ -91,6 +92,15 @@ public:
 
     virtual const Texture* texture() const { return nullptr; }
 
+    /* Append the type, options and size of the label followed by the parameters
+     * of the derived label to @_out, to create the label again when its mesh is
+     * restored. Returns false when the label cannot be serialized. */
+    virtual bool serialize(std::vector<char>& _out) const;
+
+    /* Read the type, options and size that Label::serialize() wrote */
+    static bool deserialize(const char*& _data, const char* _end, Type& _type,
+                            Options& _options, glm::vec2& _size);
+
     bool update(const glm::mat4& _mvp, const ViewState& _viewState,
                 const AABB* _bounds, ScreenTransform& _transform);
 
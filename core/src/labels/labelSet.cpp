@@ -1,5 +1,9 @@
 #include "labels/labelSet.h"
 
+#include "util/serialize.h"
+
+#include <algorithm>
+
 namespace Tangram {
 
 LabelSet::~LabelSet() {}
@@ -20,4 +24,56 @@ void LabelSet::setLabels(std::vector<std::unique_ptr<Label>>& _labels) {
     _labels.clear();
 }
 
+bool LabelSet::serializeLabels(const std::vector<std::unique_ptr<Label>>& _labels,
+                               std::vector<char>& _out) {
+
+    write(_out, uint32_t(_labels.size()));
+
+    for (const auto& label : _labels) {
+        write(_out, label->renderType());
+        if (!label->serialize(_out)) { return false; }
+
+        // Relatives in other meshes are not restored
+        int32_t relative = -1;
+        if (label->relative()) {
+            auto it = std::find_if(_labels.begin(), _labels.end(),
+                                   [&](const auto& _other) { return _other.get() == label->relative(); });
+            if (it != _labels.end()) { relative = int32_t(it - _labels.begin()); }
+        }
+        write(_out, relative);
+    }
+    return true;
+}
+
+bool LabelSet::deserializeLabels(const char*& _data, const char* _end,
+                                 const std::function<Label*(LabelType, const char*&, const char*)>& _readLabel) {
+
+    uint32_t numLabels = 0;
+    if (!read(_data, _end, numLabels)) { return false; }
+
+    std::vector<std::pair<Label*, int32_t>> labels;
+
+    for (uint32_t i = 0; i < numLabels; i++) {
+        LabelType type;
+        if (!read(_data, _end, type)) { return false; }
+
+        Label* label = _readLabel(type, _data, _end);
+
+        int32_t relative = -1;
+        if (!label || !read(_data, _end, relative) ||
+            relative < -1 || relative >= int32_t(numLabels)) {
+            return false;
+        }
+        labels.emplace_back(label, relative);
+    }
+
+    for (auto& label : labels) {
+        if (label.second < 0) { continue; }
+
+        // Options were stored with the priority and collision of the relative
+        label.first->setRelative(*labels[label.second].first, false, false);
+    }
+    return true;
+}
+
 }
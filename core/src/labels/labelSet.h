@@ -3,6 +3,7 @@
 #include "labels/label.h"
 #include "style/style.h"
 
+#include <functional>
 #include <vector>
 #include <memory>
 
@@ -22,8 +23,22 @@ public:
 
     void setLabels(std::vector<std::unique_ptr<Label>>& _labels);
 
+    /* Draw the labels with @_style, which replaces the Style of the labels in a
+     * new Scene. Returns false when the labels cannot be drawn with @_style. */
+    virtual bool setStyle(const Style& _style) { return false; }
+
     void reset();
 
+    /* Append @_labels with the index of their relatives in @_labels to @_out */
+    static bool serializeLabels(const std::vector<std::unique_ptr<Label>>& _labels,
+                                std::vector<char>& _out);
+
+    /* Read the labels which serializeLabels() wrote and link them to their
+     * relatives. @_readLabel reads a label of a LabelType and returns it, or
+     * nullptr when the label is invalid. */
+    static bool deserializeLabels(const char*& _data, const char* _end,
+                                  const std::function<Label*(LabelType, const char*&, const char*)>& _readLabel);
+
 protected:
     std::vector<std::unique_ptr<Label>> m_labels;
 };
@@ -7,6 +7,7 @@
 #include "scene/spriteAtlas.h"
 #include "style/pointStyle.h"
 #include "util/geom.h"
+#include "util/serialize.h"
 #include "view/view.h"
 
 namespace Tangram {
@@ -68,6 +69,20 @@ SpriteLabel::SpriteLabel(Coordinates _coordinates, glm::vec2 _size, Label::Optio
     applyAnchor(m_options.anchors[0]);
 }
 
+bool SpriteLabel::serialize(std::vector<char>& _out) const {
+    // Textures are restored by their name in the Scene
+    std::string texture;
+    if (m_texture && !m_labels.m_style->textureName(m_texture, texture)) { return false; }
+
+    Label::serialize(_out);
+    write(_out, m_coordinates);
+    write(_out, m_vertexAttrib);
+    write(_out, uint32_t(m_labelsPos));
+    write(_out, bool(m_texture));
+    writeString(_out, texture);
+    return true;
+}
+
 void SpriteLabel::applyAnchor(LabelProperty::Anchor _anchor) {
 
     m_anchor = LabelProperty::anchorDirection(_anchor) * m_dim * 0.5f;
@@ -235,7 +250,7 @@ void SpriteLabel::addVerticesToMesh(ScreenTransform& _transform, const glm::vec2
         uint16_t(m_alpha * SpriteVertex::alpha_scale),
     };
 
-    auto* quadVertices = m_labels.m_style.pushQuad(m_texture);
+    auto* quadVertices = m_labels.m_style->pushQuad(m_texture);
 
     if (m_options.flat) {
         FlatTransform transform(_transform);
@@ -64,6 +64,10 @@ public:
 
     const Texture* texture() const override { return m_texture; }
 
+    bool serialize(std::vector<char>& _out) const override;
+
+    void setTexture(Texture* _texture) { m_texture = _texture; }
+
 private:
 
     const Coordinates m_coordinates;
@@ -88,14 +92,14 @@ struct SpriteQuad {
 
 class SpriteLabels : public LabelSet {
 public:
-    SpriteLabels(const PointStyle& _style) : m_style(_style) {}
+    SpriteLabels(const PointStyle& _style) : m_style(&_style) {}
 
     void setQuads(std::vector<SpriteQuad>&& _quads) {
         quads = std::move(_quads);
     }
 
     // TODO: hide within class if needed
-    const PointStyle& m_style;
+    const PointStyle* m_style;
     std::vector<SpriteQuad> quads;
 };
 
@@ -8,10 +8,13 @@
 #include "style/textStyle.h"
 #include "text/fontContext.h"
 #include "util/geom.h"
+#include "util/serialize.h"
 #include "view/view.h"
 
 #include "glm/gtx/norm.hpp"
 
+#include <algorithm>
+
 namespace Tangram {
 
 using namespace LabelProperty;
@@ -205,7 +208,7 @@ void TextLabel::addVerticesToMesh(ScreenTransform& _transform, const glm::vec2&
 
     auto it = m_textLabels.quads.begin() + m_textRanges[m_textRangeIndex].start;
     auto end = it + m_textRanges[m_textRangeIndex].length;
-    auto& style = m_textLabels.style;
+    auto& style = m_textLabels.style();
 
     auto& meshes = style.getMeshes();
 
@@ -261,8 +264,97 @@ void TextLabel::addVerticesToMesh(ScreenTransform& _transform, const glm::vec2&
     }
 }
 
+bool TextLabel::serialize(std::vector<char>& _out) const {
+    size_t layout = m_textLabels.findLayout(m_textRanges);
+    if (layout == m_textLabels.layouts.size()) { return false; }
+
+    Label::serialize(_out);
+    write(_out, uint32_t(layout));
+    write(_out, m_coordinates);
+    write(_out, m_fontAttrib);
+    write(_out, m_preferedAlignment);
+    return true;
+}
+
 TextLabels::~TextLabels() {
-    style.context()->releaseAtlas(m_atlasRefs);
+    m_style->context()->releaseAtlas(m_atlasRefs);
+}
+
+bool TextLabels::setStyle(const Style& _style) {
+    auto& style = static_cast<const TextStyle&>(_style);
+    // The glyph quads refer to the atlas textures of the FontContext
+    if (style.context() != m_style->context()) { return false; }
+
+    m_style = &style;
+    return true;
+}
+
+size_t TextLabels::findLayout(const TextRange& _textRanges) const {
+    int start = _textRanges[0].start;
+    auto it = std::lower_bound(layouts.begin(), layouts.end(), start,
+                               [](const TextLayout& _layout, int _start) {
+                                   return _layout.textRanges[0].start < _start;
+                               });
+
+    if (it == layouts.end() || it->textRanges[0].start != start) { return layouts.size(); }
+    return it - layouts.begin();
+}
+
+bool TextLabels::serialize(std::vector<char>& _out) const {
+    serializeLayouts(_out);
+    return serializeLabels(m_labels, _out);
+}
+
+void TextLabels::serializeLayouts(std::vector<char>& _out) const {
+    write(_out, uint32_t(layouts.size()));
+
+    for (const auto& layout : layouts) {
+        writeString(_out, layout.fontFamily);
+        writeString(_out, layout.fontStyle);
+        writeString(_out, layout.fontWeight);
+        write(_out, layout.fontSize);
+        writeString(_out, layout.text);
+        write(_out, layout.transform);
+        write(_out, layout.align);
+        write(_out, layout.anchors);
+        write(_out, layout.wordWrap);
+        write(_out, layout.maxLines);
+        write(_out, layout.maxLineWidth);
+        write(_out, layout.lineSpacing);
+        write(_out, layout.type);
+        write(_out, layout.textRanges);
+    }
+}
+
+bool TextLabels::deserializeLayouts(const char*& _data, const char* _end,
+                                    std::vector<TextLayout>& _layouts) {
+    uint32_t numLayouts = 0;
+    if (!read(_data, _end, numLayouts)) { return false; }
+
+    for (uint32_t i = 0; i < numLayouts; i++) {
+        TextLayout layout;
+        if (!readString(_data, _end, layout.fontFamily) ||
+            !readString(_data, _end, layout.fontStyle) ||
+            !readString(_data, _end, layout.fontWeight) ||
+            !read(_data, _end, layout.fontSize) ||
+            !readString(_data, _end, layout.text) ||
+            !read(_data, _end, layout.transform) ||
+            !read(_data, _end, layout.align) ||
+            !read(_data, _end, layout.anchors) ||
+            !read(_data, _end, layout.wordWrap) ||
+            !read(_data, _end, layout.maxLines) ||
+            !read(_data, _end, layout.maxLineWidth) ||
+            !read(_data, _end, layout.lineSpacing) ||
+            !read(_data, _end, layout.type) ||
+            !read(_data, _end, layout.textRanges)) {
+            return false;
+        }
+        if (layout.anchors.count < 0 || layout.anchors.count > LabelProperty::max_anchors) {
+            return false;
+        }
+        _layouts.push_back(std::move(layout));
+    }
+    return true;
 }
 
 void TextLabels::setQuads(std::vector<GlyphQuad>&& _quads, std::bitset<FontContext::max_textures> _atlasRefs) {
@@ -82,6 +82,8 @@ public:
 
     float candidatePriority() const override;
 
+    bool serialize(std::vector<char>& _out) const override;
+
 protected:
 
     const Coordinates m_coordinates;
@@ -9,21 +9,64 @@
 
 namespace Tangram {
 
+/* Text and font of the quads of labels, to lay out the text again when the
+ * labels are restored (see TextStyleBuilder::deserialize) */
+struct TextLayout {
+    std::string fontFamily;
+    std::string fontStyle;
+    std::string fontWeight;
+    float fontSize;
+    std::string text;
+    TextLabelProperty::Transform transform;
+    TextLabelProperty::Align align;
+    LabelProperty::Anchors anchors;
+    bool wordWrap;
+    uint32_t maxLines;
+    uint32_t maxLineWidth;
+    float lineSpacing;
+    Label::Type type;
+    // Quads of the text in TextLabels::quads
+    TextRange textRanges;
+};
+
 class TextLabels : public LabelSet {
 
 public:
 
-    TextLabels(const TextStyle& _style) : style(_style) {}
+    TextLabels(const TextStyle& _style) : m_style(&_style) {}
 
     ~TextLabels() override;
 
     void setQuads(std::vector<GlyphQuad>&& _quads, std::bitset<FontContext::max_textures> _atlasRefs);
 
+    void setLayouts(std::vector<TextLayout>&& _layouts) { layouts = std::move(_layouts); }
+
+    /* Index of the layout of the quads in @_textRanges, layouts.size() when
+     * there is none */
+    size_t findLayout(const TextRange& _textRanges) const;
+
+    bool serialize(std::vector<char>& _out) const override;
+
+    /* Append the layouts to @_out, which the serialized labels refer to */
+    void serializeLayouts(std::vector<char>& _out) const;
+
+    /* Read the layouts which serializeLayouts() wrote */
+    static bool deserializeLayouts(const char*& _data, const char* _end,
+                                   std::vector<TextLayout>& _layouts);
+
+    bool setStyle(const Style& _style) override;
+
+    const TextStyle& style() const { return *m_style; }
+
     std::vector<GlyphQuad> quads;
-    const TextStyle& style;
+
+    // Sorted by the start of their quads
+    std::vector<TextLayout> layouts;
 
 private:
 
+    const TextStyle* m_style;
+
     std::bitset<FontContext::max_textures> m_atlasRefs;
 };
 
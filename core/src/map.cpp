@@ -15,12 +15,14 @@
 #include "marker/markerManager.h"
 #include "platform.h"
 #include "scene/scene.h"
+#include "scene/sceneDiff.h"
 #include "scene/sceneLoader.h"
 #include "selection/selectionQuery.h"
 #include "style/material.h"
 #include "style/style.h"
 #include "text/fontContext.h"
 #include "tile/tile.h"
+#include "tile/geometryCache.h"
 #include "tile/tileCache.h"
 #include "tile/tileManager.h"
 #include "util/asyncWorker.h"
@@ -37,6 +39,7 @@
 namespace Tangram {
 
 const static size_t MAX_WORKERS = 2;
+const static size_t MAX_PARSE_WORKERS = 2;
 
 struct CameraEase {
     struct {
@@ -56,10 +59,10 @@ public:
         platform(_platform),
         inputHandler(_platform, view),
         scene(std::make_shared<Scene>(_platform, Url())),
-        tileWorker(_platform, MAX_WORKERS),
+        tileWorker(_platform, MAX_WORKERS, MAX_PARSE_WORKERS),
         tileManager(_platform, tileWorker) {}
 
-    void setScene(std::shared_ptr<Scene>& _scene);
+    void setScene(std::shared_ptr<Scene>& _scene, const SceneDiff* _diff = nullptr);
 
     void setPixelScale(float _pixelsPerPoint);
 
@@ -92,6 +95,9 @@ public:
     float pickRadius = .5f;
     bool isCameraEasing = false;
 
+    // Time in seconds to look ahead on camera animations for tile prefetching
+    float prefetchLookahead = .5f;
+
     std::vector<SelectionQuery> selectionQueries;
 
     SceneReadyCallback onSceneReady = nullptr;
@@ -130,7 +136,10 @@ Map::~Map() {
     Primitives::deinit();
 }
 
-void Map::Impl::setScene(std::shared_ptr<Scene>& _scene) {
+void Map::Impl::setScene(std::shared_ptr<Scene>& _scene, const SceneDiff* _diff) {
+
+    // Tiles can only be kept when the diff was computed against the current scene
+    bool rebuildStyles = _diff && _diff->partial && scene->id == _diff->baseSceneId;
 
     scene = _scene;
 
@@ -168,8 +177,14 @@ void Map::Impl::setScene(std::shared_ptr<Scene>& _scene) {
     }
 
     inputHandler.setView(view);
-    tileManager.setTileSources(_scene->tileSources());
-    tileWorker.setScene(_scene);
+
+    if (rebuildStyles) {
+        tileWorker.setScene(_scene);
+        tileManager.rebuildStyles(*_diff, _scene->styles());
+    } else {
+        tileManager.setTileSources(_scene->tileSources());
+        tileWorker.setScene(_scene);
+    }
     markerManager.setScene(_scene);
 
     bool animated = scene->animated() == Scene::animate::yes;
@@ -320,9 +335,11 @@ SceneID Map::updateSceneAsync(const std::vector<SceneUpdate>& _sceneUpdates) {
                 return;
             }
 
+            std::shared_ptr<Scene> baseScene;
             {
                 std::lock_guard<std::mutex> lock(impl->sceneMutex);
-                nextScene->copyConfig(*impl->lastValidScene);
+                baseScene = impl->lastValidScene;
+                nextScene->copyConfig(*baseScene);
             }
 
             if (!SceneLoader::applyUpdates(platform, *nextScene, updates)) {
@@ -340,17 +357,28 @@ SceneID Map::updateSceneAsync(const std::vector<SceneUpdate>& _sceneUpdates) {
 
             bool configApplied = SceneLoader::applyConfig(platform, nextScene);
 
+            // Find the styles that need to be rebuilt when tiles of the
+            // previous scene can be kept.
+            SceneDiff diff;
+            if (configApplied) {
+                diff = SceneDiff::compare(*baseScene, *nextScene);
+
+                // Keep the TileSources, tiles refer to them by id
+                if (diff.partial) { nextScene->tileSources() = baseScene->tileSources(); }
+            }
+            baseScene.reset();
+
             {
                 std::lock_guard<std::mutex> lock(impl->sceneMutex);
                 // NB: Need to set the scene on the worker thread so that waiting
                 // applyUpdates AsyncTasks can access it to copy the config.
                 if (configApplied) { impl->lastValidScene = nextScene; }
             }
-            impl->jobQueue.add([nextScene, configApplied, this]() {
+            impl->jobQueue.add([nextScene, configApplied, diff = std::move(diff), this]() {
 
                     if (configApplied) {
                         auto s = nextScene;
-                        impl->setScene(s);
+                        impl->setScene(s, &diff);
                     }
                     if (impl->onSceneReady) { impl->onSceneReady(nextScene->id, nullptr); }
                 });
@@ -423,6 +451,22 @@ bool Map::update(float _dt) {
 
     impl->view.update();
 
+    // Predict the view of camera animations and flings to prefetch tiles
+    std::unique_ptr<View> predictedView;
+    if (impl->isCameraEasing && impl->prefetchLookahead > 0.f) {
+        predictedView = std::make_unique<View>(impl->view);
+
+        bool predicted = impl->ease
+            ? impl->ease->predict(impl->prefetchLookahead, *predictedView)
+            : impl->inputHandler.predictFling(impl->prefetchLookahead, *predictedView);
+
+        if (predicted) {
+            predictedView->update();
+        } else {
+            predictedView.reset();
+        }
+    }
+
     bool markersChanged = impl->markerManager.update(impl->view, _dt);
 
     for (const auto& style : impl->scene->styles()) {
@@ -432,7 +476,7 @@ bool Map::update(float _dt) {
     {
         std::lock_guard<std::mutex> lock(impl->tilesMutex);
 
-        impl->tileManager.updateTileSets(impl->view);
+        impl->tileManager.updateTileSets(impl->view, predictedView.get());
 
         auto& tiles = impl->tileManager.getVisibleTiles();
         auto& markers = impl->markerManager.markers();
@@ -462,8 +506,10 @@ bool Map::update(float _dt) {
         viewComplete = false;
     }
 
-    // Request render if labels are in fading states or markers are easing.
-    if (impl->isCameraEasing || labelsNeedUpdate || markersNeedUpdate) {
+    // Request render if labels are in fading states or markers are easing
+    // or ready tiles were deferred to the next frames.
+    if (impl->isCameraEasing || labelsNeedUpdate || markersNeedUpdate ||
+        impl->tileManager.hasDeferredTiles()) {
         platform->requestRender();
     }
 
@@ -555,7 +601,7 @@ bool Map::render() {
 
     if (drawSelectionBuffer) {
         impl->selectionBuffer->drawDebug(impl->renderState, viewport);
-        FrameInfo::draw(impl->renderState, impl->view, impl->tileManager);
+        FrameInfo::draw(impl->renderState, impl->view, impl->tileManager, impl->tileWorker);
         return impl->isCameraEasing;
     }
 
@@ -563,6 +609,9 @@ bool Map::render() {
     {
         std::lock_guard<std::mutex> lock(impl->tilesMutex);
 
+        // Upload completed tiles within the frame budget
+        impl->tileManager.uploadTiles(impl->renderState);
+
         // Loop over all styles
         for (const auto& style : impl->scene->styles()) {
 
@@ -583,7 +632,7 @@ bool Map::render() {
 
     impl->labels.drawDebug(impl->renderState, impl->view);
 
-    FrameInfo::draw(impl->renderState, impl->view, impl->tileManager);
+    FrameInfo::draw(impl->renderState, impl->view, impl->tileManager, impl->tileWorker);
 
     return impl->isCameraEasing;
 }
@@ -674,16 +723,19 @@ void Map::setCameraPositionEased(const CameraPosition& _camera, float _duration,
     e.start.tilt = getTilt();
     e.end.tilt = _camera.tilt;
 
-    impl->ease = std::make_unique<Ease>(_duration,
-        [=](float t) {
-            impl->view.setPosition(ease(e.start.pos.x, e.end.pos.x, t, _e),
-                                   ease(e.start.pos.y, e.end.pos.y, t, _e));
-            impl->view.setZoom(ease(e.start.zoom, e.end.zoom, t, _e));
+    auto apply =
+        [=](float t, View& view) {
+            view.setPosition(ease(e.start.pos.x, e.end.pos.x, t, _e),
+                             ease(e.start.pos.y, e.end.pos.y, t, _e));
+            view.setZoom(ease(e.start.zoom, e.end.zoom, t, _e));
 
-            impl->view.setRoll(ease(e.start.rotation, e.end.rotation, t, _e));
+            view.setRoll(ease(e.start.rotation, e.end.rotation, t, _e));
 
-            impl->view.setPitch(ease(e.start.tilt, e.end.tilt, t, _e));
-        });
+            view.setPitch(ease(e.start.tilt, e.end.tilt, t, _e));
+        };
+
+    impl->ease = std::make_unique<Ease>(_duration, [=](float t) { apply(t, impl->view); });
+    impl->ease->viewCb = apply;
 
     platform->requestRender();
 }
@@ -857,13 +909,18 @@ void Map::flyTo(const CameraPosition& _camera, float _duration, float _speed) {
                                distance);
 
     EaseType e = EaseType::cubic;
+    auto apply =
+        [=](float t, View& view) {
+            glm::dvec3 pos = fn(t);
+            view.setPosition(pos.x, pos.y);
+            view.setZoom(pos.z);
+            view.setRoll(ease(rStart, rEnd, t, e));
+            view.setPitch(ease(tStart, _camera.tilt, t, e));
+        };
+
     auto cb =
         [=](float t) {
-            glm::dvec3 pos = fn(t);
-            impl->view.setPosition(pos.x, pos.y);
-            impl->view.setZoom(pos.z);
-            impl->view.setRoll(ease(rStart, rEnd, t, e));
-            impl->view.setPitch(ease(tStart, _camera.tilt, t, e));
+            apply(t, impl->view);
             impl->platform->requestRender();
         };
 
@@ -874,6 +931,7 @@ void Map::flyTo(const CameraPosition& _camera, float _duration, float _speed) {
     cancelCameraAnimation();
 
     impl->ease = std::make_unique<Ease>(duration, cb);
+    impl->ease->viewCb = apply;
 
     platform->requestRender();
 }
@@ -1088,6 +1146,43 @@ void Map::setupGL() {
     // Hardware::printAvailableExtensions();
 }
 
+void Map::setTilePrefetch(float _lookahead, uint32_t _maxTiles, size_t _maxBytes) {
+    impl->prefetchLookahead = _lookahead;
+    impl->tileManager.setPrefetchBudget(_maxTiles, _maxBytes);
+}
+
+void Map::setTileFrameBudget(float _completeTime, size_t _uploadBytes) {
+    impl->tileManager.setFrameBudget(_completeTime, _uploadBytes);
+}
+
+void Map::setTileParseWorkers(uint32_t _count) {
+    impl->tileWorker.setParseWorkers(_count);
+}
+
+void Map::setTileGeometryCache(const std::string& _path, size_t _maxSize) {
+    std::shared_ptr<GeometryCache> cache;
+    if (!_path.empty()) { cache = std::make_shared<GeometryCache>(_path, _maxSize); }
+
+    impl->tileWorker.setGeometryCache(cache);
+    impl->tileManager.setGeometryCache(cache);
+
+    // Pass the cache to new TileBuilders
+    if (impl->scene) { impl->tileWorker.setScene(impl->scene); }
+}
+
+TileCacheStats Map::getTileCacheStats() {
+    auto cacheStats = impl->tileManager.getTileCache()->stats();
+
+    TileCacheStats stats;
+    stats.hits = cacheStats.hits;
+    stats.misses = cacheStats.misses;
+    stats.evictions = cacheStats.evictions;
+    stats.entries = cacheStats.entries;
+    stats.usage = cacheStats.usage;
+    stats.maxUsage = cacheStats.maxUsage;
+    return stats;
+}
+
 void Map::useCachedGlState(bool _useCache) {
     impl->cacheGlState = _useCache;
 }
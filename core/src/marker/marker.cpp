@@ -25,8 +25,9 @@ void Marker::setBounds(BoundingBox bounds) {
     m_origin = bounds.min; // South-West corner
 }
 
-void Marker::setFeature(std::unique_ptr<Feature> feature) {
+void Marker::setFeature(std::unique_ptr<Feature> feature, std::unique_ptr<GeometryArena> geometry) {
     m_feature = std::move(feature);
+    m_geometry = std::move(geometry);
 }
 
 void Marker::setStyling(std::string styling, bool isPath) {
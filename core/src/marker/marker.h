@@ -21,6 +21,7 @@ class View;
 struct DrawRule;
 struct DrawRuleData;
 struct Feature;
+class GeometryArena;
 struct StyledMesh;
 
 class Marker {
@@ -43,8 +44,9 @@ public:
     // maximum dimension (extent) of the bounds.
     void setBounds(BoundingBox bounds);
 
-    // Set the feature whose geometry will be used to build the marker.
-    void setFeature(std::unique_ptr<Feature> feature);
+    // Set the feature whose geometry will be used to build the marker, along with
+    // the arena that stores the geometry.
+    void setFeature(std::unique_ptr<Feature> feature, std::unique_ptr<GeometryArena> geometry);
 
     // Sets the styling struct for the marker
     void setStyling(std::string styling, bool isPath);
@@ -134,6 +136,7 @@ public:
 protected:
 
     std::unique_ptr<Feature> m_feature;
+    std::unique_ptr<GeometryArena> m_geometry;
     std::unique_ptr<StyledMesh> m_mesh;
     std::unique_ptr<Texture> m_texture;
     std::unique_ptr<DrawRuleMergeSet> m_drawRuleSet;
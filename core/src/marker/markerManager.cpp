@@ -139,9 +139,12 @@ bool MarkerManager::setPoint(MarkerID markerID, LngLat lngLat) {
     // If the marker does not have a 'point' feature mesh built, build it.
     if (!marker->mesh() || !marker->feature() || marker->feature()->geometryType != GeometryType::points) {
         auto feature = std::make_unique<Feature>();
+        auto geometry = std::make_unique<GeometryArena>();
         feature->geometryType = GeometryType::points;
-        feature->points.emplace_back();
-        marker->setFeature(std::move(feature));
+        geometry->addPoint({ 0.f, 0.f });
+        geometry->endRing();
+        feature->geometry = geometry->endFeature();
+        marker->setFeature(std::move(feature), std::move(geometry));
         buildMesh(*marker, m_zoom);
     }
 
@@ -187,9 +190,8 @@ bool MarkerManager::setPolyline(MarkerID markerID, LngLat* coordinates, int coun
 
     // Build a feature for the new set of polyline points.
     auto feature = std::make_unique<Feature>();
+    auto geometry = std::make_unique<GeometryArena>();
     feature->geometryType = GeometryType::lines;
-    feature->lines.emplace_back();
-    auto& line = feature->lines.back();
 
     // Determine the bounds of the polyline.
     BoundingBox bounds;
@@ -211,11 +213,13 @@ bool MarkerManager::setPolyline(MarkerID markerID, LngLat* coordinates, int coun
     for (int i = 0; i < count; ++i) {
         auto degrees = LngLat(coordinates[i].longitude, coordinates[i].latitude);
         auto meters = MapProjection::lngLatToProjectedMeters(degrees);
-        line.emplace_back((meters.x - origin.x) * scale, (meters.y - origin.y) * scale);
+        geometry->addPoint(Point((meters.x - origin.x) * scale, (meters.y - origin.y) * scale));
     }
+    geometry->endRing();
+    feature->geometry = geometry->endFeature();
 
     // Update the feature data for the marker.
-    marker->setFeature(std::move(feature));
+    marker->setFeature(std::move(feature), std::move(geometry));
 
     // Build a new mesh for the marker.
     buildMesh(*marker, m_zoom);
@@ -238,9 +242,8 @@ bool MarkerManager::setPolygon(MarkerID markerID, LngLat* coordinates, int* coun
 
     // Build a feature for the new set of polygon points.
     auto feature = std::make_unique<Feature>();
+    auto geometry = std::make_unique<GeometryArena>();
     feature->geometryType = GeometryType::polygons;
-    feature->polygons.emplace_back();
-    auto& polygon = feature->polygons.back();
 
     // Determine the bounds of the polygon.
     BoundingBox bounds;
@@ -269,18 +272,19 @@ bool MarkerManager::setPolygon(MarkerID markerID, LngLat* coordinates, int* coun
     ring = coordinates;
     for (int i = 0; i < rings; ++i) {
         int count = counts[i];
-        polygon.emplace_back();
-        auto& line = polygon.back();
         for (int j = 0; j < count; ++j) {
             auto degrees = LngLat(ring[j].longitude, ring[j].latitude);
             auto meters = MapProjection::lngLatToProjectedMeters(degrees);
-            line.emplace_back((meters.x - origin.x) * scale, (meters.y - origin.y) * scale);
+            geometry->addPoint(Point((meters.x - origin.x) * scale, (meters.y - origin.y) * scale));
         }
+        geometry->endRing();
         ring += count;
     }
+    geometry->endPart();
+    feature->geometry = geometry->endFeature();
 
     // Update the feature data for the marker.
-    marker->setFeature(std::move(feature));
+    marker->setFeature(std::move(feature), std::move(geometry));
 
     // Build a new mesh for the marker.
     buildMesh(*marker, m_zoom);
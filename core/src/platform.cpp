@@ -18,6 +18,11 @@ bool Platform::isContinuousRendering() const {
     return m_continuousRendering;
 }
 
+UrlRequestHandle Platform::startUrlRequestWithPriority(Url _url, UrlCallback _callback,
+                                                       UrlRequestPriority _priority) {
+    return startUrlRequest(std::move(_url), std::move(_callback));
+}
+
 bool Platform::bytesFromFileSystem(const char* _path, std::function<char*(size_t)> _allocator) {
     std::ifstream resource(_path, std::ifstream::ate | std::ifstream::binary);
 
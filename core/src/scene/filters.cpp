@@ -348,18 +348,18 @@ struct matcher {
         return true;
     }
     bool operator() (const Filter::Existence& f) const {
-        return f.exists == props.contains(f.key);
+        return f.exists == props.contains(f.property);
     }
     bool operator() (const Filter::EqualitySet& f) const {
         auto& value = (f.keyword == FilterKeyword::undefined)
-            ? props.get(f.key)
+            ? props.get(f.property)
             : ctx.getKeyword(f.keyword);
 
         return Value::visit(value, match_equal_set{f.values});
     }
     bool operator() (const Filter::Equality& f) const {
         auto& value = (f.keyword == FilterKeyword::undefined)
-            ? props.get(f.key)
+            ? props.get(f.property)
             : ctx.getKeyword(f.keyword);
 
         return Value::visit(value, match_equal{f.value});
@@ -367,7 +367,7 @@ struct matcher {
     bool operator() (const Filter::Range& f) const {
         auto scale = (f.hasPixelArea) ? ctx.getPixelAreaScale() : 1.f;
         auto& value = (f.keyword == FilterKeyword::undefined)
-            ? props.get(f.key)
+            ? props.get(f.property)
             : ctx.getKeyword(f.keyword);
         return Value::visit(value, match_range{f, scale});
     }
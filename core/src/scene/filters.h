@@ -1,5 +1,6 @@
 #pragma once
 
+#include "data/propertyKey.h"
 #include "util/variant.h"
 
 #include <memory>
@@ -31,11 +32,13 @@ struct Filter {
         std::string key;
         std::vector<Value> values;
         FilterKeyword keyword;
+        PropertyKey property;
     };
     struct Equality {
         std::string key;
         Value value;
         FilterKeyword keyword;
+        PropertyKey property;
     };
     struct Range {
         std::string key;
@@ -43,10 +46,12 @@ struct Filter {
         float max;
         FilterKeyword keyword;
         bool hasPixelArea;
+        PropertyKey property;
     };
     struct Existence {
         std::string key;
         bool exists;
+        PropertyKey property;
     };
     struct Function {
         uint32_t id;
@@ -83,18 +88,18 @@ struct Filter {
     // Create an 'equality' filter
     inline static Filter MatchEquality(const std::string& k, const std::vector<Value>& vals) {
         if (vals.size() == 1) {
-            return { Equality{ k, vals[0], keywordType(k) }};
+            return { Equality{ k, vals[0], keywordType(k), PropertyKey::intern(k) }};
         } else {
-            return { EqualitySet{ k, vals, keywordType(k) }};
+            return { EqualitySet{ k, vals, keywordType(k), PropertyKey::intern(k) }};
         }
     }
     // Create a 'range' filter
     inline static Filter MatchRange(const std::string& k, float min, float max, bool sqA) {
-        return { Range{ k, min, max, keywordType(k), sqA }};
+        return { Range{ k, min, max, keywordType(k), sqA, PropertyKey::intern(k) }};
     }
     // Create an 'existence' filter
     inline static Filter MatchExistence(const std::string& k, bool ex) {
-        return { Existence{ k, ex }};
+        return { Existence{ k, ex, PropertyKey::intern(k) }};
     }
     // Create an 'function' filter with reference to Scene function id
     inline static Filter MatchFunction(uint32_t id) {
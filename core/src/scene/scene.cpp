@@ -27,13 +27,13 @@ Scene::Scene(std::shared_ptr<const Platform> _platform, const Url& _url)
     : id(s_serial++),
       m_url(_url),
       m_fontContext(std::make_shared<FontContext>(_platform)),
-      m_featureSelection(std::make_unique<FeatureSelection>()) {
+      m_featureSelection(std::make_shared<FeatureSelection>()) {
 }
 
 Scene::Scene(std::shared_ptr<const Platform> _platform, const std::string& _yaml, const Url& _url)
     : id(s_serial++),
       m_fontContext(std::make_shared<FontContext>(_platform)),
-      m_featureSelection(std::make_unique<FeatureSelection>()) {
+      m_featureSelection(std::make_shared<FeatureSelection>()) {
 
     m_url = _url;
     m_yaml = _yaml;
@@ -41,7 +41,7 @@ Scene::Scene(std::shared_ptr<const Platform> _platform, const std::string& _yaml
 
 void Scene::copyConfig(const Scene& _other) {
 
-    m_featureSelection.reset(new FeatureSelection());
+    m_featureSelection = _other.m_featureSelection;
 
     m_config = YAML::Clone(_other.m_config);
     m_fontContext = _other.m_fontContext;
@@ -194,7 +194,9 @@ private:
 
     std::shared_ptr<FontContext> m_fontContext;
 
-    std::unique_ptr<FeatureSelection> m_featureSelection;
+    // Shared with Scenes derived by copyConfig() so that selection colors
+    // of tiles that are kept on scene updates remain unique
+    std::shared_ptr<FeatureSelection> m_featureSelection;
 
     animate m_animated = none;
 
@@ -0,0 +1,269 @@
+#include "scene/sceneDiff.h"
+
+#include "data/tileSource.h"
+#include "scene/dataLayer.h"
+#include "scene/scene.h"
+#include "style/style.h"
+
+#include "yaml-cpp/yaml.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <typeinfo>
+
+namespace Tangram {
+
+using StyleNames = std::set<std::string>;
+
+// Style names set for draw rules by parent layers
+using InheritedStyles = std::map<std::string, std::string>;
+
+static YAML::Node child(const YAML::Node& _node, const std::string& _key) {
+    if (_node.IsDefined() && _node.IsMap()) { return _node[_key]; }
+    return YAML::Node();
+}
+
+static bool equalNodes(const YAML::Node& _a, const YAML::Node& _b) {
+    bool definedA = _a.IsDefined() && !_a.IsNull();
+    bool definedB = _b.IsDefined() && !_b.IsNull();
+    if (!definedA || !definedB) { return definedA == definedB; }
+
+    return YAML::Dump(_a) == YAML::Dump(_b);
+}
+
+// Whether @_node contains JavaScript functions, which may read the scene globals
+static bool hasFunctions(const YAML::Node& _node) {
+    if (_node.IsScalar()) { return _node.Scalar().compare(0, 8, "function") == 0; }
+
+    if (_node.IsSequence()) {
+        for (const auto& item : _node) {
+            if (hasFunctions(item)) { return true; }
+        }
+    } else if (_node.IsMap()) {
+        for (const auto& entry : _node) {
+            if (hasFunctions(entry.second)) { return true; }
+        }
+    }
+    return false;
+}
+
+static bool isStyleParam(const StyleParam& _param) {
+    return (_param.key == StyleParamKey::style ||
+            _param.key == StyleParamKey::outline_style) &&
+        _param.value.is<std::string>();
+}
+
+static InheritedStyles inheritStyles(const SceneLayer& _layer, InheritedStyles _inherited) {
+    for (const auto& rule : _layer.rules()) {
+        for (const auto& param : rule.parameters) {
+            if (param.key == StyleParamKey::style && param.value.is<std::string>()) {
+                _inherited[rule.name] = param.value.get<std::string>();
+            }
+        }
+    }
+    return _inherited;
+}
+
+// Collect the styles of all draw rules in _layer and its sublayers or
+// only of the draw rules named _ruleName.
+static void collectStyles(const SceneLayer& _layer, const InheritedStyles& _inherited,
+                          const std::string* _ruleName, StyleNames& _styles) {
+
+    for (const auto& rule : _layer.rules()) {
+        if (_ruleName && rule.name != *_ruleName) { continue; }
+
+        _styles.insert(rule.name);
+
+        auto it = _inherited.find(rule.name);
+        if (it != _inherited.end()) { _styles.insert(it->second); }
+
+        for (const auto& param : rule.parameters) {
+            if (isStyleParam(param)) { _styles.insert(param.value.get<std::string>()); }
+        }
+    }
+
+    auto inherited = inheritStyles(_layer, _inherited);
+
+    for (const auto& sublayer : _layer.sublayers()) {
+        collectStyles(sublayer, inherited, _ruleName, _styles);
+    }
+}
+
+static void compareLayers(const SceneLayer& _old, const SceneLayer& _new,
+                          const YAML::Node& _oldNode, const YAML::Node& _newNode,
+                          const InheritedStyles& _oldInherited, const InheritedStyles& _newInherited,
+                          StyleNames& _styles) {
+
+    // Different set of features: All styles used by this layer are affected
+    if (_old.enabled() != _new.enabled() ||
+        !equalNodes(child(_oldNode, "filter"), child(_newNode, "filter"))) {
+        collectStyles(_old, _oldInherited, nullptr, _styles);
+        collectStyles(_new, _newInherited, nullptr, _styles);
+        return;
+    }
+
+    // Changed draw rules are merged with the rules of matching sublayers
+    std::set<std::string> ruleNames;
+    for (const auto& rule : _old.rules()) { ruleNames.insert(rule.name); }
+    for (const auto& rule : _new.rules()) { ruleNames.insert(rule.name); }
+
+    auto oldDraw = child(_oldNode, "draw");
+    auto newDraw = child(_newNode, "draw");
+
+    for (const auto& name : ruleNames) {
+        if (!equalNodes(child(oldDraw, name), child(newDraw, name))) {
+            collectStyles(_old, _oldInherited, &name, _styles);
+            collectStyles(_new, _newInherited, &name, _styles);
+        }
+    }
+
+    auto oldInherited = inheritStyles(_old, _oldInherited);
+    auto newInherited = inheritStyles(_new, _newInherited);
+
+    // Sublayer names are prefixed by the parent layer name
+    size_t prefix = _old.name().size() + DELIMITER.size();
+
+    for (const auto& oldSublayer : _old.sublayers()) {
+        auto it = std::find_if(_new.sublayers().begin(), _new.sublayers().end(),
+                               [&](auto& l) { return l.name() == oldSublayer.name(); });
+
+        if (it == _new.sublayers().end()) {
+            collectStyles(oldSublayer, oldInherited, nullptr, _styles);
+            continue;
+        }
+        auto key = oldSublayer.name().substr(prefix);
+        compareLayers(oldSublayer, *it, child(_oldNode, key), child(_newNode, key),
+                      oldInherited, newInherited, _styles);
+    }
+
+    for (const auto& newSublayer : _new.sublayers()) {
+        auto it = std::find_if(_old.sublayers().begin(), _old.sublayers().end(),
+                               [&](auto& l) { return l.name() == newSublayer.name(); });
+
+        if (it == _old.sublayers().end()) {
+            collectStyles(newSublayer, newInherited, nullptr, _styles);
+        }
+    }
+}
+
+bool SceneDiff::affects(const Style& _style) const {
+    return _style.getID() < styles.size() && styles[_style.getID()];
+}
+
+SceneDiff SceneDiff::compare(const Scene& _oldScene, const Scene& _newScene) {
+
+    SceneDiff diff;
+    diff.baseSceneId = _oldScene.id;
+
+    const auto& oldConfig = _oldScene.config();
+    const auto& newConfig = _newScene.config();
+
+    // Changes of tile data or resources which are shared by all tiles
+    for (const auto& key : { "sources", "textures", "fonts" }) {
+        if (!equalNodes(child(oldConfig, key), child(newConfig, key))) {
+            return diff;
+        }
+    }
+
+    const auto& oldStyles = _oldScene.styles();
+    const auto& newStyles = _newScene.styles();
+
+    // Tiles store meshes by Style ID
+    if (oldStyles.size() != newStyles.size()) { return diff; }
+
+    for (size_t i = 0; i < newStyles.size(); i++) {
+        if (oldStyles[i]->getName() != newStyles[i]->getName() ||
+            typeid(*oldStyles[i]) != typeid(*newStyles[i])) { return diff; }
+    }
+
+    const auto& oldSources = _oldScene.tileSources();
+    const auto& newSources = _newScene.tileSources();
+
+    if (oldSources.size() != newSources.size()) { return diff; }
+
+    for (size_t i = 0; i < newSources.size(); i++) {
+        if (oldSources[i]->name() != newSources[i]->name() ||
+            oldSources[i]->generateGeometry() != newSources[i]->generateGeometry() ||
+            oldSources[i]->collections() != newSources[i]->collections()) {
+            return diff;
+        }
+    }
+
+    StyleNames names;
+
+    // References to globals are resolved in the config, but functions read
+    // the globals when tiles are built
+    bool globalsChanged = !equalNodes(child(oldConfig, "global"), child(newConfig, "global"));
+
+    auto oldStyleNodes = child(oldConfig, "styles");
+    auto newStyleNodes = child(newConfig, "styles");
+
+    for (const auto& style : newStyles) {
+        const auto& name = style->getName();
+        auto styleNode = child(newStyleNodes, name);
+
+        if (!equalNodes(child(oldStyleNodes, name), styleNode) ||
+            (globalsChanged && hasFunctions(styleNode))) {
+            names.insert(name);
+        }
+    }
+
+    auto oldLayerNodes = child(oldConfig, "layers");
+    auto newLayerNodes = child(newConfig, "layers");
+
+    const auto& oldLayers = _oldScene.layers();
+    const auto& newLayers = _newScene.layers();
+
+    if (globalsChanged) {
+        for (const auto& layer : newLayers) {
+            if (hasFunctions(child(newLayerNodes, layer.name()))) {
+                collectStyles(layer, {}, nullptr, names);
+            }
+        }
+    }
+
+    for (const auto& oldLayer : oldLayers) {
+        auto it = std::find_if(newLayers.begin(), newLayers.end(),
+                               [&](auto& l) { return l.name() == oldLayer.name(); });
+
+        if (it == newLayers.end()) {
+            collectStyles(oldLayer, {}, nullptr, names);
+
+        } else if (oldLayer.source() != it->source() ||
+                   oldLayer.collections() != it->collections()) {
+            collectStyles(oldLayer, {}, nullptr, names);
+            collectStyles(*it, {}, nullptr, names);
+
+        } else {
+            compareLayers(oldLayer, *it,
+                          child(oldLayerNodes, oldLayer.name()),
+                          child(newLayerNodes, oldLayer.name()),
+                          {}, {}, names);
+        }
+    }
+
+    for (const auto& newLayer : newLayers) {
+        auto it = std::find_if(oldLayers.begin(), oldLayers.end(),
+                               [&](auto& l) { return l.name() == newLayer.name(); });
+
+        if (it == oldLayers.end()) {
+            collectStyles(newLayer, {}, nullptr, names);
+        }
+    }
+
+    diff.styles.assign(newStyles.size(), false);
+
+    for (const auto& name : names) {
+        if (const auto* style = _newScene.findStyle(name)) {
+            diff.styles[style->getID()] = true;
+        }
+    }
+
+    diff.partial = true;
+
+    return diff;
+}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+class Scene;
+class Style;
+
+/* Changes between two Scenes where one was derived from the other by
+ * SceneUpdates (see Scene::copyConfig)
+ *
+ * Compares layers, draw rules, style definitions and, for JavaScript
+ * functions, the scene globals to determine which styles of already built
+ * tiles need to be rebuilt. Tiles can keep their TileData and the meshes of
+ * all other styles.
+ */
+struct SceneDiff {
+
+    // Id of the Scene the diff was computed against
+    int32_t baseSceneId = -1;
+
+    // When false the new Scene requires to reload all tiles
+    bool partial = false;
+
+    // Styles to rebuild, indexed by Style ID. Style IDs are equal in both
+    // Scenes when the diff is partial.
+    std::vector<bool> styles;
+
+    bool affects(const Style& _style) const;
+
+    static SceneDiff compare(const Scene& _oldScene, const Scene& _newScene);
+};
+
+}
@@ -5,6 +5,7 @@
 #include "data/mbtilesDataSource.h"
 #include "data/networkDataSource.h"
 #include "data/rasterSource.h"
+#include "data/tileArchiveDataSource.h"
 #include "data/tileSource.h"
 #include "gl/shaderSource.h"
 #include "gl/texture.h"
@@ -1029,6 +1030,14 @@ void SceneLoader::loadSource(const std::shared_ptr<Platform>& platform, const st
         isMBTilesFile = urlLength > extLength && (url.compare(urlLength - extLength, extLength, extStr) == 0);
     }
 
+    bool isTileArchive = false;
+    {
+        const char* extStr = ".tilearchive";
+        const size_t extLength = strlen(extStr);
+        const size_t urlLength = url.length();
+        isTileArchive = urlLength > extLength && (url.compare(urlLength - extLength, extLength, extStr) == 0);
+    }
+
     bool isTms = false;
     if (auto tmsNode = source["tms"]) {
         YamlUtil::getBool(tmsNode, isTms);
@@ -1047,8 +1056,23 @@ void SceneLoader::loadSource(const std::shared_ptr<Platform>& platform, const st
         LOGE("MBTiles support is disabled. This source will be ignored: %s", name.c_str());
         return;
 #endif
+    } else if (isTileArchive) {
+        // The archive is tiled.
+        tiled = true;
+        rawSources->setNext(std::make_unique<TileArchiveDataSource>(platform, url));
     } else if (tiled) {
-        rawSources->setNext(std::make_unique<NetworkDataSource>(platform, url, std::move(subdomains), isTms));
+        auto network = std::make_unique<NetworkDataSource>(platform, url, std::move(subdomains), isTms);
+        // Seconds after which tiles of this source are requested again instead of
+        // being restored from the GeometryCache
+        if (auto maxAgeNode = source["max_age"]) {
+            int maxAge = 0;
+            if (YamlUtil::getInt(maxAgeNode, maxAge) && maxAge >= 0) {
+                network->setMaxAge(std::chrono::seconds(maxAge));
+            } else {
+                LOGW("Invalid max_age for source '%s': %s", name.c_str(), Dump(maxAgeNode).c_str());
+            }
+        }
+        rawSources->setNext(std::move(network));
     }
 
     std::shared_ptr<TileSource> sourcePtr;
@@ -1767,6 +1791,7 @@ void SceneLoader::loadLayer(const std::pair<Node, Node>& layer, const std::share
 
     std::string source;
     std::vector<std::string> collections;
+    std::shared_ptr<TileSource> dataSource;
 
     auto sublayer = loadSublayer(layer.second, name, scene);
 
@@ -1774,7 +1799,7 @@ void SceneLoader::loadLayer(const std::pair<Node, Node>& layer, const std::share
         if (Node data_source = data["source"]) {
             if (data_source.IsScalar()) {
                 source = data_source.Scalar();
-                auto dataSource = scene->getTileSource(source);
+                dataSource = scene->getTileSource(source);
                 // Makes sure to set the data source as a primary tile geometry generation source.
                 // A data source is geometry generating source only when its used within a layer's data block
                 // and when the layer is not disabled
@@ -1804,6 +1829,10 @@ void SceneLoader::loadLayer(const std::pair<Node, Node>& layer, const std::share
         collections.push_back(name);
     }
 
+    // Lets the parser skip the collections that no layer uses
+    if (dataSource && sublayer.enabled()) {
+        dataSource->addCollections(collections);
+    }
 
     scene->layers().push_back({ std::move(sublayer), source, collections });
 }
@@ -71,6 +71,8 @@ struct DebugStyleBuilder : public StyleBuilder {
         return std::move(mesh);
     }
 
+    void reset() override {}
+
     const Style& style() const override { return m_style; }
 
     DebugStyleBuilder(const DebugStyle& _style) : m_style(_style) {}
@@ -112,11 +112,52 @@ std::unique_ptr<StyleBuilder> PointStyle::createBuilder() const {
     return std::make_unique<PointStyleBuilder>(*this);
 }
 
+bool PointStyle::deserializeMesh(const char*& _data, const char* _end, const Tile& _tile,
+                                 const SelectionColorMap& _selectionColors,
+                                 std::unique_ptr<StyledMesh>& _mesh) const {
+
+    // Labels are built again from their serialized parameters
+    PointStyleBuilder builder(*this);
+    builder.setup(_tile);
+
+    if (!builder.deserialize(_data, _end, _selectionColors)) {
+        builder.reset();
+        return false;
+    }
+
+    _mesh = builder.build();
+    return true;
+}
+
 void PointStyle::setPixelScale(float _pixelScale) {
     Style::setPixelScale(_pixelScale);
     m_textStyle->setPixelScale(_pixelScale);
 }
 
+bool PointStyle::textureName(const Texture* _texture, std::string& _name) const {
+    if (_texture && _texture == m_defaultTexture.get()) {
+        _name.clear();
+        return true;
+    }
+    if (!_texture || !m_textures) { return false; }
+
+    for (const auto& entry : *m_textures) {
+        if (entry.second.get() == _texture) {
+            _name = entry.first;
+            return true;
+        }
+    }
+    return false;
+}
+
+Texture* PointStyle::texture(const std::string& _name) const {
+    if (_name.empty()) { return m_defaultTexture.get(); }
+    if (!m_textures) { return nullptr; }
+
+    auto it = m_textures->find(_name);
+    return it != m_textures->end() ? it->second.get() : nullptr;
+}
+
 SpriteVertex* PointStyle::pushQuad(Texture* texture) const {
 
     if (m_batches.empty() || m_batches.back().texture != texture) {
@@ -43,11 +43,22 @@ public:
     auto textures() const { return m_textures; }
     const auto& defaultTexture() const { return m_defaultTexture; }
 
+    /* Name of @_texture in the textures of the Scene, empty for the default
+     * texture. Returns false when @_texture is neither. */
+    bool textureName(const Texture* _texture, std::string& _name) const;
+
+    /* Texture of the Scene named @_name, the default texture for an empty name */
+    Texture* texture(const std::string& _name) const;
+
     auto& mesh() const { return m_mesh; }
     virtual size_t dynamicMeshSize() const override { return m_mesh->bufferSize(); }
 
     virtual std::unique_ptr<StyleBuilder> createBuilder() const override;
 
+    virtual bool deserializeMesh(const char*& _data, const char* _end, const Tile& _tile,
+                                 const SelectionColorMap& _selectionColors,
+                                 std::unique_ptr<StyledMesh>& _mesh) const override;
+
     virtual void build(const Scene& _scene) override;
 
     virtual void constructVertexLayout() override;
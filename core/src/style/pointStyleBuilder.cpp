@@ -13,6 +13,7 @@
 #include "tile/tile.h"
 #include "util/geom.h"
 #include "util/lineSampler.h"
+#include "util/serialize.h"
 #include "view/view.h"
 
 namespace Tangram {
@@ -33,6 +34,69 @@ void IconMesh::setTextLabels(std::unique_ptr<StyledMesh> _textLabels) {
     textLabels = std::move(_textLabels);
 }
 
+// Texture of @_style with the name of @_texture in @_previous
+static bool findTexture(const PointStyle& _previous, const PointStyle& _style,
+                        const Texture* _texture, Texture*& _result) {
+    if (!_texture) {
+        _result = nullptr;
+        return true;
+    }
+    std::string name;
+    if (!_previous.textureName(_texture, name)) { return false; }
+
+    _result = _style.texture(name);
+    return _result != nullptr;
+}
+
+bool IconMesh::setStyle(const Style& _style) {
+    auto& style = static_cast<const PointStyle&>(_style);
+    auto* sprites = static_cast<SpriteLabels*>(spriteLabels.get());
+    if (!sprites) { return false; }
+
+    // Find all textures before any label is changed
+    std::vector<Texture*> textures;
+    for (auto& label : m_labels) {
+        auto* sprite = dynamic_cast<SpriteLabel*>(label.get());
+        if (!sprite) { continue; }
+
+        Texture* texture = nullptr;
+        if (!findTexture(*sprites->m_style, style, sprite->texture(), texture)) {
+            return false;
+        }
+        textures.push_back(texture);
+    }
+
+    if (textLabels && !static_cast<TextLabels&>(*textLabels).setStyle(style.textStyle())) {
+        return false;
+    }
+
+    size_t i = 0;
+    for (auto& label : m_labels) {
+        if (auto* sprite = dynamic_cast<SpriteLabel*>(label.get())) {
+            sprite->setTexture(textures[i++]);
+        }
+    }
+    sprites->m_style = &style;
+    return true;
+}
+
+bool IconMesh::serialize(std::vector<char>& _out) const {
+    auto* sprites = static_cast<const SpriteLabels*>(spriteLabels.get());
+    if (!sprites) { return false; }
+
+    write(_out, uint32_t(sprites->quads.size()));
+    for (const auto& quad : sprites->quads) { write(_out, quad); }
+
+    // Layouts of the texts of the labels
+    if (textLabels) {
+        static_cast<const TextLabels&>(*textLabels).serializeLayouts(_out);
+    } else {
+        write(_out, uint32_t(0));
+    }
+
+    return serializeLabels(m_labels, _out);
+}
+
 void PointStyleBuilder::addLayoutItems(LabelCollider& _layout) {
     _layout.addLabels(m_labels);
     m_textStyleBuilder->addLayoutItems(_layout);
@@ -80,6 +144,69 @@ std::unique_ptr<StyledMesh> PointStyleBuilder::build() {
     return std::move(m_iconMesh);
 }
 
+bool PointStyleBuilder::deserialize(const char*& _data, const char* _end,
+                                    const SelectionColorMap& _selectionColors) {
+
+    uint32_t numQuads = 0;
+    if (!read(_data, _end, numQuads) || size_t(_end - _data) / sizeof(SpriteQuad) < numQuads) {
+        return false;
+    }
+    m_quads.resize(numQuads);
+    for (auto& quad : m_quads) { read(_data, _end, quad); }
+
+    auto& textStyleBuilder = static_cast<TextStyleBuilder&>(*m_textStyleBuilder);
+
+    std::vector<TextStyleBuilder::LabelAttributes> textAttributes;
+    if (!textStyleBuilder.deserializeLayouts(_data, _end, textAttributes)) { return false; }
+
+    auto readLabel = [&](LabelType _type, const char*& _labelData, const char* _labelEnd) -> Label* {
+        if (_type == LabelType::text) {
+            return textStyleBuilder.deserializeLabel(_labelData, _labelEnd, textAttributes, _selectionColors);
+        }
+        if (_type != LabelType::icon) { return nullptr; }
+
+        Label::Type type;
+        Label::Options options;
+        glm::vec2 size;
+        SpriteLabel::Coordinates coordinates;
+        SpriteLabel::VertexAttributes attrib;
+        uint32_t labelsPos = 0;
+        bool hasTexture = false;
+        std::string textureName;
+
+        if (!Label::deserialize(_labelData, _labelEnd, type, options, size) ||
+            !read(_labelData, _labelEnd, coordinates) || !read(_labelData, _labelEnd, attrib) ||
+            !read(_labelData, _labelEnd, labelsPos) || labelsPos >= numQuads ||
+            !read(_labelData, _labelEnd, hasTexture) || !readString(_labelData, _labelEnd, textureName)) {
+            return nullptr;
+        }
+
+        Texture* texture = nullptr;
+        if (hasTexture) {
+            texture = m_style.texture(textureName);
+            if (!texture) { return nullptr; }
+        }
+
+        options.featureId = _selectionColors(options.featureId);
+        attrib.selectionColor = _selectionColors(attrib.selectionColor);
+
+        m_labels.push_back(std::make_unique<SpriteLabel>(coordinates, size, options, attrib, texture,
+                                                         *m_spriteLabels, labelsPos));
+        return m_labels.back().get();
+    };
+
+    return LabelSet::deserializeLabels(_data, _end, readLabel);
+}
+
+void PointStyleBuilder::reset() {
+    m_quads.clear();
+    m_labels.clear();
+    m_iconMesh.reset();
+    m_spriteLabels.reset();
+
+    m_textStyleBuilder->reset();
+}
+
 void PointStyleBuilder::setup(const Tile& _tile) {
     m_zoom = _tile.getID().z;
     m_styleZoom = _tile.getID().s;
@@ -397,7 +524,7 @@ bool PointStyleBuilder::getUVQuad(Parameters& _params, glm::vec4& _quad, const T
     return true;
 }
 
-void PointStyleBuilder::labelPointsPlacing(const Line& _line, const glm::vec4& _uvsQuad, Texture* _texture,
+void PointStyleBuilder::labelPointsPlacing(const LineSpan& _line, const glm::vec4& _uvsQuad, Texture* _texture,
                                            Parameters& params, const DrawRule& _rule) {
 
     if (_line.size() < 2) { return; }
@@ -509,7 +636,7 @@ bool PointStyleBuilder::addPoint(const Point& _point, const Properties& _props,
     return true;
 }
 
-bool PointStyleBuilder::addLine(const Line& _line, const Properties& _props,
+bool PointStyleBuilder::addLine(const LineSpan& _line, const Properties& _props,
                                 const DrawRule& _rule) {
 
     Parameters p = applyRule(_rule);
@@ -531,7 +658,7 @@ bool PointStyleBuilder::addLine(const Line& _line, const Properties& _props,
     return true;
 }
 
-bool PointStyleBuilder::addPolygon(const Polygon& _polygon, const Properties& _props,
+bool PointStyleBuilder::addPolygon(const PolygonSpan& _polygon, const Properties& _props,
                                    const DrawRule& _rule) {
 
     Parameters p = applyRule(_rule);
@@ -15,6 +15,10 @@ struct IconMesh : LabelSet {
     std::unique_ptr<StyledMesh> spriteLabels;
 
     void setTextLabels(std::unique_ptr<StyledMesh> _textLabels);
+
+    bool setStyle(const Style& _style) override;
+
+    bool serialize(std::vector<char>& _out) const override;
 };
 
 struct PointStyleBuilder : public StyleBuilder {
@@ -47,12 +51,14 @@ struct PointStyleBuilder : public StyleBuilder {
 
     bool checkRule(const DrawRule& _rule) const override;
 
-    bool addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) override;
-    bool addLine(const Line& _line, const Properties& _props, const DrawRule& _rule) override;
+    bool addPolygon(const PolygonSpan& _polygon, const Properties& _props, const DrawRule& _rule) override;
+    bool addLine(const LineSpan& _line, const Properties& _props, const DrawRule& _rule) override;
     bool addPoint(const Point& _line, const Properties& _props, const DrawRule& _rule) override;
 
     std::unique_ptr<StyledMesh> build() override;
 
+    void reset() override;
+
     const Style& style() const override { return m_style; }
 
     PointStyleBuilder(const PointStyle& _style) : m_style(_style) {
@@ -62,7 +68,7 @@ struct PointStyleBuilder : public StyleBuilder {
     Parameters applyRule(const DrawRule& _rule) const;
 
     // Gets points for label placement and appropriate angle for each label (if `auto` angle is set)
-    void labelPointsPlacing(const Line& _line, const glm::vec4& _quad, Texture* _texture,
+    void labelPointsPlacing(const LineSpan& _line, const glm::vec4& _quad, Texture* _texture,
                             Parameters& _params, const DrawRule& _rule);
 
     void addLabel(const Point& _point, const glm::vec4& _quad, Texture* _texture,
@@ -72,6 +78,9 @@ struct PointStyleBuilder : public StyleBuilder {
 
     bool addFeature(const Feature& _feat, const DrawRule& _rule) override;
 
+    /* Add the sprites and labels of an IconMesh which IconMesh::serialize() wrote */
+    bool deserialize(const char*& _data, const char* _end, const SelectionColorMap& _selectionColors);
+
 private:
 
     /*
@@ -112,12 +112,14 @@ public:
         m_meshData.clear();
     }
 
-    bool addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) override;
+    bool addPolygon(const PolygonSpan& _polygon, const Properties& _props, const DrawRule& _rule) override;
 
     const Style& style() const override { return m_style; }
 
     std::unique_ptr<StyledMesh> build() override;
 
+    void reset() override { m_meshData.clear(); }
+
     PolygonStyleBuilder(const PolygonStyle& _style) : m_style(_style) {}
 
     Parameters parseRule(const DrawRule& _rule, const Properties& _props);
@@ -170,7 +172,7 @@ auto PolygonStyleBuilder<V>::parseRule(const DrawRule& _rule, const Properties&
 }
 
 template <class V>
-bool PolygonStyleBuilder<V>::addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) {
+bool PolygonStyleBuilder<V>::addPolygon(const PolygonSpan& _polygon, const Properties& _props, const DrawRule& _rule) {
 
     auto p = parseRule(_rule, _props);
 
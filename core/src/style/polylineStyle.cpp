@@ -188,13 +188,15 @@ public:
 
     std::unique_ptr<StyledMesh> build() override;
 
+    void reset() override;
+
     PolylineStyleBuilder(const PolylineStyle& _style)
         : m_style(_style),
           m_meshData(2) {}
 
-    void addMesh(const Line& _line, const Parameters& _params);
+    void addMesh(const LineSpan& _line, const Parameters& _params);
 
-    void buildLine(const Line& _line, const typename Parameters::Attributes& _att,
+    void buildLine(const LineSpan& _line, const typename Parameters::Attributes& _att,
                    MeshData<V>& _mesh, GLuint _selection);
 
     Parameters parseRule(const DrawRule& _rule, const Properties& _props);
@@ -273,6 +275,12 @@ std::unique_ptr<StyledMesh> PolylineStyleBuilder<V>::build() {
     return std::move(mesh);
 }
 
+template <class V>
+void PolylineStyleBuilder<V>::reset() {
+    m_meshData[0].clear();
+    m_meshData[1].clear();
+}
+
 template <class V>
 auto PolylineStyleBuilder<V>::parseRule(const DrawRule& _rule, const Properties& _props) -> Parameters {
     Parameters p;
@@ -411,14 +419,14 @@ bool PolylineStyleBuilder<V>::addFeature(const Feature& _feat, const DrawRule& _
         // Line geometries are never clipped to tiles, so keep all segments
         params.keepTileEdges = true;
 
-        for (auto& line : _feat.lines) {
+        for (auto line : _feat.lines()) {
             addMesh(line, params);
         }
     } else {
         params.closedPolygon = true;
 
-        for (auto& polygon : _feat.polygons) {
-            for (const auto& line : polygon) {
+        for (auto polygon : _feat.polygons()) {
+            for (auto line : polygon) {
                 addMesh(line, params);
             }
         }
@@ -428,7 +436,7 @@ bool PolylineStyleBuilder<V>::addFeature(const Feature& _feat, const DrawRule& _
 }
 
 template <class V>
-void PolylineStyleBuilder<V>::buildLine(const Line& _line, const typename Parameters::Attributes& _att,
+void PolylineStyleBuilder<V>::buildLine(const LineSpan& _line, const typename Parameters::Attributes& _att,
                                         MeshData<V>& _mesh, GLuint selection) {
 
     float zoom = m_overzoom2;
@@ -450,7 +458,7 @@ void PolylineStyleBuilder<V>::buildLine(const Line& _line, const typename Parame
 }
 
 template <class V>
-void PolylineStyleBuilder<V>::addMesh(const Line& _line, const Parameters& _params) {
+void PolylineStyleBuilder<V>::addMesh(const LineSpan& _line, const Parameters& _params) {
 
     m_builder.cap = _params.fill.cap;
     m_builder.join = _params.fill.join;
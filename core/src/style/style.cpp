@@ -537,6 +537,21 @@ void Style::applyDefaultDrawRules(DrawRule& _rule) const {
     }
 }
 
+bool Style::deserializeMesh(const char*& _data, const char* _end, const Tile& _tile,
+                            const SelectionColorMap& _selectionColors,
+                            std::unique_ptr<StyledMesh>& _mesh) const {
+
+    if (!m_vertexLayout) { return false; }
+
+    auto mesh = std::make_unique<RawMesh>(m_vertexLayout);
+    if (!mesh->deserialize(_data, _end)) { return false; }
+
+    mesh->mapSelectionColors(_selectionColors);
+
+    _mesh = std::move(mesh);
+    return true;
+}
+
 bool StyleBuilder::checkRule(const DrawRule& _rule) const {
 
     uint32_t checkColor;
@@ -562,17 +577,17 @@ bool StyleBuilder::addFeature(const Feature& _feat, const DrawRule& _rule) {
     bool added = false;
     switch (_feat.geometryType) {
         case GeometryType::points:
-            for (auto& point : _feat.points) {
+            for (const auto& point : _feat.points()) {
                 added |= addPoint(point, _feat.props, _rule);
             }
             break;
         case GeometryType::lines:
-            for (auto& line : _feat.lines) {
+            for (auto line : _feat.lines()) {
                 added |= addLine(line, _feat.props, _rule);
             }
             break;
         case GeometryType::polygons:
-            for (auto& polygon : _feat.polygons) {
+            for (auto polygon : _feat.polygons()) {
                 added |= addPolygon(polygon, _feat.props, _rule);
             }
             break;
@@ -588,12 +603,12 @@ bool StyleBuilder::addPoint(const Point& _point, const Properties& _props, const
     return false;
 }
 
-bool StyleBuilder::addLine(const Line& _line, const Properties& _props, const DrawRule& _rule) {
+bool StyleBuilder::addLine(const LineSpan& _line, const Properties& _props, const DrawRule& _rule) {
     // No-op by default
     return false;
 }
 
-bool StyleBuilder::addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) {
+bool StyleBuilder::addPolygon(const PolygonSpan& _polygon, const Properties& _props, const DrawRule& _rule) {
     // No-op by default
     return false;
 }
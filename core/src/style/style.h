@@ -6,6 +6,7 @@
 #include "scene/drawRule.h"
 #include "util/fastmap.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -63,10 +64,27 @@ enum class RasterType : uint8_t {
     custom
 };
 
+/* Maps the selection color of a serialized mesh to the color of the restored mesh */
+using SelectionColorMap = std::function<uint32_t(uint32_t)>;
+
 struct StyledMesh {
     virtual bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao = true) = 0;
     virtual size_t bufferSize() const = 0;
 
+    /* Whether the mesh can be drawn without uploading buffers first */
+    virtual bool isUploaded() const { return true; }
+
+    /* Upload buffers ahead of the first draw, returns the uploaded bytes */
+    virtual size_t uploadBuffers(RenderState& rs) { return 0; }
+
+    /* Drop vertex array objects which were set up for the attribute locations of
+     * a previous ShaderProgram, they are set up again on the next draw */
+    virtual void resetVaos() {}
+
+    /* Append the compiled buffers or the labels to @_out, returns false when
+     * the mesh cannot be restored from them (see Style::deserializeMesh) */
+    virtual bool serialize(std::vector<char>& _out) const { return false; }
+
     virtual ~StyledMesh() {}
 };
 
@@ -85,14 +103,17 @@ public:
     virtual bool addPoint(const Point& _point, const Properties& _props, const DrawRule& _rule);
 
     /* Build styled vertex data for line geometry */
-    virtual bool addLine(const Line& _line, const Properties& _props, const DrawRule& _rule);
+    virtual bool addLine(const LineSpan& _line, const Properties& _props, const DrawRule& _rule);
 
     /* Build styled vertex data for polygon geometry */
-    virtual bool addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule);
+    virtual bool addPolygon(const PolygonSpan& _polygon, const Properties& _props, const DrawRule& _rule);
 
     /* Create a new mesh object using the vertex layout corresponding to this style */
     virtual std::unique_ptr<StyledMesh> build() = 0;
 
+    /* Discard the geometry added since setup() without building a mesh */
+    virtual void reset() = 0;
+
     virtual bool checkRule(const DrawRule& _rule) const;
 
     virtual void addLayoutItems(LabelCollider& _layout) {}
@@ -322,6 +343,14 @@ public:
 
     virtual std::unique_ptr<StyleBuilder> createBuilder() const = 0;
 
+    /* Restore the mesh of @_tile which StyledMesh::serialize() wrote at @_data
+     * and advance @_data past it. @_mesh is empty when the mesh had no geometry.
+     * The selection colors of the mesh are replaced by @_selectionColors.
+     * Returns false when @_data holds no valid mesh of this Style. */
+    virtual bool deserializeMesh(const char*& _data, const char* _end, const Tile& _tile,
+                                 const SelectionColorMap& _selectionColors,
+                                 std::unique_ptr<StyledMesh>& _mesh) const;
+
     GLenum drawMode() const { return m_drawMode; }
     float pixelScale() const { return m_pixelScale; }
     const auto& vertexLayout() const { return m_vertexLayout; }
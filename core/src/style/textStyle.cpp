@@ -127,6 +127,23 @@ std::unique_ptr<StyleBuilder> TextStyle::createBuilder() const {
     return std::make_unique<TextStyleBuilder>(*this);
 }
 
+bool TextStyle::deserializeMesh(const char*& _data, const char* _end, const Tile& _tile,
+                                const SelectionColorMap& _selectionColors,
+                                std::unique_ptr<StyledMesh>& _mesh) const {
+
+    // Labels are built again from their serialized parameters
+    TextStyleBuilder builder(*this);
+    builder.setup(_tile);
+
+    if (!builder.deserialize(_data, _end, _selectionColors)) {
+        builder.reset();
+        return false;
+    }
+
+    _mesh = builder.build();
+    return true;
+}
+
 
 DynamicQuadMesh<TextVertex>& TextStyle::getMesh(size_t id) const {
     if (id >= m_meshes.size()) {
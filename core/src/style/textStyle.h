@@ -25,6 +25,9 @@ public:
 
     struct Parameters {
         std::shared_ptr<alfons::Font> font;
+        std::string fontFamily = "";
+        std::string fontStyle = "";
+        std::string fontWeight = "";
         std::string text = "";
         std::string textLeft = "";
         std::string textRight = "";
@@ -97,6 +100,10 @@ public:
 
     std::unique_ptr<StyleBuilder> createBuilder() const override;
 
+    bool deserializeMesh(const char*& _data, const char* _end, const Tile& _tile,
+                         const SelectionColorMap& _selectionColors,
+                         std::unique_ptr<StyledMesh>& _mesh) const override;
+
     DynamicQuadMesh<TextVertex>& getMesh(size_t id) const;
 
     auto& getMeshes() const { return m_meshes; }
@@ -14,6 +14,7 @@
 #include "util/geom.h"
 #include "util/mapProjection.h"
 #include "util/lineSampler.h"
+#include "util/serialize.h"
 #include "view/view.h"
 
 #include "unicode/unistr.h"
@@ -61,6 +62,17 @@ void TextStyleBuilder::setup(const Marker& marker, int zoom) {
     m_textLabels = std::make_unique<TextLabels>(m_style);
 }
 
+void TextStyleBuilder::reset() {
+    // Release the glyph atlases referenced by the discarded quads
+    m_style.context()->releaseAtlas(m_atlasRefs);
+    m_atlasRefs.reset();
+
+    m_quads.clear();
+    m_layouts.clear();
+    m_labels.clear();
+    m_textLabels.reset();
+}
+
 void TextStyleBuilder::addLayoutItems(LabelCollider& _layout) {
     _layout.addLabels(m_labels);
 }
@@ -74,6 +86,7 @@ std::unique_ptr<StyledMesh> TextStyleBuilder::build() {
 
         std::vector<GlyphQuad> quads(m_quads);
         m_textLabels->setQuads(std::move(quads), m_atlasRefs);
+        m_textLabels->setLayouts(std::move(m_layouts));
 
     } else {
 
@@ -119,6 +132,9 @@ std::unique_ptr<StyledMesh> TextStyleBuilder::build() {
         std::vector<GlyphQuad> quads;
         quads.reserve(sumQuads);
 
+        std::vector<TextLayout> layouts;
+        auto layout = m_layouts.begin();
+
         // Add only alive labels
         for (auto& label : m_labels) {
             auto* textLabel = static_cast<TextLabel*>(label.get());
@@ -129,6 +145,7 @@ std::unique_ptr<StyledMesh> TextStyleBuilder::build() {
             auto& ranges = textLabel->textRanges();
 
             // Add the quads of line-labels only once
+            bool layoutAdded = false;
             if (ranges.back().end() != quadPos) {
                 quadStart = quadEnd;
                 quadPos = ranges.back().end();
@@ -141,6 +158,15 @@ std::unique_ptr<StyledMesh> TextStyleBuilder::build() {
                         quads.insert(quads.end(), it, it + textRange.length);
                     }
                 }
+
+                // Keep the layout of the added quads
+                while (layout != m_layouts.end() && layout->textRanges[0].start < ranges[0].start) {
+                    ++layout;
+                }
+                if (layout != m_layouts.end() && layout->textRanges[0].start == ranges[0].start) {
+                    layouts.push_back(std::move(*layout));
+                    layoutAdded = true;
+                }
             }
 
             // Update TextRange
@@ -151,15 +177,19 @@ std::unique_ptr<StyledMesh> TextStyleBuilder::build() {
                 start += textRange.length;
             }
 
+            if (layoutAdded) { layouts.back().textRanges = ranges; }
+
             labels.push_back(std::move(label));
         }
 
         m_textLabels->setLabels(labels);
         m_textLabels->setQuads(std::move(quads), m_atlasRefs);
+        m_textLabels->setLayouts(std::move(layouts));
     }
 
     m_labels.clear();
     m_quads.clear();
+    m_layouts.clear();
 
     return std::move(m_textLabels);
 }
@@ -242,7 +272,7 @@ bool TextStyleBuilder::handleBoundaryLabel(const Feature& _feat, const DrawRule&
     };
 
     bool added = false;
-    for (auto& line : _feat.lines) {
+    for (auto line : _feat.lines()) {
         added |= addStraightTextLabels(line, labelWidth, onAddLabel);
     }
 
@@ -275,14 +305,13 @@ bool TextStyleBuilder::addFeature(const Feature& _feat, const DrawRule& _rule) {
         if (!prepareLabel(params, labelType, attrib)) { return false; }
 
         if (_feat.geometryType == GeometryType::points) {
-            for (auto& point : _feat.points) {
+            for (const auto& point : _feat.points()) {
                 auto p = glm::vec2(point);
                 addLabel(Label::Type::point, {{ p }}, params, attrib, _rule);
             }
 
         } else if (_feat.geometryType == GeometryType::polygons) {
-            const auto& polygons = _feat.polygons;
-            for (const auto& polygon : polygons) {
+            for (auto polygon : _feat.polygons()) {
                 if (!polygon.empty()) {
                     glm::vec2 c;
                     c = centroid(polygon.front().begin(), polygon.front().end());
@@ -302,7 +331,7 @@ bool TextStyleBuilder::addFeature(const Feature& _feat, const DrawRule& _rule) {
     return true;
 }
 
-bool TextStyleBuilder::addStraightTextLabels(const Line& _line, float _labelWidth,
+bool TextStyleBuilder::addStraightTextLabels(const LineSpan& _line, float _labelWidth,
                                              const std::function<void(glm::vec2,glm::vec2)>& _onAddLabel) {
 
     // Size of pixel in tile coordinates
@@ -381,7 +410,7 @@ bool TextStyleBuilder::addStraightTextLabels(const Line& _line, float _labelWidt
     return false;
 }
 
-void TextStyleBuilder::addCurvedTextLabels(const Line& _line, const TextStyle::Parameters& _params,
+void TextStyleBuilder::addCurvedTextLabels(const LineSpan& _line, const TextStyle::Parameters& _params,
                                            const LabelAttributes& _attributes, const DrawRule& _rule) {
 
     // Size of pixel in tile coordinates
@@ -541,7 +570,7 @@ void TextStyleBuilder::addLineTextLabels(const Feature& _feat, const TextStyle::
         addLabel(Label::Type::line, {{ a, b }}, _params, _attributes, _rule);
     };
 
-    for (auto& line : _feat.lines) {
+    for (auto line : _feat.lines()) {
 
         if (!addStraightTextLabels(line, _attributes.width, straightLabelCb) &&
             line.size() > 2 && !_params.hasComplexShaping &&
@@ -601,6 +630,9 @@ TextStyle::Parameters TextStyleBuilder::applyRule(const DrawRule& _rule,
     _rule.get(StyleParamKey::text_font_size, p.fontSize);
     p.fontSize *= m_style.pixelScale();
 
+    p.fontFamily = *fontFamily;
+    p.fontStyle = *fontStyle;
+    p.fontWeight = *fontWeight;
     p.font = m_style.context()->getFont(*fontFamily, *fontStyle, *fontWeight, p.fontSize);
     if (!p.font) {
         LOGW("Missing font for %s / %s / %s / %d", fontFamily->c_str(), fontStyle->c_str(), fontWeight->c_str(), p.fontSize);
@@ -823,6 +855,12 @@ bool TextStyleBuilder::prepareLabel(TextStyle::Parameters& _params, Label::Type
         }
         _attributes.width = bbox.x;
         _attributes.height = bbox.y;
+
+        m_layouts.push_back({ _params.fontFamily, _params.fontStyle, _params.fontWeight,
+                              _params.fontSize, _params.text, _params.transform, _params.align,
+                              _params.labelOptions.anchors, _params.wordWrap, _params.maxLines,
+                              _params.maxLineWidth, _params.lineSpacing, _type,
+                              _attributes.textRanges });
         return true;
     }
 
@@ -851,4 +889,106 @@ Label* TextStyleBuilder::addLabel(Label::Type _type, TextLabel::Coordinates _coo
     return m_labels.back().get();
 }
 
+bool TextStyleBuilder::deserialize(const char*& _data, const char* _end,
+                                   const SelectionColorMap& _selectionColors) {
+
+    std::vector<LabelAttributes> attributes;
+    if (!deserializeLayouts(_data, _end, attributes)) { return false; }
+
+    auto readLabel = [&](LabelType _type, const char*& _labelData, const char* _labelEnd) -> Label* {
+        if (_type != LabelType::text) { return nullptr; }
+        return deserializeLabel(_labelData, _labelEnd, attributes, _selectionColors);
+    };
+
+    return LabelSet::deserializeLabels(_data, _end, readLabel);
+}
+
+bool TextStyleBuilder::deserializeLayouts(const char*& _data, const char* _end,
+                                          std::vector<LabelAttributes>& _attributes) {
+
+    std::vector<TextLayout> layouts;
+    if (!TextLabels::deserializeLayouts(_data, _end, layouts)) { return false; }
+
+    for (auto& layout : layouts) {
+        TextStyle::Parameters params;
+        params.font = m_style.context()->getFont(layout.fontFamily, layout.fontStyle,
+                                                 layout.fontWeight, layout.fontSize);
+        if (!params.font) { return false; }
+
+        params.fontFamily = std::move(layout.fontFamily);
+        params.fontStyle = std::move(layout.fontStyle);
+        params.fontWeight = std::move(layout.fontWeight);
+        params.fontSize = layout.fontSize;
+        params.text = std::move(layout.text);
+        params.transform = layout.transform;
+        params.align = layout.align;
+        params.labelOptions.anchors = layout.anchors;
+        params.wordWrap = layout.wordWrap;
+        params.maxLines = layout.maxLines;
+        params.maxLineWidth = layout.maxLineWidth;
+        params.lineSpacing = layout.lineSpacing;
+
+        LabelAttributes attributes;
+        if (!prepareLabel(params, layout.type, attributes)) { return false; }
+
+        // Labels of the layout refer to its quads, e.g. when a font has changed
+        for (size_t i = 0; i < attributes.textRanges.size(); i++) {
+            if (attributes.textRanges[i].length != layout.textRanges[i].length) { return false; }
+        }
+        _attributes.push_back(attributes);
+    }
+    return true;
+}
+
+Label* TextStyleBuilder::deserializeLabel(const char*& _data, const char* _end,
+                                          const std::vector<LabelAttributes>& _attributes,
+                                          const SelectionColorMap& _selectionColors) {
+
+    Label::Type type;
+    Label::Options options;
+    glm::vec2 size;
+    uint32_t layout = 0;
+    TextLabel::Coordinates coordinates;
+    TextLabel::VertexAttributes attrib;
+    TextLabelProperty::Align align;
+
+    if (!Label::deserialize(_data, _end, type, options, size) ||
+        !read(_data, _end, layout) || layout >= _attributes.size() ||
+        !read(_data, _end, coordinates) || !read(_data, _end, attrib) ||
+        !read(_data, _end, align)) {
+        return nullptr;
+    }
+
+    options.featureId = _selectionColors(options.featureId);
+    attrib.selectionColor = _selectionColors(attrib.selectionColor);
+
+    const auto& textRanges = _attributes[layout].textRanges;
+
+    if (type == Label::Type::curved) {
+        float prio = 0;
+        uint32_t anchorPoint = 0;
+        uint32_t numPoints = 0;
+
+        if (!read(_data, _end, prio) || !read(_data, _end, anchorPoint) ||
+            !read(_data, _end, numPoints) || anchorPoint >= numPoints ||
+            size_t(_end - _data) / sizeof(glm::vec2) < numPoints) {
+            return nullptr;
+        }
+
+        CurvedLabel::ModelTransform modelTransform(numPoints);
+        for (auto& point : modelTransform) { read(_data, _end, point); }
+
+        m_labels.emplace_back(new CurvedLabel(std::move(modelTransform), options, prio, attrib, size,
+                                              *m_textLabels, textRanges, align, anchorPoint));
+
+    } else if (type == Label::Type::point || type == Label::Type::line) {
+        m_labels.emplace_back(new TextLabel(coordinates, type, options, attrib, size,
+                                            *m_textLabels, textRanges, align));
+    } else {
+        return nullptr;
+    }
+
+    return m_labels.back().get();
+}
+
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "labels/textLabel.h"
+#include "labels/textLabels.h"
 #include "labels/labelProperty.h"
 #include "style/textStyle.h"
 #include "text/fontContext.h"
@@ -37,6 +38,8 @@ public:
 
     std::unique_ptr<StyledMesh> build() override;
 
+    void reset() override;
+
     TextStyle::Parameters applyRule(const DrawRule& _rule, const Properties& _props, bool _iconText) const;
 
     bool prepareLabel(TextStyle::Parameters& _params, Label::Type _type, LabelAttributes& _attributes);
@@ -48,15 +51,25 @@ public:
     void addLineTextLabels(const Feature& _feature, const TextStyle::Parameters& _params,
                            const LabelAttributes& _attributes, const DrawRule& _rule);
 
-    bool addStraightTextLabels(const Line& _feature, float _labelWidth,
+    bool addStraightTextLabels(const LineSpan& _feature, float _labelWidth,
                                const std::function<void(glm::vec2,glm::vec2)>& _onAddLabel);
 
-    void addCurvedTextLabels(const Line& _feature, const TextStyle::Parameters& _params,
+    void addCurvedTextLabels(const LineSpan& _feature, const TextStyle::Parameters& _params,
                              const LabelAttributes& _attributes, const DrawRule& _rule);
 
     bool handleBoundaryLabel(const Feature& _feat, const DrawRule& _rule,
                              const TextStyle::Parameters& _params);
 
+    /* Add the labels of a TextLabels mesh which TextLabels::serialize() wrote */
+    bool deserialize(const char*& _data, const char* _end, const SelectionColorMap& _selectionColors);
+
+    /* Lay out the texts which TextLabels::serializeLayouts() wrote again */
+    bool deserializeLayouts(const char*& _data, const char* _end, std::vector<LabelAttributes>& _attributes);
+
+    /* Add a label which TextLabel::serialize() wrote, for the texts of @_attributes */
+    Label* deserializeLabel(const char*& _data, const char* _end, const std::vector<LabelAttributes>& _attributes,
+                            const SelectionColorMap& _selectionColors);
+
     bool checkRule(const DrawRule& _rule) const override;
     std::vector<std::unique_ptr<Label>>* labels() { return &m_labels; }
 
@@ -71,6 +84,7 @@ protected:
 
     // Buffers to hold data for TextLabels until build()
     std::vector<GlyphQuad> m_quads;
+    std::vector<TextLayout> m_layouts;
     std::bitset<FontContext::max_textures> m_atlasRefs;
     std::vector<std::unique_ptr<Label>> m_labels;
 
@@ -0,0 +1,513 @@
+#include "tile/geometryCache.h"
+
+#include "data/propertyItem.h"
+#include "data/tileSource.h"
+#include "gl/mesh.h"
+#include "log.h"
+#include "scene/scene.h"
+#include "selection/featureSelection.h"
+#include "style/style.h"
+#include "tile/tile.h"
+#include "util/asyncWorker.h"
+#include "util/hash.h"
+#include "util/serialize.h"
+
+#include "yaml-cpp/yaml.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+// Changes of the file format or of mesh serialization invalidate cached tiles
+#define CACHE_FORMAT_VERSION 3
+
+namespace Tangram {
+
+static const char MAGIC[4] = { 'T', 'G', 'C', 'T' };
+
+enum class EntryType : uint8_t { empty, mesh };
+
+enum class PropertyType : uint8_t { string, number };
+
+// Whether an entry stored at @_created is older than the maximum age of the data of @_source
+static bool isExpired(time_t _created, const TileSource& _source) {
+    auto maxAge = _source.dataMaxAge().count();
+    return maxAge > 0 && std::difftime(std::time(nullptr), _created) > maxAge;
+}
+
+static void writeSelectionFeatures(std::vector<char>& _out, const Tile& _tile) {
+    const auto& features = _tile.getSelectionFeatures();
+    write(_out, uint32_t(features.size()));
+
+    for (const auto& feature : features) {
+        const auto& props = *feature.second;
+        write(_out, feature.first);
+        write(_out, props.sourceId);
+
+        const auto& items = props.items();
+        size_t countOffset = _out.size();
+        uint32_t numItems = 0;
+        write(_out, numItems);
+
+        for (const auto& item : items) {
+            if (item.value->is<std::string>()) {
+                writeString(_out, item.key.name());
+                write(_out, PropertyType::string);
+                writeString(_out, item.value->get<std::string>());
+            } else if (item.value->is<double>()) {
+                writeString(_out, item.key.name());
+                write(_out, PropertyType::number);
+                write(_out, item.value->get<double>());
+            } else {
+                continue;
+            }
+            numItems++;
+        }
+        std::memcpy(_out.data() + countOffset, &numItems, sizeof(numItems));
+    }
+}
+
+// Read the features written by writeSelectionFeatures(), by their stored selection color
+static bool readSelectionFeatures(const char*& _data, const char* _end,
+                                  std::vector<std::pair<uint32_t, std::shared_ptr<Properties>>>& _features) {
+    uint32_t numFeatures = 0;
+    if (!read(_data, _end, numFeatures)) { return false; }
+
+    for (uint32_t i = 0; i < numFeatures; i++) {
+        uint32_t color = 0;
+        uint32_t numItems = 0;
+        auto props = std::make_shared<Properties>();
+
+        if (!read(_data, _end, color) || !read(_data, _end, props->sourceId) ||
+            !read(_data, _end, numItems)) {
+            return false;
+        }
+
+        for (uint32_t j = 0; j < numItems; j++) {
+            std::string key;
+            PropertyType type;
+            if (!readString(_data, _end, key) || !read(_data, _end, type)) { return false; }
+
+            if (type == PropertyType::string) {
+                std::string value;
+                if (!readString(_data, _end, value)) { return false; }
+                props->set(std::move(key), std::move(value));
+            } else if (type == PropertyType::number) {
+                double value = 0;
+                if (!read(_data, _end, value)) { return false; }
+                props->set(std::move(key), value);
+            } else {
+                return false;
+            }
+        }
+        _features.emplace_back(color, std::move(props));
+    }
+    return true;
+}
+
+GeometryCache::GeometryCache(const std::string& _path, size_t _maxSize) :
+    m_path(_path),
+    m_maxSize(_maxSize),
+    m_writer(std::make_unique<AsyncWorker>()) {
+
+    if (!m_path.empty() && m_path.back() != '/') { m_path += '/'; }
+
+    m_writer->enqueue([this]() { indexFiles(); });
+}
+
+GeometryCache::~GeometryCache() {}
+
+uint64_t GeometryCache::sceneHash(Scene& _scene) {
+    size_t seed = 0;
+    hash_combine(seed, YAML::Dump(_scene.config()));
+    hash_combine(seed, _scene.pixelScale());
+    return seed;
+}
+
+bool GeometryCache::isCacheable(const TileSource& _source) {
+    return !_source.dataVersion().empty();
+}
+
+std::string GeometryCache::key(uint64_t _sceneHash, const TileSource& _source, const TileID& _tileId) const {
+    std::stringstream key;
+    key << CACHE_FORMAT_VERSION << '/' << std::hex << _sceneHash << std::dec << '/'
+        << _source.name() << '/' << _source.dataVersion() << '/'
+        << _tileId.z << '/' << _tileId.x << '/' << _tileId.y << '/' << _tileId.s;
+    return key.str();
+}
+
+std::string GeometryCache::filePath(const std::string& _key) const {
+    std::stringstream path;
+    path << m_path << std::hex << std::hash<std::string>()(_key) << ".tile";
+    return path.str();
+}
+
+bool GeometryCache::contains(const TileSource& _source, const TileID& _tileId) const {
+    auto cacheKey = key(m_sceneHash, _source, _tileId);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(cacheKey);
+    return it != m_entries.end() && it->second.complete && !isExpired(it->second.created, _source);
+}
+
+bool GeometryCache::load(uint64_t _sceneHash, const Scene& _scene, const TileSource& _source,
+                         Tile& _tile, std::vector<bool>& _loaded) {
+
+    auto cacheKey = key(_sceneHash, _source, _tile.getID());
+
+    std::ifstream file(filePath(cacheKey), std::ios::binary);
+    if (!file) {
+        removeEntry(cacheKey);
+        m_misses++;
+        return false;
+    }
+
+    std::vector<char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    const char* data = buffer.data();
+    const char* end = data + buffer.size();
+
+    uint32_t keyLength = 0;
+    if (size_t(end - data) < sizeof(MAGIC) || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        LOGW("Invalid geometry cache file for tile %s", _tile.getID().toString().c_str());
+        removeEntry(cacheKey);
+        m_misses++;
+        return false;
+    }
+    data += sizeof(MAGIC);
+
+    // Different key with the same file name
+    if (!read(data, end, keyLength) || size_t(end - data) < keyLength ||
+        cacheKey.compare(0, std::string::npos, data, keyLength) != 0) {
+        removeEntry(cacheKey);
+        m_misses++;
+        return false;
+    }
+    data += keyLength;
+
+    int64_t created = 0;
+    uint8_t complete = 0;
+    if (!read(data, end, created) || !read(data, end, complete)) {
+        LOGW("Invalid geometry cache file for tile %s", _tile.getID().toString().c_str());
+        removeEntry(cacheKey);
+        m_misses++;
+        return false;
+    }
+
+    // Built again from newly loaded data
+    if (isExpired(time_t(created), _source)) {
+        removeEntry(cacheKey);
+        std::remove(filePath(cacheKey).c_str());
+        m_misses++;
+        return false;
+    }
+
+    const auto& styles = _scene.styles();
+
+    // Selection colors are only valid for the session which built the
+    // tile, the stored colors are replaced by colors of this session
+    std::vector<std::pair<uint32_t, std::shared_ptr<Properties>>> storedFeatures;
+    std::unordered_map<uint32_t, uint32_t> colors;
+    auto* featureSelection = _scene.featureSelection().get();
+
+    SelectionColorMap mapColor = [&](uint32_t _color) -> uint32_t {
+        if (_color == 0) { return 0; }
+        auto it = colors.find(_color);
+        if (it != colors.end()) { return it->second; }
+        // Selection colors of labels without a selection feature
+        uint32_t color = featureSelection->nextColorIdentifier();
+        colors.emplace(_color, color);
+        return color;
+    };
+
+    std::vector<std::pair<const Style*, std::unique_ptr<StyledMesh>>> meshes;
+    uint32_t numEntries = 0;
+    bool valid = readSelectionFeatures(data, end, storedFeatures) && read(data, end, numEntries);
+
+    fastmap<uint32_t, std::shared_ptr<Properties>> selectionFeatures;
+    for (auto& feature : storedFeatures) {
+        selectionFeatures[mapColor(feature.first)] = std::move(feature.second);
+    }
+
+    for (uint32_t i = 0; valid && i < numEntries; i++) {
+        uint32_t styleId;
+        EntryType type;
+
+        if (!read(data, end, styleId) || !read(data, end, type) || styleId >= styles.size()) {
+            valid = false;
+            break;
+        }
+
+        const auto& style = *styles[styleId];
+        if (type == EntryType::empty) {
+            meshes.emplace_back(&style, nullptr);
+            continue;
+        }
+
+        std::unique_ptr<StyledMesh> mesh;
+        if (!style.deserializeMesh(data, end, _tile, mapColor, mesh)) {
+            valid = false;
+            break;
+        }
+        meshes.emplace_back(&style, std::move(mesh));
+    }
+
+    if (!valid) {
+        LOGW("Invalid geometry cache file for tile %s", _tile.getID().toString().c_str());
+        removeEntry(cacheKey);
+        m_misses++;
+        return false;
+    }
+
+    _loaded.assign(styles.size(), false);
+
+    for (auto& entry : meshes) {
+        _loaded[entry.first->getID()] = true;
+        if (entry.second) { _tile.setMesh(*entry.first, std::move(entry.second)); }
+    }
+    _tile.setSelectionFeatures(selectionFeatures);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(cacheKey);
+        if (it != m_entries.end()) { it->second.lastUse = ++m_useCount; }
+    }
+
+    m_hits++;
+    return true;
+}
+
+void GeometryCache::store(uint64_t _sceneHash, const Scene& _scene, const TileSource& _source,
+                          const Tile& _tile) {
+
+    auto cacheKey = key(_sceneHash, _source, _tile.getID());
+
+    auto buffer = std::make_shared<std::vector<char>>();
+    auto& out = *buffer;
+
+    out.insert(out.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    write(out, uint32_t(cacheKey.size()));
+    out.insert(out.end(), cacheKey.begin(), cacheKey.end());
+
+    time_t created = std::time(nullptr);
+    write(out, int64_t(created));
+
+    size_t completeOffset = out.size();
+    write(out, uint8_t(0));
+
+    writeSelectionFeatures(out, _tile);
+
+    size_t countOffset = out.size();
+    uint32_t numEntries = 0;
+    write(out, numEntries);
+
+    for (const auto& style : _scene.styles()) {
+        const auto& mesh = _tile.getMesh(*style);
+
+        size_t entryOffset = out.size();
+        write(out, uint32_t(style->getID()));
+
+        if (!mesh) {
+            write(out, EntryType::empty);
+        } else {
+            write(out, EntryType::mesh);
+            if (!mesh->serialize(out)) {
+                // Built again when the tile is loaded from the cache
+                out.resize(entryOffset);
+                continue;
+            }
+        }
+        numEntries++;
+    }
+
+    std::memcpy(out.data() + countOffset, &numEntries, sizeof(numEntries));
+
+    bool complete = numEntries == _scene.styles().size();
+    out[completeOffset] = complete;
+
+    m_stored++;
+
+    auto path = filePath(cacheKey);
+
+    m_writer->enqueue([this, buffer, path, cacheKey, created, complete]() {
+        // Write to a temporary file first so that readers never see partial files
+        auto tmpPath = path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                LOGW("Cannot write geometry cache file %s", tmpPath.c_str());
+                return;
+            }
+            file.write(buffer->data(), buffer->size());
+            if (!file) {
+                LOGW("Cannot write geometry cache file %s", tmpPath.c_str());
+                file.close();
+                std::remove(tmpPath.c_str());
+                return;
+            }
+        }
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            // Renaming does not replace existing files on all platforms
+            std::remove(path.c_str());
+            if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+                std::remove(tmpPath.c_str());
+                removeEntry(cacheKey);
+                return;
+            }
+        }
+
+        addEntry(cacheKey, buffer->size(), created, complete);
+        evict();
+    });
+}
+
+void GeometryCache::indexFiles() {
+
+    DIR* dir = opendir(m_path.c_str());
+    if (!dir) {
+        LOGW("Cannot read geometry cache directory %s", m_path.c_str());
+        return;
+    }
+
+    struct File {
+        std::string key;
+        size_t size;
+        time_t created;
+        bool complete;
+    };
+    std::vector<File> files;
+
+    std::stringstream format;
+    format << CACHE_FORMAT_VERSION << '/';
+    auto formatPrefix = format.str();
+
+    while (auto* dirEntry = readdir(dir)) {
+        std::string name = dirEntry->d_name;
+        if (name.size() <= 5 || name.compare(name.size() - 5, 5, ".tile") != 0) { continue; }
+
+        auto path = m_path + name;
+
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) { continue; }
+
+        // Read the key, the creation time and the completeness of the entries from the header
+        std::ifstream file(path, std::ios::binary);
+        char magic[sizeof(MAGIC)] = {};
+        uint32_t keyLength = 0;
+        file.read(magic, sizeof(MAGIC));
+        file.read(reinterpret_cast<char*>(&keyLength), sizeof(keyLength));
+
+        std::string fileKey;
+        int64_t created = 0;
+        uint8_t complete = 0;
+        if (file && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 && keyLength < size_t(st.st_size)) {
+            fileKey.resize(keyLength);
+            file.read(&fileKey[0], keyLength);
+            file.read(reinterpret_cast<char*>(&created), sizeof(created));
+            file.read(reinterpret_cast<char*>(&complete), sizeof(complete));
+        }
+        file.close();
+
+        // Remove files of previous formats and invalid files
+        if (!file || fileKey.compare(0, formatPrefix.size(), formatPrefix) != 0 ||
+            filePath(fileKey) != path) {
+            std::remove(path.c_str());
+            continue;
+        }
+
+        files.push_back({ std::move(fileKey), size_t(st.st_size), time_t(created), complete != 0 });
+    }
+    closedir(dir);
+
+    // Files of previous sessions are used before tiles of this session
+    std::sort(files.begin(), files.end(), [](auto& a, auto& b) { return a.created < b.created; });
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        int64_t lastUse = -int64_t(files.size());
+
+        for (auto& file : files) {
+            // Keep entries of tiles stored meanwhile
+            if (m_entries.emplace(file.key, Entry{ file.size, lastUse++, file.created, file.complete }).second) {
+                m_size += file.size;
+            }
+        }
+    }
+
+    evict();
+}
+
+void GeometryCache::addEntry(const std::string& _key, size_t _size, time_t _created, bool _complete) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto& entry = m_entries[_key];
+    m_size = m_size - entry.size + _size;
+    entry = Entry{ _size, ++m_useCount, _created, _complete };
+}
+
+void GeometryCache::removeEntry(const std::string& _key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(_key);
+    if (it == m_entries.end()) { return; }
+
+    m_size -= it->second.size;
+    m_entries.erase(it);
+}
+
+void GeometryCache::evict() {
+
+    std::vector<std::string> paths;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_size <= m_maxSize) { return; }
+
+        std::vector<decltype(m_entries)::iterator> entries;
+        entries.reserve(m_entries.size());
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            entries.push_back(it);
+        }
+        std::sort(entries.begin(), entries.end(), [](auto& a, auto& b) {
+                return a->second.lastUse < b->second.lastUse;
+            });
+
+        // Remove down to 90% of the maximum size, so that not every
+        // following store has to evict
+        size_t targetSize = m_maxSize - m_maxSize / 10;
+
+        for (auto& it : entries) {
+            if (m_size <= targetSize) { break; }
+
+            m_size -= it->second.size;
+            paths.push_back(filePath(it->first));
+            m_entries.erase(it);
+        }
+    }
+
+    for (auto& path : paths) {
+        std::remove(path.c_str());
+    }
+    m_evicted += paths.size();
+}
+
+GeometryCache::Stats GeometryCache::stats() const {
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.stored = m_stored;
+    stats.evicted = m_evicted;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.size = m_size;
+    return stats;
+}
+
+}
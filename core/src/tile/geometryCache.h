@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+class AsyncWorker;
+class Scene;
+class Tile;
+class TileSource;
+struct TileID;
+
+/* Persistent cache of built tile meshes
+ *
+ * Stores the compiled vertex and index buffers of each style of a built tile
+ * in a file below a directory. Built tiles are written by a background thread.
+ * Tiles are keyed by the hash of the scene content, the TileSource name and
+ * data version and the TileID, so that a cached tile is only restored for the
+ * scene and data it was built from. Tiles of sources whose data may change
+ * without a new version are restored until the maximum age of the data.
+ *
+ * Labels are stored by their definitions, and texts are laid out again when
+ * they are restored (see Style::deserializeMesh). The properties of the
+ * selection features are stored with the tile, and the selection colors in
+ * the meshes are replaced by colors of the current session.
+ *
+ * An index of the cached tiles is kept in memory, so that TileManager can
+ * skip loading tiles which are cached completely. The least recently used
+ * files are removed when the cache exceeds its maximum size.
+ *
+ * Meshes which cannot be serialized are not stored, their styles are built
+ * from the TileData as usual.
+ */
+class GeometryCache {
+
+public:
+
+    const static size_t DEFAULT_MAX_SIZE = 128*1024*1024; // 128 MB
+
+    struct Stats {
+        // Tiles restored from the cache or not found
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        // Tiles written to the cache and removed to stay below the maximum size
+        uint64_t stored = 0;
+        uint64_t evicted = 0;
+        // Bytes of the indexed cache files
+        size_t size = 0;
+    };
+
+    /* @_path: existing directory for the cache files
+     * @_maxSize: maximum size of the cache files in bytes */
+    explicit GeometryCache(const std::string& _path, size_t _maxSize = DEFAULT_MAX_SIZE);
+
+    ~GeometryCache();
+
+    /* Hash of the scene content and device properties that determine tile geometry */
+    static uint64_t sceneHash(Scene& _scene);
+
+    /* Whether tiles of @_source can be cached: Its data must have a version.
+     * Tiles of client sources are not cached. */
+    static bool isCacheable(const TileSource& _source);
+
+    /* Hash of the Scene which tiles are loaded for, used by contains() */
+    void setSceneHash(uint64_t _sceneHash) { m_sceneHash = _sceneHash; }
+
+    /* Whether the meshes of all styles of tile @_tileId are cached for the
+     * current Scene and not older than the maximum age of the data of
+     * @_source. Only checks the index, does no file I/O. */
+    bool contains(const TileSource& _source, const TileID& _tileId) const;
+
+    /* Set the meshes of @_tile from the cache. @_loaded is set for the
+     * styles whose mesh was restored, including styles without geometry.
+     * Sets the selection features of @_tile with new selection colors.
+     * Returns false when the tile is not cached or expired, the tile is then
+     * removed from the index. */
+    bool load(uint64_t _sceneHash, const Scene& _scene, const TileSource& _source,
+              Tile& _tile, std::vector<bool>& _loaded);
+
+    /* Serialize the meshes of the fully built @_tile and write them in the
+     * background. Must be called before the meshes are uploaded. */
+    void store(uint64_t _sceneHash, const Scene& _scene, const TileSource& _source,
+               const Tile& _tile);
+
+    Stats stats() const;
+
+private:
+
+    struct Entry {
+        // Size of the file in bytes
+        size_t size;
+        // Order of the last store or load, lowest for the least recently used
+        int64_t lastUse;
+        // Time when the tile was stored
+        time_t created;
+        // Whether the meshes of all styles are stored
+        bool complete;
+    };
+
+    std::string key(uint64_t _sceneHash, const TileSource& _source, const TileID& _tileId) const;
+
+    std::string filePath(const std::string& _key) const;
+
+    // Running on the writer thread
+    void indexFiles();
+    void addEntry(const std::string& _key, size_t _size, time_t _created, bool _complete);
+    void evict();
+
+    void removeEntry(const std::string& _key);
+
+    std::string m_path;
+
+    size_t m_maxSize;
+
+    std::atomic<uint64_t> m_sceneHash{0};
+
+    // Cached tiles by key and the total size of their files
+    std::unordered_map<std::string, Entry> m_entries;
+    size_t m_size = 0;
+    int64_t m_useCount = 0;
+    mutable std::mutex m_mutex;
+
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_stored{0};
+    std::atomic<uint64_t> m_evicted{0};
+
+    std::unique_ptr<AsyncWorker> m_writer;
+};
+
+}
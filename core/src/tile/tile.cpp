@@ -66,6 +66,62 @@ void Tile::setMesh(const Style& _style, std::unique_ptr<StyledMesh> _mesh) {
     m_geometry[_style.getID()] = std::move(_mesh);
 }
 
+void Tile::setLabelStyles(const std::vector<std::unique_ptr<Style>>& _styles) {
+    for (size_t i = 0; i < m_geometry.size(); i++) {
+        auto* labels = dynamic_cast<LabelSet*>(m_geometry[i].get());
+        if (!labels) { continue; }
+
+        if (i >= _styles.size() || !labels->setStyle(*_styles[i])) {
+            m_geometry[i].reset();
+            m_memoryUsage = 0;
+        }
+    }
+}
+
+void Tile::adoptGeometry(Tile& _tile, const std::vector<bool>& _styles) {
+    if (m_geometry.size() < _tile.m_geometry.size()) {
+        m_geometry.resize(_tile.m_geometry.size());
+    }
+
+    for (size_t i = 0; i < _tile.m_geometry.size(); i++) {
+        if (i < _styles.size() && _styles[i]) { continue; }
+        m_geometry[i] = std::move(_tile.m_geometry[i]);
+    }
+
+    for (auto& raster : _tile.m_rasters) {
+        m_rasters.push_back(std::move(raster));
+    }
+    _tile.m_rasters.clear();
+
+    // Selection colors are unique across Scene updates (see Scene::copyConfig)
+    for (auto& feature : _tile.m_selectionFeatures) {
+        m_selectionFeatures[feature.first] = feature.second;
+    }
+
+    m_memoryUsage = 0;
+    _tile.m_memoryUsage = 0;
+}
+
+void Tile::setBaseTile(std::shared_ptr<Tile> _tile, std::shared_ptr<const std::vector<bool>> _styles) {
+    m_baseTile = std::move(_tile);
+    m_baseStyles = std::move(_styles);
+}
+
+void Tile::adoptBaseGeometry() {
+    if (!m_baseTile) { return; }
+
+    adoptGeometry(*m_baseTile, *m_baseStyles);
+
+    m_baseTile.reset();
+    m_baseStyles.reset();
+}
+
+void Tile::resetVaos() {
+    for (auto& mesh : m_geometry) {
+        if (mesh) { mesh->resetVaos(); }
+    }
+}
+
 const std::unique_ptr<StyledMesh>& Tile::getMesh(const Style& _style) const {
     static std::unique_ptr<StyledMesh> NONE = nullptr;
     if (_style.getID() >= m_geometry.size()) { return NONE; }
@@ -85,6 +141,21 @@ std::shared_ptr<Properties> Tile::getSelectionFeature(uint32_t _id) const {
     return nullptr;
 }
 
+bool Tile::isUploaded() const {
+    for (auto& mesh : m_geometry) {
+        if (mesh && !mesh->isUploaded()) { return false; }
+    }
+    return true;
+}
+
+size_t Tile::upload(RenderState& _rs) {
+    size_t bytes = 0;
+    for (auto& mesh : m_geometry) {
+        if (mesh) { bytes += mesh->uploadBuffers(_rs); }
+    }
+    return bytes;
+}
+
 size_t Tile::getMemoryUsage() const {
     if (m_memoryUsage == 0) {
         for (auto& entry : m_geometry) {
@@ -15,10 +15,12 @@
 namespace Tangram {
 
 class MapProjection;
+class RenderState;
 struct Properties;
 class Style;
 class View;
 struct StyledMesh;
+struct TileData;
 
 struct Raster {
     TileID tileID;
@@ -67,6 +69,37 @@ public:
 
     void setMesh(const Style& _style, std::unique_ptr<StyledMesh> _mesh);
 
+    /* Draw the label meshes with the Styles of a new Scene, @_styles indexed by
+     * Style ID. Label meshes refer to the Style that created them, those that
+     * cannot use the new Style are removed. */
+    void setLabelStyles(const std::vector<std::unique_ptr<Style>>& _styles);
+
+    /* Take over meshes of styles not marked in @_styles, rasters and selection
+     * features from @_tile. Used when only some styles of @_tile were rebuilt.
+     */
+    void adoptGeometry(Tile& _tile, const std::vector<bool>& _styles);
+
+    /* Adopt the geometry of @_tile for the styles not marked in @_styles when
+     * this tile replaces it (see adoptBaseGeometry). @_tile keeps drawing all
+     * its meshes until then. */
+    void setBaseTile(std::shared_ptr<Tile> _tile, std::shared_ptr<const std::vector<bool>> _styles);
+
+    /* Take over the geometry of the tile set by setBaseTile(), if any */
+    void adoptBaseGeometry();
+
+    /* Let meshes set up their vertex arrays again for the ShaderPrograms of a new Scene */
+    void resetVaos();
+
+    /* Tile built for a previous Scene without its TileData. It is drawn until it is rebuilt */
+    bool isStale() const { return m_stale; }
+
+    void setStale(bool _stale) { m_stale = _stale; }
+
+    /* TileData from which the tile was built, kept to rebuild single styles */
+    const std::shared_ptr<TileData>& tileData() const { return m_tileData; }
+
+    void setTileData(std::shared_ptr<TileData> _tileData) { m_tileData = std::move(_tileData); }
+
     void setSelectionFeatures(const fastmap<uint32_t, std::shared_ptr<Properties>> _selectionFeatures);
 
     std::shared_ptr<Properties> getSelectionFeature(uint32_t _id) const;
@@ -84,6 +117,12 @@ public:
     /* Get the sum in bytes of static <Mesh>es */
     size_t getMemoryUsage() const;
 
+    /* Returns true when all meshes can be drawn without uploading buffers */
+    bool isUploaded() const;
+
+    /* Upload the buffers of all meshes, returns the uploaded bytes */
+    size_t upload(RenderState& _rs);
+
     int64_t sourceGeneration() const { return m_sourceGeneration; }
 
     int32_t sourceID() const { return m_sourceId; }
@@ -92,6 +131,11 @@ public:
 
     void setProxyState(bool isProxy) { m_proxyState = isProxy; }
 
+    /* Time in microseconds it took to parse and build this tile */
+    uint64_t buildTime() const { return m_buildTime; }
+
+    void setBuildTime(uint64_t _buildTime) { m_buildTime = _buildTime; }
+
 private:
 
     const TileID m_id;
@@ -106,6 +150,10 @@ private:
 
     bool m_proxyState = false;
 
+    bool m_stale = false;
+
+    uint64_t m_buildTime = 0;
+
     glm::dvec2 m_tileOrigin; // South-West corner of the tile in 2D projection space in meters (e.g. mercator meters)
 
     glm::mat4 m_modelMatrix; // Matrix relating tile-local coordinates to global projection space coordinates;
@@ -123,6 +171,12 @@ private:
 
     fastmap<uint32_t, std::shared_ptr<Properties>> m_selectionFeatures;
 
+    std::shared_ptr<TileData> m_tileData;
+
+    // Tile replaced by this restyled tile and the styles that were rebuilt
+    std::shared_ptr<Tile> m_baseTile;
+    std::shared_ptr<const std::vector<bool>> m_baseStyles;
+
 };
 
 }
@@ -9,12 +9,27 @@
 #include "scene/scene.h"
 #include "selection/featureSelection.h"
 #include "style/style.h"
+#include "tile/geometryCache.h"
 #include "tile/tile.h"
+#include "tile/tileTask.h"
 #include "util/mapProjection.h"
 #include "view/view.h"
 
+#include <algorithm>
+#include <chrono>
+
+// Number of features to process between checks for task cancellation
+#define CANCEL_CHECK_FEATURES 64
+
 namespace Tangram {
 
+static bool containsCollection(const DataLayer& _layer, const Layer& _collection) {
+    if (_collection.name.empty()) { return true; }
+
+    const auto& dlc = _layer.collections();
+    return std::find(dlc.begin(), dlc.end(), _collection.name) != dlc.end();
+}
+
 TileBuilder::TileBuilder(std::shared_ptr<Scene> _scene)
     : m_scene(_scene),
       m_styleContext(std::make_unique<StyleContext>()) {
@@ -49,11 +64,20 @@ StyleBuilder* TileBuilder::getStyleBuilder(const std::string& _name) {
     return it->second.get();
 }
 
+bool TileBuilder::isSelected(const StyleBuilder& _builder) const {
+    if (!m_styles) { return true; }
+
+    size_t id = _builder.style().getID();
+    return id < m_styles->size() && (*m_styles)[id];
+}
+
 void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer) {
 
     // If no rules matched the feature, return immediately
     if (!m_ruleSet.match(_feature, _layer, *m_styleContext)) { return; }
 
+    if (m_tileData) { m_tileData->decodeGeometry(_feature); }
+
     uint32_t selectionColor = 0;
     bool added = false;
 
@@ -68,6 +92,12 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
             continue;
         }
 
+        // Skip rules which only build styles that are not selected
+        bool buildStyle = isSelected(*style);
+        if (!buildStyle && !rule.findParameter(StyleParamKey::outline_style)) {
+            continue;
+        }
+
         // Apply default draw rules defined for this style
         style->style().applyDefaultDrawRules(rule);
 
@@ -93,7 +123,7 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
             auto* outlineStyle = getStyleBuilder(styleName);
             if (!outlineStyle) {
                 LOGN("Invalid style %s", styleName.c_str());
-            } else {
+            } else if (isSelected(*outlineStyle)) {
                 rule.isOutlineOnly = true;
                 outlineStyle->addFeature(_feature, rule);
                 rule.isOutlineOnly = false;
@@ -101,7 +131,9 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
         }
 
         // build feature with style
-        added |= style->addFeature(_feature, rule);
+        if (buildStyle) {
+            added |= style->addFeature(_feature, rule);
+        }
     }
 
     if (added && (selectionColor != 0)) {
@@ -109,42 +141,136 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
     }
 }
 
-std::unique_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileData, const TileSource& _source) {
+void TileBuilder::setGeometryCache(std::shared_ptr<GeometryCache> _cache, uint64_t _sceneHash) {
+    m_geometryCache = std::move(_cache);
+    m_sceneHash = _sceneHash;
+}
+
+void TileBuilder::resetBuilders() {
+    for (auto& builder : m_styleBuilder) {
+        if (!isSelected(*builder.second)) { continue; }
+
+        builder.second->reset();
+    }
+}
+
+std::unique_ptr<Tile> TileBuilder::restore(TileID _tileID, const TileSource& _source) {
+
+    if (!m_geometryCache) { return nullptr; }
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto tile = std::make_unique<Tile>(_tileID, _source.id(), _source.generation());
+
+    tile->initGeometry(m_scene->styles().size());
+
+    std::vector<bool> loaded;
+    if (!m_geometryCache->load(m_sceneHash, *m_scene, _source, *tile, loaded) ||
+        std::find(loaded.begin(), loaded.end(), false) != loaded.end()) {
+        return nullptr;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    tile->setBuildTime(elapsed);
+
+    return tile;
+}
+
+std::unique_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileData, const TileSource& _source,
+                                         const std::vector<bool>* _styles, const TileTask* _task) {
+
+    auto start = std::chrono::steady_clock::now();
 
     m_selectionFeatures.clear();
+    m_styles = _styles;
+    m_tileData = &_tileData;
 
     auto tile = std::make_unique<Tile>(_tileID, _source.id(), _source.generation());
 
     tile->initGeometry(m_scene->styles().size());
 
+    bool cacheable = m_geometryCache && !_styles && GeometryCache::isCacheable(_source);
+    bool cached = false;
+
+    // Styles which could not be restored from the GeometryCache, e.g. labels
+    std::vector<bool> uncachedStyles;
+
+    if (cacheable) {
+        cached = m_geometryCache->load(m_sceneHash, *m_scene, _source, *tile, uncachedStyles);
+        if (cached) {
+            uncachedStyles.flip();
+            m_styles = &uncachedStyles;
+            // Selection features of the restored meshes
+            for (const auto& feature : tile->getSelectionFeatures()) {
+                m_selectionFeatures[feature.first] = feature.second;
+            }
+        }
+    }
+
+    bool buildFeatures = !cached ||
+        std::find(uncachedStyles.begin(), uncachedStyles.end(), true) != uncachedStyles.end();
+
     m_styleContext->setKeywordZoom(_tileID.s);
 
     for (auto& builder : m_styleBuilder) {
-        if (builder.second)
+        if (builder.second && isSelected(*builder.second))
             builder.second->setup(*tile);
     }
 
+    size_t numFeatures = 0;
+    size_t processed = 0;
+
+    for (const auto& datalayer : m_scene->layers()) {
+        if (!buildFeatures || datalayer.source() != _source.name()) { continue; }
+
+        for (const auto& collection : _tileData.layers) {
+            if (containsCollection(datalayer, collection)) {
+                numFeatures += collection.features.size();
+            }
+        }
+    }
+
+    bool canceled = false;
+
     for (const auto& datalayer : m_scene->layers()) {
 
-        if (datalayer.source() != _source.name()) { continue; }
+        if (!buildFeatures || datalayer.source() != _source.name()) { continue; }
 
         for (const auto& collection : _tileData.layers) {
 
-            if (!collection.name.empty()) {
-                const auto& dlc = datalayer.collections();
-                bool layerContainsCollection =
-                    std::find(dlc.begin(), dlc.end(), collection.name) != dlc.end();
+            if (!containsCollection(datalayer, collection)) { continue; }
 
-                if (!layerContainsCollection) { continue; }
-            }
+            const auto& features = collection.features;
 
-            for (const auto& feat : collection.features) {
-                applyStyling(feat, datalayer);
+            for (size_t i = 0; i < features.size(); i++) {
+                // Check for cancellation between layers and feature batches
+                if (i % CANCEL_CHECK_FEATURES == 0 && _task && _task->isCanceled()) {
+                    canceled = true;
+                    break;
+                }
+                applyStyling(features[i], datalayer);
+                processed++;
             }
+            if (canceled) { break; }
         }
+        if (canceled) { break; }
     }
 
+    if (canceled || (_task && _task->isCanceled())) {
+        m_buildProgress = numFeatures > 0 ? float(processed) / numFeatures : 0.f;
+        m_canceledBuilds++;
+
+        resetBuilders();
+        m_styles = nullptr;
+        m_tileData = nullptr;
+        return nullptr;
+    }
+
+    m_buildProgress = 1.f;
+
     for (auto& builder : m_styleBuilder) {
+        if (!isSelected(*builder.second)) { continue; }
 
         builder.second->addLayoutItems(m_labelLayout);
     }
@@ -154,11 +280,25 @@ std::unique_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileDa
     m_labelLayout.process(_tileID, tile->getInverseScale(), tileSize);
 
     for (auto& builder : m_styleBuilder) {
+        if (!isSelected(*builder.second)) { continue; }
+
         tile->setMesh(builder.second->style(), builder.second->build());
     }
 
     tile->setSelectionFeatures(m_selectionFeatures);
 
+    if (cacheable && !cached) {
+        m_geometryCache->store(m_sceneHash, *m_scene, _source, *tile);
+    }
+
+    // Rebuild cost of the tile, weighed against its size by the TileCache
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    tile->setBuildTime((_task ? _task->parseTime() : 0) + elapsed);
+
+    m_styles = nullptr;
+    m_tileData = nullptr;
+
     return tile;
 }
 
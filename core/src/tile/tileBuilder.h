@@ -8,9 +8,11 @@
 namespace Tangram {
 
 class DataLayer;
+class GeometryCache;
 class StyleBuilder;
 class Tile;
 class TileSource;
+class TileTask;
 struct Feature;
 struct Properties;
 struct TileData;
@@ -25,10 +27,33 @@ public:
 
     StyleBuilder* getStyleBuilder(const std::string& _name);
 
-    std::unique_ptr<Tile> build(TileID _tileID, const TileData& _data, const TileSource& _source);
+    /* Build the meshes of all styles or, when @_styles is given, only of the
+     * styles marked in @_styles (indexed by Style ID)
+     *
+     * When @_task is given, building stops and returns nullptr as soon as
+     * the task gets canceled.
+     */
+    std::unique_ptr<Tile> build(TileID _tileID, const TileData& _data, const TileSource& _source,
+                                const std::vector<bool>* _styles = nullptr,
+                                const TileTask* _task = nullptr);
+
+    /* Restore all meshes of tile @_tileID from the GeometryCache, without
+     * TileData. Returns nullptr when not all styles are cached. */
+    std::unique_ptr<Tile> restore(TileID _tileID, const TileSource& _source);
+
+    /* Fraction of features processed by the last build. Less than 1 when the
+     * build was canceled */
+    float buildProgress() const { return m_buildProgress; }
+
+    /* Number of builds stopped because their task was canceled */
+    uint64_t canceledBuilds() const { return m_canceledBuilds; }
 
     const Scene& scene() const { return *m_scene; }
 
+    /* Restore tiles from @_cache instead of building them and store built tiles.
+     * @_sceneHash identifies the Scene of this TileBuilder (see GeometryCache::sceneHash) */
+    void setGeometryCache(std::shared_ptr<GeometryCache> _cache, uint64_t _sceneHash);
+
     // For testing
     TileBuilder(std::shared_ptr<Scene> _scene, StyleContext* _styleContext);
 
@@ -37,6 +62,11 @@ private:
     // Determine and apply DrawRules for a @_feature
     void applyStyling(const Feature& _feature, const SceneLayer& _layer);
 
+    bool isSelected(const StyleBuilder& _builder) const;
+
+    // Discard geometry of a canceled build
+    void resetBuilders();
+
     std::shared_ptr<Scene> m_scene;
 
     std::unique_ptr<StyleContext> m_styleContext;
@@ -47,6 +77,19 @@ private:
     fastmap<std::string, std::unique_ptr<StyleBuilder>> m_styleBuilder;
 
     fastmap<uint32_t, std::shared_ptr<Properties>> m_selectionFeatures;
+
+    // Styles to build, all when null
+    const std::vector<bool>* m_styles = nullptr;
+
+    // TileData of the current build, decodes the geometry of matched features
+    const TileData* m_tileData = nullptr;
+
+    float m_buildProgress = 0;
+
+    uint64_t m_canceledBuilds = 0;
+
+    std::shared_ptr<GeometryCache> m_geometryCache;
+    uint64_t m_sceneHash = 0;
 };
 
 }
@@ -5,6 +5,8 @@
 #include "tile/tileHash.h"
 #include "tile/tileID.h"
 
+#include <algorithm>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <unordered_map>
@@ -28,27 +30,78 @@ namespace std {
 
 namespace Tangram {
 
+/* Cache for tiles that left the view, limited by the memory usage of their meshes
+ *
+ * Scan resistant replacement similar to 2Q: Cached tiles enter a probation
+ * queue that may use a quarter of the cache. Tiles which were taken from the
+ * cache before, or evicted from probation recently, enter the protected queue
+ * instead. Tiles passed only once, e.g. during a long pan, thus displace other
+ * probation tiles but not the tiles the user keeps coming back to.
+ *
+ * Eviction picks among the least recently cached tiles of a queue the one with
+ * the lowest rebuild cost (parse and build time) per byte.
+ */
 class TileCache {
+
+    enum class Queue : uint8_t { probation, protect };
+
     struct CacheEntry {
         TileCacheKey key;
         std::shared_ptr<Tile> tile;
+        size_t size;
+        Queue queue;
     };
 
     using CacheList = std::list<CacheEntry>;
     using CacheMap = std::unordered_map<TileCacheKey, typename CacheList::iterator>;
 
+    // Keys of tiles that were used again or evicted from probation
+    using HistoryList = std::list<TileCacheKey>;
+    using HistoryMap = std::unordered_map<TileCacheKey, typename HistoryList::iterator>;
+
+    // Number of least recently cached tiles compared on eviction
+    static constexpr int EVICTION_CANDIDATES = 4;
+
+    // Minimum number of keys kept in the history
+    static constexpr size_t MIN_HISTORY = 256;
+
 public:
 
-    TileCache(size_t _cacheSizeMB) :
-        m_cacheUsage(0),
-        m_cacheMaxUsage(_cacheSizeMB) {}
+    struct Stats {
+        // Tiles found or not found by get()
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        // Tiles removed to stay within the cache size
+        uint64_t evictions = 0;
+        // Cached tiles and their memory usage in bytes
+        size_t entries = 0;
+        size_t usage = 0;
+        size_t maxUsage = 0;
+    };
+
+    TileCache(size_t _cacheSizeBytes) :
+        m_cacheMaxUsage(_cacheSizeBytes) {}
 
     void put(int32_t _sourceId, std::shared_ptr<Tile> _tile) {
         TileCacheKey k(_sourceId, _tile->getID());
 
-        m_cacheList.push_front({k, _tile});
-        m_cacheMap[k] = m_cacheList.begin();
-        m_cacheUsage += _tile->getMemoryUsage();
+        auto it = m_cacheMap.find(k);
+        if (it != m_cacheMap.end()) { remove(it->second); }
+
+        Queue queue = Queue::probation;
+        auto history = m_historyMap.find(k);
+        if (history != m_historyMap.end()) {
+            m_historyList.erase(history->second);
+            m_historyMap.erase(history);
+            queue = Queue::protect;
+        }
+
+        auto& list = queue == Queue::protect ? m_protectList : m_probationList;
+        size_t size = _tile->getMemoryUsage();
+
+        list.push_front({k, std::move(_tile), size, queue});
+        m_cacheMap[k] = list.begin();
+        usage(queue) += size;
 
         limitCacheSize(m_cacheMaxUsage);
     }
@@ -58,17 +111,22 @@ public:
         TileCacheKey k(_sourceId, _tileId);
 
         auto it = m_cacheMap.find(k);
-        if (it != m_cacheMap.end()) {
-            std::swap(tile, (*(it->second)).tile);
-            m_cacheList.erase(it->second);
-            m_cacheMap.erase(it);
-            m_cacheUsage -= tile->getMemoryUsage();
+        if (it == m_cacheMap.end()) {
+            m_stats.misses++;
+            return tile;
         }
+        m_stats.hits++;
+
+        std::swap(tile, it->second->tile);
+        remove(it->second);
+
+        // Protect the tile when it is cached again
+        remember(k);
+
         return tile;
     }
 
     std::shared_ptr<Tile> contains(int32_t _source, TileID _tileID) {
-        std::shared_ptr<Tile> tile;
         TileCacheKey k(_source, _tileID);
 
         auto it = m_cacheMap.find(k);
@@ -81,39 +139,122 @@ public:
     void limitCacheSize(size_t _cacheSizeBytes) {
         m_cacheMaxUsage = _cacheSizeBytes;
 
-        while (m_cacheUsage > m_cacheMaxUsage) {
-            if (m_cacheList.empty()) {
+        size_t probationMaxUsage = m_cacheMaxUsage / 4;
+
+        while (m_probationUsage + m_protectUsage > m_cacheMaxUsage) {
+            if (m_probationList.empty() && m_protectList.empty()) {
                 LOGE("Invalid cache state!");
-                m_cacheUsage = 0;
+                m_probationUsage = 0;
+                m_protectUsage = 0;
                 break;
             }
-            auto& tile = m_cacheList.back().tile;
-            m_cacheUsage -= tile->getMemoryUsage();
-            m_cacheMap.erase(m_cacheList.back().key);
-            m_cacheList.pop_back();
+
+            bool probation = !m_probationList.empty() &&
+                (m_probationUsage > probationMaxUsage || m_protectList.empty());
+
+            auto& list = probation ? m_probationList : m_protectList;
+            auto victim = selectVictim(list);
+            TileCacheKey k = victim->key;
+
+            remove(victim);
+            m_stats.evictions++;
+
+            // Tiles which are requested again soon after leaving probation
+            // get protected
+            if (probation) { remember(k); }
         }
     }
 
+    /* Call @_fn with each cached tile */
+    template<typename F>
+    void forEach(F _fn) {
+        for (auto& entry : m_protectList) { _fn(*entry.tile); }
+        for (auto& entry : m_probationList) { _fn(*entry.tile); }
+    }
+
     size_t getMemoryUsage() const {
-        size_t sum = 0;
-        for (auto& entry : m_cacheList) {
-            sum += entry.tile->getMemoryUsage();
-        }
-        return sum;
+        return m_probationUsage + m_protectUsage;
+    }
+
+    Stats stats() const {
+        Stats stats = m_stats;
+        stats.entries = m_cacheMap.size();
+        stats.usage = getMemoryUsage();
+        stats.maxUsage = m_cacheMaxUsage;
+        return stats;
     }
 
     void clear() {
         m_cacheMap.clear();
-        m_cacheList.clear();
-        m_cacheUsage = 0;
+        m_probationList.clear();
+        m_protectList.clear();
+        m_historyMap.clear();
+        m_historyList.clear();
+        m_probationUsage = 0;
+        m_protectUsage = 0;
     }
 
 private:
+
+    size_t& usage(Queue _queue) {
+        return _queue == Queue::protect ? m_protectUsage : m_probationUsage;
+    }
+
+    void remove(typename CacheList::iterator _entry) {
+        usage(_entry->queue) -= _entry->size;
+        m_cacheMap.erase(_entry->key);
+
+        auto& list = _entry->queue == Queue::protect ? m_protectList : m_probationList;
+        list.erase(_entry);
+    }
+
+    void remember(const TileCacheKey& _key) {
+        if (m_historyMap.find(_key) != m_historyMap.end()) { return; }
+
+        m_historyList.push_front(_key);
+        m_historyMap[_key] = m_historyList.begin();
+
+        size_t maxHistory = std::max(size_t(MIN_HISTORY), m_cacheMap.size());
+        while (m_historyList.size() > maxHistory) {
+            m_historyMap.erase(m_historyList.back());
+            m_historyList.pop_back();
+        }
+    }
+
+    // Least recently cached tile with the lowest rebuild cost per byte
+    // among the last EVICTION_CANDIDATES entries of @_list
+    typename CacheList::iterator selectVictim(CacheList& _list) {
+        auto victim = std::prev(_list.end());
+        double minCost = cost(*victim);
+
+        auto it = victim;
+        for (int i = 1; i < EVICTION_CANDIDATES && it != _list.begin(); i++) {
+            --it;
+            double c = cost(*it);
+            if (c < minCost) {
+                minCost = c;
+                victim = it;
+            }
+        }
+        return victim;
+    }
+
+    static double cost(const CacheEntry& _entry) {
+        return double(_entry.tile->buildTime() + 1) / double(std::max(_entry.size, size_t(1)));
+    }
+
     CacheMap m_cacheMap;
-    CacheList m_cacheList;
+    CacheList m_probationList;
+    CacheList m_protectList;
+
+    HistoryMap m_historyMap;
+    HistoryList m_historyList;
+
+    size_t m_probationUsage = 0;
+    size_t m_protectUsage = 0;
+    size_t m_cacheMaxUsage;
 
-    int m_cacheUsage;
-    int m_cacheMaxUsage;
+    Stats m_stats;
 };
 
 }
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "tile/tileHash.h"
+#include "tile/tileID.h"
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Tangram {
+
+/* Flat hash map keyed by TileID
+ *
+ * Open addressing with linear probing over a single vector of slots, so that
+ * lookups and iteration touch contiguous memory. Erased slots are marked as
+ * deleted: erase() never moves other entries, which allows to erase while
+ * iterating.
+ *
+ * References and iterators are invalidated when an insertion grows the table.
+ * Use reserve() before inserting while holding references.
+ */
+template<typename T>
+class TileIDMap {
+
+    enum class State : uint8_t { empty, full, deleted };
+
+    struct Slot {
+        std::pair<TileID, T> entry{ NOT_A_TILE, T() };
+        State state = State::empty;
+    };
+
+    using Slots = std::vector<Slot>;
+
+    // Keep at most half of the slots in use
+    static size_t capacityFor(size_t _size) {
+        size_t capacity = 16;
+        while (capacity < _size * 2) { capacity *= 2; }
+        return capacity;
+    }
+
+public:
+
+    template<typename S, typename V>
+    class Iterator {
+    public:
+        Iterator(S* _slot, S* _end) : m_slot(_slot), m_end(_end) { skip(); }
+
+        V& operator*() const { return m_slot->entry; }
+        V* operator->() const { return &m_slot->entry; }
+
+        Iterator& operator++() {
+            ++m_slot;
+            skip();
+            return *this;
+        }
+
+        bool operator==(const Iterator& _other) const { return m_slot == _other.m_slot; }
+        bool operator!=(const Iterator& _other) const { return m_slot != _other.m_slot; }
+
+    private:
+        void skip() {
+            while (m_slot != m_end && m_slot->state != State::full) { ++m_slot; }
+        }
+
+        S* m_slot;
+        S* m_end;
+
+        friend class TileIDMap;
+    };
+
+    using iterator = Iterator<Slot, std::pair<TileID, T>>;
+    using const_iterator = Iterator<const Slot, const std::pair<TileID, T>>;
+
+    iterator begin() { return { m_slots.data(), m_slots.data() + m_slots.size() }; }
+    iterator end() { return { m_slots.data() + m_slots.size(), m_slots.data() + m_slots.size() }; }
+
+    const_iterator begin() const { return { m_slots.data(), m_slots.data() + m_slots.size() }; }
+    const_iterator end() const { return { m_slots.data() + m_slots.size(), m_slots.data() + m_slots.size() }; }
+
+    size_t size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    iterator find(const TileID& _id) {
+        size_t index = lookup(_id);
+        if (index == m_slots.size()) { return end(); }
+        return { &m_slots[index], m_slots.data() + m_slots.size() };
+    }
+
+    const_iterator find(const TileID& _id) const {
+        size_t index = lookup(_id);
+        if (index == m_slots.size()) { return end(); }
+        return { &m_slots[index], m_slots.data() + m_slots.size() };
+    }
+
+    size_t count(const TileID& _id) const { return lookup(_id) != m_slots.size() ? 1 : 0; }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const TileID& _id, Args&&... _args) {
+        size_t index = lookup(_id);
+        if (index != m_slots.size()) {
+            return { { &m_slots[index], m_slots.data() + m_slots.size() }, false };
+        }
+
+        if (m_size + m_deleted + 1 > m_slots.size() / 2) {
+            rehash(capacityFor(m_size + 1));
+        }
+
+        size_t mask = m_slots.size() - 1;
+        index = hash(_id) & mask;
+        while (m_slots[index].state == State::full) { index = (index + 1) & mask; }
+
+        auto& slot = m_slots[index];
+        if (slot.state == State::deleted) { m_deleted--; }
+
+        slot.entry.first = _id;
+        slot.entry.second = T(std::forward<Args>(_args)...);
+        slot.state = State::full;
+        m_size++;
+
+        return { { &slot, m_slots.data() + m_slots.size() }, true };
+    }
+
+    T& operator[](const TileID& _id) {
+        return emplace(_id).first->second;
+    }
+
+    iterator erase(iterator _it) {
+        auto* slot = _it.m_slot;
+        assert(slot->state == State::full);
+
+        slot->entry.second = T();
+        slot->state = State::deleted;
+        m_size--;
+        m_deleted++;
+
+        return ++_it;
+    }
+
+    size_t erase(const TileID& _id) {
+        auto it = find(_id);
+        if (it == end()) { return 0; }
+        erase(it);
+        return 1;
+    }
+
+    void clear() {
+        m_slots.clear();
+        m_size = 0;
+        m_deleted = 0;
+    }
+
+    /* Make room for @_size entries, so that inserting up to @_size entries
+     * does not invalidate references */
+    void reserve(size_t _size) {
+        if (_size + m_deleted > m_slots.size() / 2) {
+            rehash(capacityFor(_size));
+        }
+    }
+
+private:
+
+    static size_t hash(const TileID& _id) {
+        // Spread the combined hash over the high bits used by the mask
+        uint64_t h = std::hash<TileID>()(_id);
+        return (h * 0x9E3779B97F4A7C15ull) >> 32;
+    }
+
+    // Returns the slot index of @_id or m_slots.size() when not found
+    size_t lookup(const TileID& _id) const {
+        if (m_size == 0) { return m_slots.size(); }
+
+        size_t mask = m_slots.size() - 1;
+        size_t index = hash(_id) & mask;
+
+        while (m_slots[index].state != State::empty) {
+            if (m_slots[index].state == State::full && m_slots[index].entry.first == _id) {
+                return index;
+            }
+            index = (index + 1) & mask;
+        }
+        return m_slots.size();
+    }
+
+    void rehash(size_t _capacity) {
+        Slots slots(_capacity);
+        std::swap(slots, m_slots);
+
+        size_t mask = _capacity - 1;
+        for (auto& slot : slots) {
+            if (slot.state != State::full) { continue; }
+
+            size_t index = hash(slot.entry.first) & mask;
+            while (m_slots[index].state == State::full) { index = (index + 1) & mask; }
+
+            m_slots[index].entry.first = slot.entry.first;
+            m_slots[index].entry.second = std::move(slot.entry.second);
+            m_slots[index].state = State::full;
+        }
+        m_deleted = 0;
+    }
+
+    Slots m_slots;
+    size_t m_size = 0;
+    size_t m_deleted = 0;
+};
+
+}
@@ -3,6 +3,8 @@
 #include "data/tileSource.h"
 #include "map.h"
 #include "platform.h"
+#include "scene/sceneDiff.h"
+#include "tile/geometryCache.h"
 #include "tile/tile.h"
 #include "tile/tileCache.h"
 #include "util/mapProjection.h"
@@ -11,11 +13,16 @@
 #include "glm/gtx/norm.hpp"
 
 #include <algorithm>
+#include <chrono>
 
 #define DBG(...) // LOGD(__VA_ARGS__)
 
 namespace Tangram {
 
+static void sortUnique(std::vector<TileID>& _tiles) {
+    std::sort(_tiles.begin(), _tiles.end());
+    _tiles.erase(std::unique(_tiles.begin(), _tiles.end()), _tiles.end());
+}
 
 enum class TileManager::ProxyID : uint8_t {
     no_proxies = 0,
@@ -29,14 +36,34 @@ enum class TileManager::ProxyID : uint8_t {
 
 struct TileManager::TileEntry {
 
+    TileEntry() : m_proxyCounter(0), m_proxies(0), m_visible(false) {}
+
     TileEntry(std::shared_ptr<Tile>& _tile)
         : tile(_tile), m_proxyCounter(0), m_proxies(0), m_visible(false) {}
 
+    TileEntry(TileEntry&& _other) = default;
+
+    // Replacing an entry cancels its task like removing it
+    TileEntry& operator=(TileEntry&& _other) {
+        clearTask();
+        tile = std::move(_other.tile);
+        task = std::move(_other.task);
+        pending = std::move(_other.pending);
+        m_proxyCounter = _other.m_proxyCounter;
+        m_proxies = _other.m_proxies;
+        m_visible = _other.m_visible;
+        return *this;
+    }
+
     ~TileEntry() { clearTask(); }
 
     std::shared_ptr<Tile> tile;
     std::shared_ptr<TileTask> task;
 
+    /* Completed tile waiting for the upload of its meshes. Replaces
+     * tile (and its proxies) once uploaded. */
+    std::shared_ptr<Tile> pending;
+
     /* A Counter for number of tiles this tile acts a proxy for */
     int32_t m_proxyCounter;
 
@@ -53,7 +80,7 @@ struct TileManager::TileEntry {
     }
 
     bool needsLoading() {
-        if (bool(tile)) { return false; }
+        if (bool(tile) || bool(pending)) { return false; }
         if (!task) { return true; }
         if (task->isCanceled()) { return false; }
         if (task->needsLoading()) { return true; }
@@ -64,19 +91,25 @@ struct TileManager::TileEntry {
         return false;
     }
 
-    // Complete task only when
+    // Task can be completed when
     // - task still exists
     // - task has a tile ready
     // - tile has all rasters set
-    bool completeTileTask() {
+    bool isReady() {
         if (bool(task) && task->isReady()) {
 
             for (auto& rTask : task->subTasks()) {
                 if (!rTask->isReady()) { return false; }
             }
+            return true;
+        }
+        return false;
+    }
 
+    bool completeTileTask() {
+        if (isReady()) {
             task->complete();
-            tile = task->getTile();
+            pending = task->getTile();
             task.reset();
 
             return true;
@@ -84,6 +117,22 @@ struct TileManager::TileEntry {
         return false;
     }
 
+    // Replace tile with the pending tile once it is uploaded
+    bool finishUpload() {
+        if (bool(pending) && pending->isUploaded()) {
+            replaceTile();
+            return true;
+        }
+        return false;
+    }
+
+    // Replace tile with the pending tile. A restyled tile takes over the
+    // meshes of the styles that were not rebuilt from the tile it replaces.
+    void replaceTile() {
+        pending->adoptBaseGeometry();
+        tile = std::move(pending);
+    }
+
     void clearTask() {
         if (task) {
             for (auto& raster : task->subTasks()) {
@@ -133,6 +182,10 @@ struct TileManager::TileEntry {
 TileManager::TileSet::TileSet(std::shared_ptr<TileSource> _source, bool _clientSource) :
     source(_source), clientTileSource(_clientSource) {}
 
+TileManager::TileSet::TileSet(TileSet&& _other) = default;
+
+TileManager::TileSet& TileManager::TileSet::operator=(TileSet&& _other) = default;
+
 TileManager::TileSet::~TileSet() {}
 
 TileManager::TileManager(std::shared_ptr<Platform> platform, TileTaskQueue& _tileWorker) :
@@ -174,6 +227,7 @@ void TileManager::setTileSources(const std::vector<std::shared_ptr<TileSource>>&
             }
             // Clear cache
             tileSet.tiles.clear();
+            clearPrefetchTiles(tileSet);
             return false;
         });
 
@@ -227,6 +281,7 @@ bool TileManager::removeClientTileSource(TileSource& _tileSource) {
 void TileManager::clearTileSets(bool clearSourceCaches) {
     for (auto& tileSet : m_tileSets) {
         tileSet.tiles.clear();
+        clearPrefetchTiles(tileSet);
 
         if (clearSourceCaches) {
             tileSet.source->clearData();
@@ -240,22 +295,83 @@ void TileManager::clearTileSet(int32_t _sourceId) {
     for (auto& tileSet : m_tileSets) {
         if (tileSet.source->id() != _sourceId) { continue; }
         tileSet.tiles.clear();
+        clearPrefetchTiles(tileSet);
     }
 
     m_tileCache->clear();
     m_tileSetChanged = true;
 }
 
-void TileManager::updateTileSets(const View& _view) {
+void TileManager::rebuildStyles(const SceneDiff& _diff, const std::vector<std::unique_ptr<Style>>& _styles) {
+
+    // Cached tiles do not keep their TileData. They are rebuilt when used
+    // again and drawn until then.
+    m_tileCache->forEach([&](Tile& _tile) {
+        _tile.setLabelStyles(_styles);
+        _tile.resetVaos();
+        _tile.setStale(true);
+    });
+
+    auto styles = std::make_shared<const std::vector<bool>>(_diff.styles);
+
+    for (auto& tileSet : m_tileSets) {
+        auto& source = tileSet.source;
+
+        clearPrefetchTiles(tileSet);
+
+        for (auto& it : tileSet.tiles) {
+            auto& entry = it.second;
+
+            // Restart tasks which may have been built with the previous Scene
+            if (entry.isInProgress()) {
+                source->cancelLoadingTile(*entry.task);
+            }
+            entry.clearTask();
+
+            // Restyle the most recent tile, its meshes are uploaded on first draw
+            if (entry.pending) { entry.replaceTile(); }
+
+            if (!entry.tile) { continue; }
+
+            if (entry.tile->sourceGeneration() != source->generation()) {
+                // Reload the tile
+                entry.tile.reset();
+                continue;
+            }
+
+            entry.tile->setLabelStyles(_styles);
+
+            // Kept meshes are drawn with the ShaderPrograms of the new Scene
+            entry.tile->resetVaos();
+
+            if (!entry.tile->tileData()) {
+                // Tile from the TileCache, reloaded by updateTileSet()
+                entry.tile->setStale(true);
+                continue;
+            }
+
+            entry.task = std::make_shared<RestyleTileTask>(entry.tile, source, styles);
+            m_workers.enqueue(entry.task);
+        }
+    }
+
+    m_tileSetChanged = true;
+}
+
+void TileManager::updateTileSets(const View& _view, const View* _predictedView) {
 
     m_tiles.clear();
+    m_uploadTiles.clear();
     m_tilesInProgress = 0;
     m_tileSetChanged = false;
 
+    completeTileTasks();
+
     if (!getDebugFlag(DebugFlags::freeze_tiles)) {
 
         for (auto& tileSet : m_tileSets) {
             tileSet.visibleTiles.clear();
+            tileSet.predictedTiles.clear();
         }
 
         auto tileCb = [&, zoom = _view.getZoom()](TileID _tileID){
@@ -264,11 +380,29 @@ void TileManager::updateTileSets(const View& _view) {
                 auto maxZoom = tileSet.source->maxZoom();
 
                 // Insert scaled and maxZoom mapped tileID in the visible set
-                tileSet.visibleTiles.insert(_tileID.zoomBiasAdjusted(zoomBias).withMaxSourceZoom(maxZoom));
+                tileSet.visibleTiles.push_back(_tileID.zoomBiasAdjusted(zoomBias).withMaxSourceZoom(maxZoom));
             }
         };
 
         _view.getVisibleTiles(tileCb);
+
+        if (_predictedView) {
+            auto predictedTileCb = [&](TileID _tileID){
+                for (auto& tileSet : m_tileSets) {
+                    auto zoomBias = tileSet.source->zoomBias();
+                    auto maxZoom = tileSet.source->maxZoom();
+
+                    tileSet.predictedTiles.push_back(_tileID.zoomBiasAdjusted(zoomBias).withMaxSourceZoom(maxZoom));
+                }
+            };
+
+            _predictedView->getVisibleTiles(predictedTileCb);
+        }
+
+        for (auto& tileSet : m_tileSets) {
+            sortUnique(tileSet.visibleTiles);
+            sortUnique(tileSet.predictedTiles);
+        }
     }
 
     for (auto& tileSet : m_tileSets) {
@@ -280,6 +414,17 @@ void TileManager::updateTileSets(const View& _view) {
 
     loadTiles();
 
+    m_prefetchTasks = 0;
+    m_prefetchBytes = 0;
+
+    for (auto& tileSet : m_tileSets) {
+        updatePrefetchTiles(tileSet);
+    }
+
+    if (_predictedView) {
+        prefetchTiles(_predictedView->state());
+    }
+
     // Make m_tiles an unique list of tiles for rendering sorted from
     // high to low zoom-levels.
     std::sort(m_tiles.begin(), m_tiles.end(), [](auto& a, auto& b) {
@@ -290,6 +435,74 @@ void TileManager::updateTileSets(const View& _view) {
 
     // Remove duplicates: Proxy tiles could have been added more than once
     m_tiles.erase(std::unique(m_tiles.begin(), m_tiles.end()), m_tiles.end());
+
+    // Upload tiles closest to the view center first
+    std::sort(m_uploadTiles.begin(), m_uploadTiles.end(), [](auto& a, auto& b) {
+            return a.first < b.first;
+        });
+}
+
+void TileManager::completeTileTasks() {
+
+    using Clock = std::chrono::steady_clock;
+
+    m_completeStart = Clock::now();
+    m_completedTasks = 0;
+    m_deferredTasks = 0;
+
+    std::vector<TileEntry*> readyTiles;
+
+    for (auto& tileSet : m_tileSets) {
+        for (auto& it : tileSet.tiles) {
+            if (it.second.isReady()) { readyTiles.push_back(&it.second); }
+        }
+    }
+
+    // Complete tiles in the order of TileWorker: visible tiles before
+    // proxies, then by distance to the view center
+    std::sort(readyTiles.begin(), readyTiles.end(), [](auto* a, auto* b) {
+            if (a->task->isProxy() != b->task->isProxy()) {
+                return !a->task->isProxy();
+            }
+            return a->task->getPriority() < b->task->getPriority();
+        });
+
+    for (auto* entry : readyTiles) {
+        if (!hasCompleteBudget()) {
+            m_deferredTasks++;
+            continue;
+        }
+        entry->completeTileTask();
+        m_completedTasks++;
+    }
+}
+
+bool TileManager::hasCompleteBudget() {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Always complete one task per frame
+    if (m_completeMaxTime <= 0.f || m_completedTasks == 0) { return true; }
+
+    auto elapsed = std::chrono::duration<float, std::milli>(Clock::now() - m_completeStart);
+    return elapsed.count() < m_completeMaxTime;
+}
+
+size_t TileManager::uploadTiles(RenderState& _rs) {
+
+    size_t bytes = 0;
+    size_t uploaded = 0;
+
+    for (auto& it : m_uploadTiles) {
+        if (m_uploadMaxBytes > 0 && uploaded > 0 && bytes >= m_uploadMaxBytes) { break; }
+
+        bytes += it.second->upload(_rs);
+        uploaded++;
+    }
+
+    m_uploadTiles.erase(m_uploadTiles.begin(), m_uploadTiles.begin() + uploaded);
+
+    return bytes;
 }
 
 void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
@@ -309,43 +522,36 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
     std::vector<TileID> removeTiles;
     auto& tiles = _tileSet.tiles;
 
-    // Check for ready tasks, move Tile to active TileSet and unset Proxies.
+    // Check for uploaded tiles, move Tile to active TileSet and unset Proxies.
     for (auto& it : tiles) {
         auto& entry = it.second;
-        if (entry.completeTileTask()) {
+        if (entry.finishUpload()) {
             clearProxyTiles(_tileSet, it.first, entry, removeTiles);
 
             newTiles = true;
             m_tileSetChanged = true;
         }
+        // Visibility is set again below, removed tiles are checked again
+        entry.setVisible(false);
     }
 
     const auto& visibleTiles = _tileSet.visibleTiles;
 
-    // Loop over visibleTiles and add any needed tiles to tileSet
-    auto curTilesIt = tiles.begin();
-    auto visTilesIt = visibleTiles.begin();
-
     auto generation = _tileSet.source->generation();
 
-    while (visTilesIt != visibleTiles.end() || curTilesIt != tiles.end()) {
-
-        auto& visTileId = visTilesIt == visibleTiles.end()
-            ? NOT_A_TILE : *visTilesIt;
-
-        auto& curTileId = curTilesIt == tiles.end()
-            ? NOT_A_TILE : curTilesIt->first;
+    // Loop over visibleTiles and add any needed tiles to tileSet
+    for (const auto& visTileId : visibleTiles) {
 
-        if (visTileId == curTileId) {
-            // tiles in both sets match
-            assert(visTilesIt != visibleTiles.end() &&
-                   curTilesIt != tiles.end());
+        auto curTilesIt = tiles.find(visTileId);
 
+        if (curTilesIt != tiles.end()) {
+            // tile is already in the tileSet
             auto& entry = curTilesIt->second;
             entry.setVisible(true);
 
             if (entry.tile) {
                 m_tiles.push_back(entry.tile);
+                reloadStaleTile(_tileSet, visTileId, entry, _view);
             } else if (entry.needsLoading()) {
                 // Not yet available - enqueue for loading
                 if (!entry.task) {
@@ -372,55 +578,56 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
                 }
             }
 
-            if (entry.isInProgress()) {
+            if (entry.isInProgress() || entry.pending) {
                 m_tilesInProgress++;
             }
 
-            if (newTiles && entry.isInProgress()) {
+            if (newTiles && (entry.isInProgress() || entry.pending)) {
                 // check again for proxies
-                updateProxyTiles(_tileSet, visTileId, entry);
+                updateProxyTiles(_tileSet, visTileId);
             }
 
-            ++curTilesIt;
-            ++visTilesIt;
-
-        } else if (curTileId > visTileId) {
+        } else {
             // tileSet is missing an element present in visibleTiles
-            // NB: if (curTileId == NOT_A_TILE) it is always > visTileId
-            //     and if curTileId > visTileId, then visTileId cannot be
-            //     NOT_A_TILE. (for the current implementation of > operator)
-            assert(visTilesIt != visibleTiles.end());
+            auto& entry = addTile(_tileSet, visTileId);
 
-            if (!addTile(_tileSet, visTileId)) {
-                // Not in cache - enqueue for loading
-                enqueueTask(_tileSet, visTileId, _view);
+            if (entry.pending) {
                 m_tilesInProgress++;
-            }
 
-            ++visTilesIt;
+            } else if (reloadStaleTile(_tileSet, visTileId, entry, _view)) {
+                m_tilesInProgress++;
 
-        } else {
-            // tileSet has a tile not present in visibleTiles
-            assert(curTilesIt != tiles.end());
+            } else if (!entry.tile) {
+                // Not in cache - enqueue for loading, unless the
+                // tile was already loading for the predicted view
+                if (entry.needsLoading()) {
+                    enqueueTask(_tileSet, visTileId, _view);
+                }
+                m_tilesInProgress++;
+            }
+        }
+    }
 
-            auto& entry = curTilesIt->second;
+    // Check tiles not present in visibleTiles
+    for (auto& it : tiles) {
+        auto& entry = it.second;
+        if (entry.isVisible()) { continue; }
 
-            if (entry.getProxyCounter() > 0) {
-                if (entry.tile) {
-                    m_tiles.push_back(entry.tile);
-                } else if (entry.isInProgress()) {
-                    if (curTileId.z >= maxZoom || curTileId.z <= minZoom) {
-                        // Cancel tile loading but keep tile entry for referencing
-                        // this tiles proxy tiles.
-                        _tileSet.source->cancelLoadingTile(*entry.task);
-                        entry.clearTask();
-                    }
+        auto& curTileId = it.first;
+
+        if (entry.getProxyCounter() > 0) {
+            if (entry.tile) {
+                m_tiles.push_back(entry.tile);
+            } else if (entry.isInProgress()) {
+                if (curTileId.z >= maxZoom || curTileId.z <= minZoom) {
+                    // Cancel tile loading but keep tile entry for referencing
+                    // this tiles proxy tiles.
+                    _tileSet.source->cancelLoadingTile(*entry.task);
+                    entry.clearTask();
                 }
-            } else {
-                removeTiles.push_back(curTileId);
             }
-            entry.setVisible(false);
-            ++curTilesIt;
+        } else {
+            removeTiles.push_back(curTileId);
         }
     }
 
@@ -471,6 +678,12 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
             task->setProxyState(entry.getProxyCounter() > 0);
         }
 
+        if (entry.pending) {
+            // Upload priority by distance to map center
+            auto tileCenter = MapProjection::tileCenter(it.first);
+            m_uploadTiles.emplace_back(glm::length2(tileCenter - _view.center), entry.pending);
+        }
+
         if (entry.tile) {
             // Mark as proxy
             entry.tile->setProxyState(entry.getProxyCounter() > 0);
@@ -478,6 +691,19 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view) {
     }
 }
 
+bool TileManager::reloadStaleTile(TileSet& _tileSet, const TileID& _tileID, TileEntry& _entry,
+                                  const ViewState& _view) {
+
+    if (!_entry.tile || !_entry.tile->isStale() || _entry.task || _entry.pending) {
+        return false;
+    }
+
+    // The stale tile is drawn until the new tile is uploaded
+    _entry.task = _tileSet.source->createTask(_tileID);
+    enqueueTask(_tileSet, _tileID, _view);
+    return true;
+}
+
 void TileManager::enqueueTask(TileSet& _tileSet, const TileID& _tileID,
                               const ViewState& _view) {
 
@@ -504,7 +730,7 @@ void TileManager::loadTiles() {
         auto tileIt = tileSet.tiles.find(tileId);
         auto& entry = tileIt->second;
 
-        tileSet.source->loadTileData(entry.task, m_dataCallback);
+        loadTileData(tileSet, entry.task);
     }
 
     DBG("loading:%d pending:%d cache: %fMB",
@@ -514,16 +740,41 @@ void TileManager::loadTiles() {
     m_loadTasks.clear();
 }
 
-bool TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
+void TileManager::loadTileData(TileSet& _tileSet, std::shared_ptr<TileTask>& _task) {
+
+    auto& source = *_tileSet.source;
+
+    // Raster tiles need their data for the texture
+    if (m_geometryCache && !source.isRaster() && !_task->hasCachedGeometry() &&
+        GeometryCache::isCacheable(source) && m_geometryCache->contains(source, _task->tileId())) {
+        // Passed to the TileWorker by the TileSource, which still loads the sub-tasks
+        _task->setCachedGeometry();
+        _task->startedLoading();
+    }
+
+    source.loadTileData(_task, m_dataCallback);
+}
+
+TileManager::TileEntry& TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
 
     auto tile = m_tileCache->get(_tileSet.source->id(), _tileID);
+    std::shared_ptr<Tile> pending;
 
     if (tile) {
         if (tile->sourceGeneration() == _tileSet.source->generation()) {
-            m_tiles.push_back(tile);
-
             // Reset tile on potential internal dynamic data set
             tile->resetState();
+
+            if (tile->isUploaded()) {
+                m_tiles.push_back(tile);
+            } else {
+                // Prefetched tile, draw proxies until it is uploaded
+                pending = std::move(tile);
+            }
+
+            if (_tileSet.prefetched.erase(_tileID) > 0) {
+                m_prefetchStats.hits++;
+            }
         } else {
             // Clear stale tile data
             tile.reset();
@@ -531,20 +782,41 @@ bool TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
     }
 
     // Add TileEntry to TileSet
-    auto entry = _tileSet.tiles.emplace(_tileID, tile);
+    _tileSet.tiles.emplace(_tileID, tile);
 
     if (!tile) {
         // Add Proxy if corresponding proxy MapTile ready
-        updateProxyTiles(_tileSet, _tileID, entry.first->second);
+        updateProxyTiles(_tileSet, _tileID);
+    }
 
-        entry.first->second.task = _tileSet.source->createTask(_tileID);
+    // Adding proxies may move the entry
+    auto& tileEntry = _tileSet.tiles.find(_tileID)->second;
+
+    if (pending) {
+        tileEntry.pending = std::move(pending);
+
+    } else if (!tile) {
+
+        auto prefetchIt = _tileSet.prefetchTiles.find(_tileID);
+
+        if (prefetchIt != _tileSet.prefetchTiles.end() &&
+            prefetchIt->second.isInProgress()) {
+            // Continue with the task started for the predicted view
+            tileEntry.task = std::move(prefetchIt->second.task);
+            tileEntry.task->setPrefetch(false);
+            _tileSet.prefetchTiles.erase(prefetchIt);
+
+            m_prefetchStats.hits++;
+        } else {
+            tileEntry.task = _tileSet.source->createTask(_tileID);
+        }
     }
-    entry.first->second.setVisible(true);
+    tileEntry.setVisible(true);
 
-    return bool(tile);
+    return tileEntry;
 }
 
-void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::iterator& _tileIt) {
+void TileManager::removeTile(TileSet& _tileSet, TileIDMap<TileEntry>::iterator& _tileIt) {
 
     auto& entry = _tileIt->second;
 
@@ -555,8 +827,10 @@ void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::ite
 
         entry.clearTask();
 
-    } else if (entry.tile) {
-        // Add to cache
+    } else if (entry.pending || entry.tile) {
+        // Add to cache, TileData is only kept for tiles in use
+        if (entry.pending) { entry.replaceTile(); }
+        entry.tile->setTileData(nullptr);
         m_tileCache->put(_tileSet.source->id(), entry.tile);
     }
 
@@ -564,7 +838,115 @@ void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::ite
     _tileIt = _tileSet.tiles.erase(_tileIt);
 }
 
-bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
+void TileManager::updatePrefetchTiles(TileSet& _tileSet) {
+
+    auto& source = _tileSet.source;
+
+    for (auto it = _tileSet.prefetchTiles.begin(); it != _tileSet.prefetchTiles.end();) {
+        auto& entry = it->second;
+
+        if (entry.isReady() && hasCompleteBudget()) {
+            entry.completeTileTask();
+            m_completedTasks++;
+
+            // Keep the tile in the TileCache until it becomes visible. Skip
+            // it when the tile was loaded in the meantime.
+            if (!m_tileCache->contains(source->id(), it->first) &&
+                _tileSet.tiles.find(it->first) == _tileSet.tiles.end()) {
+
+                entry.pending->setTileData(nullptr);
+                _tileSet.prefetched[it->first] = entry.pending->getMemoryUsage();
+                m_tileCache->put(source->id(), entry.pending);
+            }
+        } else if (entry.isInProgress()) {
+            if (std::binary_search(_tileSet.predictedTiles.begin(), _tileSet.predictedTiles.end(),
+                                   it->first)) {
+                ++it;
+                continue;
+            }
+            // Prediction changed
+            source->cancelLoadingTile(*entry.task);
+            m_prefetchStats.canceled++;
+        }
+
+        it = _tileSet.prefetchTiles.erase(it);
+    }
+
+    // Forget prefetched tiles that were evicted from the cache
+    for (auto it = _tileSet.prefetched.begin(); it != _tileSet.prefetched.end();) {
+        if (!m_tileCache->contains(source->id(), it->first)) {
+            it = _tileSet.prefetched.erase(it);
+        } else {
+            m_prefetchBytes += it->second;
+            ++it;
+        }
+    }
+
+    m_prefetchTasks += _tileSet.prefetchTiles.size();
+}
+
+void TileManager::prefetchTiles(const ViewState& _predictedView) {
+
+    for (auto& tileSet : m_tileSets) {
+        if (!tileSet.source->isActiveForZoom(_predictedView.zoom)) { continue; }
+
+        auto sourceId = tileSet.source->id();
+
+        for (const auto& tileId : tileSet.predictedTiles) {
+            if (tileSet.tiles.find(tileId) != tileSet.tiles.end() ||
+                tileSet.prefetchTiles.find(tileId) != tileSet.prefetchTiles.end() ||
+                tileSet.prefetched.find(tileId) != tileSet.prefetched.end() ||
+                m_tileCache->contains(sourceId, tileId)) {
+                continue;
+            }
+
+            double distance = glm::length2(MapProjection::tileCenter(tileId) - _predictedView.center);
+            m_loadTasks.emplace_back(distance, &tileSet, tileId);
+        }
+    }
+
+    // Start with the tiles closest to the predicted center
+    std::sort(m_loadTasks.begin(), m_loadTasks.end(), [](auto& a, auto& b) {
+            return std::get<0>(a) < std::get<0>(b);
+        });
+
+    for (auto& loadTask : m_loadTasks) {
+        if (m_prefetchTasks >= m_prefetchMaxTiles ||
+            m_prefetchBytes >= m_prefetchMaxBytes) {
+            break;
+        }
+
+        auto& tileSet = *std::get<1>(loadTask);
+        auto& tileId = std::get<2>(loadTask);
+
+        std::shared_ptr<Tile> tile;
+        auto& entry = tileSet.prefetchTiles.emplace(tileId, tile).first->second;
+
+        entry.task = tileSet.source->createTask(tileId);
+        entry.task->setPrefetch(true);
+        entry.task->setPriority(std::get<0>(loadTask));
+
+        loadTileData(tileSet, entry.task);
+
+        m_prefetchTasks++;
+        m_prefetchStats.requested++;
+    }
+
+    m_loadTasks.clear();
+}
+
+void TileManager::clearPrefetchTiles(TileSet& _tileSet) {
+    for (auto& it : _tileSet.prefetchTiles) {
+        auto& entry = it.second;
+        if (entry.isInProgress()) {
+            _tileSet.source->cancelLoadingTile(*entry.task);
+        }
+    }
+    _tileSet.prefetchTiles.clear();
+    _tileSet.prefetched.clear();
+}
+
+bool TileManager::updateProxyTile(TileSet& _tileSet, const TileID& _tileID,
                                   const TileID& _proxyTileId,
                                   const ProxyID _proxyId) {
 
@@ -572,11 +954,14 @@ bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
 
     auto& tiles = _tileSet.tiles;
 
+    // Look up the entry for each proxy, adding a proxy entry may move it
+    auto& tile = tiles.find(_tileID)->second;
+
     // check if the proxy exists in the visible tile set
     {
         const auto& it = tiles.find(_proxyTileId);
         if (it != tiles.end()) {
-            if (_tile.setProxy(_proxyId)) {
+            if (tile.setProxy(_proxyId)) {
                 auto& entry = it->second;
                 entry.incProxyCounter();
 
@@ -593,8 +978,12 @@ bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
 
     // check if the proxy exists in the cache
     {
+        // Prefetched tiles which are not uploaded yet are not used as proxy
+        auto cached = m_tileCache->contains(_tileSet.source->id(), _proxyTileId);
+        if (!cached || !cached->isUploaded()) { return false; }
+
         auto proxyTile = m_tileCache->get(_tileSet.source->id(), _proxyTileId);
-        if (proxyTile && _tile.setProxy(_proxyId)) {
+        if (proxyTile && tile.setProxy(_proxyId)) {
 
             auto result = tiles.emplace(_proxyTileId, proxyTile);
             auto& entry = result.first->second;
@@ -608,7 +997,7 @@ bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
     return false;
 }
 
-void TileManager::updateProxyTiles(TileSet& _tileSet, const TileID& _tileID, TileEntry& _tile) {
+void TileManager::updateProxyTiles(TileSet& _tileSet, const TileID& _tileID) {
     // TODO: this should be improved to use the nearest proxy tile available.
     // Currently it would use parent or grand*parent  as proxies even if the
     // child proxies would be more appropriate
@@ -619,20 +1008,20 @@ void TileManager::updateProxyTiles(TileSet& _tileSet, const TileID& _tileID, Til
     auto parentID = _tileID.getParent(zoomBias);
     auto minZoom = _tileSet.source->minDisplayZoom();
     if (minZoom <= parentID.z
-            && updateProxyTile(_tileSet, _tile, parentID, ProxyID::parent)) {
+            && updateProxyTile(_tileSet, _tileID, parentID, ProxyID::parent)) {
         return;
     }
     // Try grandparent
     auto grandparentID = parentID.getParent(zoomBias);
     if (minZoom <= grandparentID.z
-            && updateProxyTile(_tileSet, _tile, grandparentID, ProxyID::parent2)) {
+            && updateProxyTile(_tileSet, _tileID, grandparentID, ProxyID::parent2)) {
         return;
     }
     // Try children
     if (maxZoom > _tileID.z) {
         for (int i = 0; i < 4; i++) {
             auto childID = _tileID.getChild(i, maxZoom);
-            updateProxyTile(_tileSet, _tile, childID, static_cast<ProxyID>(1 << i));
+            updateProxyTile(_tileSet, _tileID, childID, static_cast<ProxyID>(1 << i));
         }
     }
 }
@@ -678,4 +1067,14 @@ void TileManager::setCacheSize(size_t _cacheSize) {
     m_tileCache->limitCacheSize(_cacheSize);
 }
 
+void TileManager::setPrefetchBudget(size_t _maxTiles, size_t _maxBytes) {
+    m_prefetchMaxTiles = _maxTiles;
+    m_prefetchMaxBytes = _maxBytes;
+}
+
+void TileManager::setFrameBudget(float _completeTime, size_t _uploadBytes) {
+    m_completeMaxTime = _completeTime;
+    m_uploadMaxBytes = _uploadBytes;
+}
+
 }
@@ -4,23 +4,27 @@
 #include "data/tileSource.h"
 #include "tile/tile.h"
 #include "tile/tileID.h"
+#include "tile/tileIDMap.h"
 #include "tile/tileTask.h"
 #include "tile/tileWorker.h"
 
-#include <map>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <tuple>
-#include <set>
 #include <vector>
 
 class Platform;
 
 namespace Tangram {
 
+class GeometryCache;
+class RenderState;
+class Style;
 class TileSource;
 class TileCache;
 class View;
+struct SceneDiff;
 struct ViewState;
 
 /* Singleton container of <TileSet>s
@@ -32,8 +36,25 @@ class TileManager {
 
     const static size_t DEFAULT_CACHE_SIZE = 32*1024*1024; // 32 MB
 
+    const static size_t DEFAULT_PREFETCH_TILES = 16;
+    const static size_t DEFAULT_PREFETCH_SIZE = 8*1024*1024; // 8 MB
+
+    constexpr static float DEFAULT_COMPLETE_TIME = 4.f; // ms
+    const static size_t DEFAULT_UPLOAD_SIZE = 4*1024*1024; // 4 MB
+
 public:
 
+    struct PrefetchStats {
+        // Prefetch tasks started
+        uint64_t requested = 0;
+        // Prefetch tasks canceled because the prediction changed
+        uint64_t canceled = 0;
+        // Prefetched tiles (loaded or still loading) that became visible
+        uint64_t hits = 0;
+
+        float hitRate() const { return requested > 0 ? float(hits) / requested : 0.f; }
+    };
+
     TileManager(std::shared_ptr<Platform> platform, TileTaskQueue& _tileWorker);
 
     virtual ~TileManager();
@@ -41,13 +62,24 @@ public:
     /* Sets the tile TileSources */
     void setTileSources(const std::vector<std::shared_ptr<TileSource>>& _sources);
 
-    /* Updates visible tile set and load missing tiles */
-    void updateTileSets(const View& _view);
+    /* Updates visible tile set and load missing tiles. When @_predictedView
+     * is given, tiles of the predicted view are prefetched with lower priority.
+     */
+    void updateTileSets(const View& _view, const View* _predictedView = nullptr);
 
     void clearTileSets(bool clearSourceCaches = false);
 
     void clearTileSet(int32_t _sourceId);
 
+    /* Rebuild the styles marked in @_diff for all tiles in the current tile
+     * sets, keeping their TileData and the meshes of other styles. Tiles stay
+     * visible until rebuilt. Cached tiles, which have no TileData, are loaded
+     * again when they are used and drawn until then. Kept label meshes are
+     * drawn with @_styles, the Styles of the new Scene. TileWorker must already
+     * use the new Scene.
+     */
+    void rebuildStyles(const SceneDiff& _diff, const std::vector<std::unique_ptr<Style>>& _styles);
+
     /* Returns the set of currently visible tiles */
     const auto& getVisibleTiles() const { return m_tiles; }
 
@@ -57,6 +89,22 @@ public:
         return m_tilesInProgress > 0;
     }
 
+    /* Returns true when ready tiles wait for the next frame to be completed
+     * or uploaded */
+    bool hasDeferredTiles() const {
+        return m_deferredTasks > 0 || !m_uploadTiles.empty();
+    }
+
+    /* Upload the meshes of completed tiles, closest to the view center first,
+     * until the upload budget of the frame is used. Tiles replace their
+     * proxies on the next update after they were uploaded.
+     * Returns the number of uploaded bytes */
+    size_t uploadTiles(RenderState& _rs);
+
+    size_t deferredTasks() const { return m_deferredTasks; }
+
+    size_t pendingUploads() const { return m_uploadTiles.size(); }
+
     std::shared_ptr<TileSource> getClientTileSource(int32_t sourceID);
 
     void addClientTileSource(std::shared_ptr<TileSource> _source);
@@ -65,11 +113,28 @@ public:
 
     std::unique_ptr<TileCache>& getTileCache() { return m_tileCache; }
 
+    /* Tiles cached completely in @_cache are restored by the TileWorker
+     * without loading their data */
+    void setGeometryCache(std::shared_ptr<GeometryCache> _cache) { m_geometryCache = std::move(_cache); }
+
     /* @_cacheSize: Set size of in-memory tile cache in bytes.
      * This cache holds recently used <Tile>s that are ready for rendering.
      */
     void setCacheSize(size_t _cacheSize);
 
+    /* @_maxTiles: Maximum number of prefetch tasks in progress
+     * @_maxBytes: Maximum size of prefetched tiles which did not become visible yet
+     */
+    void setPrefetchBudget(size_t _maxTiles, size_t _maxBytes);
+
+    /* @_completeTime: Time in milliseconds per update to complete ready tile tasks
+     * @_uploadBytes: Mesh bytes per frame to upload for completed tiles
+     * Remaining tiles are deferred to the next frames. 0 disables the limit.
+     */
+    void setFrameBudget(float _completeTime, size_t _uploadBytes);
+
+    const PrefetchStats& prefetchStats() const { return m_prefetchStats; }
+
 protected:
 
     enum class ProxyID : uint8_t;
@@ -77,12 +142,22 @@ protected:
 
     struct TileSet {
         TileSet(std::shared_ptr<TileSource> _source, bool _clientSource);
+        TileSet(TileSet&& _other);
+        TileSet& operator=(TileSet&& _other);
         ~TileSet();
 
         std::shared_ptr<TileSource> source;
 
-        std::set<TileID> visibleTiles;
-        std::map<TileID, TileEntry> tiles;
+        // Sorted and unique
+        std::vector<TileID> visibleTiles;
+        TileIDMap<TileEntry> tiles;
+
+        // Sorted and unique
+        std::vector<TileID> predictedTiles;
+        // Tiles loading for the predicted view
+        TileIDMap<TileEntry> prefetchTiles;
+        // Prefetched tiles moved to the TileCache and their size
+        TileIDMap<size_t> prefetched;
 
         int64_t sourceGeneration = 0;
         bool clientTileSource;
@@ -90,28 +165,51 @@ protected:
 
     void updateTileSet(TileSet& tileSet, const ViewState& _view);
 
+    /* Complete ready tasks of all tile sets by priority within the time budget */
+    void completeTileTasks();
+
+    bool hasCompleteBudget();
+
     void enqueueTask(TileSet& _tileSet, const TileID& _tileID, const ViewState& _view);
 
+    /* Creates and enqueues a task to load a stale tile of @_entry again.
+     * Returns true when a task was created */
+    bool reloadStaleTile(TileSet& _tileSet, const TileID& _tileID, TileEntry& _entry,
+                         const ViewState& _view);
+
     void loadTiles();
 
+    /* Load the data of @_task, or restore its tile from the GeometryCache */
+    void loadTileData(TileSet& _tileSet, std::shared_ptr<TileTask>& _task);
+
+    /* Move prefetched tiles to the TileCache and cancel prefetch tasks
+     * of tiles that are not predicted anymore */
+    void updatePrefetchTiles(TileSet& _tileSet);
+
+    /* Start prefetch tasks for predicted tiles within the prefetch budget */
+    void prefetchTiles(const ViewState& _predictedView);
+
+    void clearPrefetchTiles(TileSet& _tileSet);
+
     /*
      * Constructs a future (async) to load data of a new visible tile this is
      *      also responsible for loading proxy tiles for the newly visible tiles
      * @_tileID: TileID for which new Tile needs to be constructed
+     * Returns the new TileEntry
      */
-    bool addTile(TileSet& _tileSet, const TileID& _tileID);
+    TileEntry& addTile(TileSet& _tileSet, const TileID& _tileID);
 
     /*
      * Removes a tile from m_tileSet
      */
-    void removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::iterator& _tileIter);
+    void removeTile(TileSet& _tileSet, TileIDMap<TileEntry>::iterator& _tileIter);
 
     /*
      * Checks and updates m_tileSet with proxy tiles for every new visible tile
-     *  @_tile: Tile, the new visible tile for which proxies needs to be added
+     *  @_tileID: TileID of the new visible tile for which proxies needs to be added
      */
-    bool updateProxyTile(TileSet& _tileSet, TileEntry& _tile, const TileID& _proxy, const ProxyID _proxyID);
-    void updateProxyTiles(TileSet& _tileSet, const TileID& _tileID, TileEntry& _tile);
+    bool updateProxyTile(TileSet& _tileSet, const TileID& _tileID, const TileID& _proxy, const ProxyID _proxyID);
+    void updateProxyTiles(TileSet& _tileSet, const TileID& _tileID);
 
     /*
      * Once a visible tile finishes loading and is added to m_tileSet, all
@@ -128,6 +226,8 @@ protected:
 
     std::unique_ptr<TileCache> m_tileCache;
 
+    std::shared_ptr<GeometryCache> m_geometryCache;
+
     TileTaskQueue& m_workers;
 
     bool m_tileSetChanged = false;
@@ -140,6 +240,27 @@ protected:
     /* Temporary list of tiles that need to be loaded */
     std::vector<std::tuple<double, TileSet*, TileID>> m_loadTasks;
 
+    size_t m_prefetchMaxTiles = DEFAULT_PREFETCH_TILES;
+    size_t m_prefetchMaxBytes = DEFAULT_PREFETCH_SIZE;
+
+    /* Prefetch tasks and size of unused prefetched tiles of the current update */
+    size_t m_prefetchTasks = 0;
+    size_t m_prefetchBytes = 0;
+
+    PrefetchStats m_prefetchStats;
+
+    float m_completeMaxTime = DEFAULT_COMPLETE_TIME;
+    size_t m_uploadMaxBytes = DEFAULT_UPLOAD_SIZE;
+
+    std::chrono::steady_clock::time_point m_completeStart;
+
+    /* Tasks completed and ready tasks deferred in the current update */
+    size_t m_completedTasks = 0;
+    size_t m_deferredTasks = 0;
+
+    /* Completed tiles waiting for upload and their priority */
+    std::vector<std::pair<double, std::shared_ptr<Tile>>> m_uploadTiles;
+
 };
 
 }
@@ -1,14 +1,18 @@
 #include "tile/tileTask.h"
 
+#include "data/tileData.h"
 #include "data/tileSource.h"
 #include "scene/scene.h"
 #include "tile/tile.h"
 #include "tile/tileBuilder.h"
+#include "tile/tileTaskHeap.h"
 #include "util/mapProjection.h"
 
+#include <algorithm>
+
 namespace Tangram {
 
-TileTask::TileTask(TileID& _tileId, std::shared_ptr<TileSource> _source, int _subTask) :
+TileTask::TileTask(const TileID& _tileId, std::shared_ptr<TileSource> _source, int _subTask) :
     m_tileId(_tileId),
     m_subTaskId(_subTask),
     m_source(_source),
@@ -18,10 +22,26 @@ TileTask::TileTask(TileID& _tileId, std::shared_ptr<TileSource> _source, int _su
     m_canceled(false),
     m_needsLoading(true),
     m_priority(0),
-    m_proxyState(false) {}
+    m_proxyState(false),
+    m_prefetch(false),
+    m_heap(nullptr) {}
 
 TileTask::~TileTask() {}
 
+void TileTask::cancel() {
+    m_canceled = true;
+
+    if (auto* heap = m_heap.load()) {
+        heap->remove(*this);
+    }
+}
+
+void TileTask::updateQueuePosition() {
+    if (auto* heap = m_heap.load()) {
+        heap->update(*this);
+    }
+}
+
 std::unique_ptr<Tile> TileTask::getTile() {
     return std::move(m_tile);
 }
@@ -31,18 +51,50 @@ void TileTask::setTile(std::unique_ptr<Tile>&& _tile) {
     m_ready = true;
 }
 
+void TileTask::parse() {
+
+    auto source = m_source.lock();
+    if (!source) { return; }
+
+    m_tileData = source->parseTileData(*this);
+    m_parsed = true;
+
+    if (!m_tileData) {
+        cancel();
+    }
+}
+
 void TileTask::process(TileBuilder& _tileBuilder) {
 
+    if (!m_parsed) { parse(); }
+
     auto source = m_source.lock();
     if (!source) { return; }
 
-    auto tileData = source->parse(*this);
+    if (m_cachedGeometry) {
+        m_tile = _tileBuilder.restore(m_tileId, *source);
+        if (m_tile) {
+            m_ready = true;
+            return;
+        }
+
+        // Removed from the cache meanwhile: TileManager loads the tile data
+        m_cachedGeometry = false;
+        m_parsed = false;
+        m_needsLoading = true;
+        return;
+    }
+
+    if (m_tileData) {
+        m_tile = _tileBuilder.build(m_tileId, *m_tileData, *source, nullptr, this);
+
+        // Canceled while building
+        if (!m_tile) { return; }
 
-    if (tileData) {
-        m_tile = _tileBuilder.build(m_tileId, *tileData, *source);
         m_ready = true;
-    } else {
-        cancel();
+
+        // Keep TileData with the tile to rebuild single styles on scene updates
+        m_tile->setTileData(std::move(m_tileData));
     }
 }
 
@@ -55,4 +107,43 @@ void TileTask::complete() {
 
 }
 
+RestyleTileTask::RestyleTileTask(std::shared_ptr<Tile> _tile, std::shared_ptr<TileSource> _source,
+                                 std::shared_ptr<const std::vector<bool>> _styles)
+    : TileTask(_tile->getID(), _source, -1),
+      m_baseTile(_tile),
+      m_styles(_styles) {
+
+    m_tileData = _tile->tileData();
+    m_parsed = true;
+    m_needsLoading = false;
+}
+
+void RestyleTileTask::process(TileBuilder& _tileBuilder) {
+
+    auto source = m_source.lock();
+    if (!source || !m_tileData) { return; }
+
+    m_tile = _tileBuilder.build(m_tileId, *m_tileData, *source, m_styles.get(), this);
+
+    // Canceled while building
+    if (!m_tile) { return; }
+
+    // Rebuilding from scratch would cost as much as the base tile
+    m_tile->setBuildTime(std::max(m_tile->buildTime(), m_baseTile->buildTime()));
+
+    m_tile->setTileData(std::move(m_tileData));
+    m_ready = true;
+}
+
+void RestyleTileTask::complete() {
+
+    TileTask::complete();
+
+    // The base tile is drawn with all its meshes until the new tile is uploaded
+    if (m_tile) {
+        m_tile->setBaseTile(std::move(m_baseTile), m_styles);
+    }
+    m_baseTile.reset();
+}
+
 }
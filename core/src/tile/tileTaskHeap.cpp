@@ -0,0 +1,163 @@
+#include "tile/tileTaskHeap.h"
+
+#include "tile/tileTask.h"
+
+namespace Tangram {
+
+TileTaskHeap::~TileTaskHeap() {
+    clear();
+}
+
+bool TileTaskHeap::higherPriority(const Entry& _a, const Entry& _b) {
+    if (_a.prefetch != _b.prefetch) {
+        return !_a.prefetch;
+    }
+    if (_a.proxy != _b.proxy) {
+        return !_a.proxy;
+    }
+    if (_a.sourceId == _b.sourceId &&
+        _a.sourceGeneration != _b.sourceGeneration) {
+        return _a.sourceGeneration < _b.sourceGeneration;
+    }
+    return _a.priority < _b.priority;
+}
+
+void TileTaskHeap::readKey(Entry& _entry) {
+    auto& task = *_entry.task;
+    _entry.prefetch = task.isPrefetch();
+    _entry.proxy = task.isProxy();
+    _entry.sourceId = task.sourceId();
+    _entry.sourceGeneration = task.sourceGeneration();
+    _entry.priority = task.getPriority();
+}
+
+bool TileTaskHeap::contains(const TileTask& _task) const {
+    // m_heap is only set to 'this' and reset while holding m_mutex, so the
+    // task index is valid as long as the task points to this heap.
+    return _task.m_heap.load() == this;
+}
+
+void TileTaskHeap::place(size_t _index, Entry&& _entry) {
+    m_entries[_index] = std::move(_entry);
+    m_entries[_index].task->m_heapIndex = _index;
+}
+
+void TileTaskHeap::siftUp(size_t _index) {
+    Entry entry = std::move(m_entries[_index]);
+
+    while (_index > 0) {
+        size_t parent = (_index - 1) / 2;
+        if (!higherPriority(entry, m_entries[parent])) { break; }
+
+        place(_index, std::move(m_entries[parent]));
+        _index = parent;
+    }
+    place(_index, std::move(entry));
+}
+
+void TileTaskHeap::siftDown(size_t _index) {
+    size_t size = m_entries.size();
+    Entry entry = std::move(m_entries[_index]);
+
+    while (true) {
+        size_t child = 2 * _index + 1;
+        if (child >= size) { break; }
+
+        if (child + 1 < size && higherPriority(m_entries[child + 1], m_entries[child])) {
+            child++;
+        }
+        if (!higherPriority(m_entries[child], entry)) { break; }
+
+        place(_index, std::move(m_entries[child]));
+        _index = child;
+    }
+    place(_index, std::move(entry));
+}
+
+void TileTaskHeap::removeAt(size_t _index) {
+    m_entries[_index].task->m_heap = nullptr;
+
+    size_t last = m_entries.size() - 1;
+    if (_index != last) {
+        place(_index, std::move(m_entries[last]));
+    }
+    m_entries.pop_back();
+
+    if (_index < m_entries.size()) {
+        // Restore heap order for the entry moved into the free slot
+        auto* moved = m_entries[_index].task.get();
+        siftUp(_index);
+        siftDown(moved->m_heapIndex);
+    }
+    m_size = m_entries.size();
+}
+
+void TileTaskHeap::push(std::shared_ptr<TileTask> _task) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    TileTaskHeap* queued = nullptr;
+    if (!_task->m_heap.compare_exchange_strong(queued, this)) {
+        // Task is already waiting in a queue
+        return;
+    }
+
+    Entry entry;
+    entry.task = std::move(_task);
+    readKey(entry);
+
+    m_entries.emplace_back();
+    place(m_entries.size() - 1, std::move(entry));
+    siftUp(m_entries.size() - 1);
+
+    m_size = m_entries.size();
+}
+
+std::shared_ptr<TileTask> TileTaskHeap::pop() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_entries.empty()) { return nullptr; }
+
+    auto task = m_entries.front().task;
+    removeAt(0);
+
+    return task;
+}
+
+void TileTaskHeap::update(TileTask& _task) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!contains(_task)) { return; }
+
+    size_t index = _task.m_heapIndex;
+    readKey(m_entries[index]);
+
+    siftUp(index);
+    siftDown(_task.m_heapIndex);
+}
+
+void TileTaskHeap::remove(TileTask& _task) {
+    std::shared_ptr<TileTask> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!contains(_task)) { return; }
+
+        // Keep a reference until the lock is released
+        removed = m_entries[_task.m_heapIndex].task;
+        removeAt(_task.m_heapIndex);
+    }
+
+    if (m_removeCallback) { m_removeCallback(); }
+}
+
+void TileTaskHeap::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& entry : m_entries) {
+        entry.task->m_heap = nullptr;
+    }
+    m_entries.clear();
+    m_size = 0;
+}
+
+}
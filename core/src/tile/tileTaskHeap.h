@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Tangram {
+
+class TileTask;
+
+/* Indexed binary heap of TileTasks ordered by load priority.
+ *
+ * Every queued TileTask keeps a reference to its slot in the heap. This way
+ * TileTask::setPriority() and TileTask::setProxyState() can restore the heap
+ * order in place and TileTask::cancel() can drop the task right away, instead
+ * of scanning the whole queue on every dequeue.
+ *
+ * All methods are thread-safe.
+ */
+class TileTaskHeap {
+
+public:
+
+    TileTaskHeap() = default;
+
+    ~TileTaskHeap();
+
+    /* Add @_task to the heap. Does nothing when the task is already queued */
+    void push(std::shared_ptr<TileTask> _task);
+
+    /* Remove and return the highest priority task or nullptr if the heap is empty */
+    std::shared_ptr<TileTask> pop();
+
+    /* Reorder @_task after its priority, proxy or prefetch state changed */
+    void update(TileTask& _task);
+
+    /* Remove @_task from the heap */
+    void remove(TileTask& _task);
+
+    /* Set a function that is called after remove() took a task from the heap. Must be set
+     * before the heap is used. */
+    void setRemoveCallback(std::function<void()> _callback) { m_removeCallback = _callback; }
+
+    /* Remove all tasks */
+    void clear();
+
+    size_t size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+private:
+
+    struct Entry {
+        std::shared_ptr<TileTask> task;
+
+        // Snapshot of the ordering key: Priority and proxy state are updated
+        // concurrently by the main thread, the heap invariant must only depend
+        // on values that change under m_mutex.
+        bool prefetch;
+        bool proxy;
+        int64_t sourceId;
+        int64_t sourceGeneration;
+        float priority;
+    };
+
+    static bool higherPriority(const Entry& _a, const Entry& _b);
+
+    static void readKey(Entry& _entry);
+
+    bool contains(const TileTask& _task) const;
+
+    void place(size_t _index, Entry&& _entry);
+
+    void siftUp(size_t _index);
+
+    void siftDown(size_t _index);
+
+    void removeAt(size_t _index);
+
+    std::mutex m_mutex;
+
+    std::vector<Entry> m_entries;
+
+    std::atomic<size_t> m_size{0};
+
+    std::function<void()> m_removeCallback;
+};
+
+}
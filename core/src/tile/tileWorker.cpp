@@ -4,23 +4,43 @@
 #include "log.h"
 #include "map.h"
 #include "platform.h"
+#include "tile/geometryCache.h"
 #include "tile/tileBuilder.h"
 #include "tile/tileID.h"
 #include "tile/tileTask.h"
 
-#include <algorithm>
+#include <chrono>
 
 #define WORKER_NICENESS 10
 
 namespace Tangram {
 
-TileWorker::TileWorker(std::shared_ptr<Platform> _platform, int _numWorker) : m_platform(_platform) {
+using Clock = std::chrono::steady_clock;
+
+static uint64_t elapsedMicros(Clock::time_point _start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - _start).count();
+}
+
+TileWorker::TileWorker(std::shared_ptr<Platform> _platform, int _numWorker,
+                       int _numParseWorker, size_t _maxBuildQueue)
+    : m_numParseWorker(_numParseWorker), m_maxBuildQueue(_maxBuildQueue), m_platform(_platform) {
     m_running = true;
 
+    // Wake up parsers waiting for room in the build queue when a task was canceled
+    m_buildQueue.setRemoveCallback([this]() {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+        }
+        m_parseCondition.notify_one();
+    });
+
     for (int i = 0; i < _numWorker; i++) {
-        auto worker = std::make_unique<Worker>();
-        worker->thread = std::thread(&TileWorker::run, this, worker.get());
-        m_workers.push_back(std::move(worker));
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->thread = std::thread(&TileWorker::run, this, m_workers.back().get());
+    }
+
+    for (int i = 0; i < _numParseWorker; i++) {
+        m_parsers.emplace_back(&TileWorker::runParser, this, i);
     }
 }
 
@@ -30,6 +50,54 @@ TileWorker::~TileWorker(){
     }
 }
 
+void TileWorker::runParser(int _index) {
+
+    setCurrentThreadPriority(WORKER_NICENESS);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            // Wait for tasks to parse and for the builders to catch up.
+            // Builders and canceled tasks notify when they leave the build queue.
+            m_parseCondition.wait(lock, [&, this]{
+                    return !m_running || _index >= m_numParseWorker ||
+                        (!m_parseQueue.empty() && buildQueueSize() < m_maxBuildQueue);
+                });
+
+            // Check if thread should stop
+            if (!m_running || _index >= m_numParseWorker) {
+                break;
+            }
+        }
+
+        auto task = m_parseQueue.pop();
+
+        if (!task || task->isCanceled()) {
+            continue;
+        }
+
+        auto start = Clock::now();
+        task->parse();
+        auto elapsed = elapsedMicros(start);
+        task->setParseTime(elapsed);
+        m_parseTime += elapsed;
+        m_parseCount++;
+
+        if (task->isCanceled()) {
+            continue;
+        }
+
+        if (task->isReady()) {
+            // Nothing to build, e.g. raster sub-tasks
+            m_platform->requestRender();
+            continue;
+        }
+
+        enqueueBuild(std::move(task));
+    }
+}
+
 void TileWorker::run(Worker* instance) {
 
     setCurrentThreadPriority(WORKER_NICENESS);
@@ -37,13 +105,12 @@ void TileWorker::run(Worker* instance) {
     std::unique_ptr<TileBuilder> builder;
 
     while (true) {
-
-        std::shared_ptr<TileTask> task;
         {
             std::unique_lock<std::mutex> lock(m_mutex);
 
+            // Tasks wait in the queue until setScene() passed a TileBuilder
             m_condition.wait(lock, [&, this]{
-                    return !m_running || !m_queue.empty();
+                    return !m_running || ((builder || instance->tileBuilder) && buildQueueSize() > 0);
                 });
 
             if (instance->tileBuilder) {
@@ -59,61 +126,169 @@ void TileWorker::run(Worker* instance) {
             if (!builder) {
                 continue;
             }
+        }
 
-            // Remove all canceled tasks
-            auto removes = std::remove_if(m_queue.begin(), m_queue.end(),
-                                          [](const auto& a) { return a->isCanceled(); });
+        // Canceled tasks are removed from the queue by TileTask::cancel()
+        auto task = m_buildQueue.pop();
 
-            m_queue.erase(removes, m_queue.end());
+        if (!task) {
+            continue;
+        }
 
-            if (m_queue.empty()) {
-                continue;
+        // Check again for a new TileBuilder so that tasks enqueued after
+        // setScene() are always built with the new Scene
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (instance->tileBuilder) {
+                builder = std::move(instance->tileBuilder);
+                LOG("Passed new TileBuilder to TileWorker");
             }
-
-            // Pop highest priority tile from queue
-            auto it = std::min_element(m_queue.begin(), m_queue.end(),
-                [](const auto& a, const auto& b) {
-                    if (a->isProxy() != b->isProxy()) {
-                        return !a->isProxy();
-                    }
-                    if (a->sourceId() == b->sourceId() &&
-                        a->sourceGeneration() != b->sourceGeneration()) {
-                        return a->sourceGeneration() < b->sourceGeneration();
-                    }
-                    return a->getPriority() < b->getPriority();
-                });
-
-            task = std::move(*it);
-            m_queue.erase(it);
         }
 
+        // Make room in the hand-off queue
+        m_parseCondition.notify_one();
+
         if (task->isCanceled()) {
             continue;
         }
 
+        if (!task->isParsed()) {
+            auto start = Clock::now();
+            task->parse();
+            auto elapsed = elapsedMicros(start);
+            task->setParseTime(elapsed);
+            m_parseTime += elapsed;
+            m_parseCount++;
+        }
+
+        auto canceledBuilds = builder->canceledBuilds();
+
+        auto start = Clock::now();
         task->process(*builder);
+        auto elapsed = elapsedMicros(start);
+
+        if (builder->canceledBuilds() != canceledBuilds) {
+            // Estimate the remaining build time from the processed
+            // fraction of features or the average build time
+            float progress = builder->buildProgress();
+            uint64_t saved = 0;
+            if (progress > 0.f) {
+                saved = elapsed * (1.f - progress) / progress;
+            } else if (m_buildCount > 0) {
+                saved = m_buildTime / m_buildCount;
+            }
+            m_cancelTimeSaved += saved;
+            m_cancelCount++;
+            continue;
+        }
+
+        m_buildTime += elapsed;
+        m_buildCount++;
 
         m_platform->requestRender();
     }
 }
 
 void TileWorker::setScene(std::shared_ptr<Scene>& _scene) {
-    for (auto& worker : m_workers) {
-        worker->tileBuilder = std::make_unique<TileBuilder>(_scene);
+    uint64_t sceneHash = 0;
+    if (m_geometryCache) {
+        sceneHash = GeometryCache::sceneHash(*_scene);
+        // Tiles are looked up for the new Scene from now on
+        m_geometryCache->setSceneHash(sceneHash);
+    }
+
+    std::vector<std::unique_ptr<TileBuilder>> builders;
+    for (size_t i = 0; i < m_workers.size(); i++) {
+        builders.push_back(std::make_unique<TileBuilder>(_scene));
+        builders.back()->setGeometryCache(m_geometryCache, sceneHash);
     }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < m_workers.size(); i++) {
+            m_workers[i]->tileBuilder = std::move(builders[i]);
+        }
+    }
+    m_condition.notify_all();
 }
 
 void TileWorker::enqueue(std::shared_ptr<TileTask> task) {
     {
         std::unique_lock<std::mutex> lock(m_mutex);
-        if (!m_running) {
+        if (!m_running || m_workers.empty()) {
             return;
         }
-        m_queue.push_back(std::move(task));
+
+        // Push under the lock so that setParseWorkers() can pass the
+        // queued tasks on when the last parser stops
+        if (m_numParseWorker > 0 && !task->isParsed()) {
+            m_parseQueue.push(std::move(task));
+        }
+    }
+
+    if (task) {
+        enqueueBuild(std::move(task));
+        return;
+    }
+
+    m_parseCondition.notify_one();
+}
+
+void TileWorker::setParseWorkers(int _numParseWorker) {
+    std::vector<std::thread> stopped;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_running) { return; }
+
+        m_numParseWorker = _numParseWorker;
+        while (int(m_parsers.size()) > m_numParseWorker) {
+            stopped.push_back(std::move(m_parsers.back()));
+            m_parsers.pop_back();
+        }
+        while (int(m_parsers.size()) < m_numParseWorker) {
+            m_parsers.emplace_back(&TileWorker::runParser, this, int(m_parsers.size()));
+        }
+    }
+
+    m_parseCondition.notify_all();
+
+    for (auto& parser : stopped) {
+        parser.join();
+    }
+
+    if (_numParseWorker == 0) {
+        // Parse the remaining tasks on the build threads
+        while (auto task = m_parseQueue.pop()) {
+            enqueueBuild(std::move(task));
+        }
+    }
+}
+
+void TileWorker::enqueueBuild(std::shared_ptr<TileTask> _task) {
+
+    m_buildQueue.push(std::move(_task));
+
+    // Synchronize with workers that are about to wait on m_condition,
+    // otherwise the notification could get lost.
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
     }
     m_condition.notify_one();
 }
 
+TileWorker::Stats TileWorker::stats() const {
+    Stats stats;
+    stats.parseQueue = m_parseQueue.size();
+    stats.buildQueue = buildQueueSize();
+    stats.parsed = m_parseCount;
+    stats.built = m_buildCount;
+    if (stats.parsed > 0) { stats.parseTime = m_parseTime / 1000.f / stats.parsed; }
+    if (stats.built > 0) { stats.buildTime = m_buildTime / 1000.f / stats.built; }
+    stats.canceled = m_cancelCount;
+    stats.canceledTimeSaved = m_cancelTimeSaved / 1000.f;
+    return stats;
+}
+
 void TileWorker::stop() {
     {
         std::unique_lock<std::mutex> lock(m_mutex);
@@ -121,12 +296,18 @@ void TileWorker::stop() {
     }
 
     m_condition.notify_all();
+    m_parseCondition.notify_all();
+
+    for (auto& parser : m_parsers) {
+        parser.join();
+    }
 
     for (auto& worker : m_workers) {
         worker->thread.join();
     }
 
-    m_queue.clear();
+    m_parseQueue.clear();
+    m_buildQueue.clear();
 }
 
 }
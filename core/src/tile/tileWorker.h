@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tile/tileTask.h"
+#include "tile/tileTaskHeap.h"
 #include "util/jobQueue.h"
 
 #include <atomic>
@@ -12,16 +13,44 @@
 
 namespace Tangram {
 
+class GeometryCache;
 class JobQueue;
 class Platform;
 class Scene;
 class TileBuilder;
 
+/* TileWorker processes TileTasks in two stages:
+ *
+ * Parse threads decode the raw tile data into TileData. Parsed tasks are
+ * handed over to the build threads which own a TileBuilder to create the
+ * tile geometry. The hand-off queue is bounded so that parse threads do not
+ * run ahead of the builders with a growing number of decoded tiles.
+ *
+ * When no parse threads are configured tasks are parsed on the build threads.
+ */
 class TileWorker : public TileTaskQueue {
 
 public:
 
-    TileWorker(std::shared_ptr<Platform> _platform, int _numWorker);
+    struct Stats {
+        // Tasks waiting to be parsed
+        size_t parseQueue = 0;
+        // Parsed tasks waiting for a TileBuilder
+        size_t buildQueue = 0;
+        // Number of processed tasks per stage
+        uint64_t parsed = 0;
+        uint64_t built = 0;
+        // Average processing time per task in milliseconds
+        float parseTime = 0;
+        float buildTime = 0;
+        // Builds stopped because their task was canceled and the estimated
+        // build time saved by stopping early, in milliseconds
+        uint64_t canceled = 0;
+        float canceledTimeSaved = 0;
+    };
+
+    TileWorker(std::shared_ptr<Platform> _platform, int _numWorker,
+               int _numParseWorker = 0, size_t _maxBuildQueue = 16);
 
     ~TileWorker();
 
@@ -33,6 +62,14 @@ public:
 
     void setScene(std::shared_ptr<Scene>& _scene);
 
+    /* Set the number of parse threads. With no parse threads tasks are parsed on the build threads */
+    void setParseWorkers(int _numParseWorker);
+
+    /* Persistent cache for built tiles, used by the TileBuilders of the next setScene() */
+    void setGeometryCache(std::shared_ptr<GeometryCache> _cache) { m_geometryCache = _cache; }
+
+    Stats stats() const;
+
 private:
 
     struct Worker {
@@ -42,16 +79,47 @@ private:
 
     void run(Worker* instance);
 
+    void runParser(int _index);
+
+    // Pass a parsed task on to the build workers
+    void enqueueBuild(std::shared_ptr<TileTask> _task);
+
+    size_t buildQueueSize() const { return m_buildQueue.size(); }
+
     bool m_running;
 
     std::vector<std::unique_ptr<Worker>> m_workers;
 
+    std::vector<std::thread> m_parsers;
+
+    // Number of parse threads that should run, parsers with a higher index stop
+    int m_numParseWorker;
+
+    TileTaskHeap m_parseQueue;
+
+    // Parsed tasks, shared by all build workers so that they are built in
+    // the global load order
+    TileTaskHeap m_buildQueue;
+
+    size_t m_maxBuildQueue;
+
     std::condition_variable m_condition;
 
+    std::condition_variable m_parseCondition;
+
     std::mutex m_mutex;
-    std::vector<std::shared_ptr<TileTask>> m_queue;
+
+    // Stage statistics: number of tasks and accumulated time in microseconds
+    std::atomic<uint64_t> m_parseCount{0};
+    std::atomic<uint64_t> m_parseTime{0};
+    std::atomic<uint64_t> m_buildCount{0};
+    std::atomic<uint64_t> m_buildTime{0};
+    std::atomic<uint64_t> m_cancelCount{0};
+    std::atomic<uint64_t> m_cancelTimeSaved{0};
 
     std::shared_ptr<Platform> m_platform;
+
+    std::shared_ptr<GeometryCache> m_geometryCache;
 };
 
 }
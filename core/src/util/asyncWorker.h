@@ -1,15 +1,23 @@
+#pragma once
+
+#include <algorithm>
 #include <condition_variable>
 #include <deque>
+#include <functional>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace Tangram {
 
 class AsyncWorker {
 public:
 
-    AsyncWorker() {
-        thread = std::thread(&AsyncWorker::run, this);
+    // Tasks are started in the order they were enqueued, by @_numThreads threads
+    explicit AsyncWorker(size_t _numThreads = 1) {
+        for (size_t i = 0; i < std::max(_numThreads, size_t(1)); i++) {
+            m_threads.emplace_back(&AsyncWorker::run, this);
+        }
     }
 
     ~AsyncWorker() {
@@ -18,7 +26,7 @@ public:
             m_running = false;
         }
         m_condition.notify_all();
-        thread.join();
+        for (auto& thread : m_threads) { thread.join(); }
     }
 
     void enqueue(std::function<void()> _task) {
@@ -48,7 +56,7 @@ private:
         }
     }
 
-    std::thread thread;
+    std::vector<std::thread> m_threads;
     bool m_running = true;
     std::condition_variable m_condition;
     std::mutex m_mutex;
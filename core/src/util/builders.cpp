@@ -51,7 +51,7 @@ JoinTypes JoinTypeFromString(const std::string& str) {
     return JoinTypes::miter;
 }
 
-void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx) {
+void Builders::buildPolygon(const PolygonSpan& _polygon, float _height, PolygonBuilder& _ctx) {
 
     glm::vec2 min, max;
     if (_ctx.useTexCoords) {
@@ -70,7 +70,7 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
     _ctx.earcut(_polygon);
 
     size_t sumPoints = 0;
-    for (auto& line : _polygon) {
+    for (auto line : _polygon) {
         sumPoints += line.size();
     }
 
@@ -123,14 +123,14 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
     }
 }
 
-void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
+void Builders::buildPolygonExtrusion(const PolygonSpan& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
 
     auto vertexDataOffset = _ctx.numVertices;
 
     static const glm::vec3 upVector(0.0f, 0.0f, 1.0f);
     glm::vec3 normalVector;
 
-    for (auto& line : _polygon) {
+    for (auto line : _polygon) {
 
         size_t lineSize = line.size();
 
@@ -280,7 +280,7 @@ void addCap(const glm::vec2& _coord, const glm::vec2& _normal, int _numCorners,
     addFan(_coord, nA, nB, nC, uA, uB, uC, _numCorners, _ctx);
 }
 
-void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _startIndex,
+void buildPolyLineSegment(const LineSpan& _line, PolyLineBuilder& _ctx, size_t _startIndex,
                           size_t _endIndex, bool endCap = true) {
 
     float distance = 0; // Cumulative distance along the polyline.
@@ -401,7 +401,7 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
 
 }
 
-void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
+void Builders::buildPolyLine(const LineSpan& _line, PolyLineBuilder& _ctx) {
 
     size_t lineSize = _line.size();
 
@@ -117,21 +117,21 @@ public:
      * @_polygon input coordinates describing the polygon
      * @_ctx output vectors, see <PolygonBuilder>
      */
-    static void buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx);
+    static void buildPolygon(const PolygonSpan& _polygon, float _height, PolygonBuilder& _ctx);
 
     /* Build extruded 'walls' from a polygon
      * @_polygon input coordinates describing the polygon
      * @_minHeight the extrusion will extend from this z coordinate to the z of the polygon points
      * @_ctx output vectors, see <PolygonBuilder>
      */
-    static void buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx);
+    static void buildPolygonExtrusion(const PolygonSpan& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx);
 
     /* Build a tesselated polygon line of fixed width from line coordinates
      * @_line input coordinates describing the line
      * @_options parameters for polyline construction
      * @_ctx output vectors, see <PolyLineBuilder>
      */
-    static void buildPolyLine(const Line& _line, PolyLineBuilder& _ctx);
+    static void buildPolyLine(const LineSpan& _line, PolyLineBuilder& _ctx);
 
     /* Build a tesselated quad centered on _screenOrigin
      * @_screenOrigin the sprite origin in screen space
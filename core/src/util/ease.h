@@ -7,8 +7,12 @@
 
 namespace Tangram {
 
+class View;
+
 using EaseCb = std::function<void (float)>;
 
+using EaseViewCb = std::function<void (float, View&)>;
+
 template<typename T>
 T ease(T _start, T _end, float _t, EaseType _e) {
     float f = _t;
@@ -27,6 +31,9 @@ struct Ease {
     float d;
     EaseCb cb;
 
+    // Optional: Applies the eased camera state at a given time to a View
+    EaseViewCb viewCb;
+
     Ease() : t(0), d(0), cb([](float) {}) {}
     Ease(float _duration, EaseCb _cb) : t(-1), d(_duration), cb(_cb) {}
 
@@ -42,6 +49,15 @@ struct Ease {
         }
     }
 
+    // Apply the camera state @_dt seconds ahead to @_view
+    bool predict(float _dt, View& _view) const {
+        if (!viewCb) { return false; }
+
+        float f = d > 0.f ? std::fmin(1.f, (std::fmax(t, 0.f) + _dt) / d) : 1.f;
+        viewCb(f, _view);
+        return true;
+    }
+
 };
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "glm/glm.hpp"
+#include <iterator>
 #include <vector>
 
 #ifndef PI
@@ -87,7 +88,7 @@ float signedArea(InputIt _begin, InputIt _end) {
 /* Calculate the area centroid of a closed polygon given as a sequence of vectors.
  * If the polygon has no area, the coordinates returned are NaN.
  */
-template<class InputIt, class Vector = typename InputIt::value_type>
+template<class InputIt, class Vector = typename std::iterator_traits<InputIt>::value_type>
 Vector centroid(InputIt begin, InputIt end, bool relative = true) {
     // TODO: Implement centroid calculation relative to first coordinate in the polygon ring
     Vector centroid;
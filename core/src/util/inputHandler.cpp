@@ -28,12 +28,17 @@ namespace Tangram {
 
 InputHandler::InputHandler(std::shared_ptr<Platform> _platform, View& _view) : m_platform(_platform), m_view(_view) {}
 
-bool InputHandler::update(float _dt) {
+bool InputHandler::isFlinging() const {
 
     auto velocityPanPixels = m_view.pixelsPerMeter() / m_view.pixelScale() * m_velocityPan;
 
-    bool isFlinging = glm::length(velocityPanPixels) > THRESHOLD_STOP_PAN ||
-                      std::abs(m_velocityZoom) > THRESHOLD_STOP_ZOOM;
+    return glm::length(velocityPanPixels) > THRESHOLD_STOP_PAN ||
+           std::abs(m_velocityZoom) > THRESHOLD_STOP_ZOOM;
+}
+
+bool InputHandler::update(float _dt) {
+
+    bool isFlinging = this->isFlinging();
 
     if (isFlinging) {
 
@@ -49,6 +54,20 @@ bool InputHandler::update(float _dt) {
     return isFlinging;
 }
 
+bool InputHandler::predictFling(float _dt, View& _view) const {
+
+    if (!isFlinging()) { return false; }
+
+    // Integral of the exponentially damped velocities over _dt
+    float pan = (1.f - std::exp(-DAMPING_PAN * _dt)) / DAMPING_PAN;
+    float zoom = (1.f - std::exp(-DAMPING_ZOOM * _dt)) / DAMPING_ZOOM;
+
+    _view.translate(pan * m_velocityPan.x, pan * m_velocityPan.y);
+    _view.zoom(zoom * m_velocityZoom);
+
+    return true;
+}
+
 void InputHandler::handleTapGesture(float _posX, float _posY) {
 
     onGesture();
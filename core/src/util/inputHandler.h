@@ -29,12 +29,20 @@ public:
 
     void cancelFling();
 
+    /*
+     * Applies the remaining fling motion within the next @_dt seconds to
+     * @_view. Returns false when not flinging.
+     */
+    bool predictFling(float _dt, View& _view) const;
+
     void setView(View& _view) { m_view = _view; }
 
 private:
 
     void setVelocity(float _zoom, glm::vec2 _pan);
 
+    bool isFlinging() const;
+
     void onGesture();
 
     std::shared_ptr<Platform> m_platform;
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Tangram {
+
+/* Binary serialization of trivially copyable values and strings, in the byte
+ * order of the host. Used for the files of the GeometryCache. */
+
+template<typename T>
+inline void write(std::vector<char>& _out, const T& _value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+    const char* bytes = reinterpret_cast<const char*>(&_value);
+    _out.insert(_out.end(), bytes, bytes + sizeof(T));
+}
+
+inline void writeString(std::vector<char>& _out, const std::string& _value) {
+    write(_out, uint32_t(_value.size()));
+    _out.insert(_out.end(), _value.begin(), _value.end());
+}
+
+/* Read a value written by write() and advance @_data past it. Returns false
+ * when @_data ends before the value. */
+template<typename T>
+inline bool read(const char*& _data, const char* _end, T& _value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+    if (size_t(_end - _data) < sizeof(T)) { return false; }
+    std::memcpy(&_value, _data, sizeof(T));
+    _data += sizeof(T);
+    return true;
+}
+
+inline bool readString(const char*& _data, const char* _end, std::string& _value) {
+    uint32_t length = 0;
+    if (!read(_data, _end, length) || size_t(_end - _data) < length) { return false; }
+    _value.assign(_data, length);
+    _data += length;
+    return true;
+}
+
+}
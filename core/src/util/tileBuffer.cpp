@@ -0,0 +1,161 @@
+#include "util/tileBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+
+// Size classes from 4KB to 4MB, larger blocks are not pooled
+#define MIN_CLASS_SHIFT 12
+#define MAX_CLASS_SHIFT 22
+#define NUM_CLASSES (MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1)
+
+// Bytes kept in the pool for each size class
+#define MAX_POOLED_CLASS_BYTES (4 << 20)
+
+namespace Tangram {
+
+struct BufferPool {
+    struct SizeClass {
+        std::mutex mutex;
+        std::vector<char*> blocks;
+    };
+    SizeClass classes[NUM_CLASSES];
+
+    std::atomic<uint64_t> reused{0};
+    std::atomic<uint64_t> allocated{0};
+    std::atomic<size_t> pooledBytes{0};
+
+    ~BufferPool() {
+        for (auto& sizeClass : classes) {
+            for (char* block : sizeClass.blocks) { delete[] block; }
+        }
+    }
+
+    static int classIndex(size_t _size) {
+        int shift = MIN_CLASS_SHIFT;
+        while ((size_t(1) << shift) < _size) { shift++; }
+        return shift - MIN_CLASS_SHIFT;
+    }
+
+    // Returns a block of at least @_size bytes and sets @_capacity to its size
+    char* acquire(size_t _size, size_t& _capacity) {
+        int index = classIndex(_size);
+        if (index >= NUM_CLASSES) {
+            allocated++;
+            _capacity = _size;
+            return new char[_size];
+        }
+        _capacity = size_t(1) << (index + MIN_CLASS_SHIFT);
+
+        auto& sizeClass = classes[index];
+        {
+            std::lock_guard<std::mutex> lock(sizeClass.mutex);
+            if (!sizeClass.blocks.empty()) {
+                char* block = sizeClass.blocks.back();
+                sizeClass.blocks.pop_back();
+                pooledBytes -= _capacity;
+                reused++;
+                return block;
+            }
+        }
+        allocated++;
+        return new char[_capacity];
+    }
+
+    void release(char* _block, size_t _capacity) {
+        int index = classIndex(_capacity);
+        if (index < NUM_CLASSES && (size_t(1) << (index + MIN_CLASS_SHIFT)) == _capacity) {
+            auto& sizeClass = classes[index];
+            std::lock_guard<std::mutex> lock(sizeClass.mutex);
+            if ((sizeClass.blocks.size() + 1) * _capacity <= MAX_POOLED_CLASS_BYTES) {
+                sizeClass.blocks.push_back(_block);
+                pooledBytes += _capacity;
+                return;
+            }
+        }
+        delete[] _block;
+    }
+};
+
+static BufferPool& pool() {
+    // Not destroyed, buffers may be released from static destructors
+    static BufferPool* instance = new BufferPool();
+    return *instance;
+}
+
+std::shared_ptr<TileBuffer> TileBuffer::create(size_t _size) {
+    std::shared_ptr<TileBuffer> buffer(new TileBuffer());
+    buffer->resize(_size);
+    return buffer;
+}
+
+std::shared_ptr<TileBuffer> TileBuffer::copy(const char* _data, size_t _size) {
+    auto buffer = create(_size);
+    if (_size > 0) {
+        std::memcpy(buffer->m_block, _data, _size);
+    }
+    return buffer;
+}
+
+std::shared_ptr<TileBuffer> TileBuffer::adopt(std::vector<char>&& _data) {
+    std::shared_ptr<TileBuffer> buffer(new TileBuffer());
+    buffer->m_vector = std::move(_data);
+    buffer->m_data = buffer->m_vector.data();
+    buffer->m_size = buffer->m_vector.size();
+    return buffer;
+}
+
+std::shared_ptr<TileBuffer> TileBuffer::view(const char* _data, size_t _size,
+                                             std::shared_ptr<const void> _owner) {
+    std::shared_ptr<TileBuffer> buffer(new TileBuffer());
+    buffer->m_data = _data;
+    buffer->m_size = _size;
+    buffer->m_owner = std::move(_owner);
+    return buffer;
+}
+
+TileBuffer::~TileBuffer() {
+    if (m_block) {
+        pool().release(m_block, m_capacity);
+    }
+}
+
+void TileBuffer::reserve(size_t _capacity) {
+    // Only owned buffers can grow
+    assert(m_block || m_size == 0);
+
+    if (_capacity <= m_capacity) { return; }
+
+    size_t capacity = 0;
+    char* block = pool().acquire(_capacity, capacity);
+
+    if (m_block) {
+        std::memcpy(block, m_block, m_size);
+        pool().release(m_block, m_capacity);
+    }
+    m_block = block;
+    m_capacity = capacity;
+    m_data = m_block;
+}
+
+void TileBuffer::resize(size_t _size) {
+    if (_size > m_capacity) {
+        // Grow geometrically when appending
+        reserve(std::max(_size, m_capacity * 2));
+    }
+    m_size = _size;
+}
+
+TileBuffer::PoolStats TileBuffer::poolStats() {
+    auto& instance = pool();
+
+    PoolStats stats;
+    stats.reused = instance.reused;
+    stats.allocated = instance.allocated;
+    stats.pooledBytes = instance.pooledBytes;
+    return stats;
+}
+
+}
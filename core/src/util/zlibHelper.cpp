@@ -1,7 +1,9 @@
 #include "util/zlibHelper.h"
+#include "util/tileBuffer.h"
 
 #include <zlib.h>
 
+#include <algorithm>
 #include <assert.h>
 
 #define CHUNK 16384
@@ -52,5 +54,55 @@ int inflate(const char* _data, size_t _size, std::vector<char>& dst) {
     return ret == Z_STREAM_END ? Z_OK : Z_DATA_ERROR;
 }
 
+int inflate(const char* _data, size_t _size, TileBuffer& dst) {
+
+    int ret;
+
+    z_stream strm;
+    memset(&strm, 0, sizeof(z_stream));
+
+    ret = inflateInit2(&strm, 16+MAX_WBITS);
+    if (ret != Z_OK) { return ret; }
+
+    strm.avail_in = _size;
+    strm.next_in = (Bytef*)_data;
+
+    // Tiles are typically compressed to a third or less
+    dst.reserve(dst.size() + std::max(_size * 4, size_t(CHUNK)));
+
+    do {
+        size_t size = dst.size();
+        if (dst.capacity() - size < CHUNK) {
+            dst.reserve(dst.capacity() * 2);
+        }
+        size_t avail = dst.capacity() - size;
+
+        strm.avail_out = avail;
+        strm.next_out = (Bytef*)(dst.mutableData() + size);
+
+        ret = inflate(&strm, Z_NO_FLUSH);
+
+         /* state not clobbered */
+        assert(ret != Z_STREAM_ERROR);
+
+        switch (ret) {
+        case Z_NEED_DICT:
+            ret = Z_DATA_ERROR;
+            /* fall through */
+        case Z_DATA_ERROR:
+        case Z_MEM_ERROR:
+            inflateEnd(&strm);
+            return ret;
+        }
+
+        dst.resize(size + avail - strm.avail_out);
+
+    } while (ret == Z_OK);
+
+    inflateEnd(&strm);
+
+    return ret == Z_STREAM_END ? Z_OK : Z_DATA_ERROR;
+}
+
 }
 }
@@ -4,9 +4,15 @@
 #include <string.h>
 
 namespace Tangram {
+
+class TileBuffer;
+
 namespace zlib {
 
 int inflate(const char* _data, size_t _size, std::vector<char>& dst);
 
+/* Appends to @dst, inflating directly into its block */
+int inflate(const char* _data, size_t _size, TileBuffer& dst);
+
 }
 }
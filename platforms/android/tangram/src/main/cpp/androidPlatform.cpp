@@ -393,8 +393,8 @@ void AndroidPlatform::labelPickCallback(const LabelPickResult* labelPickResult)
         hashmap = jniEnv->NewObject(hashmapClass, hashmapInitMID);
 
         for (const auto& item : properties->items()) {
-            jstring jkey = jstringFromString(jniEnv, item.key);
-            jstring jvalue = jstringFromString(jniEnv, properties->asString(item.value));
+            jstring jkey = jstringFromString(jniEnv, item.key.name());
+            jstring jvalue = jstringFromString(jniEnv, properties->asString(*item.value));
             jniEnv->CallObjectMethod(hashmap, hashmapPutMID, jkey, jvalue);
         }
     }
@@ -434,8 +434,8 @@ void AndroidPlatform::featurePickCallback(const Tangram::FeaturePickResult* feat
         position[1] = featurePickResult->position[1];
 
         for (const auto& item : properties->items()) {
-            jstring jkey = jstringFromString(jniEnv, item.key);
-            jstring jvalue = jstringFromString(jniEnv, properties->asString(item.value));
+            jstring jkey = jstringFromString(jniEnv, item.key.name());
+            jstring jvalue = jstringFromString(jniEnv, properties->asString(*item.value));
             jniEnv->CallObjectMethod(hashmap, hashmapPutMID, jkey, jvalue);
         }
     }
@@ -1,8 +1,9 @@
 #include "urlClient.h"
 #include "log.h"
+#include <algorithm>
 #include <cassert>
 #include <cstring>
-#include <curl/curl.h>
+#include <limits>
 
 namespace Tangram {
 
@@ -19,82 +20,82 @@ struct CurlGlobals {
 
 const char* requestCancelledError = "Request cancelled";
 
+// Maximum time to wait for socket activity when no transfer needs attention.
+const int pollTimeoutMs = 1000;
+
 UrlClient::UrlClient(Options options) : m_options(options) {
-    assert(options.numberOfThreads > 0);
-    // Start the curl threads.
+    assert(options.maxActiveRequests > 0);
+    m_multi = curl_multi_init();
+    // Multiplex requests over HTTP/2 connections.
+    curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, long(options.maxConnectionsPerHost));
+    // Start the curl thread.
     m_keepRunning = true;
-    m_tasks.resize(options.numberOfThreads);
-    for (uint32_t i = 0; i < options.numberOfThreads; i++) {
-        m_threads.emplace_back(&UrlClient::curlLoop, this, i);
-    }
+    m_thread = std::thread(&UrlClient::curlLoop, this);
 }
 
 UrlClient::~UrlClient() {
-    // Make all tasks canceled.
+    std::vector<Request> requests;
     {
         // Lock the mutex to prevent concurrent modification of the list by the curl loop thread.
         std::lock_guard<std::mutex> lock(m_requestMutex);
-        // For all requests that have not started, finish them now with a canceled response.
-        for (auto& request : m_requests) {
-            if (request.callback) {
-                request.callback(getCanceledResponse());
-            }
-        }
-        m_requests.clear();
-        for (auto& task : m_tasks) {
-            task.request.canceled = true;
+        std::swap(requests, m_requests);
+        m_keepRunning = false;
+    }
+    // For all requests that have not started, finish them now with a canceled response.
+    for (auto& request : requests) {
+        if (request.callback) {
+            request.callback(getCanceledResponse());
         }
     }
-    // Stop the curl threads.
-    m_keepRunning = false;
-    m_requestCondition.notify_all();
-    for (auto& thread : m_threads) {
-        thread.join();
+    // Stop the curl thread, it cancels the running requests.
+    curl_multi_wakeup(m_multi);
+    m_thread.join();
+
+    for (auto handle : m_easyHandles) {
+        curl_easy_cleanup(handle);
     }
+    curl_multi_cleanup(m_multi);
 }
 
-UrlRequestHandle UrlClient::addRequest(const std::string& url, UrlCallback onComplete) {
-    // Create a new request.
-    m_requestCount++;
-    Request request = {url, onComplete, m_requestCount, false};
+UrlRequestHandle UrlClient::addRequest(const std::string& url, UrlCallback onComplete,
+                                       UrlRequestPriority priority) {
+    UrlRequestHandle handle;
     // Add the request to our list.
     {
         // Lock the mutex to prevent concurrent modification of the list by the curl loop thread.
         std::lock_guard<std::mutex> lock(m_requestMutex);
-        m_requests.push_back(request);
+        handle = ++m_requestCount;
+        m_requests.push_back({url, std::move(onComplete), std::move(priority), handle});
     }
-    // Notify a thread to start the transfer.
-    m_requestCondition.notify_one();
-    return m_requestCount;
+    // Wake up the curl thread to start the transfer.
+    curl_multi_wakeup(m_multi);
+    return handle;
 }
 
 void UrlClient::cancelRequest(UrlRequestHandle handle) {
     UrlCallback callback;
-    // First check the pending request list.
     {
         // Lock the mutex to prevent concurrent modification of the list by the curl loop thread.
         std::lock_guard<std::mutex> lock(m_requestMutex);
-        for (auto it = m_requests.begin(), end = m_requests.end(); it != end; ++it) {
-            auto& request = *it;
-            if (request.handle == handle) {
-                // Found the request! Now run its callback and remove it.
-                callback = std::move(request.callback);
-                m_requests.erase(it);
-                break;
-            }
+        // First check the pending request list.
+        auto it = std::find_if(m_requests.begin(), m_requests.end(),
+                               [&](const Request& request) { return request.handle == handle; });
+        if (it != m_requests.end()) {
+            // Found the request! Now run its callback and remove it.
+            callback = std::move(it->callback);
+            m_requests.erase(it);
+        } else {
+            // Otherwise the curl thread aborts the running request.
+            m_canceled.push_back(handle);
         }
     }
     // We run the callback outside of the mutex lock to prevent deadlock in case the callback
     // makes further calls into this UrlClient.
     if (callback) {
         callback(getCanceledResponse());
-    }
-
-    // Next check the active request list.
-    for (auto& task : m_tasks) {
-        if (task.request.handle == handle) {
-            task.request.canceled = true;
-        }
+    } else {
+        curl_multi_wakeup(m_multi);
     }
 }
 
@@ -109,92 +110,170 @@ size_t UrlClient::curlWriteCallback(char* ptr, size_t size, size_t n, void* user
     auto* response = reinterpret_cast<UrlClient::Response*>(user);
     auto& buffer = response->content;
     auto addedSize = size * n;
-    auto oldSize = buffer.size();
-    buffer.resize(oldSize + addedSize);
-    std::memcpy(buffer.data() + oldSize, ptr, addedSize);
+    buffer.insert(buffer.end(), ptr, ptr + addedSize);
     return addedSize;
 }
 
-int UrlClient::curlProgressCallback(void* user, double dltotal, double dlnow, double ultotal, double ulnow) {
-    // Signals libCURL to abort the request if marked as canceled.
-    auto* task = reinterpret_cast<UrlClient::Task*>(user);
-    return static_cast<int>(task->request.canceled);
-}
-
-void UrlClient::curlLoop(uint32_t index) {
-    assert(m_tasks.size() > index);
-    Task& task = m_tasks[index];
-    LOGD("curlLoop %u starting", index);
-    // Create a buffer for curl error messages.
-    char curlErrorString[CURL_ERROR_SIZE] = {0};
-    // Set up an easy handle for reuse.
+CURL* UrlClient::createEasyHandle() {
+    // Reuse easy handles, they keep their options.
+    if (!m_easyHandles.empty()) {
+        auto handle = m_easyHandles.back();
+        m_easyHandles.pop_back();
+        return handle;
+    }
     auto handle = curl_easy_init();
     curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &curlWriteCallback);
-    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &task.content);
-    curl_easy_setopt(handle, CURLOPT_PROGRESSFUNCTION, &curlProgressCallback);
-    curl_easy_setopt(handle, CURLOPT_PROGRESSDATA, &task);
-    curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 1L);
     curl_easy_setopt(handle, CURLOPT_HEADER, 0L);
     curl_easy_setopt(handle, CURLOPT_VERBOSE, 0L);
     curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "gzip");
-    curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, curlErrorString);
     curl_easy_setopt(handle, CURLOPT_FAILONERROR, 1L);
-    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, m_options.connectionTimeoutMs);
-    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, m_options.requestTimeoutMs);
-    curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1);
-    curl_easy_setopt(handle, CURLOPT_MAXREDIRS, 20);
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, long(m_options.connectionTimeoutMs));
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, long(m_options.requestTimeoutMs));
+    curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(handle, CURLOPT_MAXREDIRS, 20L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    // Use HTTP/2 for HTTPS and prefer waiting for a connection that can be
+    // multiplexed over opening a new one.
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, long(CURL_HTTP_VERSION_2TLS));
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    return handle;
+}
+
+void UrlClient::startRequests() {
+    size_t slots = m_options.maxActiveRequests - std::min(size_t(m_options.maxActiveRequests), m_tasks.size());
+    if (slots == 0 || m_requests.empty()) { return; }
+
+    if (slots < m_requests.size()) {
+        // Rank the waiting requests by their current priority. Requests
+        // without priority, e.g. for scene files, go first.
+        std::vector<std::pair<double, size_t>> ranks;
+        ranks.reserve(m_requests.size());
+        for (size_t i = 0; i < m_requests.size(); i++) {
+            auto& priority = m_requests[i].priority;
+            ranks.emplace_back(priority ? priority() : std::numeric_limits<double>::lowest(), i);
+        }
+        std::stable_sort(ranks.begin(), ranks.end(), [](const std::pair<double, size_t>& a,
+                                                         const std::pair<double, size_t>& b) {
+            return a.first < b.first;
+        });
+        // Order the requests to start first to the front.
+        std::vector<Request> requests;
+        requests.reserve(m_requests.size());
+        for (auto& rank : ranks) {
+            requests.push_back(std::move(m_requests[rank.second]));
+        }
+        std::swap(requests, m_requests);
+    }
+
+    slots = std::min(slots, m_requests.size());
+    for (size_t i = 0; i < slots; i++) {
+        std::unique_ptr<Task> task(new Task());
+        task->request = std::move(m_requests[i]);
+        task->handle = createEasyHandle();
+
+        // Configure the easy handle.
+        const char* url = task->request.url.c_str();
+        curl_easy_setopt(task->handle, CURLOPT_URL, url);
+        curl_easy_setopt(task->handle, CURLOPT_WRITEDATA, &task->response);
+        curl_easy_setopt(task->handle, CURLOPT_ERRORBUFFER, task->curlErrorString);
+        LOGD("curlLoop starting request for url: %s", url);
+
+        task->response.transferStart = std::chrono::steady_clock::now();
+        curl_multi_add_handle(m_multi, task->handle);
+        m_tasks.push_back(std::move(task));
+    }
+    m_requests.erase(m_requests.begin(), m_requests.begin() + slots);
+}
+
+void UrlClient::finishTask(size_t index, const char* error) {
+    std::unique_ptr<Task> task = std::move(m_tasks[index]);
+    m_tasks.erase(m_tasks.begin() + index);
+
+    long httpStatus = 0;
+    curl_easy_getinfo(task->handle, CURLINFO_RESPONSE_CODE, &httpStatus);
+    task->response.httpStatus = int(httpStatus);
+
+    curl_multi_remove_handle(m_multi, task->handle);
+    curl_easy_setopt(task->handle, CURLOPT_ERRORBUFFER, nullptr);
+    m_easyHandles.push_back(task->handle);
+
+    task->response.error = error;
+    // If a callback is given, always run it regardless of request result.
+    if (task->request.callback) {
+        task->request.callback(std::move(task->response));
+    }
+}
+
+void UrlClient::curlLoop() {
+    LOGD("curlLoop starting");
     // Loop until the session is destroyed.
-    while (m_keepRunning) {
-        bool haveRequest = false;
-        // Wait until the condition variable is notified.
+    while (true) {
+        std::vector<UrlRequestHandle> canceled;
         {
-            std::unique_lock<std::mutex> lock(m_requestMutex);
-            if (m_requests.empty()) {
-                LOGD("curlLoop %u waiting", index);
-                m_requestCondition.wait(lock);
-            }
-            LOGD("curlLoop %u notified", index);
-            // Try to get a request from the list.
-            if (!m_requests.empty()) {
-                // Take the first request from our list.
-                task.request = m_requests.front();
-                m_requests.erase(m_requests.begin());
-                haveRequest = true;
-            }
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            if (!m_keepRunning) { break; }
+
+            std::swap(canceled, m_canceled);
+            startRequests();
         }
-        if (haveRequest) {
-            UrlResponse response;
-
-            // Configure the easy handle.
-            const char* url = task.request.url.data();
-            curl_easy_setopt(handle, CURLOPT_URL, url);
-            LOGD("curlLoop %u starting request for url: %s", index, url);
-            // Perform the request.
-            auto result = curl_easy_perform(handle);
-            // Handle success or error.
-            if (result == CURLE_OK) {
-                LOGD("curlLoop %u succeeded for url: %s", index, url);
-                response.error = nullptr;
-            } else if (result == CURLE_ABORTED_BY_CALLBACK) {
-                LOGD("curlLoop %u aborted request for url: %s", index, url);
-                response.error = requestCancelledError;
-            } else {
-                LOGD("curlLoop %u failed with error '%s' for url: %s", index, curlErrorString, url);
-                response.error = curlErrorString;
+
+        // Abort canceled requests.
+        for (auto handle : canceled) {
+            for (size_t i = 0; i < m_tasks.size(); i++) {
+                if (m_tasks[i]->request.handle == handle) {
+                    LOGD("curlLoop aborted request for url: %s", m_tasks[i]->request.url.c_str());
+                    finishTask(i, requestCancelledError);
+                    break;
+                }
             }
-            // If a callback is given, always run it regardless of request result.
-            if (task.request.callback) {
-                LOGD("curlLoop %u performing request callback", index);
-                response.content = task.content;
-                task.request.callback(std::move(response));
+        }
+
+        int running = 0;
+        curl_multi_perform(m_multi, &running);
+
+        // Handle success or error of completed requests.
+        bool finished = false;
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(m_multi, &queued)) {
+            if (message->msg != CURLMSG_DONE) { continue; }
+
+            CURL* handle = message->easy_handle;
+            CURLcode result = message->data.result;
+
+            for (size_t i = 0; i < m_tasks.size(); i++) {
+                auto& task = *m_tasks[i];
+                if (task.handle != handle) { continue; }
+
+                if (result == CURLE_OK) {
+                    LOGD("curlLoop succeeded for url: %s", task.request.url.c_str());
+                    finishTask(i, nullptr);
+                } else {
+                    if (task.curlErrorString[0] == '\0') {
+                        std::strncpy(task.curlErrorString, curl_easy_strerror(result), CURL_ERROR_SIZE - 1);
+                    }
+                    LOGD("curlLoop failed with error '%s' for url: %s", task.curlErrorString,
+                         task.request.url.c_str());
+                    task.response.timedOut = result == CURLE_OPERATION_TIMEDOUT;
+                    finishTask(i, task.curlErrorString);
+                }
+                finished = true;
+                break;
             }
         }
-        // Reset the task.
-        task.content.clear();
+
+        // Start waiting requests right away when transfers finished.
+        if (finished || !canceled.empty()) { continue; }
+
+        // Wait for socket activity, timeouts or a wakeup by another thread.
+        curl_multi_poll(m_multi, nullptr, 0, pollTimeoutMs, nullptr);
+    }
+
+    // Cancel running requests.
+    while (!m_tasks.empty()) {
+        finishTask(m_tasks.size() - 1, requestCancelledError);
     }
-    LOGD("curlLoop %u exiting", index);
-    // Clean up our easy handle.
-    curl_easy_cleanup(handle);
+    LOGD("curlLoop exiting");
 }
 
 } // namespace Tangram
@@ -1,8 +1,9 @@
 #pragma once
 
 #include "platform.h"
-#include <condition_variable>
+#include <curl/curl.h>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -10,12 +11,17 @@
 
 namespace Tangram {
 
+// Runs URL requests on one thread with a curl multi handle. Connections are
+// kept alive and reused, requests to the same host share HTTP/2 connections
+// when the server supports it. Requests that exceed maxActiveRequests wait
+// in a queue and are started in the order of their priority.
 class UrlClient {
 
 public:
 
     struct Options {
-        uint32_t numberOfThreads = 4;
+        uint32_t maxActiveRequests = 16;
+        uint32_t maxConnectionsPerHost = 4;
         uint32_t connectionTimeoutMs = 3000;
         uint32_t requestTimeoutMs = 30000;
     };
@@ -23,7 +29,8 @@ public:
     UrlClient(Options options);
     ~UrlClient();
 
-    UrlRequestHandle addRequest(const std::string& url, UrlCallback onComplete);
+    UrlRequestHandle addRequest(const std::string& url, UrlCallback onComplete,
+                                UrlRequestPriority priority = nullptr);
 
     void cancelRequest(UrlRequestHandle request);
 
@@ -32,28 +39,44 @@ private:
     struct Request {
         std::string url;
         UrlCallback callback;
+        UrlRequestPriority priority;
         UrlRequestHandle handle;
-        bool canceled;
     };
 
     using Response = UrlResponse;
 
     struct Task {
         Request request;
-        std::vector<char> content;
+        Response response;
+        CURL* handle = nullptr;
+        char curlErrorString[CURL_ERROR_SIZE] = {0};
     };
 
     static Response getCanceledResponse();
     static size_t curlWriteCallback(char* ptr, size_t size, size_t n, void* user);
-    static int curlProgressCallback(void* user, double dltotal, double dlnow, double ultotal, double ulnow);
 
-    void curlLoop(uint32_t index);
+    void curlLoop();
 
-    std::vector<std::thread> m_threads;
-    std::vector<Task> m_tasks;
+    // Move the most urgent waiting requests to m_tasks. Called with m_requestMutex held.
+    void startRequests();
+
+    // Remove the transfer of a task and run its callback
+    void finishTask(size_t index, const char* error);
+
+    CURL* createEasyHandle();
+
+    CURLM* m_multi = nullptr;
+    std::thread m_thread;
+
+    // Only accessed by the curl thread
+    std::vector<std::unique_ptr<Task>> m_tasks;
+    std::vector<CURL*> m_easyHandles;
+
+    // Waiting requests and canceled handles of running requests
     std::vector<Request> m_requests;
-    std::condition_variable m_requestCondition;
+    std::vector<UrlRequestHandle> m_canceled;
     std::mutex m_requestMutex;
+
     Options m_options;
     UrlRequestHandle m_requestCount = 0;
     bool m_keepRunning = false;
@@ -658,8 +658,8 @@ std::vector<Tangram::SceneUpdate> unpackSceneUpdates(NSArray<TGSceneUpdate *> *s
                                featureResult->position[1] / strongSelf.contentScaleFactor);
 
         for (const auto& item : properties->items()) {
-            NSString* key = [NSString stringWithUTF8String:item.key.c_str()];
-            NSString* value = [NSString stringWithUTF8String:properties->asString(item.value).c_str()];
+            NSString* key = [NSString stringWithUTF8String:item.key.name().c_str()];
+            NSString* value = [NSString stringWithUTF8String:properties->asString(*item.value).c_str()];
             featureProperties[key] = value;
         }
 
@@ -738,8 +738,8 @@ std::vector<Tangram::SceneUpdate> unpackSceneUpdates(NSArray<TGSceneUpdate *> *s
                                touchItem.position[1] / strongSelf.contentScaleFactor);
 
         for (const auto& item : properties->items()) {
-            NSString* key = [NSString stringWithUTF8String:item.key.c_str()];
-            NSString* value = [NSString stringWithUTF8String:properties->asString(item.value).c_str()];
+            NSString* key = [NSString stringWithUTF8String:item.key.name().c_str()];
+            NSString* value = [NSString stringWithUTF8String:properties->asString(*item.value).c_str()];
             featureProperties[key] = value;
         }
 
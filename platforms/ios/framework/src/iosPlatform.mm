@@ -171,11 +171,13 @@ UrlRequestHandle iOSPlatform::startUrlRequest(Url _url, UrlCallback _callback) {
         if (error != nil) {
 
             urlResponse.error = [error.localizedDescription UTF8String];
+            urlResponse.timedOut = error.code == NSURLErrorTimedOut;
 
         } else if ([response isKindOfClass:[NSHTTPURLResponse class]]) {
 
             NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
             long statusCode = [httpResponse statusCode];
+            urlResponse.httpStatus = int(statusCode);
             if (statusCode < 200 || statusCode >= 300) {
                 urlResponse.error = [[NSHTTPURLResponse localizedStringForStatusCode: statusCode] UTF8String];
             }
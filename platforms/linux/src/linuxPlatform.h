@@ -19,6 +19,8 @@ public:
     FontSourceHandle systemFont(const std::string& _name, const std::string& _weight,
             const std::string& _face) const override;
     UrlRequestHandle startUrlRequest(Url _url, UrlCallback _callback) override;
+    UrlRequestHandle startUrlRequestWithPriority(Url _url, UrlCallback _callback,
+                                                 UrlRequestPriority _priority) override;
     void cancelUrlRequest(UrlRequestHandle _request) override;
 
 protected:
@@ -149,11 +149,13 @@ UrlRequestHandle OSXPlatform::startUrlRequest(Url _url, UrlCallback _callback) {
         if (error != nil) {
 
             urlResponse.error = [error.localizedDescription UTF8String];
+            urlResponse.timedOut = error.code == NSURLErrorTimedOut;
 
         } else if ([response isKindOfClass:[NSHTTPURLResponse class]]) {
 
             NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
             int statusCode = [httpResponse statusCode];
+            urlResponse.httpStatus = statusCode;
             if (statusCode >= 400) {
                 urlResponse.error = [[NSHTTPURLResponse localizedStringForStatusCode: statusCode] UTF8String];
             }
@@ -68,6 +68,12 @@ UrlRequestHandle RpiPlatform::startUrlRequest(Url _url, UrlCallback _callback) {
     return m_urlClient.addRequest(_url.string(), _callback);
 }
 
+UrlRequestHandle RpiPlatform::startUrlRequestWithPriority(Url _url, UrlCallback _callback,
+                                                          UrlRequestPriority _priority) {
+
+    return m_urlClient.addRequest(_url.string(), _callback, _priority);
+}
+
 void RpiPlatform::cancelUrlRequest(UrlRequestHandle _request) {
     m_urlClient.cancelRequest(_request);
 }
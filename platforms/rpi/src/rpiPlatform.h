@@ -17,6 +17,8 @@ public:
     void requestRender() const override;
     std::vector<FontSourceHandle> systemFontFallbacksHandle() const override;
     UrlRequestHandle startUrlRequest(Url _url, UrlCallback _callback) override;
+    UrlRequestHandle startUrlRequestWithPriority(Url _url, UrlCallback _callback,
+                                                 UrlRequestPriority _priority) override;
     void cancelUrlRequest(UrlRequestHandle _url) override;
     FontSourceHandle systemFont(const std::string& _name, const std::string& _weight,
             const std::string& _face) const override;
@@ -0,0 +1,136 @@
+#include "catch.hpp"
+
+#include "data/formats/geoJson.h"
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "tile/tileTask.h"
+
+#include <string>
+
+using namespace Tangram;
+
+static std::shared_ptr<TileData> parse(const std::string& _json, bool _document) {
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    source->setFormat(TileSource::Format::GeoJson);
+
+    auto task = source->createTask(TileID(0, 0, 0));
+    static_cast<BinaryTileTask&>(*task).rawTileData = TileBuffer::copy(_json.data(), _json.size());
+
+    return _document ? GeoJson::parseTileDocument(*task, 0) : GeoJson::parseTile(*task, 0);
+}
+
+static void requireSameLines(const LineList& _a, const LineList& _b) {
+    REQUIRE(_a.size() == _b.size());
+    for (size_t i = 0; i < _a.size(); i++) {
+        REQUIRE(_a[i].size() == _b[i].size());
+        for (size_t j = 0; j < _a[i].size(); j++) {
+            REQUIRE(_a[i][j] == _b[i][j]);
+        }
+    }
+}
+
+static void requireSameTileData(const TileData& _a, const TileData& _b) {
+    REQUIRE(_a.layers.size() == _b.layers.size());
+
+    for (size_t l = 0; l < _a.layers.size(); l++) {
+        auto& a = _a.layers[l];
+        auto& b = _b.layers[l];
+        REQUIRE(a.name == b.name);
+        REQUIRE(a.features.size() == b.features.size());
+
+        for (size_t f = 0; f < a.features.size(); f++) {
+            auto& fa = a.features[f];
+            auto& fb = b.features[f];
+            REQUIRE(fa.geometryType == fb.geometryType);
+            REQUIRE(fa.props.toJson() == fb.props.toJson());
+            requireSameLines(fa.lines(), fb.lines());
+            REQUIRE(fa.polygons().size() == fb.polygons().size());
+            for (size_t p = 0; p < fa.polygons().size(); p++) {
+                requireSameLines(fa.polygons()[p], fb.polygons()[p]);
+            }
+        }
+    }
+}
+
+const std::string collection = R"({
+  "type": "FeatureCollection",
+  "features": [
+    { "type": "Feature",
+      "properties": { "name": "park", "area": 12.5, "open": true, "tags": { "kind": "x" }, "none": null },
+      "geometry": { "type": "Polygon", "coordinates": [
+        [[0, 0], [10, 0], [10, 10], [0, 0]],
+        [[1, 1], [2, 1], [2, 2], [1, 1]] ] } },
+    { "type": "Feature", "id": 2,
+      "geometry": { "coordinates": [[0, 0, 5], [-10, 20]], "type": "LineString" },
+      "properties": { "kind": "path" } },
+    { "type": "Feature", "properties": {},
+      "geometry": { "type": "MultiPolygon", "coordinates": [
+        [[[0, 0], [1, 0], [1, 1], [0, 0]]],
+        [[[5, 5], [6, 5], [6, 6], [5, 5]]] ] } },
+    { "type": "Feature", "properties": { "kind": "stops" },
+      "geometry": { "type": "MultiLineString", "coordinates": [[[0, 0], [1, 1]], [[2, 2], [3, 3]]] } },
+    { "type": "Feature", "properties": { "kind": "stop" },
+      "geometry": { "type": "Point", "coordinates": [20, 30] } },
+    { "type": "Feature", "properties": { "kind": "stops" },
+      "geometry": { "type": "MultiPoint", "coordinates": [[20, 30], [21, 31]] } }
+  ]
+})";
+
+TEST_CASE("Streaming GeoJSON reader matches the document parser", "[GeoJson]") {
+    auto stream = parse(collection, false);
+    auto document = parse(collection, true);
+
+    REQUIRE(stream->layers.size() == 1);
+    REQUIRE(stream->layers[0].name == "");
+    REQUIRE(stream->layers[0].features.size() == 6);
+
+    requireSameTileData(*stream, *document);
+
+    auto& park = stream->layers[0].features[0];
+    REQUIRE(park.geometryType == GeometryType::polygons);
+    REQUIRE(park.polygons().size() == 1);
+    REQUIRE(park.polygons()[0].size() == 2);
+    REQUIRE(park.props.getString("name") == "park");
+    REQUIRE(park.props.getNumber("area") == 12.5);
+    REQUIRE(park.props.getNumber("open") == 1);
+    REQUIRE_FALSE(park.props.contains("tags"));
+    REQUIRE_FALSE(park.props.contains("none"));
+
+    auto& path = stream->layers[0].features[1];
+    REQUIRE(path.geometryType == GeometryType::lines);
+    REQUIRE(path.lines().size() == 1);
+    REQUIRE(path.lines()[0].size() == 2);
+    REQUIRE(path.polygons().empty());
+
+    auto& stops = stream->layers[0].features[5];
+    REQUIRE(stops.geometryType == GeometryType::points);
+    REQUIRE(stops.points().size() == 2);
+}
+
+TEST_CASE("Streaming GeoJSON reader reads named layers", "[GeoJson]") {
+    std::string layers = R"({
+      "roads": { "features": [
+        { "properties": { "kind": "major" },
+          "geometry": { "type": "LineString", "coordinates": [[0, 0], [1, 1]] } } ],
+        "type": "FeatureCollection" },
+      "meta": { "type": "Other", "features": [] },
+      "water": { "type": "FeatureCollection", "features": [
+        { "properties": { "kind": "lake" },
+          "geometry": { "type": "Point", "coordinates": [5, 5] } } ] }
+    })";
+
+    auto stream = parse(layers, false);
+    auto document = parse(layers, true);
+
+    REQUIRE(stream->layers.size() == 2);
+    REQUIRE(stream->layers[0].name == "roads");
+    REQUIRE(stream->layers[1].name == "water");
+
+    requireSameTileData(*stream, *document);
+}
+
+TEST_CASE("Streaming GeoJSON reader drops invalid tiles", "[GeoJson]") {
+    auto tileData = parse(collection.substr(0, collection.size() / 2), false);
+    REQUIRE(tileData);
+    REQUIRE(tileData->layers.empty());
+}
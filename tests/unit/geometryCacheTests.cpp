@@ -0,0 +1,344 @@
+#include "catch.hpp"
+
+#include "data/properties.h"
+#include "data/tileSource.h"
+#include "gl/mesh.h"
+#include "scene/scene.h"
+#include "selection/featureSelection.h"
+#include "style/polygonStyle.h"
+#include "tile/geometryCache.h"
+#include "tile/tile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace Tangram;
+
+const char cacheDir[] = "geometry_cache_test";
+
+struct TestVertex {
+    float x, y, z;
+    uint32_t color;
+};
+
+struct TestStyle : PolygonStyle {
+    TestStyle(std::string _name) : PolygonStyle(_name) {
+        m_vertexLayout = std::shared_ptr<VertexLayout>(new VertexLayout({
+            {"a_position", 3, GL_FLOAT, false, 0},
+            {"a_color", 4, GL_UNSIGNED_BYTE, true, 0},
+        }));
+    }
+};
+
+struct SelectableStyle : PolygonStyle {
+    SelectableStyle(std::string _name) : PolygonStyle(_name) {
+        m_vertexLayout = std::shared_ptr<VertexLayout>(new VertexLayout({
+            {"a_position", 3, GL_FLOAT, false, 0},
+            {"a_selection_color", 4, GL_UNSIGNED_BYTE, true, 0},
+        }));
+    }
+};
+
+struct VersionedDataSource : TileSource::DataSource {
+    std::string version = "v1";
+    std::chrono::seconds age{0};
+
+    bool loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override { return false; }
+    std::string dataVersion() const override { return version; }
+    std::chrono::seconds maxAge() const override { return age; }
+};
+
+static void clearCacheDir() {
+    mkdir(cacheDir, 0755);
+    if (DIR* dir = opendir(cacheDir)) {
+        while (auto* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name != "." && name != "..") { std::remove((std::string(cacheDir) + "/" + name).c_str()); }
+        }
+        closedir(dir);
+    }
+}
+
+// Files are written and indexed by the writer thread of the cache
+static bool waitFor(std::function<bool()> _condition) {
+    for (int i = 0; i < 1000 && !_condition(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return _condition();
+}
+
+static std::unique_ptr<Scene> makeScene() {
+    auto scene = std::make_unique<Scene>();
+    for (auto name : { "polygons", "empty" }) {
+        auto style = std::make_unique<TestStyle>(name);
+        style->setID(scene->styles().size());
+        scene->styles().push_back(std::move(style));
+    }
+    return scene;
+}
+
+static std::unique_ptr<Tile> makeTile(const Scene& _scene, const TileSource& _source, TileID _tileId) {
+    auto tile = std::make_unique<Tile>(_tileId, _source.id(), _source.generation());
+    tile->initGeometry(_scene.styles().size());
+
+    auto& style = *_scene.styles()[0];
+    auto mesh = std::make_unique<Mesh<TestVertex>>(style.vertexLayout(), GL_TRIANGLES);
+    mesh->compile(MeshData<TestVertex>({ 0, 1, 2 }, std::vector<TestVertex>(3, { 1.f, 2.f, 3.f, 0xff00ff00 })));
+    tile->setMesh(style, std::move(mesh));
+
+    return tile;
+}
+
+TEST_CASE( "GeometryCache restores the stored meshes of a tile", "[GeometryCache]" ) {
+    clearCacheDir();
+
+    auto scene = makeScene();
+    auto& style = *scene->styles()[0];
+    REQUIRE(style.vertexLayout()->getStride() == sizeof(TestVertex));
+
+    auto dataSource = std::make_unique<VersionedDataSource>();
+    auto& data = *dataSource;
+    TileSource source("test", std::move(dataSource));
+    REQUIRE(GeometryCache::isCacheable(source));
+
+    TileID tileId(1, 2, 3);
+    auto tile = makeTile(*scene, source, tileId);
+    size_t bufferSize = tile->getMesh(style)->bufferSize();
+
+    {
+        GeometryCache cache(cacheDir);
+        cache.setSceneHash(42);
+        cache.store(42, *scene, source, *tile);
+        REQUIRE(waitFor([&]{ return cache.contains(source, tileId); }));
+    }
+
+    // Indexed again by a new cache, e.g. after a restart
+    GeometryCache cache(cacheDir);
+    cache.setSceneHash(42);
+    REQUIRE(waitFor([&]{ return cache.contains(source, tileId); }));
+    REQUIRE(!cache.contains(source, TileID(1, 2, 3, 4)));
+
+    Tile restored(tileId, source.id(), source.generation());
+    restored.initGeometry(scene->styles().size());
+    std::vector<bool> loaded;
+    REQUIRE(cache.load(42, *scene, source, restored, loaded));
+    REQUIRE(loaded == std::vector<bool>({ true, true }));
+    REQUIRE(restored.getMesh(style));
+    REQUIRE(restored.getMesh(style)->bufferSize() == bufferSize);
+    REQUIRE(!restored.getMesh(*scene->styles()[1]));
+
+    // Other scene
+    cache.setSceneHash(43);
+    REQUIRE(!cache.contains(source, tileId));
+    REQUIRE(!cache.load(43, *scene, source, restored, loaded));
+    cache.setSceneHash(42);
+
+    // Changed data
+    data.version = "v2";
+    REQUIRE(!cache.contains(source, tileId));
+    REQUIRE(!cache.load(42, *scene, source, restored, loaded));
+
+    REQUIRE(cache.stats().hits == 1);
+    REQUIRE(cache.stats().misses == 2);
+}
+
+TEST_CASE( "GeometryCache removes the least recently used tiles above its maximum size", "[GeometryCache]" ) {
+    clearCacheDir();
+
+    auto scene = makeScene();
+    TileSource source("test", std::make_unique<VersionedDataSource>());
+
+    TileID a(1, 1, 3), b(2, 1, 3), c(3, 1, 3);
+    auto tileA = makeTile(*scene, source, a);
+    auto tileB = makeTile(*scene, source, b);
+    auto tileC = makeTile(*scene, source, c);
+
+    size_t fileSize = 0;
+    {
+        GeometryCache cache(cacheDir);
+        cache.store(0, *scene, source, *tileA);
+        REQUIRE(waitFor([&]{ return cache.stats().size > 0; }));
+        fileSize = cache.stats().size;
+    }
+
+    // Room for two and a half tiles
+    clearCacheDir();
+    GeometryCache cache(cacheDir, fileSize * 5 / 2);
+
+    cache.store(0, *scene, source, *tileA);
+    REQUIRE(waitFor([&]{ return cache.contains(source, a); }));
+    cache.store(0, *scene, source, *tileB);
+    REQUIRE(waitFor([&]{ return cache.contains(source, b); }));
+
+    // Use A, so that B is the least recently used tile
+    Tile restored(a, source.id(), source.generation());
+    restored.initGeometry(scene->styles().size());
+    std::vector<bool> loaded;
+    REQUIRE(cache.load(0, *scene, source, restored, loaded));
+
+    cache.store(0, *scene, source, *tileC);
+    REQUIRE(waitFor([&]{ return cache.contains(source, c); }));
+
+    REQUIRE(cache.contains(source, a));
+    REQUIRE(!cache.contains(source, b));
+    REQUIRE(cache.stats().evicted == 1);
+    REQUIRE(cache.stats().size == 2 * fileSize);
+
+    // The file of B was removed
+    Tile evicted(b, source.id(), source.generation());
+    evicted.initGeometry(scene->styles().size());
+    REQUIRE(!cache.load(0, *scene, source, evicted, loaded));
+}
+
+// Selection colors of the vertices of a serialized mesh with TestVertex layout
+static std::vector<uint32_t> selectionColors(const StyledMesh& _mesh) {
+    std::vector<char> data;
+    REQUIRE(_mesh.serialize(data));
+
+    // Header of MeshBase::serialize
+    uint64_t numVertices = 0;
+    uint32_t numOffsets = 0;
+    std::memcpy(&numVertices, data.data() + 12, sizeof(numVertices));
+    std::memcpy(&numOffsets, data.data() + 28, sizeof(numOffsets));
+    size_t vertexOffset = 32 + numOffsets * 2 * sizeof(uint32_t);
+
+    std::vector<uint32_t> colors;
+    for (uint64_t i = 0; i < numVertices; i++) {
+        TestVertex vertex;
+        std::memcpy(&vertex, data.data() + vertexOffset + i * sizeof(TestVertex), sizeof(vertex));
+        colors.push_back(vertex.color);
+    }
+    return colors;
+}
+
+TEST_CASE( "GeometryCache restores selection features with new selection colors", "[GeometryCache]" ) {
+    clearCacheDir();
+
+    auto scene = std::make_unique<Scene>();
+    scene->featureSelection() = std::make_shared<FeatureSelection>();
+    auto selectable = std::make_unique<SelectableStyle>("selectable");
+    selectable->setID(0);
+    scene->styles().push_back(std::move(selectable));
+    auto& style = *scene->styles()[0];
+
+    TileSource source("test", std::make_unique<VersionedDataSource>());
+    TileID tileId(1, 2, 3);
+
+    Tile tile(tileId, source.id(), source.generation());
+    tile.initGeometry(scene->styles().size());
+
+    // Colors of a feature, of a label without feature and no selection
+    auto mesh = std::make_unique<Mesh<TestVertex>>(style.vertexLayout(), GL_TRIANGLES);
+    mesh->compile(MeshData<TestVertex>({ 0, 1, 2 }, {
+                { 1.f, 2.f, 3.f, 7 }, { 1.f, 2.f, 3.f, 9 }, { 1.f, 2.f, 3.f, 0 } }));
+    tile.setMesh(style, std::move(mesh));
+
+    auto props = std::make_shared<Properties>();
+    props->set("name", "park");
+    props->set("area", 12.5);
+    props->sourceId = 3;
+    fastmap<uint32_t, std::shared_ptr<Properties>> features;
+    features[7] = props;
+    tile.setSelectionFeatures(features);
+
+    GeometryCache cache(cacheDir);
+    cache.setSceneHash(42);
+    cache.store(42, *scene, source, tile);
+    REQUIRE(waitFor([&]{ return cache.contains(source, tileId); }));
+
+    // Colors of this session
+    for (int i = 0; i < 20; i++) { scene->featureSelection()->nextColorIdentifier(); }
+
+    Tile restored(tileId, source.id(), source.generation());
+    restored.initGeometry(scene->styles().size());
+    std::vector<bool> loaded;
+    REQUIRE(cache.load(42, *scene, source, restored, loaded));
+    REQUIRE(restored.getMesh(style));
+
+    auto colors = selectionColors(*restored.getMesh(style));
+    REQUIRE(colors.size() == 3);
+    REQUIRE(colors[0] >= 20);
+    REQUIRE(colors[1] >= 20);
+    REQUIRE(colors[0] != colors[1]);
+    REQUIRE(colors[2] == 0);
+
+    REQUIRE(restored.getSelectionFeatures().size() == 1);
+    REQUIRE(!restored.getSelectionFeature(7));
+    auto feature = restored.getSelectionFeature(colors[0]);
+    REQUIRE(feature);
+    REQUIRE(feature->getString("name") == "park");
+    REQUIRE(feature->getNumber("area") == 12.5);
+    REQUIRE(feature->sourceId == 3);
+}
+
+TEST_CASE( "GeometryCache does not restore tiles older than the maximum age of their data", "[GeometryCache]" ) {
+    clearCacheDir();
+
+    auto scene = makeScene();
+    auto dataSource = std::make_unique<VersionedDataSource>();
+    auto& data = *dataSource;
+    TileSource source("test", std::move(dataSource));
+
+    TileID tileId(1, 2, 3);
+    auto tile = makeTile(*scene, source, tileId);
+
+    std::string path;
+    {
+        GeometryCache cache(cacheDir);
+        cache.store(42, *scene, source, *tile);
+        cache.setSceneHash(42);
+        REQUIRE(waitFor([&]{ return cache.contains(source, tileId); }));
+    }
+    if (DIR* dir = opendir(cacheDir)) {
+        while (auto* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name != "." && name != "..") { path = std::string(cacheDir) + "/" + name; }
+        }
+        closedir(dir);
+    }
+    REQUIRE(!path.empty());
+
+    // Stored an hour ago: The creation time follows the magic and the key
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        uint32_t keyLength = 0;
+        file.seekg(4);
+        file.read(reinterpret_cast<char*>(&keyLength), sizeof(keyLength));
+        int64_t created = int64_t(std::time(nullptr)) - 3600;
+        file.seekp(8 + keyLength);
+        file.write(reinterpret_cast<const char*>(&created), sizeof(created));
+        REQUIRE(file);
+    }
+
+    GeometryCache cache(cacheDir);
+    cache.setSceneHash(42);
+
+    // Data of the same version does not change
+    REQUIRE(waitFor([&]{ return cache.contains(source, tileId); }));
+
+    data.age = std::chrono::hours(2);
+    REQUIRE(cache.contains(source, tileId));
+
+    data.age = std::chrono::minutes(30);
+    REQUIRE(!cache.contains(source, tileId));
+
+    Tile restored(tileId, source.id(), source.generation());
+    restored.initGeometry(scene->styles().size());
+    std::vector<bool> loaded;
+    REQUIRE(!cache.load(42, *scene, source, restored, loaded));
+
+    // The expired file was removed
+    data.age = std::chrono::seconds(0);
+    REQUIRE(!cache.contains(source, tileId));
+    REQUIRE(!cache.load(42, *scene, source, restored, loaded));
+}
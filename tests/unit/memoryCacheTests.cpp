@@ -0,0 +1,115 @@
+#include "catch.hpp"
+
+#include "data/memoryCacheDataSource.h"
+#include "data/tileSource.h"
+#include "tile/tileTask.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+// Loads tiles of 1KB synchronously
+struct CountingDataSource : TileSource::DataSource {
+    std::atomic<int> loads{0};
+
+    bool loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override {
+        loads++;
+        auto& task = static_cast<BinaryTileTask&>(*_task);
+        task.rawTileData = TileBuffer::create(1024);
+        _cb.func(_task);
+        return true;
+    }
+};
+
+struct CacheFixture {
+    MemoryCacheDataSource* cache;
+    CountingDataSource* counter;
+    std::shared_ptr<TileSource> source;
+
+    CacheFixture(size_t _cacheSize) {
+        auto rawSources = std::make_unique<MemoryCacheDataSource>();
+        cache = rawSources.get();
+        cache->setCacheSize(_cacheSize);
+
+        auto next = std::make_unique<CountingDataSource>();
+        counter = next.get();
+        rawSources->setNext(std::move(next));
+
+        source = std::make_shared<TileSource>("test", std::move(rawSources));
+    }
+
+    bool load(TileID _tileId) {
+        auto task = source->createTask(_tileId);
+        bool loaded = false;
+        source->loadTileData(task, {[&](std::shared_ptr<TileTask> _task) {
+            loaded = _task->hasData();
+        }});
+        return loaded;
+    }
+};
+
+TEST_CASE("Cached tiles are not loaded again", "[MemoryCache]") {
+    CacheFixture fixture(1 << 20);
+
+    REQUIRE(fixture.load(TileID(1, 2, 3)));
+    REQUIRE(fixture.load(TileID(1, 2, 3)));
+    REQUIRE(fixture.counter->loads == 1);
+
+    auto stats = fixture.cache->stats();
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.entries == 1);
+    REQUIRE(stats.usage == 1024);
+
+    fixture.cache->clear();
+    REQUIRE(fixture.cache->stats().usage == 0);
+    REQUIRE(fixture.load(TileID(1, 2, 3)));
+    REQUIRE(fixture.counter->loads == 2);
+}
+
+TEST_CASE("Cache usage stays within the cache size", "[MemoryCache]") {
+    CacheFixture fixture(64 * 1024);
+
+    for (int x = 0; x < 256; x++) {
+        REQUIRE(fixture.load(TileID(x, 0, 8)));
+    }
+    auto stats = fixture.cache->stats();
+    REQUIRE(stats.usage <= 64 * 1024);
+    REQUIRE(stats.usage == stats.entries * 1024);
+    REQUIRE(stats.entries > 0);
+
+    fixture.cache->setCacheSize(16 * 1024);
+    REQUIRE(fixture.cache->stats().usage <= 16 * 1024);
+}
+
+TEST_CASE("Cache sizes beyond 2GB are accounted for", "[MemoryCache]") {
+    size_t cacheSize = size_t(8) << 30;
+    CacheFixture fixture(cacheSize);
+
+    REQUIRE(fixture.cache->stats().maxUsage == cacheSize);
+    REQUIRE(fixture.load(TileID(0, 0, 0)));
+    REQUIRE(fixture.load(TileID(0, 0, 0)));
+    REQUIRE(fixture.counter->loads == 1);
+}
+
+TEST_CASE("Concurrent cache reads and writes", "[MemoryCache]") {
+    CacheFixture fixture(256 * 1024);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> failed{0};
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 1000; i++) {
+                if (!fixture.load(TileID((i * 7 + t) % 512, 0, 9))) { failed++; }
+            }
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+
+    auto stats = fixture.cache->stats();
+    REQUIRE(failed == 0);
+    REQUIRE(stats.hits + stats.misses == 4000);
+    REQUIRE(stats.usage <= 256 * 1024);
+}
@@ -170,3 +170,27 @@ TEST_CASE( "Check overflow", "[Core][TypedMesh]" ) {
 
     checkBounds(mesh);
 }
+
+TEST_CASE( "Restore a serialized mesh", "[Core][TypedMesh]" ) {
+    auto mesh = std::make_shared<TestMesh>(layout, GL_TRIANGLES);
+    mesh->compile(MeshData<Vertex>({ 0, 1, 2, 2, 1, 3 }, std::vector<Vertex>(4, Vertex{1, 2, 3, 4})));
+
+    std::vector<char> data;
+    REQUIRE(mesh->serialize(data));
+
+    RawMesh restored(layout);
+    const char* begin = data.data();
+    REQUIRE(restored.deserialize(begin, data.data() + data.size()));
+    REQUIRE(begin == data.data() + data.size());
+    REQUIRE(restored.bufferSize() == mesh->bufferSize());
+
+    std::vector<char> restoredData;
+    REQUIRE(restored.serialize(restoredData));
+    REQUIRE(restoredData == data);
+
+    // Truncated data
+    RawMesh truncated(layout);
+    begin = data.data();
+    REQUIRE(!truncated.deserialize(begin, data.data() + data.size() - 1));
+    REQUIRE(begin == data.data());
+}
@@ -0,0 +1,250 @@
+#include "catch.hpp"
+
+#include "data/formats/mvt.h"
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "tile/tileTask.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+// Writes protobuf messages of the Mapbox Vector Tile format
+struct PbfWriter {
+    std::string data;
+
+    void varint(uint64_t _value) {
+        while (_value >= 0x80) {
+            data.push_back(char((_value & 0x7f) | 0x80));
+            _value >>= 7;
+        }
+        data.push_back(char(_value));
+    }
+
+    void field(uint32_t _tag, uint64_t _value) {
+        varint(_tag << 3);
+        varint(_value);
+    }
+
+    void bytes(uint32_t _tag, const std::string& _bytes) {
+        varint((_tag << 3) | 2);
+        varint(_bytes.size());
+        data += _bytes;
+    }
+
+    void packed(uint32_t _tag, const std::vector<uint32_t>& _values) {
+        PbfWriter values;
+        for (auto value : _values) { values.varint(value); }
+        bytes(_tag, values.data);
+    }
+};
+
+static uint32_t zigzag(int32_t _value) { return (_value << 1) ^ (_value >> 31); }
+
+static std::string feature(GeometryType _type, std::vector<uint32_t> _geometry, uint32_t _kind) {
+    PbfWriter feature;
+    feature.packed(2, { 0, _kind });
+    feature.field(3, _type);
+    feature.packed(4, _geometry);
+    return feature.data;
+}
+
+static std::string layer(const std::string& _name, const std::vector<std::string>& _features) {
+    PbfWriter layer;
+    layer.bytes(1, _name);
+    for (auto& feature : _features) { layer.bytes(2, feature); }
+    layer.bytes(3, "kind");
+    for (auto kind : { "a", "b" }) {
+        PbfWriter value;
+        value.bytes(1, kind);
+        layer.bytes(4, value.data);
+    }
+    layer.field(5, 4097);
+    return layer.data;
+}
+
+static std::string testTile() {
+    // Point at 2048/1024
+    auto point = feature(GeometryType::points, { (1 << 3) | 1, zigzag(2048), zigzag(1024) }, 0);
+    // Line from 0/0 to 4096/0 to 4096/4096
+    auto line = feature(GeometryType::lines, { (1 << 3) | 1, 0, 0, (2 << 3) | 2,
+                                               zigzag(4096), 0, 0, zigzag(4096) }, 1);
+    PbfWriter tile;
+    tile.bytes(3, layer("roads", { line, line }));
+    tile.bytes(3, layer("pois", { point }));
+    tile.bytes(3, layer("water", { line }));
+    return tile.data;
+}
+
+static std::shared_ptr<TileData> parse(TileSource& _source, const std::string& _tile) {
+    auto task = _source.createTask(TileID(0, 0, 0));
+    static_cast<BinaryTileTask&>(*task).rawTileData = TileBuffer::copy(_tile.data(), _tile.size());
+    return _source.parse(*task);
+}
+
+TEST_CASE("Only the collections used by the scene are parsed", "[Mvt]") {
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    source->setFormat(TileSource::Format::Mvt);
+
+    auto tile = testTile();
+
+    auto all = parse(*source, tile);
+    REQUIRE(all);
+    REQUIRE(all->layers.size() == 3);
+
+    source->addCollections({ "water", "pois" });
+    source->addCollections({ "pois" });
+    REQUIRE(source->collections() == std::vector<std::string>({ "pois", "water" }));
+
+    auto used = parse(*source, tile);
+    REQUIRE(used);
+    REQUIRE(used->layers.size() == 2);
+    REQUIRE(used->layers[0].name == "pois");
+    REQUIRE(used->layers[1].name == "water");
+    REQUIRE(used->layers[1].features.size() == 1);
+    REQUIRE(used->layers[1].features[0].props.getString("kind") == "b");
+}
+
+TEST_CASE("Feature geometry is decoded when it is used", "[Mvt]") {
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    source->setFormat(TileSource::Format::Mvt);
+
+    auto tileData = parse(*source, testTile());
+    REQUIRE(tileData);
+
+    const auto& roads = tileData->layers[0].features;
+    REQUIRE(roads.size() == 2);
+    REQUIRE(roads[0].geometryType == GeometryType::lines);
+    REQUIRE(roads[0].props.getString("kind") == "b");
+    REQUIRE(roads[0].lines().empty());
+
+    tileData->decodeGeometry(roads[0]);
+    tileData->decodeGeometry(roads[0]);
+    REQUIRE(roads[0].lines().size() == 1);
+    REQUIRE(roads[0].lines()[0].size() == 3);
+    REQUIRE(roads[0].lines()[0][0].x == Approx(0));
+    REQUIRE(roads[0].lines()[0][0].y == Approx(4097.f / 4096));
+    REQUIRE(roads[0].lines()[0][2].x == Approx(1));
+    REQUIRE(roads[0].lines()[0][2].y == Approx(1.f / 4096));
+
+    // Other features stay encoded
+    REQUIRE(roads[1].lines().empty());
+
+    const auto& point = tileData->layers[1].features[0];
+    tileData->decodeGeometry(point);
+    REQUIRE(point.points().size() == 1);
+    REQUIRE(point.points()[0].x == Approx(0.5));
+    REQUIRE(point.points()[0].y == Approx(3073.f / 4096));
+}
+
+TEST_CASE("Packed varints are decoded", "[Mvt]") {
+    std::vector<uint32_t> input = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 300, 0, 127, 128,
+                                    16384, 0xffffffff, 1, 2, 3, 4, 5, 6, 7, 8 };
+    PbfWriter data;
+    for (auto value : input) { data.varint(value); }
+
+    std::vector<uint32_t> output;
+    Mvt::decodeVarints(data.data.data(), data.data.data() + data.data.size(), output);
+    REQUIRE(output == input);
+
+    // Truncated
+    REQUIRE_THROWS(Mvt::decodeVarints(data.data.data(), data.data.data() + data.data.size() - 12, output));
+    // Longer than 32 bits
+    std::string tooLong = "\xff\xff\xff\xff\xff\x01";
+    REQUIRE_THROWS(Mvt::decodeVarints(tooLong.data(), tooLong.data() + tooLong.size(), output));
+}
+
+TEST_CASE("Polygon rings are closed and repeated points dropped", "[Mvt]") {
+    // Square with a repeated corner: 0/0 - 4096/0 - 4096/0 - 4096/4096 - 0/4096 - close
+    auto square = feature(GeometryType::polygons, { (1 << 3) | 1, 0, 0, (4 << 3) | 2,
+                                                    zigzag(4096), 0, 0, 0, 0, zigzag(4096),
+                                                    zigzag(-4096), 0, (1 << 3) | 7 }, 0);
+    PbfWriter tile;
+    tile.bytes(3, layer("buildings", { square }));
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    source->setFormat(TileSource::Format::Mvt);
+
+    auto tileData = parse(*source, tile.data);
+    REQUIRE(tileData);
+
+    const auto& building = tileData->layers[0].features[0];
+    tileData->decodeGeometry(building);
+    REQUIRE(building.polygons().size() == 1);
+
+    auto ring = building.polygons()[0][0];
+    REQUIRE(ring.size() == 5);
+    REQUIRE(ring.front() == ring.back());
+}
+
+TEST_CASE("The exterior winding of each layer is set by its first polygon", "[Mvt]") {
+    // Square with a square hole, the rings in the order of @_exterior
+    auto squareWithHole = [](std::vector<std::pair<int, int>> _exterior) {
+        std::vector<std::pair<int, int>> hole;
+        for (auto it = _exterior.rbegin(); it != _exterior.rend(); ++it) {
+            hole.emplace_back(1024 + it->first / 2, 1024 + it->second / 2);
+        }
+        std::vector<uint32_t> geometry;
+        int x = 0, y = 0;
+        for (auto& ring : { _exterior, hole }) {
+            for (size_t i = 0; i < ring.size(); i++) {
+                if (i == 0) { geometry.push_back((1 << 3) | 1); }
+                if (i == 1) { geometry.push_back(((ring.size() - 1) << 3) | 2); }
+                geometry.push_back(zigzag(ring[i].first - x));
+                geometry.push_back(zigzag(ring[i].second - y));
+                x = ring[i].first;
+                y = ring[i].second;
+            }
+            geometry.push_back((1 << 3) | 7);
+        }
+        return feature(GeometryType::polygons, geometry, 0);
+    };
+    PbfWriter tile;
+    tile.bytes(3, layer("a", { squareWithHole({ {0, 0}, {4096, 0}, {4096, 4096}, {0, 4096} }) }));
+    tile.bytes(3, layer("b", { squareWithHole({ {0, 0}, {0, 4096}, {4096, 4096}, {4096, 0} }) }));
+
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    source->setFormat(TileSource::Format::Mvt);
+
+    auto tileData = parse(*source, tile.data);
+    REQUIRE(tileData);
+
+    // Decoded in another order than the layers were parsed
+    const auto& a = tileData->layers[0].features[0];
+    const auto& b = tileData->layers[1].features[0];
+    tileData->decodeGeometry(b);
+    tileData->decodeGeometry(a);
+
+    for (auto* building : { &a, &b }) {
+        REQUIRE(building->polygons().size() == 1);
+        REQUIRE(building->polygons()[0].size() == 2);
+    }
+}
+
+TEST_CASE("Features of a shared tile are decoded once by concurrent builders", "[Mvt]") {
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    source->setFormat(TileSource::Format::Mvt);
+
+    auto tileData = parse(*source, testTile());
+    REQUIRE(tileData);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&]() {
+            for (int k = 0; k < 100; k++) {
+                for (auto& layer : tileData->layers) {
+                    for (auto& feature : layer.features) { tileData->decodeGeometry(feature); }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+
+    for (auto& layer : tileData->layers) {
+        for (auto& feature : layer.features) { REQUIRE(feature.points().size() > 0); }
+    }
+    REQUIRE(tileData->layers[0].features[0].lines().size() == 1);
+    REQUIRE(tileData->layers[0].features[0].lines()[0].size() == 3);
+}
@@ -0,0 +1,307 @@
+#include "catch.hpp"
+
+#include "data/networkDataSource.h"
+#include "data/tileSource.h"
+#include "mockPlatform.h"
+#include "tile/tileTask.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+// Responds to URL requests when told to
+class DeferredPlatform : public MockPlatform {
+public:
+    std::vector<std::pair<std::string, UrlCallback>> requests;
+    std::vector<UrlRequestHandle> canceled;
+
+    UrlRequestHandle startUrlRequest(Url _url, UrlCallback _callback) override {
+        requests.emplace_back(_url.string(), std::move(_callback));
+        return requests.size();
+    }
+
+    void cancelUrlRequest(UrlRequestHandle _request) override {
+        canceled.push_back(_request);
+    }
+
+    void respond(size_t _index, std::string _content,
+                 std::chrono::steady_clock::time_point _transferStart = {}) {
+        UrlResponse response;
+        response.content.assign(_content.begin(), _content.end());
+        response.transferStart = _transferStart;
+        requests[_index].second(std::move(response));
+    }
+
+    void fail(size_t _index, int _httpStatus = 503) {
+        UrlResponse response;
+        response.error = "failed";
+        response.httpStatus = _httpStatus;
+        requests[_index].second(std::move(response));
+    }
+};
+
+static std::shared_ptr<TileSource> createSource(std::shared_ptr<Platform> _platform,
+                                                std::string _urlTemplate = "https://tiles/{z}/{x}/{y}.mvt",
+                                                std::vector<std::string> _subdomains = {}) {
+    auto network = std::make_unique<NetworkDataSource>(_platform, _urlTemplate,
+                                                       std::move(_subdomains), false);
+    return std::make_shared<TileSource>("test", std::move(network));
+}
+
+static std::shared_ptr<TileSource> createLimitedSource(std::shared_ptr<Platform> _platform,
+                                                       double _limit, NetworkDataSource*& _network) {
+    RequestLimiter::Options options;
+    options.initialLimit = _limit;
+    // Only errors reduce the limit, the latencies of these requests are arbitrary
+    options.latencyTolerance = std::numeric_limits<double>::max();
+    auto network = std::make_unique<NetworkDataSource>(_platform, "https://tiles/{z}/{x}/{y}.mvt",
+                                                       std::vector<std::string>{}, false, options);
+    _network = network.get();
+    return std::make_shared<TileSource>("test", std::move(network));
+}
+
+TEST_CASE("Requests for the same tile URL share one request", "[NetworkDataSource]") {
+    auto platform = std::make_shared<DeferredPlatform>();
+    auto sourceA = createSource(platform);
+    auto sourceB = createSource(platform);
+
+    int loaded = 0;
+    TileTaskCb cb{[&](std::shared_ptr<TileTask> _task) {
+        auto& task = static_cast<BinaryTileTask&>(*_task);
+        if (task.hasData() && std::string(task.rawTileData->data(), task.rawTileData->size()) == "tile") {
+            loaded++;
+        }
+    }};
+
+    auto taskA = sourceA->createTask(TileID(1, 2, 3));
+    auto taskB = sourceB->createTask(TileID(1, 2, 3));
+    auto taskC = sourceA->createTask(TileID(2, 2, 3));
+
+    sourceA->loadTileData(taskA, cb);
+    sourceB->loadTileData(taskB, cb);
+    sourceA->loadTileData(taskC, cb);
+
+    REQUIRE(platform->requests.size() == 2);
+    REQUIRE(platform->requests[0].first == "https://tiles/3/1/2.mvt");
+
+    platform->respond(0, "tile");
+    REQUIRE(loaded == 2);
+
+    // Requested again after the response
+    auto taskD = sourceA->createTask(TileID(1, 2, 3));
+    sourceA->loadTileData(taskD, cb);
+    REQUIRE(platform->requests.size() == 3);
+}
+
+TEST_CASE("Shared requests are canceled when all tasks are canceled", "[NetworkDataSource]") {
+    auto platform = std::make_shared<DeferredPlatform>();
+    auto source = createSource(platform);
+
+    int loaded = 0;
+    TileTaskCb cb{[&](std::shared_ptr<TileTask> _task) { loaded++; }};
+
+    auto proxy = source->createTask(TileID(1, 2, 3));
+    auto visible = source->createTask(TileID(1, 2, 3));
+
+    source->loadTileData(proxy, cb);
+    source->loadTileData(visible, cb);
+    REQUIRE(platform->requests.size() == 1);
+
+    proxy->cancel();
+    source->cancelLoadingTile(*proxy);
+    REQUIRE(platform->canceled.empty());
+
+    visible->cancel();
+    source->cancelLoadingTile(*visible);
+    REQUIRE(platform->canceled.size() == 1);
+    REQUIRE(platform->canceled[0] == 1);
+
+    // The callback of canceled requests still runs
+    platform->respond(0, "tile");
+    REQUIRE(loaded == 0);
+}
+
+TEST_CASE("Tiles are requested from the same subdomain", "[NetworkDataSource]") {
+    auto platform = std::make_shared<DeferredPlatform>();
+    auto source = createSource(platform, "https://{s}tiles/{z}/{x}/{y}.mvt", { "a.", "b." });
+
+    TileTaskCb cb{[](std::shared_ptr<TileTask> _task) {}};
+
+    for (int i = 0; i < 2; i++) {
+        source->loadTileData(source->createTask(TileID(1, 2, 3)), cb);
+        source->loadTileData(source->createTask(TileID(2, 2, 3)), cb);
+    }
+
+    REQUIRE(platform->requests.size() == 2);
+    REQUIRE(platform->requests[0].first == "https://b.tiles/3/1/2.mvt");
+    REQUIRE(platform->requests[1].first == "https://a.tiles/3/2/2.mvt");
+}
+
+TEST_CASE("Requests beyond the limit wait and start by priority", "[NetworkDataSource]") {
+    auto platform = std::make_shared<DeferredPlatform>();
+    NetworkDataSource* network = nullptr;
+    auto source = createLimitedSource(platform, 2, network);
+
+    int loaded = 0;
+    TileTaskCb cb{[&](std::shared_ptr<TileTask> _task) { loaded++; }};
+
+    std::vector<std::shared_ptr<TileTask>> tasks;
+    std::vector<double> priorities = { 0, 1, 5, 3, 4 };
+    for (int x = 0; x < 5; x++) {
+        auto task = source->createTask(TileID(x, 0, 3));
+        task->setPriority(priorities[x]);
+        source->loadTileData(task, cb);
+        tasks.push_back(task);
+    }
+
+    REQUIRE(platform->requests.size() == 2);
+    auto stats = network->metrics();
+    REQUIRE(stats.queued == 3);
+    REQUIRE(stats.limiter.inFlight == 2);
+
+    // Joins the queued request
+    auto proxy = source->createTask(TileID(2, 0, 3));
+    proxy->setPriority(6);
+    source->loadTileData(proxy, cb);
+    REQUIRE(network->metrics().queued == 3);
+
+    // Raised priority while waiting
+    tasks[4]->setPriority(2);
+
+    platform->respond(0, "tile");
+    REQUIRE(platform->requests.size() == 3);
+    REQUIRE(platform->requests[2].first == "https://tiles/3/4/0.mvt");
+
+    // Queued requests are removed without a platform request
+    tasks[3]->cancel();
+    source->cancelLoadingTile(*tasks[3]);
+    REQUIRE(network->metrics().queued == 1);
+    REQUIRE(platform->canceled.empty());
+
+    platform->respond(1, "tile");
+    REQUIRE(platform->requests.size() == 4);
+    REQUIRE(platform->requests[3].first == "https://tiles/3/2/0.mvt");
+
+    platform->respond(2, "tile");
+    platform->respond(3, "tile");
+    REQUIRE(loaded == 5);
+
+    stats = network->metrics();
+    REQUIRE(stats.queued == 0);
+    REQUIRE(stats.limiter.inFlight == 0);
+    REQUIRE(stats.limiter.succeeded == 4);
+}
+
+TEST_CASE("Failed requests reduce the number of concurrent requests", "[NetworkDataSource]") {
+    auto platform = std::make_shared<DeferredPlatform>();
+    NetworkDataSource* network = nullptr;
+    auto source = createLimitedSource(platform, 4, network);
+
+    TileTaskCb cb{[](std::shared_ptr<TileTask> _task) {}};
+
+    for (int x = 0; x < 8; x++) {
+        source->loadTileData(source->createTask(TileID(x, 0, 4)), cb);
+    }
+    REQUIRE(platform->requests.size() == 4);
+
+    platform->fail(0);
+    auto stats = network->metrics();
+    REQUIRE(stats.limiter.limit == 2);
+    REQUIRE(stats.limiter.failed == 1);
+
+    // Three requests are still running, above the new limit
+    REQUIRE(platform->requests.size() == 4);
+    platform->respond(1, "tile");
+    platform->respond(2, "tile");
+    REQUIRE(platform->requests.size() == 5);
+    REQUIRE(network->metrics().limiter.inFlight == 2);
+}
+
+TEST_CASE("Missing tiles do not reduce the number of concurrent requests", "[NetworkDataSource]") {
+    auto platform = std::make_shared<DeferredPlatform>();
+    NetworkDataSource* network = nullptr;
+    auto source = createLimitedSource(platform, 4, network);
+
+    TileTaskCb cb{[](std::shared_ptr<TileTask> _task) {}};
+
+    for (int x = 0; x < 8; x++) {
+        source->loadTileData(source->createTask(TileID(x, 0, 4)), cb);
+    }
+
+    platform->fail(0, 404);
+    auto stats = network->metrics();
+    REQUIRE(stats.limiter.limit == 4);
+    REQUIRE(stats.limiter.failed == 1);
+    REQUIRE(stats.limiter.decreases == 0);
+
+    // The freed slot starts the next request
+    REQUIRE(platform->requests.size() == 5);
+}
+
+TEST_CASE("Request latency is measured from the start of the transfer", "[NetworkDataSource]") {
+    auto platform = std::make_shared<DeferredPlatform>();
+    NetworkDataSource* network = nullptr;
+    auto source = createLimitedSource(platform, 4, network);
+
+    TileTaskCb cb{[](std::shared_ptr<TileTask> _task) {}};
+    source->loadTileData(source->createTask(TileID(0, 0, 4)), cb);
+    source->loadTileData(source->createTask(TileID(1, 0, 4)), cb);
+
+    // Both requests wait in the queue of the platform, the first one starts
+    // its transfer right before the response
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    platform->respond(0, "tile", std::chrono::steady_clock::now());
+    REQUIRE(network->metrics().limiter.latencyMs < 50);
+
+    // Without the transfer start the latency includes the wait
+    platform->respond(1, "tile");
+    auto stats = network->metrics();
+    REQUIRE(stats.limiter.baseLatencyMs < 50);
+    REQUIRE(stats.limiter.latencyMs > stats.limiter.baseLatencyMs);
+}
+
+TEST_CASE("Queued requests are dropped with their NetworkDataSource", "[NetworkDataSource]") {
+    auto platform = std::make_shared<DeferredPlatform>();
+    NetworkDataSource* network = nullptr;
+    auto source = createLimitedSource(platform, 1, network);
+
+    int loaded = 0;
+    TileTaskCb cb{[&](std::shared_ptr<TileTask> _task) { loaded++; }};
+
+    source->loadTileData(source->createTask(TileID(0, 0, 3)), cb);
+    source->loadTileData(source->createTask(TileID(1, 0, 3)), cb);
+    REQUIRE(platform->requests.size() == 1);
+
+    source.reset();
+    platform->respond(0, "tile");
+    REQUIRE(platform->requests.size() == 1);
+    REQUIRE(loaded == 0);
+
+    // Not shared with the dropped request
+    auto other = createSource(platform);
+    other->loadTileData(other->createTask(TileID(1, 0, 3)), cb);
+    REQUIRE(platform->requests.size() == 2);
+}
+
+TEST_CASE("Tiles of network sources are versioned by URL and expire", "[NetworkDataSource]") {
+    auto platform = std::make_shared<DeferredPlatform>();
+
+    auto source = createSource(platform, "https://{s}.tiles/{z}/{x}/{y}.mvt", { "a", "b" });
+    REQUIRE(source->dataVersion() == "https://{s}.tiles/{z}/{x}/{y}.mvt,a,b");
+    REQUIRE(source->dataMaxAge() == NetworkDataSource::DEFAULT_MAX_AGE);
+
+    auto other = createSource(platform, "https://{s}.tiles/v2/{z}/{x}/{y}.mvt", { "a", "b" });
+    REQUIRE(other->dataVersion() != source->dataVersion());
+
+    auto network = std::make_unique<NetworkDataSource>(platform, "https://tiles/{z}/{x}/{y}.mvt",
+                                                       std::vector<std::string>{}, true);
+    network->setMaxAge(std::chrono::seconds(60));
+    TileSource tms("tms", std::move(network));
+    REQUIRE(tms.dataVersion() == "https://tiles/{z}/{x}/{y}.mvt,tms");
+    REQUIRE(tms.dataMaxAge() == std::chrono::seconds(60));
+}
@@ -0,0 +1,145 @@
+#include "catch.hpp"
+
+#include "data/offlineRegion.h"
+#include "data/tileSource.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace Tangram;
+
+static LngLat tileCoordinates(double _x, double _y, int _z) {
+    return MapProjection::projectedMetersToLngLat(
+        MapProjection::tileCoordinatesToProjectedMeters({ _x, _y, _z }));
+}
+
+// Completes requested tiles when told to, without data for tiles with odd x
+struct ManualDataSource : TileSource::DataSource {
+    std::mutex mutex;
+    std::vector<std::pair<std::shared_ptr<TileTask>, TileTaskCb>> requests;
+    size_t maxRequests = 0;
+    size_t canceled = 0;
+
+    bool loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.emplace_back(_task, _cb);
+        maxRequests = std::max(maxRequests, requests.size());
+        return true;
+    }
+
+    void cancelLoadingTile(TileTask& _task) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        canceled++;
+    }
+
+    void complete() {
+        std::vector<std::pair<std::shared_ptr<TileTask>, TileTaskCb>> completed;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::swap(completed, requests);
+        }
+        for (auto& request : completed) {
+            if (request.first->tileId().x % 2 == 0) {
+                auto& task = static_cast<BinaryTileTask&>(*request.first);
+                task.rawTileData = TileBuffer::copy("x", 1);
+            }
+            request.second.func(request.first);
+        }
+    }
+
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return requests.size();
+    }
+};
+
+TEST_CASE("Enumerate the tiles of a bounding box", "[OfflineRegion]") {
+    auto region = OfflineRegion::fromBounds(tileCoordinates(1.3, 2.6, 3), tileCoordinates(3.3, 1.3, 3), 3, 4);
+
+    auto tiles = region.tileIDs();
+
+    // z3: x 1-3, y 1-2; z4: x 2-6, y 2-5
+    REQUIRE(tiles.size() == 6 + 20);
+    REQUIRE(std::count(tiles.begin(), tiles.end(), TileID(1, 1, 3)) == 1);
+    REQUIRE(std::count(tiles.begin(), tiles.end(), TileID(6, 5, 4)) == 1);
+    REQUIRE(std::count(tiles.begin(), tiles.end(), TileID(7, 5, 4)) == 0);
+    REQUIRE(tiles.front().z == 3);
+    REQUIRE(tiles.back().z == 4);
+}
+
+TEST_CASE("Enumerate only the tiles intersecting a polygon", "[OfflineRegion]") {
+    OfflineRegion region({
+            tileCoordinates(0.1, 0.1, 2),
+            tileCoordinates(3.7, 0.1, 2),
+            tileCoordinates(0.1, 3.7, 2)
+        }, 2, 2);
+
+    auto tiles = region.tileIDs();
+
+    // Tiles with x + y <= 3
+    REQUIRE(tiles.size() == 10);
+    for (const auto& tile : tiles) {
+        REQUIRE(tile.x + tile.y <= 3);
+    }
+}
+
+TEST_CASE("Download the tiles of a region with a bounded number of requests", "[OfflineRegion]") {
+    auto dataSource = std::make_unique<ManualDataSource>();
+    auto& manual = *dataSource;
+    auto source = std::make_shared<TileSource>("test", std::move(dataSource));
+
+    auto region = OfflineRegion::fromBounds(tileCoordinates(1.3, 2.6, 3), tileCoordinates(3.3, 1.3, 3), 3, 4);
+    OfflineDownload download(source, region, 4);
+
+    std::vector<OfflineDownload::Progress> reports;
+    download.start([&](const OfflineDownload::Progress& _progress) {
+        reports.push_back(_progress);
+    });
+
+    while (!download.progress().done) {
+        manual.complete();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    REQUIRE(!download.wait());
+    REQUIRE(manual.maxRequests <= 4);
+
+    auto progress = download.progress();
+    REQUIRE(progress.total == 26);
+    REQUIRE(progress.completed + progress.failed == 26);
+    // Odd columns: z3 x 1, 3; z4 x 3, 5
+    REQUIRE(progress.failed == 2 * 2 + 2 * 4);
+
+    REQUIRE(!reports.empty());
+    REQUIRE(reports.back().done);
+    REQUIRE(reports.back().completed == progress.completed);
+}
+
+TEST_CASE("Cancel the running requests of a download", "[OfflineRegion]") {
+    auto dataSource = std::make_unique<ManualDataSource>();
+    auto& manual = *dataSource;
+    auto source = std::make_shared<TileSource>("test", std::move(dataSource));
+
+    OfflineDownload download(source, OfflineRegion::fromBounds({ -10, -10 }, { 10, 10 }, 0, 8), 8);
+    download.start();
+
+    while (manual.pending() < 8) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    download.cancel();
+    REQUIRE(!download.wait());
+
+    // Requests which complete after cancelation are ignored
+    manual.complete();
+
+    auto progress = download.progress();
+    REQUIRE(progress.canceled);
+    REQUIRE(!progress.done);
+    REQUIRE(progress.completed == 0);
+    REQUIRE(manual.canceled == 8);
+}
@@ -0,0 +1,141 @@
+#include "catch.hpp"
+
+#include "data/properties.h"
+#include "data/propertyItem.h"
+#include "data/propertyKey.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+TEST_CASE("Property keys are interned", "[Properties]") {
+    auto key = PropertyKey::intern("propertiesTests:kind");
+    REQUIRE(key.isValid());
+    REQUIRE(key.name() == "propertiesTests:kind");
+    REQUIRE(PropertyKey::intern(std::string("propertiesTests:") + "kind") == key);
+    REQUIRE(PropertyKey::find("propertiesTests:kind") == key);
+
+    REQUIRE_FALSE(PropertyKey::find("propertiesTests:unknown").isValid());
+    REQUIRE(PropertyKey().name().empty());
+
+    // Interned by all threads with the same ids
+    std::vector<std::thread> threads;
+    std::vector<PropertyKey> keys(8);
+    for (size_t i = 0; i < keys.size(); i++) {
+        threads.emplace_back([&, i]() {
+            for (int k = 0; k < 100; k++) {
+                PropertyKey::intern("propertiesTests:" + std::to_string(k));
+            }
+            keys[i] = PropertyKey::intern("propertiesTests:50");
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+    for (auto& k : keys) {
+        REQUIRE(k == keys[0]);
+        REQUIRE(k.name() == "propertiesTests:50");
+    }
+}
+
+TEST_CASE("Property keys are found while new keys are interned", "[Properties]") {
+    auto kind = PropertyKey::intern("propertiesTests:found");
+
+    std::vector<std::thread> threads;
+    std::vector<int> found(4, 1);
+    for (size_t i = 0; i < found.size(); i++) {
+        threads.emplace_back([&, i]() {
+            for (int k = 0; k < 10000; k++) {
+                if (i % 2 == 0) {
+                    PropertyKey::intern("propertiesTests:new" + std::to_string(i) + ":" + std::to_string(k));
+                } else if (PropertyKey::find("propertiesTests:found") != kind ||
+                           kind.name() != "propertiesTests:found") {
+                    found[i] = 0;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+    for (int f : found) { REQUIRE(f == 1); }
+    REQUIRE(PropertyKey::find("propertiesTests:new2:9999").name() == "propertiesTests:new2:9999");
+}
+
+TEST_CASE("The property key table grows with the interned names", "[Properties]") {
+    auto kind = PropertyKey::intern("propertiesTests:kind");
+    uint32_t count = PropertyKey::count();
+
+    // Many more names than the initial table holds, e.g. localized names
+    std::vector<PropertyKey> keys;
+    for (int i = 0; i < 100000; i++) {
+        keys.push_back(PropertyKey::intern("propertiesTests:name:" + std::to_string(i)));
+    }
+    REQUIRE(PropertyKey::count() == count + 100000);
+
+    int found = 0;
+    for (int i = 0; i < 100000; i++) {
+        auto name = "propertiesTests:name:" + std::to_string(i);
+        if (keys[i].isValid() && keys[i].name() == name && PropertyKey::find(name) == keys[i]) { found++; }
+    }
+    REQUIRE(found == 100000);
+    REQUIRE(PropertyKey::find("propertiesTests:kind") == kind);
+    REQUIRE(kind.name() == "propertiesTests:kind");
+}
+
+TEST_CASE("Properties are found by key", "[Properties]") {
+    Properties props;
+    props.set("name", "Main Street");
+    props.set("kind", "road");
+    props.set("lanes", 2);
+    props.set("kind", "street");
+
+    REQUIRE(props.items().size() == 3);
+    REQUIRE(props.getString("name") == "Main Street");
+    REQUIRE(props.getString("kind") == "street");
+    REQUIRE(props.getNumber("lanes") == 2);
+    REQUIRE(props.get(PropertyKey::intern("lanes")).is<double>());
+
+    REQUIRE_FALSE(props.contains("propertiesTests:missing"));
+    REQUIRE_FALSE(props.contains(PropertyKey()));
+
+    // Sorted by key
+    for (size_t i = 1; i < props.items().size(); i++) {
+        REQUIRE(props.items()[i - 1].key < props.items()[i].key);
+    }
+}
+
+TEST_CASE("Properties share values until they are modified", "[Properties]") {
+    // Value table of a tile layer
+    auto values = std::make_shared<PropertyValues>();
+    values->push_back(std::string("water"));
+    values->push_back(std::string("ocean"));
+
+    auto kind = PropertyKey::intern("kind");
+    auto name = PropertyKey::intern("name");
+
+    std::vector<Properties::Item> items;
+    items.emplace_back(kind, &(*values)[0]);
+    items.emplace_back(name, &(*values)[1]);
+    std::sort(items.begin(), items.end());
+
+    Properties feature;
+    feature.setSorted(std::move(items), values);
+    REQUIRE(&feature.get(kind) == &(*values)[0]);
+
+    Properties copy = feature;
+    REQUIRE(&copy.get(name) == &(*values)[1]);
+
+    copy.set("name", "sea");
+    REQUIRE(copy.getString("name") == "sea");
+    REQUIRE(copy.getString("kind") == "water");
+    REQUIRE(&copy.get(kind) != &(*values)[0]);
+
+    // The shared values are unchanged
+    REQUIRE(feature.getString("name") == "ocean");
+    REQUIRE((*values)[1].get<std::string>() == "ocean");
+
+    // Values outlive the table owner
+    values.reset();
+    REQUIRE(feature.getString("kind") == "water");
+}
@@ -0,0 +1,189 @@
+#include "catch.hpp"
+
+#include "data/requestLimiter.h"
+
+using namespace Tangram;
+
+using Clock = RequestLimiter::Clock;
+using std::chrono::milliseconds;
+
+// Starts requests up to the limit and completes them with @_latency
+static void runRound(RequestLimiter& _limiter, Clock::time_point& _now, milliseconds _latency) {
+    size_t count = 0;
+    while (_limiter.canStart()) {
+        _limiter.onStart();
+        count++;
+    }
+    auto start = _now;
+    _now += _latency;
+    for (size_t i = 0; i < count; i++) {
+        _limiter.onSuccess(start, _now);
+    }
+}
+
+TEST_CASE("Limit grows while responses are fast and the limit is in use", "[RequestLimiter]") {
+    RequestLimiter::Options options;
+    options.initialLimit = 2;
+    options.maxLimit = 8;
+    RequestLimiter limiter(options);
+
+    Clock::time_point now;
+    REQUIRE(limiter.canStart());
+
+    // Grows by up to one request per round
+    runRound(limiter, now, milliseconds(50));
+    REQUIRE(limiter.metrics().limit > 2);
+    REQUIRE(limiter.metrics().limit <= 3);
+
+    for (int i = 0; i < 40; i++) {
+        runRound(limiter, now, milliseconds(50));
+    }
+    auto metrics = limiter.metrics();
+    REQUIRE(metrics.limit == 8);
+    REQUIRE(metrics.inFlight == 0);
+    REQUIRE(metrics.baseLatencyMs == 50);
+    REQUIRE(metrics.decreases == 0);
+
+    // Unused capacity does not grow the limit
+    options.initialLimit = 4;
+    RequestLimiter idle(options);
+    for (int i = 0; i < 10; i++) {
+        idle.onStart();
+        idle.onSuccess(now, now + milliseconds(50));
+    }
+    REQUIRE(idle.metrics().limit == 4);
+}
+
+TEST_CASE("Limit backs off on failures and slow responses", "[RequestLimiter]") {
+    RequestLimiter::Options options;
+    options.initialLimit = 16;
+    options.maxLimit = 16;
+    RequestLimiter limiter(options);
+
+    Clock::time_point now;
+    for (int i = 0; i < 16; i++) { limiter.onStart(); }
+    REQUIRE_FALSE(limiter.canStart());
+
+    for (int i = 0; i < 8; i++) { limiter.onSuccess(now, now + milliseconds(20)); }
+    REQUIRE(limiter.metrics().baseLatencyMs == 20);
+
+    // Average latency beyond twice the base latency
+    auto end = now + milliseconds(100);
+    limiter.onSuccess(now, end);
+    REQUIRE(limiter.metrics().limit == 16);
+    limiter.onSuccess(now, end);
+    REQUIRE(limiter.metrics().limit == 8);
+
+    // Requests that started before the decrease count once
+    for (int i = 0; i < 4; i++) {
+        limiter.onFailure(now, end + milliseconds(i), true);
+    }
+    auto metrics = limiter.metrics();
+    REQUIRE(metrics.limit == 8);
+    REQUIRE(metrics.failed == 4);
+    REQUIRE(metrics.decreases == 1);
+    REQUIRE(metrics.inFlight == 2);
+
+    // A request started after the decrease backs off again
+    limiter.onStart();
+    limiter.onFailure(end + milliseconds(10), end + milliseconds(20), true);
+    REQUIRE(limiter.metrics().limit == 4);
+
+    // Not below the minimum
+    for (int i = 0; i < 10; i++) {
+        auto start = end + milliseconds(100 * (i + 1));
+        limiter.onStart();
+        limiter.onFailure(start, start + milliseconds(10), true);
+    }
+    REQUIRE(limiter.metrics().limit == options.minLimit);
+
+    // Canceled requests free their slot only
+    while (limiter.metrics().inFlight > 0) { limiter.onCancel(); }
+    REQUIRE(limiter.canStart());
+    REQUIRE(limiter.metrics().limit == options.minLimit);
+}
+
+TEST_CASE("Limit grows with responses of mixed latency", "[RequestLimiter]") {
+    RequestLimiter::Options options;
+    options.initialLimit = 2;
+    options.maxLimit = 16;
+    RequestLimiter limiter(options);
+
+    // Small tiles arrive in 10 ms, every fourth tile is dense and takes 40 ms
+    Clock::time_point now;
+    int responses = 0;
+    for (int round = 0; round < 60; round++) {
+        size_t count = 0;
+        while (limiter.canStart()) {
+            limiter.onStart();
+            count++;
+        }
+        auto start = now;
+        now += milliseconds(40);
+        for (size_t i = 0; i < count; i++) {
+            limiter.onSuccess(start, start + milliseconds(++responses % 4 == 0 ? 40 : 10));
+        }
+    }
+    auto metrics = limiter.metrics();
+    REQUIRE(metrics.baseLatencyMs > 10);
+    REQUIRE(metrics.decreases == 0);
+    REQUIRE(metrics.limit == 16);
+
+    // Backs off once the average latency doubles
+    runRound(limiter, now, milliseconds(60));
+    REQUIRE(limiter.metrics().decreases == 1);
+    REQUIRE(limiter.metrics().limit == 8);
+}
+
+TEST_CASE("Only failures caused by congestion reduce the limit", "[RequestLimiter]") {
+    RequestLimiter::Options options;
+    options.initialLimit = 16;
+    options.maxLimit = 16;
+    RequestLimiter limiter(options);
+
+    REQUIRE_FALSE(RequestLimiter::isCongestion(404, false));
+    REQUIRE_FALSE(RequestLimiter::isCongestion(0, false));
+    REQUIRE(RequestLimiter::isCongestion(429, false));
+    REQUIRE(RequestLimiter::isCongestion(503, false));
+    REQUIRE(RequestLimiter::isCongestion(0, true));
+
+    Clock::time_point now;
+    for (int i = 0; i < 4; i++) { limiter.onStart(); }
+
+    // Missing tiles
+    limiter.onFailure(now, now + milliseconds(10), RequestLimiter::isCongestion(404, false));
+    REQUIRE(limiter.metrics().limit == 16);
+    REQUIRE(limiter.metrics().failed == 1);
+    REQUIRE(limiter.metrics().decreases == 0);
+
+    limiter.onFailure(now, now + milliseconds(20), RequestLimiter::isCongestion(429, false));
+    REQUIRE(limiter.metrics().limit == 8);
+
+    limiter.onStart();
+    limiter.onFailure(now + milliseconds(30), now + milliseconds(40), RequestLimiter::isCongestion(0, true));
+    REQUIRE(limiter.metrics().limit == 4);
+    REQUIRE(limiter.metrics().failed == 3);
+    REQUIRE(limiter.metrics().inFlight == 2);
+}
+
+TEST_CASE("Limit recovers after a latency spike", "[RequestLimiter]") {
+    RequestLimiter::Options options;
+    options.initialLimit = 8;
+    options.maxLimit = 8;
+    options.baseLatencyWindow = 10;
+    RequestLimiter limiter(options);
+
+    Clock::time_point now;
+    runRound(limiter, now, milliseconds(20));
+    runRound(limiter, now, milliseconds(200));
+    REQUIRE(limiter.metrics().limit == 4);
+
+    // The base latency follows the server after two windows
+    for (int i = 0; i < 40; i++) {
+        runRound(limiter, now, milliseconds(200));
+    }
+    auto metrics = limiter.metrics();
+    REQUIRE(metrics.baseLatencyMs == Approx(200));
+    REQUIRE(metrics.limit == 8);
+    REQUIRE(metrics.latencyMs == Approx(200));
+}
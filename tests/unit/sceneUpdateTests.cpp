@@ -4,6 +4,7 @@
 #include "map.h"
 #include "mockPlatform.h"
 #include "scene/scene.h"
+#include "scene/sceneDiff.h"
 #include "scene/sceneLoader.h"
 #include "style/style.h"
 
@@ -249,3 +250,105 @@ TEST_CASE("Scene update statuses") {
     CHECK(scene.errors.front().error == Error::scene_update_value_yaml_syntax_error);
     scene.errors.clear();
 }
+
+const static std::string styledSceneString = R"END(
+layers:
+    roads:
+        data: { source: osm }
+        draw:
+            lines:
+                color: red
+                width: 2px
+    water:
+        data: { source: osm }
+        draw:
+            polygons:
+                color: blue
+)END";
+
+std::shared_ptr<Scene> updateScene(std::shared_ptr<Platform> _platform, const Scene& _scene,
+                                   const std::vector<SceneUpdate>& _updates) {
+    auto scene = std::make_shared<Scene>();
+    scene->copyConfig(_scene);
+    REQUIRE(SceneLoader::applyUpdates(_platform, *scene, _updates));
+    REQUIRE(SceneLoader::applyConfig(_platform, scene));
+    return scene;
+}
+
+TEST_CASE("Scene diff marks styles of changed draw rules") {
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    auto scene = std::make_shared<Scene>(platform, Url());
+    REQUIRE(loadConfig(styledSceneString, scene->config()));
+    REQUIRE(SceneLoader::applyConfig(platform, scene));
+
+    auto nextScene = updateScene(platform, *scene, {{"layers.roads.draw.lines.color", "green"}});
+    auto diff = SceneDiff::compare(*scene, *nextScene);
+
+    CHECK(diff.partial);
+    CHECK(diff.baseSceneId == scene->id);
+    CHECK(diff.affects(*nextScene->findStyle("lines")));
+    CHECK(!diff.affects(*nextScene->findStyle("polygons")));
+    // Label styles are only rebuilt when they are affected
+    CHECK(!diff.affects(*nextScene->findStyle("text")));
+
+    nextScene = updateScene(platform, *scene, {{"layers.water.enabled", "false"}});
+    diff = SceneDiff::compare(*scene, *nextScene);
+
+    CHECK(diff.partial);
+    CHECK(!diff.affects(*nextScene->findStyle("lines")));
+    CHECK(diff.affects(*nextScene->findStyle("polygons")));
+}
+
+const static std::string functionSceneString = R"END(
+global:
+    theme: dark
+    road_color: red
+layers:
+    roads:
+        data: { source: osm }
+        draw:
+            lines:
+                color: global.road_color
+                width: 2px
+    water:
+        data: { source: osm }
+        filter: function() { return global.theme === 'dark'; }
+        draw:
+            polygons:
+                color: blue
+)END";
+
+TEST_CASE("Scene diff marks styles of functions when globals change") {
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    auto scene = std::make_shared<Scene>(platform, Url());
+    REQUIRE(loadConfig(functionSceneString, scene->config()));
+    REQUIRE(SceneLoader::applyConfig(platform, scene));
+
+    // Read by the filter function only
+    auto nextScene = updateScene(platform, *scene, {{"global.theme", "light"}});
+    auto diff = SceneDiff::compare(*scene, *nextScene);
+
+    CHECK(diff.partial);
+    CHECK(diff.affects(*nextScene->findStyle("polygons")));
+    CHECK(!diff.affects(*nextScene->findStyle("lines")));
+
+    // Referenced by a draw rule
+    nextScene = updateScene(platform, *scene, {{"global.road_color", "green"}});
+    diff = SceneDiff::compare(*scene, *nextScene);
+
+    CHECK(diff.partial);
+    CHECK(diff.affects(*nextScene->findStyle("lines")));
+    CHECK(diff.affects(*nextScene->findStyle("polygons")));
+}
+
+TEST_CASE("Scene diff requires full reload when styles are added") {
+    std::shared_ptr<Platform> platform = std::make_shared<MockPlatform>();
+    auto scene = std::make_shared<Scene>(platform, Url());
+    REQUIRE(loadConfig(styledSceneString, scene->config()));
+    REQUIRE(SceneLoader::applyConfig(platform, scene));
+
+    auto nextScene = updateScene(platform, *scene, {{"styles", "{ roads: { base: lines } }"}});
+    auto diff = SceneDiff::compare(*scene, *nextScene);
+
+    CHECK(!diff.partial);
+}
@@ -0,0 +1,109 @@
+#include "catch.hpp"
+
+#include "data/tileArchive.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace Tangram;
+
+const char archiveFile[] = "test.tilearchive";
+
+static void writeArchive(const std::string& _data, std::vector<TileArchive::Entry> _entries) {
+    TileArchive::Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "TGTA", 4);
+    header.version = 1;
+    header.compression = TileArchive::Compression::identity;
+    header.dataOffset = sizeof(header);
+    header.dataLength = _data.size();
+    header.directoryOffset = (sizeof(header) + _data.size() + 7) / 8 * 8;
+    header.numEntries = _entries.size();
+
+    for (auto& entry : _entries) { entry.offset += header.dataOffset; }
+
+    FILE* file = std::fopen(archiveFile, "wb");
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fwrite(_data.data(), 1, _data.size(), file);
+    for (size_t i = sizeof(header) + _data.size(); i < header.directoryOffset; i++) { std::fputc(0, file); }
+    std::fwrite(_entries.data(), sizeof(TileArchive::Entry), _entries.size(), file);
+    std::fclose(file);
+}
+
+static std::string getTile(const TileArchive& _archive, TileID _tileId) {
+    const char* data = nullptr;
+    size_t size = 0;
+    if (!_archive.getTile(_tileId, data, size)) { return "none"; }
+    return std::string(data, size);
+}
+
+TEST_CASE("Tile keys enumerate the tiles of each zoom along a Hilbert curve", "[TileArchive]") {
+    REQUIRE(TileArchive::tileKey(TileID(0, 0, 0)) == 0);
+    REQUIRE(TileArchive::tileKey(TileID(0, 0, 1)) == 1);
+    REQUIRE(TileArchive::tileKey(TileID(0, 0, 2)) == 5);
+
+    for (int z = 1; z <= 4; z++) {
+        int n = 1 << z;
+        uint64_t base = TileArchive::tileKey(TileID(0, 0, z));
+
+        std::vector<TileID> tiles(n * n, TileID(0, 0, 0));
+        for (int x = 0; x < n; x++) {
+            for (int y = 0; y < n; y++) {
+                uint64_t key = TileArchive::tileKey(TileID(x, y, z));
+                REQUIRE(key >= base);
+                REQUIRE(key - base < uint64_t(n * n));
+                tiles[key - base] = TileID(x, y, z);
+            }
+        }
+        // Consecutive keys are neighbors
+        for (size_t i = 1; i < tiles.size(); i++) {
+            REQUIRE(std::abs(tiles[i].x - tiles[i - 1].x) + std::abs(tiles[i].y - tiles[i - 1].y) == 1);
+        }
+    }
+}
+
+TEST_CASE("Find tiles and runs of tiles in a TileArchive", "[TileArchive]") {
+    uint64_t base = TileArchive::tileKey(TileID(0, 0, 2));
+
+    writeArchive("rootwaterland", {
+            { TileArchive::tileKey(TileID(0, 0, 0)), 0, 4, 1 },
+            // Run of four tiles with the same data
+            { base, 4, 5, 4 },
+            { base + 4, 9, 4, 1 },
+        });
+
+    TileArchive archive(archiveFile);
+    REQUIRE(archive.isOpen());
+
+    REQUIRE(getTile(archive, TileID(0, 0, 0)) == "root");
+    REQUIRE(getTile(archive, TileID(0, 0, 1)) == "none");
+
+    std::multiset<std::string> tiles;
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            tiles.insert(getTile(archive, TileID(x, y, 2)));
+        }
+    }
+    REQUIRE(tiles.count("water") == 4);
+    REQUIRE(tiles.count("land") == 1);
+    REQUIRE(tiles.count("none") == 11);
+
+    std::remove(archiveFile);
+}
+
+TEST_CASE("Do not open invalid TileArchive files", "[TileArchive]") {
+    REQUIRE(!TileArchive("missing.tilearchive").isOpen());
+
+    FILE* file = std::fopen(archiveFile, "wb");
+    std::string content(100, 'x');
+    std::fwrite(content.data(), 1, content.size(), file);
+    std::fclose(file);
+
+    REQUIRE(!TileArchive(archiveFile).isOpen());
+
+    std::remove(archiveFile);
+}
@@ -0,0 +1,89 @@
+#include "catch.hpp"
+
+#include "util/tileBuffer.h"
+#include "util/zlibHelper.h"
+
+#include <zlib.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Tangram;
+
+TEST_CASE("Released TileBuffers are reused", "[TileBuffer]") {
+    const char* block = nullptr;
+    {
+        auto buffer = TileBuffer::create(5000);
+        REQUIRE(buffer->size() == 5000);
+        REQUIRE(buffer->capacity() == 8192);
+        block = buffer->data();
+    }
+    auto stats = TileBuffer::poolStats();
+
+    // Same size class
+    auto buffer = TileBuffer::create(6000);
+    REQUIRE(buffer->data() == block);
+    REQUIRE(TileBuffer::poolStats().reused == stats.reused + 1);
+    REQUIRE(TileBuffer::poolStats().allocated == stats.allocated);
+}
+
+TEST_CASE("Growing a TileBuffer keeps its contents", "[TileBuffer]") {
+    auto buffer = TileBuffer::copy("tile", 4);
+    buffer->resize(100000);
+    REQUIRE(buffer->capacity() >= 100000);
+    REQUIRE(std::string(buffer->data(), 4) == "tile");
+
+    buffer->resize(2);
+    REQUIRE(buffer->size() == 2);
+    REQUIRE(std::string(buffer->data(), 2) == "ti");
+}
+
+TEST_CASE("Adopted vectors and views are not copied", "[TileBuffer]") {
+    std::vector<char> data = { 'a', 'b', 'c' };
+    const char* bytes = data.data();
+
+    auto adopted = TileBuffer::adopt(std::move(data));
+    REQUIRE(adopted->data() == bytes);
+    REQUIRE(adopted->size() == 3);
+
+    auto owner = std::make_shared<std::string>("mapped");
+    std::weak_ptr<std::string> weakOwner = owner;
+
+    auto view = TileBuffer::view(owner->data() + 1, 3, owner);
+    owner.reset();
+
+    // The view keeps its owner alive
+    REQUIRE(!weakOwner.expired());
+    REQUIRE(std::string(view->data(), view->size()) == "app");
+
+    view.reset();
+    REQUIRE(weakOwner.expired());
+}
+
+TEST_CASE("Inflate gzip data into a TileBuffer", "[TileBuffer]") {
+    std::string input;
+    for (int i = 0; i < 10000; i++) { input += std::to_string(i); }
+
+    // Compress with a gzip header
+    z_stream strm;
+    std::memset(&strm, 0, sizeof(strm));
+    REQUIRE(deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8,
+                         Z_DEFAULT_STRATEGY) == Z_OK);
+
+    std::vector<char> compressed(deflateBound(&strm, input.size()));
+    strm.next_in = (Bytef*)input.data();
+    strm.avail_in = input.size();
+    strm.next_out = (Bytef*)compressed.data();
+    strm.avail_out = compressed.size();
+    REQUIRE(deflate(&strm, Z_FINISH) == Z_STREAM_END);
+    compressed.resize(strm.total_out);
+    deflateEnd(&strm);
+
+    auto buffer = TileBuffer::create();
+    REQUIRE(zlib::inflate(compressed.data(), compressed.size(), *buffer) == 0);
+    REQUIRE(std::string(buffer->data(), buffer->size()) == input);
+
+    auto invalid = TileBuffer::create();
+    REQUIRE(zlib::inflate(input.data(), input.size(), *invalid) != 0);
+}
@@ -0,0 +1,116 @@
+#include "catch.hpp"
+
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "scene/dataLayer.h"
+#include "scene/drawRule.h"
+#include "scene/filters.h"
+#include "scene/scene.h"
+#include "scene/sceneLayer.h"
+#include "style/polygonStyle.h"
+#include "tile/tile.h"
+#include "tile/tileBuilder.h"
+#include "tile/tileTask.h"
+
+#include "yaml-cpp/yaml.h"
+
+using namespace Tangram;
+
+// Scene which draws the features of layer "water" from source "osm" as extruded polygons
+static std::shared_ptr<Scene> makeScene() {
+    auto scene = std::make_shared<Scene>();
+
+    auto style = std::make_unique<PolygonStyle>("polygons");
+    style->setID(0);
+    style->build(*scene);
+    scene->styles().push_back(std::move(style));
+
+    std::vector<StyleParam> params = {
+        { StyleParamKey::order, YAML::Node(0) },
+        { StyleParamKey::color, YAML::Node("blue") },
+        { StyleParamKey::extrude, YAML::Load("[0, 10]") }
+    };
+    DrawRuleData rule("polygons", scene->addIdForName("polygons"), std::move(params));
+
+    SceneLayer layer("water", Filter(), { rule }, {}, true);
+    scene->layers().emplace_back(layer, "osm", std::vector<std::string>{ "water" });
+
+    return scene;
+}
+
+// Provides the geometry of the features and cancels the task of the build
+// after a number of features
+struct CancelingDecoder : GeometryDecoder {
+    FeatureGeometry square;
+    TileTask* task = nullptr;
+    int cancelAfter = 0;
+    int decoded = 0;
+
+    void decode(Feature& _feature) override {
+        _feature.geometry = square;
+        _feature.encodedGeometry = 0;
+        if (++decoded == cancelAfter) { task->cancel(); }
+    }
+};
+
+static std::unique_ptr<TileData> makeTileData(int _numFeatures, CancelingDecoder*& _decoder) {
+    auto tileData = std::make_unique<TileData>();
+
+    auto decoder = std::make_unique<CancelingDecoder>();
+    for (auto& p : { Point(0.1f, 0.1f), Point(0.2f, 0.1f), Point(0.2f, 0.2f), Point(0.1f, 0.2f), Point(0.1f, 0.1f) }) {
+        tileData->geometry.addPoint(p);
+    }
+    tileData->geometry.endRing();
+    tileData->geometry.endPart();
+    decoder->square = tileData->geometry.endFeature();
+
+    tileData->layers.emplace_back("water");
+    for (int i = 0; i < _numFeatures; i++) {
+        Feature feature;
+        feature.geometryType = GeometryType::polygons;
+        feature.encodedGeometry = 1;
+        tileData->layers.back().features.push_back(std::move(feature));
+    }
+
+    _decoder = decoder.get();
+    tileData->geometryDecoder = std::move(decoder);
+    return tileData;
+}
+
+TEST_CASE( "TileBuilder returns no tile for a canceled build and stays usable", "[TileBuilder]" ) {
+    auto scene = makeScene();
+
+    auto source = std::make_shared<TileSource>("osm", nullptr);
+    TileID tileId(0, 0, 1);
+    const int numFeatures = 1000;
+
+    TileBuilder tileBuilder(scene);
+
+    CancelingDecoder* decoder = nullptr;
+    auto tileData = makeTileData(numFeatures, decoder);
+
+    // Cancel in the middle of the build, after some geometry was added
+    auto canceled = source->createTask(tileId);
+    decoder->task = canceled.get();
+    decoder->cancelAfter = numFeatures / 2 + 1;
+
+    REQUIRE(tileBuilder.build(tileId, *tileData, *source, nullptr, canceled.get()) == nullptr);
+    REQUIRE(tileBuilder.canceledBuilds() == 1);
+    REQUIRE(tileBuilder.buildProgress() > 0.f);
+    REQUIRE(tileBuilder.buildProgress() < 1.f);
+
+    // The next build must not contain geometry of the canceled build
+    auto task = source->createTask(tileId);
+    auto tile = tileBuilder.build(tileId, *makeTileData(numFeatures, decoder), *source, nullptr, task.get());
+    REQUIRE(tile);
+    REQUIRE(tileBuilder.buildProgress() == 1.f);
+
+    TileBuilder freshBuilder(scene);
+    auto expected = freshBuilder.build(tileId, *makeTileData(numFeatures, decoder), *source);
+    REQUIRE(expected);
+
+    auto& style = *scene->findStyle("polygons");
+    REQUIRE(tile->getMesh(style));
+    REQUIRE(tile->getMesh(style)->bufferSize() == expected->getMesh(style)->bufferSize());
+}
@@ -0,0 +1,83 @@
+#include "catch.hpp"
+
+#include "style/polygonStyle.h"
+#include "tile/tile.h"
+#include "tile/tileCache.h"
+
+using namespace Tangram;
+
+struct SizedMesh : StyledMesh {
+    size_t size;
+    SizedMesh(size_t _size) : size(_size) {}
+    bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao) override { return true; }
+    size_t bufferSize() const override { return size; }
+};
+
+static PolygonStyle cacheStyle("polygons");
+
+static std::shared_ptr<Tile> newTile(int _x, size_t _size, uint64_t _buildTime = 0) {
+    auto tile = std::make_shared<Tile>(TileID(_x, 0, 10), 0, 0);
+    tile->initGeometry(1);
+    tile->setMesh(cacheStyle, std::make_unique<SizedMesh>(_size));
+    tile->setBuildTime(_buildTime);
+    return tile;
+}
+
+TEST_CASE("Keep reused tiles in the TileCache while panning over new tiles", "[TileCache]") {
+    TileCache cache(100);
+
+    // Tiles of the home area, shown again after leaving the view once
+    for (int x = 0; x < 4; x++) { cache.put(0, newTile(x, 10)); }
+    for (int x = 0; x < 4; x++) {
+        auto tile = cache.get(0, TileID(x, 0, 10));
+        REQUIRE(tile);
+        cache.put(0, tile);
+    }
+
+    // Long pan over tiles that are seen only once
+    for (int x = 100; x < 200; x++) { cache.put(0, newTile(x, 10)); }
+
+    for (int x = 0; x < 4; x++) {
+        REQUIRE(cache.contains(0, TileID(x, 0, 10)));
+    }
+    REQUIRE(cache.getMemoryUsage() <= 100);
+
+    auto stats = cache.stats();
+    REQUIRE(stats.hits == 4);
+    REQUIRE(stats.misses == 0);
+    REQUIRE(stats.evictions == 104 - stats.entries);
+    REQUIRE(stats.usage == cache.getMemoryUsage());
+}
+
+TEST_CASE("Evict tiles which are cheap to rebuild first", "[TileCache]") {
+    TileCache cache(40);
+
+    cache.put(0, newTile(0, 10, 10000));
+    cache.put(0, newTile(1, 10, 10));
+    cache.put(0, newTile(2, 10, 10000));
+    cache.put(0, newTile(3, 10, 10000));
+
+    REQUIRE(cache.getMemoryUsage() == 40);
+
+    cache.limitCacheSize(30);
+
+    REQUIRE(cache.contains(0, TileID(0, 0, 10)));
+    REQUIRE(!cache.contains(0, TileID(1, 0, 10)));
+    REQUIRE(cache.stats().evictions == 1);
+}
+
+TEST_CASE("Count TileCache hits and misses", "[TileCache]") {
+    TileCache cache(100);
+
+    cache.put(0, newTile(0, 10));
+
+    REQUIRE(!cache.get(1, TileID(0, 0, 10)));
+    REQUIRE(!cache.get(0, TileID(1, 0, 10)));
+    REQUIRE(cache.get(0, TileID(0, 0, 10)));
+
+    auto stats = cache.stats();
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.misses == 2);
+    REQUIRE(stats.entries == 0);
+    REQUIRE(stats.usage == 0);
+}
@@ -0,0 +1,89 @@
+#include "catch.hpp"
+
+#include "data/tileData.h"
+
+#include <vector>
+
+using namespace Tangram;
+
+TEST_CASE("Geometry arena stores lines and polygons by offsets", "[TileData]") {
+    GeometryArena arena;
+
+    Feature lines;
+    lines.geometryType = GeometryType::lines;
+    arena.addPoint({ 0, 0 });
+    arena.addPoint({ 1, 0 });
+    arena.endRing();
+    // Empty lines are dropped
+    arena.endRing();
+    arena.addPoint({ 0, 1 });
+    arena.addPoint({ 1, 1 });
+    arena.addPoint({ 1, 2 });
+    arena.endRing();
+    lines.geometry = arena.endFeature();
+
+    REQUIRE(lines.lines().size() == 2);
+    REQUIRE(lines.lines()[0].size() == 2);
+    REQUIRE(lines.lines()[1].size() == 3);
+    REQUIRE(lines.lines()[1].back() == Point(1, 2));
+    REQUIRE(lines.points().size() == 5);
+    REQUIRE(lines.polygons().empty());
+
+    Feature polygons;
+    polygons.geometryType = GeometryType::polygons;
+    for (int polygon = 0; polygon < 2; polygon++) {
+        for (int ring = 0; ring <= polygon; ring++) {
+            for (auto& p : { Point(0, 0), Point(1, 0), Point(1, 1), Point(0, 0) }) {
+                arena.addPoint(p + float(ring));
+            }
+            arena.endRing();
+        }
+        arena.endPart();
+    }
+    polygons.geometry = arena.endFeature();
+
+    REQUIRE(polygons.polygons().size() == 2);
+    REQUIRE(polygons.polygons()[0].size() == 1);
+    REQUIRE(polygons.polygons()[1].size() == 2);
+    REQUIRE(polygons.polygons()[1][1][0] == Point(1, 1));
+
+    size_t rings = 0, points = 0;
+    for (auto polygon : polygons.polygons()) {
+        for (auto ring : polygon) {
+            rings++;
+            for (const auto& point : ring) { points += point.x >= 0; }
+        }
+    }
+    REQUIRE(rings == 3);
+    REQUIRE(points == 12);
+
+    Feature empty;
+    empty.geometry = arena.endFeature();
+    REQUIRE(empty.points().empty());
+    REQUIRE(empty.lines().empty());
+}
+
+TEST_CASE("Geometry arena keeps stored geometry in place", "[TileData]") {
+    GeometryArena arena;
+
+    std::vector<Feature> features(1000);
+    for (size_t i = 0; i < features.size(); i++) {
+        for (size_t j = 0; j <= i % 10; j++) {
+            arena.addPoint({ float(i), float(j) });
+        }
+        arena.endRing();
+        features[i].geometry = arena.endFeature();
+    }
+
+    // Later features did not move the geometry of the first ones
+    for (size_t i = 0; i < features.size(); i++) {
+        auto line = features[i].lines()[0];
+        REQUIRE(line.size() == i % 10 + 1);
+        REQUIRE(line.front() == Point(i, 0));
+        REQUIRE(line.back() == Point(i, i % 10));
+    }
+
+    // Allocated in a few blocks rather than per feature
+    REQUIRE(arena.capacity() >= 1000 * (sizeof(Point) + 2 * sizeof(uint32_t)));
+    REQUIRE(arena.capacity() < 200 * 1024);
+}
@@ -0,0 +1,92 @@
+#include "catch.hpp"
+
+#include "tile/tileIDMap.h"
+
+#include <map>
+#include <memory>
+
+using namespace Tangram;
+
+TEST_CASE( "Insert, find and erase TileIDs", "[Core][TileIDMap]" ) {
+
+    TileIDMap<int> map;
+
+    REQUIRE(map.empty());
+    REQUIRE(map.find(TileID(0, 0, 0)) == map.end());
+
+    for (int i = 0; i < 100; i++) {
+        auto result = map.emplace(TileID(i, i / 2, 10), i);
+        REQUIRE(result.second);
+        REQUIRE(result.first->second == i);
+    }
+
+    REQUIRE(map.size() == 100);
+    REQUIRE(!map.emplace(TileID(5, 2, 10), 0).second);
+    REQUIRE(map.find(TileID(5, 2, 10))->second == 5);
+
+    // Same x/y on a different zoom
+    REQUIRE(map.count(TileID(5, 2, 11)) == 0);
+
+    REQUIRE(map.erase(TileID(5, 2, 10)) == 1);
+    REQUIRE(map.erase(TileID(5, 2, 10)) == 0);
+    REQUIRE(map.count(TileID(5, 2, 10)) == 0);
+    REQUIRE(map.size() == 99);
+
+    // Entries after the erased slot are still found
+    for (int i = 0; i < 100; i++) {
+        if (i == 5) { continue; }
+        REQUIRE(map.find(TileID(i, i / 2, 10))->second == i);
+    }
+
+    map[TileID(5, 2, 10)] = 50;
+    REQUIRE(map.find(TileID(5, 2, 10))->second == 50);
+    REQUIRE(map.size() == 100);
+}
+
+TEST_CASE( "Erase TileIDs while iterating", "[Core][TileIDMap]" ) {
+
+    TileIDMap<std::shared_ptr<int>> map;
+    std::map<TileID, int> expected;
+
+    for (int i = 0; i < 64; i++) {
+        map.emplace(TileID(i % 8, i / 8, 3), std::make_shared<int>(i));
+        if (i % 3 != 0) { expected.emplace(TileID(i % 8, i / 8, 3), i); }
+    }
+
+    auto value = map.find(TileID(0, 0, 3))->second;
+    REQUIRE(value.use_count() == 2);
+
+    for (auto it = map.begin(); it != map.end();) {
+        if (*it->second % 3 == 0) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Erased values are released
+    REQUIRE(value.use_count() == 1);
+
+    std::map<TileID, int> remaining;
+    for (auto& it : map) {
+        remaining.emplace(it.first, *it.second);
+    }
+    REQUIRE(remaining == expected);
+}
+
+TEST_CASE( "References stay valid after reserve", "[Core][TileIDMap]" ) {
+
+    TileIDMap<int> map;
+    map.emplace(TileID(0, 0, 0), 1);
+
+    map.reserve(map.size() + 200);
+
+    auto& first = map.find(TileID(0, 0, 0))->second;
+
+    for (int i = 0; i < 200; i++) {
+        map.emplace(TileID(i, 0, 8), i);
+    }
+
+    REQUIRE(&first == &map.find(TileID(0, 0, 0))->second);
+    REQUIRE(map.size() == 201);
+}
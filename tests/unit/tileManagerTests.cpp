@@ -1,14 +1,26 @@
 #include "catch.hpp"
 
+#include "data/tileData.h"
 #include "data/tileSource.h"
+#include "labels/labelSet.h"
 #include "mockPlatform.h"
+#include "scene/scene.h"
+#include "scene/sceneDiff.h"
+#include "style/polygonStyle.h"
+#include "tile/geometryCache.h"
+#include "tile/tileCache.h"
 #include "tile/tileManager.h"
 #include "tile/tileWorker.h"
 #include "util/mapProjection.h"
 #include "util/fastmap.h"
 #include "view/view.h"
 
+#include <chrono>
 #include <deque>
+#include <set>
+#include <thread>
+
+#include <sys/stat.h>
 
 using namespace Tangram;
 
@@ -113,20 +125,35 @@ public:
     using Base = TileManager;
     using Base::Base;
 
-    void updateTiles(const ViewState& _view, std::set<TileID> _visibleTiles) {
+    void updateTiles(const ViewState& _view, std::set<TileID> _visibleTiles,
+                     std::set<TileID> _predictedTiles = {}) {
         // Mimic TileManager::updateTileSets(View& _view)
         m_tiles.clear();
+        m_uploadTiles.clear();
         m_tilesInProgress = 0;
         m_tileSetChanged = false;
 
+        completeTileTasks();
+
         TileSet& tileSet = m_tileSets[0];
 
-        tileSet.visibleTiles = _visibleTiles;
+        tileSet.visibleTiles.assign(_visibleTiles.begin(), _visibleTiles.end());
 
         TileManager::updateTileSet(tileSet, _view);
 
         loadTiles();
 
+        m_prefetchTasks = 0;
+        m_prefetchBytes = 0;
+
+        tileSet.predictedTiles.assign(_predictedTiles.begin(), _predictedTiles.end());
+
+        updatePrefetchTiles(tileSet);
+
+        if (!_predictedTiles.empty()) {
+            prefetchTiles(_view);
+        }
+
         // Make m_tiles an unique list of tiles for rendering sorted from
         // high to low zoom-levels.
         std::sort(m_tiles.begin(), m_tiles.end(), [](auto& a, auto& b){
@@ -219,6 +246,36 @@ TEST_CASE( "Load visible Tile", "[TileManager][updateTileSets]" ) {
 
 }
 
+TEST_CASE( "Defer completion of ready Tiles over the frame budget", "[TileManager][updateTileSets]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+
+    // Complete only one task per update
+    tileManager.setFrameBudget(1e-9f, 0);
+
+    std::set<TileID> visibleTiles = {TileID{0,0,1}, TileID{1,0,1}};
+    tileManager.updateTiles(viewState, visibleTiles);
+    worker.processTask();
+    worker.processTask();
+
+    REQUIRE(worker.processedCount == 2);
+
+    tileManager.updateTiles(viewState, visibleTiles);
+
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.deferredTasks() == 1);
+    REQUIRE(tileManager.hasDeferredTiles());
+
+    tileManager.updateTiles(viewState, visibleTiles);
+
+    REQUIRE(tileManager.getVisibleTiles().size() == 2);
+    REQUIRE(tileManager.deferredTasks() == 0);
+    REQUIRE(source->tileTaskCount == 2);
+}
 
 TEST_CASE( "Use proxy Tile", "[TileManager][updateTileSets]" ) {
     TestTileWorker worker;
@@ -304,3 +361,289 @@ TEST_CASE( "Use proxy Tile - circular proxies", "[TileManager][updateTileSets]"
     REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,0));
 
 }
+
+TEST_CASE( "Prefetch predicted Tile and use it when visible", "[TileManager][prefetch]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+
+    TileID visible = TileID(0, 0, 1);
+    TileID predicted = TileID(1, 0, 1);
+
+    tileManager.updateTiles(viewState, { visible }, { predicted });
+    REQUIRE(worker.tasks.size() == 2);
+    REQUIRE(worker.tasks.back()->isPrefetch());
+
+    worker.processTask();
+    worker.processTask();
+
+    // Prefetched tile moves to the TileCache
+    tileManager.updateTiles(viewState, { visible }, { predicted });
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getTileCache()->contains(source->id(), predicted));
+
+    tileManager.updateTiles(viewState, { predicted });
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getVisibleTiles()[0]->getID() == predicted);
+    REQUIRE(source->tileTaskCount == 2);
+
+    REQUIRE(tileManager.prefetchStats().requested == 1);
+    REQUIRE(tileManager.prefetchStats().hits == 1);
+}
+
+TEST_CASE( "Continue loading prefetch Tile when it becomes visible", "[TileManager][prefetch]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+
+    TileID visible = TileID(0, 0, 1);
+    TileID predicted = TileID(1, 0, 1);
+
+    tileManager.updateTiles(viewState, { visible }, { predicted });
+    REQUIRE(worker.tasks.size() == 2);
+
+    // Prefetch task is taken over instead of loading the tile again
+    tileManager.updateTiles(viewState, { visible, predicted });
+    REQUIRE(source->tileTaskCount == 2);
+    REQUIRE(!worker.tasks.back()->isPrefetch());
+    REQUIRE(tileManager.prefetchStats().hits == 1);
+
+    worker.processTask();
+    worker.processTask();
+
+    tileManager.updateTiles(viewState, { visible, predicted });
+    REQUIRE(tileManager.getVisibleTiles().size() == 2);
+}
+
+TEST_CASE( "Cancel prefetch Tile when prediction changes", "[TileManager][prefetch]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+
+    TileID visible = TileID(0, 0, 1);
+
+    tileManager.updateTiles(viewState, { visible }, { TileID(1, 0, 1) });
+    REQUIRE(worker.tasks.size() == 2);
+
+    tileManager.updateTiles(viewState, { visible }, { TileID(1, 1, 1) });
+    REQUIRE(worker.tasks.size() == 3);
+    REQUIRE(worker.tasks[1]->isCanceled());
+    REQUIRE(!worker.tasks[2]->isCanceled());
+
+    REQUIRE(tileManager.prefetchStats().requested == 2);
+    REQUIRE(tileManager.prefetchStats().canceled == 1);
+
+    // No prediction: remaining prefetch task is canceled
+    tileManager.updateTiles(viewState, { visible });
+    REQUIRE(worker.tasks[2]->isCanceled());
+}
+
+TEST_CASE( "Keep cached Tile on partial Scene update and load it again when visible", "[TileManager][rebuildStyles]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+
+    TileID cached = TileID(0, 0, 1);
+    TileID other = TileID(1, 0, 1);
+
+    tileManager.updateTiles(viewState, { cached });
+    worker.processTask();
+    tileManager.updateTiles(viewState, { cached });
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+
+    tileManager.updateTiles(viewState, { other });
+    worker.processTask();
+    REQUIRE(tileManager.getTileCache()->contains(source->id(), cached));
+
+    SceneDiff diff;
+    diff.partial = true;
+    diff.styles = { true };
+    tileManager.rebuildStyles(diff, {});
+
+    REQUIRE(tileManager.getTileCache()->contains(source->id(), cached));
+
+    // The stale tile is drawn while it is loaded again
+    tileManager.updateTiles(viewState, { cached });
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getVisibleTiles()[0]->getID() == cached);
+    REQUIRE(tileManager.getVisibleTiles()[0]->isStale());
+    REQUIRE(source->tileTaskCount == 3);
+
+    worker.processTask();
+    tileManager.updateTiles(viewState, { cached });
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(!tileManager.getVisibleTiles()[0]->isStale());
+    REQUIRE(source->tileTaskCount == 3);
+}
+
+struct UploadTestMesh : StyledMesh {
+    bool uploaded = true;
+
+    bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao) override { return true; }
+    size_t bufferSize() const override { return 0; }
+    bool isUploaded() const override { return uploaded; }
+};
+
+TEST_CASE( "Draw unaffected meshes of a restyled Tile until the new meshes are uploaded", "[TileManager][rebuildStyles]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+
+    PolygonStyle kept("kept");
+    kept.setID(0);
+    PolygonStyle restyled("restyled");
+    restyled.setID(1);
+
+    TileID tileId = TileID(0, 0, 1);
+
+    tileManager.updateTiles(viewState, { tileId });
+    worker.processTask();
+    tileManager.updateTiles(viewState, { tileId });
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+
+    auto tile = tileManager.getVisibleTiles()[0];
+    tile->setTileData(std::make_shared<TileData>());
+    tile->setMesh(kept, std::make_unique<UploadTestMesh>());
+    tile->setMesh(restyled, std::make_unique<UploadTestMesh>());
+
+    SceneDiff diff;
+    diff.partial = true;
+    diff.styles = { false, true };
+    tileManager.rebuildStyles(diff, {});
+
+    REQUIRE(worker.tasks.size() == 1);
+
+    // Rebuild the restyled style, its mesh is not uploaded within the frame budget
+    auto task = worker.tasks.front();
+    worker.tasks.pop_front();
+    auto mesh = std::make_unique<UploadTestMesh>();
+    mesh->uploaded = false;
+    auto* restyledMesh = mesh.get();
+    auto restyledTile = std::make_unique<Tile>(tileId, source->id(), source->generation());
+    restyledTile->setMesh(restyled, std::move(mesh));
+    task->setTile(std::move(restyledTile));
+    worker.pendingTiles = true;
+
+    tileManager.updateTiles(viewState, { tileId });
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getVisibleTiles()[0] == tile);
+    REQUIRE(tile->getMesh(kept));
+    REQUIRE(tile->getMesh(restyled));
+
+    // Uploaded tile replaces the base tile and takes over its unaffected mesh
+    restyledMesh->uploaded = true;
+    tileManager.updateTiles(viewState, { tileId });
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+
+    auto& drawn = *tileManager.getVisibleTiles()[0];
+    REQUIRE(&drawn != tile.get());
+    REQUIRE(drawn.getMesh(kept));
+    REQUIRE(drawn.getMesh(restyled).get() == restyledMesh);
+}
+
+struct RestyleTestLabels : LabelSet {
+    const Style* style = nullptr;
+    bool movable = true;
+
+    bool setStyle(const Style& _style) override {
+        if (movable) { style = &_style; }
+        return movable;
+    }
+};
+
+TEST_CASE( "Label meshes of kept Tiles are drawn with the Styles of the new Scene", "[TileManager][rebuildStyles]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+    auto source = std::make_shared<TestTileSource>();
+    std::vector<std::shared_ptr<TileSource>> sources = { source };
+    tileManager.setTileSources(sources);
+
+    PolygonStyle text("text");
+    text.setID(0);
+    PolygonStyle points("points");
+    points.setID(1);
+
+    TileID tileId = TileID(0, 0, 1);
+    tileManager.updateTiles(viewState, { tileId });
+    worker.processTask();
+    tileManager.updateTiles(viewState, { tileId });
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+
+    auto tile = tileManager.getVisibleTiles()[0];
+    tile->setTileData(std::make_shared<TileData>());
+    auto movable = std::make_unique<RestyleTestLabels>();
+    auto* labels = movable.get();
+    tile->setMesh(text, std::move(movable));
+    auto fixed = std::make_unique<RestyleTestLabels>();
+    fixed->movable = false;
+    tile->setMesh(points, std::move(fixed));
+
+    std::vector<std::unique_ptr<Style>> styles;
+    styles.push_back(std::make_unique<PolygonStyle>("text"));
+    styles.back()->setID(0);
+    styles.push_back(std::make_unique<PolygonStyle>("points"));
+    styles.back()->setID(1);
+
+    // No style is affected, the tile keeps its labels
+    SceneDiff diff;
+    diff.partial = true;
+    diff.styles = { false, false };
+    tileManager.rebuildStyles(diff, styles);
+
+    REQUIRE(tile->getMesh(text).get() == labels);
+    REQUIRE(labels->style == styles[0].get());
+    // Labels that cannot use the new Style are removed
+    REQUIRE(!tile->getMesh(points));
+}
+
+struct VersionedTestDataSource : TileSource::DataSource {
+    int loadCount = 0;
+
+    bool loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override {
+        loadCount++;
+        return true;
+    }
+    std::string dataVersion() const override { return "v1"; }
+};
+
+TEST_CASE( "Restore Tiles of the GeometryCache without loading their data", "[TileManager][GeometryCache]" ) {
+    TestTileWorker worker;
+    TestTileManager tileManager(std::make_shared<MockPlatform>(), worker);
+
+    auto dataSource = std::make_unique<VersionedTestDataSource>();
+    auto& data = *dataSource;
+    auto source = std::make_shared<TileSource>("test", std::move(dataSource));
+    source->generateGeometry(true);
+    tileManager.setTileSources({ source });
+
+    // Tile without geometry, all styles of the Scene are cached
+    Scene scene;
+    TileID cached(0, 0, 1), uncached(1, 0, 1);
+
+    mkdir("tile_manager_cache_test", 0755);
+    auto cache = std::make_shared<GeometryCache>("tile_manager_cache_test");
+    cache->store(0, scene, *source, Tile(cached, source->id(), source->generation()));
+    for (int i = 0; i < 1000 && !cache->contains(*source, cached); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    REQUIRE(cache->contains(*source, cached));
+
+    tileManager.setGeometryCache(cache);
+    tileManager.updateTiles(viewState, { cached, uncached });
+
+    // Only the uncached tile is loaded, the cached one is passed to the worker
+    REQUIRE(data.loadCount == 1);
+    REQUIRE(worker.tasks.size() == 1);
+    REQUIRE(worker.tasks[0]->tileId() == cached);
+    REQUIRE(worker.tasks[0]->hasCachedGeometry());
+}
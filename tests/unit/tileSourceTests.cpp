@@ -0,0 +1,156 @@
+#include "catch.hpp"
+
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "mockPlatform.h"
+#include "scene/scene.h"
+#include "tile/tileBuilder.h"
+#include "tile/tileID.h"
+#include "tile/tileManager.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+#include "view/view.h"
+
+#include <atomic>
+#include <set>
+#include <vector>
+
+using namespace Tangram;
+
+struct CountingTileSource : TileSource {
+
+    mutable std::atomic<int> parseCount{0};
+
+    CountingTileSource() : TileSource("test", nullptr, { 0, -1, 16, 0 }) {
+        m_generateGeometry = true;
+    }
+
+    // Data is available right away
+    void loadTileData(std::shared_ptr<TileTask> _task, TileTaskCb _cb) override {
+        _task->startedLoading();
+        _cb.func(std::move(_task));
+    }
+
+    std::shared_ptr<TileData> parse(const TileTask& _task) const override {
+        parseCount++;
+        return std::make_shared<TileData>();
+    }
+
+    std::shared_ptr<TileTask> createTask(TileID _tileId, int _subTask) override {
+        return std::make_shared<TileTask>(_tileId, shared_from_this(), _subTask);
+    }
+};
+
+static std::vector<std::shared_ptr<TileTask>> overzoomedTasks(std::shared_ptr<TileSource> _source) {
+    std::vector<std::shared_ptr<TileTask>> tasks;
+
+    // Display tiles at z17-z20 which all map onto source tile 16/100/200
+    for (int z = 17; z <= 20; z++) {
+        int over = z - 16;
+        for (int i = 0; i < 2; i++) {
+            TileID tileId((100 << over) + i, (200 << over) + i, z);
+            tasks.push_back(_source->createTask(tileId.withMaxSourceZoom(16), -1));
+        }
+    }
+    return tasks;
+}
+
+TEST_CASE("Parse overzoomed tiles of one source tile once", "[TileSource]") {
+    auto source = std::make_shared<CountingTileSource>();
+
+    auto tasks = overzoomedTasks(source);
+    for (auto& task : tasks) { task->parse(); }
+
+    REQUIRE(source->parseCount == 1);
+    REQUIRE(source->parseStats().parsed == 1);
+    REQUIRE(source->parseStats().shared == tasks.size() - 1);
+
+    for (auto& task : tasks) {
+        REQUIRE(task->isParsed());
+        REQUIRE(!task->isCanceled());
+    }
+}
+
+TEST_CASE("Parse again once shared TileData is released", "[TileSource]") {
+    auto source = std::make_shared<CountingTileSource>();
+
+    auto tasks = overzoomedTasks(source);
+    tasks[0]->parse();
+    tasks.clear();
+
+    tasks = overzoomedTasks(source);
+    tasks[0]->parse();
+
+    REQUIRE(source->parseCount == 2);
+
+    // New generation of the source data
+    source->clearData();
+    source->createTask(TileID(100, 200, 16), -1)->parse();
+
+    REQUIRE(source->parseCount == 3);
+}
+
+TEST_CASE("Parse each task when TileData sharing is disabled", "[TileSource]") {
+    auto source = std::make_shared<CountingTileSource>();
+    source->shareTileData(false);
+
+    auto tasks = overzoomedTasks(source);
+    for (auto& task : tasks) { task->parse(); }
+
+    REQUIRE(source->parseCount == int(tasks.size()));
+    REQUIRE(source->parseStats().shared == 0);
+}
+
+// Parses and builds tasks right away, like a TileWorker
+struct ParsingTaskQueue : TileTaskQueue {
+    TileBuilder builder{ std::make_shared<Scene>() };
+    size_t taskCount = 0;
+
+    void enqueue(std::shared_ptr<TileTask> _task) override {
+        taskCount++;
+        _task->parse();
+        _task->process(builder);
+    }
+};
+
+TEST_CASE("Parse source tiles once when zooming in past maxZoom", "[TileSource][TileManager]") {
+    auto center = MapProjection::lngLatToProjectedMeters({ 13.4, 52.5 });
+
+    // Display tiles of one zoom which map onto the same source tile get one
+    // task, sharing applies between zooms
+    std::vector<View> views;
+    std::set<TileID> sourceTiles;
+    for (int zoom = 16; zoom <= 20; zoom++) {
+        View view(1920, 1080);
+        view.setPosition(center.x, center.y);
+        view.setZoom(zoom);
+        view.update();
+        views.push_back(view);
+
+        view.getVisibleTiles([&](TileID _tileId) {
+                auto sourceTile = _tileId.withMaxSourceZoom(16);
+                sourceTiles.insert(TileID(sourceTile.x, sourceTile.y, sourceTile.z));
+            });
+    }
+
+    for (bool share : { false, true }) {
+        INFO("sharing " << share);
+
+        auto source = std::make_shared<CountingTileSource>();
+        source->shareTileData(share);
+
+        ParsingTaskQueue queue;
+        TileManager tileManager(std::make_shared<MockPlatform>(), queue);
+        tileManager.setTileSources({ source });
+
+        // Tiles of previous zooms stay in the TileCache with their TileData
+        for (auto& view : views) {
+            tileManager.updateTileSets(view);
+            tileManager.updateTileSets(view);
+        }
+
+        REQUIRE(queue.taskCount > sourceTiles.size());
+        REQUIRE(size_t(source->parseCount) == (share ? sourceTiles.size() : queue.taskCount));
+        REQUIRE(source->parseStats().parsed + source->parseStats().shared == queue.taskCount);
+    }
+}
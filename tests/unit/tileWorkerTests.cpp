@@ -0,0 +1,130 @@
+#include "catch.hpp"
+
+#include "data/tileSource.h"
+#include "mockPlatform.h"
+#include "scene/scene.h"
+#include "tile/tileTask.h"
+#include "tile/tileWorker.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+struct OrderTask : TileTask {
+    // Tasks of the test, a lower rank must be built first
+    std::vector<std::shared_ptr<OrderTask>>* tasks = nullptr;
+    std::atomic<int>* violations = nullptr;
+    std::atomic<int>* processed = nullptr;
+    int rank = 0;
+
+    OrderTask(TileID _tileId, std::shared_ptr<TileSource> _source)
+        : TileTask(_tileId, _source, -1) {
+        m_needsLoading = false;
+    }
+
+    bool isQueued() const { return m_heap.load() != nullptr; }
+
+    void parse() override { m_parsed = true; }
+
+    void process(TileBuilder& _tileBuilder) override {
+        // Any worker must have taken all tasks of higher priority
+        for (auto& task : *tasks) {
+            if (task->rank < rank && task->isQueued()) { (*violations)++; }
+        }
+        m_ready = true;
+        (*processed)++;
+    }
+};
+
+TEST_CASE( "TileWorker builds tasks in global priority order", "[TileWorker]" ) {
+    auto platform = std::make_shared<MockPlatform>();
+    auto source = std::make_shared<TileSource>("test", nullptr);
+
+    std::vector<std::shared_ptr<OrderTask>> tasks;
+    std::atomic<int> violations{0};
+    std::atomic<int> processed{0};
+
+    // Visible tiles by priority, then proxy tiles, then prefetch tiles
+    int numTasks = 64;
+    for (int i = 0; i < numTasks; i++) {
+        auto task = std::make_shared<OrderTask>(TileID(i, 0, 10), source);
+        task->tasks = &tasks;
+        task->violations = &violations;
+        task->processed = &processed;
+        task->rank = i;
+        if (i >= numTasks / 2) {
+            task->setPrefetch(true);
+        } else if (i >= numTasks / 4) {
+            task->setProxyState(true);
+        }
+        task->setPriority(i);
+        tasks.push_back(task);
+    }
+
+    TileWorker worker(platform, 4);
+
+    // Queue all tasks before the workers can start, in reverse order
+    for (auto it = tasks.rbegin(); it != tasks.rend(); ++it) {
+        worker.enqueue(*it);
+    }
+
+    auto scene = std::make_shared<Scene>();
+    worker.setScene(scene);
+
+    for (int i = 0; i < 1000 && processed < numTasks; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    worker.stop();
+
+    REQUIRE(processed == numTasks);
+    REQUIRE(violations == 0);
+}
+
+template<typename F>
+static bool waitFor(F _condition) {
+    for (int i = 0; i < 1000 && !_condition(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return _condition();
+}
+
+TEST_CASE( "TileWorker parses again when a task leaves the full build queue", "[TileWorker]" ) {
+    auto platform = std::make_shared<MockPlatform>();
+    auto source = std::make_shared<TileSource>("test", nullptr);
+
+    // No scene is set: parsed tasks stay in the build queue of size 1
+    TileWorker worker(platform, 1, 1, 1);
+
+    auto first = std::make_shared<OrderTask>(TileID(0, 0, 1), source);
+    auto second = std::make_shared<OrderTask>(TileID(1, 0, 1), source);
+    auto third = std::make_shared<OrderTask>(TileID(0, 1, 1), source);
+
+    worker.enqueue(first);
+    REQUIRE(waitFor([&]{ return worker.stats().buildQueue == 1; }));
+
+    worker.enqueue(second);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(worker.stats().parseQueue == 1);
+    REQUIRE(!second->isParsed());
+
+    // Canceling the queued task makes room for the waiting parser
+    first->cancel();
+    REQUIRE(waitFor([&]{ return second->isParsed(); }));
+    REQUIRE(waitFor([&]{ return worker.stats().buildQueue == 1; }));
+
+    // Without parsers the waiting tasks are passed on to the builders
+    worker.enqueue(third);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(worker.stats().parseQueue == 1);
+
+    worker.setParseWorkers(0);
+    REQUIRE(worker.stats().parseQueue == 0);
+    REQUIRE(worker.stats().buildQueue == 2);
+    REQUIRE(!third->isParsed());
+
+    worker.stop();
+}
@@ -0,0 +1,102 @@
+#include "catch.hpp"
+
+#include "data/formats/topoJson.h"
+#include "data/tileData.h"
+#include "data/tileSource.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+
+#include <string>
+#include <vector>
+
+using namespace Tangram;
+
+static std::shared_ptr<TileData> parse(const std::string& _json) {
+    auto source = std::make_shared<TileSource>("test", nullptr);
+    source->setFormat(TileSource::Format::TopoJson);
+
+    auto task = source->createTask(TileID(0, 0, 0));
+    static_cast<BinaryTileTask&>(*task).rawTileData = TileBuffer::copy(_json.data(), _json.size());
+
+    return source->parse(*task);
+}
+
+// Position of a longitude and latitude in tile 0/0/0
+static Point project(double _longitude, double _latitude) {
+    BoundingBox bounds(MapProjection::tileBounds(TileID(0, 0, 0)));
+    ProjectedMeters meters = MapProjection::lngLatToProjectedMeters(LngLat(_longitude, _latitude));
+    return Point((meters.x - bounds.min.x) / bounds.width(), (meters.y - bounds.min.y) / bounds.width());
+}
+
+static void requireLine(const LineSpan& _line, const std::vector<Point>& _points) {
+    REQUIRE(_line.size() == _points.size());
+    for (size_t i = 0; i < _points.size(); i++) {
+        REQUIRE(_line[i].x == Approx(_points[i].x));
+        REQUIRE(_line[i].y == Approx(_points[i].y));
+    }
+}
+
+// Two squares of one degree sharing the arc from 1/0 to 1/1, the second
+// arc is invalid and must not change the indices of the arcs that follow
+const std::string objects = R"(
+  "objects": {
+    "regions": { "type": "GeometryCollection", "geometries": [
+      { "type": "Polygon", "arcs": [[0, 2]], "properties": { "name": "west" } },
+      { "type": "Polygon", "arcs": [[3, -3]], "properties": { "name": "east" } },
+      { "type": "LineString", "arcs": [-4] } ] } })";
+
+const std::string quantized = R"({ "type": "Topology",
+  "transform": { "scale": [0.5, 0.5], "translate": [0, 0] },
+  "arcs": [
+    [[2, 2], [-2, 0], [0, -2], [2, 0]],
+    "invalid",
+    [[2, 0], [0, 2]],
+    [[2, 0], [2, 0], [0, 2], [-2, 0]] ],)" + objects + "}";
+
+const std::string absolute = R"({ "type": "Topology",
+  "arcs": [
+    [[1, 1], [0, 1], [0, 0], [1, 0]],
+    "invalid",
+    [[1, 0], [1, 1]],
+    [[1, 0], [2, 0], [2, 1], [1.0, 1]] ],)" + objects + "}";
+
+TEST_CASE("Features are assembled from shared TopoJSON arcs", "[TopoJson]") {
+    for (auto& json : { quantized, absolute }) {
+        auto tileData = parse(json);
+        REQUIRE(tileData->layers.size() == 1);
+
+        auto& features = tileData->layers[0].features;
+        REQUIRE(features.size() == 3);
+
+        auto& west = features[0];
+        REQUIRE(west.geometryType == GeometryType::polygons);
+        REQUIRE(west.props.getString("name") == "west");
+        REQUIRE(west.polygons().size() == 1);
+        REQUIRE(west.polygons()[0].size() == 1);
+        requireLine(west.polygons()[0][0], { project(1, 1), project(0, 1), project(0, 0),
+                                             project(1, 0), project(1, 1) });
+
+        // The shared arc is reversed and its first point dropped
+        auto& east = features[1];
+        REQUIRE(east.polygons().size() == 1);
+        requireLine(east.polygons()[0][0], { project(1, 0), project(2, 0), project(2, 1),
+                                             project(1, 1), project(1, 0) });
+
+        auto& line = features[2];
+        REQUIRE(line.geometryType == GeometryType::lines);
+        REQUIRE(line.lines().size() == 1);
+        requireLine(line.lines()[0], { project(1, 1), project(2, 1), project(2, 0), project(1, 0) });
+    }
+}
+
+TEST_CASE("Points of a quantized topology are not delta-encoded", "[TopoJson]") {
+    auto tileData = parse(R"({ "type": "Topology", "arcs": [],
+      "transform": { "scale": [0.5, 0.5], "translate": [1, 1] },
+      "objects": { "pois": { "type": "GeometryCollection", "geometries": [
+        { "type": "MultiPoint", "coordinates": [[2, 2], [2, 2]] } ] } } })");
+
+    REQUIRE(tileData->layers.size() == 1);
+    auto& feature = tileData->layers[0].features[0];
+    REQUIRE(feature.geometryType == GeometryType::points);
+    requireLine(feature.points(), { project(2, 2), project(2, 2) });
+}
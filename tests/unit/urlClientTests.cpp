@@ -0,0 +1,240 @@
+#include "catch.hpp"
+
+#include "urlClient.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+// Minimal HTTP/1.1 server on localhost with keep-alive. Responds to any path
+// with the path as content. Requests for paths starting with '/hold' are
+// answered when release() is called.
+class HttpServer {
+public:
+    HttpServer() {
+        m_socket = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(m_socket, (sockaddr*)&address, sizeof(address));
+        listen(m_socket, 64);
+
+        socklen_t length = sizeof(address);
+        getsockname(m_socket, (sockaddr*)&address, &length);
+        m_port = ntohs(address.sin_port);
+
+        m_thread = std::thread(&HttpServer::acceptLoop, this);
+    }
+
+    ~HttpServer() {
+        m_running = false;
+        release();
+        m_thread.join();
+        for (auto& thread : m_connections) { thread.join(); }
+        close(m_socket);
+    }
+
+    std::string url(const std::string& _path) const {
+        return "http://127.0.0.1:" + std::to_string(m_port) + _path;
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_released = true;
+        m_condition.notify_all();
+    }
+
+    std::vector<std::string> paths() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_paths;
+    }
+
+    int connections() const { return m_numConnections; }
+
+private:
+    void acceptLoop() {
+        while (m_running) {
+            pollfd fd = { m_socket, POLLIN, 0 };
+            if (poll(&fd, 1, 50) <= 0) { continue; }
+
+            int connection = accept(m_socket, nullptr, nullptr);
+            if (connection < 0) { continue; }
+
+            m_numConnections++;
+            m_connections.emplace_back(&HttpServer::serve, this, connection);
+        }
+    }
+
+    void serve(int _connection) {
+        std::string buffer;
+        char chunk[4096];
+
+        while (m_running) {
+            size_t end = buffer.find("\r\n\r\n");
+            if (end == std::string::npos) {
+                pollfd fd = { _connection, POLLIN, 0 };
+                if (poll(&fd, 1, 50) <= 0) { continue; }
+
+                ssize_t n = recv(_connection, chunk, sizeof(chunk), 0);
+                if (n <= 0) { break; }
+                buffer.append(chunk, n);
+                continue;
+            }
+
+            // "GET <path> HTTP/1.1"
+            size_t start = buffer.find(' ') + 1;
+            std::string path = buffer.substr(start, buffer.find(' ', start) - start);
+            buffer.erase(0, end + 4);
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_paths.push_back(path);
+                if (path.compare(0, 5, "/hold") == 0) {
+                    m_condition.wait(lock, [&]{ return m_released || !m_running; });
+                }
+            }
+
+            std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " +
+                std::to_string(path.size()) + "\r\nConnection: keep-alive\r\n\r\n" + path;
+            if (send(_connection, response.data(), response.size(), MSG_NOSIGNAL) < 0) { break; }
+        }
+        close(_connection);
+    }
+
+    int m_socket = -1;
+    int m_port = 0;
+    std::atomic<bool> m_running{true};
+    std::atomic<int> m_numConnections{0};
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_released = false;
+    std::vector<std::string> m_paths;
+
+    std::thread m_thread;
+    std::vector<std::thread> m_connections;
+};
+
+// Counts completed requests and waits for them
+struct Responses {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::string> contents;
+    int errors = 0;
+
+    UrlCallback callback() {
+        return [this](UrlResponse&& _response) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (_response.error) {
+                errors++;
+            } else {
+                contents.emplace_back(_response.content.begin(), _response.content.end());
+            }
+            condition.notify_all();
+        };
+    }
+
+    bool wait(size_t _count, std::chrono::milliseconds _timeout = std::chrono::seconds(10)) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return condition.wait_for(lock, _timeout, [&]{ return contents.size() + errors >= _count; });
+    }
+};
+
+TEST_CASE("Waiting requests are started in the order of their current priority", "[UrlClient]") {
+    HttpServer server;
+    Responses responses;
+
+    UrlClient::Options options;
+    options.maxActiveRequests = 1;
+    UrlClient client(options);
+
+    // Occupies the only slot while the other requests wait
+    client.addRequest(server.url("/hold"), responses.callback());
+
+    std::vector<double> priorities = { 3, 1, 4, 2 };
+    std::mutex priorityMutex;
+    for (size_t i = 0; i < priorities.size(); i++) {
+        client.addRequest(server.url("/" + std::to_string(i)), responses.callback(), [&, i]() {
+            std::lock_guard<std::mutex> lock(priorityMutex);
+            return priorities[i];
+        });
+    }
+    {
+        // Re-ranked while waiting
+        std::lock_guard<std::mutex> lock(priorityMutex);
+        priorities[2] = 0;
+    }
+    server.release();
+
+    REQUIRE(responses.wait(5));
+    REQUIRE(responses.errors == 0);
+    REQUIRE(server.paths() == std::vector<std::string>({ "/hold", "/2", "/1", "/3", "/0" }));
+}
+
+TEST_CASE("Requests reuse kept-alive connections", "[UrlClient]") {
+    HttpServer server;
+    Responses responses;
+
+    UrlClient::Options options;
+    options.maxActiveRequests = 8;
+    options.maxConnectionsPerHost = 4;
+    UrlClient client(options);
+
+    const size_t count = 500;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        client.addRequest(server.url("/" + std::to_string(i)), responses.callback());
+    }
+    REQUIRE(responses.wait(count));
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(responses.errors == 0);
+    REQUIRE(responses.contents.size() == count);
+    REQUIRE(server.connections() <= 4);
+    REQUIRE(duration < std::chrono::seconds(5));
+}
+
+TEST_CASE("Canceled requests finish promptly", "[UrlClient]") {
+    HttpServer server;
+    Responses responses;
+
+    UrlClient::Options options;
+    options.maxActiveRequests = 1;
+    UrlClient client(options);
+
+    auto running = client.addRequest(server.url("/hold/running"), responses.callback());
+    auto waiting = client.addRequest(server.url("/waiting"), responses.callback());
+
+    // Waiting requests are finished by cancelRequest
+    client.cancelRequest(waiting);
+    REQUIRE(responses.errors == 1);
+
+    // Wait for the running request to reach the server
+    for (int i = 0; i < 100 && server.paths().empty(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(server.paths().size() == 1);
+
+    auto start = std::chrono::steady_clock::now();
+    client.cancelRequest(running);
+    REQUIRE(responses.wait(2, std::chrono::milliseconds(500)));
+    auto latency = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(responses.errors == 2);
+    REQUIRE(latency < std::chrono::milliseconds(100));
+}